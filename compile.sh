@@ -22,18 +22,49 @@ CXX="g++"
 CXXFLAGS="-std=c++17 -I./src -I./external/imgui -I./external/imgui/backends -pthread -O2 -DIMGUI_AVAILABLE"
 LIBS="-lglfw -lGL -lm"
 
+# SIMD backend for packet tracing: SSE2 by default, SIMD_FLAGS="-mavx2" for 8-wide AVX2,
+# SIMD_FLAGS="-DSIMD_DISABLE" for the scalar fallback
+CXXFLAGS="$CXXFLAGS ${SIMD_FLAGS}"
+
+# PROFILER_FLAGS="-DPROFILER_DISABLE" compiles the frame profiler instrumentation out
+CXXFLAGS="$CXXFLAGS ${PROFILER_FLAGS}"
+
+# LOG_FLAGS="-DLOG_MIN_LEVEL=2" compiles the LOG_DEBUG / LOG_INFO hot-path logging out
+CXXFLAGS="$CXXFLAGS ${LOG_FLAGS}"
+
 # Source files (common to all targets)
 COMMON_SOURCES="
 src/math/Vector3.cpp
 src/math/Matrix4.cpp
 src/core/Model.cpp
+src/core/ModelSaver.cpp
+src/core/MeshAdjacency.cpp
+src/core/MeshArrays.cpp
 src/core/Camera.cpp
 src/core/CoordinateAxes.cpp
 src/core/RayIntersection.cpp
+src/core/BVH.cpp
+src/core/InstanceBVH.cpp
+src/core/Scene.cpp
+src/core/RayBatch.cpp
+src/core/VertexBVH.cpp
+src/core/MeshSimplifier.cpp
+src/core/ModelLod.cpp
 src/rendering/SoftwareRenderer.cpp
+src/rendering/ScreenSpaceOverlays.cpp
+src/rendering/Framebuffer.cpp
+src/rendering/SkyTable.cpp
+src/rendering/ReprojectionCache.cpp
+src/rendering/Rasterizer.cpp
+src/rendering/ImageWriter.cpp
+src/rendering/FramePresenter.cpp
 src/input/InputHandler.cpp
 src/ui/UI.cpp
 src/utils/Utils.cpp
+src/utils/ThreadPool.cpp
+src/utils/MappedFile.cpp
+src/utils/ChunkedWriter.cpp
+src/utils/Profiler.cpp
 external/imgui/imgui.cpp
 external/imgui/imgui_demo.cpp
 external/imgui/imgui_draw.cpp
@@ -63,6 +94,9 @@ compile_target() {
 # Compilation targets
 echo -e "${BLUE}Available compilation targets:${NC}"
 echo "  model-editor - Main 3D model editor application (default)"
+echo "  benchmark    - Headless render benchmark (JSON results)"
+echo "  render       - Headless offline renderer (image sequences)"
+echo "  model-test   - Model viewer test app (--checks runs the model checks)"
 echo "  clean        - Clean build directory"
 echo
 
@@ -84,6 +118,15 @@ case $TARGET in
             exit 1
         fi
         ;;
+    "benchmark")
+        compile_target "render-benchmark" "src/rendering/RenderBenchmark.cpp"
+        ;;
+    "render")
+        compile_target "offline-render" "src/rendering/OfflineRender.cpp"
+        ;;
+    "model-test")
+        compile_target "model-test" "src/test/ModelTest.cpp"
+        ;;
     "clean")
         echo -e "${YELLOW}Cleaning build directory...${NC}"
         rm -rf build/*
@@ -95,12 +138,18 @@ case $TARGET in
         echo "Available targets:"
         echo "  model-editor - Main 3D model editor application (default)"
         echo "  main         - Alias for model-editor"
+        echo "  benchmark    - Headless render benchmark (run from the repo root for default_scene.fjwr)"
+        echo "  render       - Headless offline renderer (turntable or pose list to PNG/EXR/raw)"
+        echo "  model-test   - Model viewer test app; ./build/model-test --checks runs the headless model checks"
         echo "  clean        - Clean build directory"
         echo "  help         - Show this help message"
         echo
         echo "Examples:"
         echo "  $0                    # Compile main application"
         echo "  $0 model-editor       # Compile 3D model editor"
+        echo "  $0 benchmark          # Compile render benchmark (./build/render-benchmark --quick)"
+        echo "  $0 render             # Compile offline renderer (./build/offline-render --scene default_scene.fjwr)"
+        echo "  $0 model-test         # Compile model test app (./build/model-test --checks)"
         echo "  $0 clean              # Clean build directory"
         ;;
     *)
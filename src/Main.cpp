@@ -2,11 +2,16 @@
 #include <GL/gl.h>
 #include "core/Camera.h"
 #include "core/Model.h"
+#include "core/ModelSaver.h"
+#include "core/ModelLod.h"
+#include "core/Scene.h"
 #include "core/CoordinateAxes.h"
 #include "input/InputHandler.h"
 #include "rendering/SoftwareRenderer.h"
+#include "rendering/FramePresenter.h"
 #include "ui/UI.h"
 #include "utils/Utils.h"
+#include "utils/Profiler.h"
 #include <iostream>
 #include <vector>
 #include <chrono>
@@ -25,10 +30,29 @@ private:
     int windowWidth = 1000;
     int windowHeight = 800;
 
-    // Frame buffer for OpenGL display
-    std::vector<unsigned char> pixelBuffer;
+    // Streams the renderer's RGBA8 framebuffer to the window
+    FramePresenter presenter;
+
+    // Writes File > Save on a worker thread
+    ModelSaver saver;
+
+    // Simplified levels of large models, traced while the camera moves; rebuilt on a worker thread
+    // once edits pause
+    ModelLod lod;
+    std::chrono::steady_clock::time_point lastEditTime;
+    static constexpr int LOD_MIN_SOURCE_FACES = 200000; // Smaller models orbit fast enough as they are
+    static constexpr int LOD_MIN_FACES = 20000;         // Coarsest level built
+    static constexpr int LOD_FACE_BUDGET = 100000;      // Faces traced while the camera moves
+    static constexpr double LOD_EDIT_IDLE_SECONDS = 1.0;
+
+    // Scratch list for syncing model edits to the renderer
+    std::vector<int> changedIndices;
+
+    // Model face -> renderer scene triangle (the model is loaded as one instance per connected part)
+    std::vector<int> faceSceneTriangles;
 
     // Frame timing
+    static constexpr double IDLE_WAIT_SECONDS = 0.1; // Keeps the UI and background saves ticking while idle
     std::chrono::steady_clock::time_point lastFrameTime;
     float deltaTime = 0.0f;
     int frameCount = 0;
@@ -75,7 +99,8 @@ public:
         camera.setDistance(5.0f);
         camera.setIsometricView();
 
-        // Load default scene from .fjwr file
+        // Load default scene from .fjwr file (large scenes get a .fjwb sidecar for fast reloads)
+        model.setBinaryCacheEnabled(true);
         if (!model.loadFromFile("default_scene.fjwr")) {
             Utils::logError("Failed to load default_scene.fjwr, creating fallback model");
             createTestModel();
@@ -92,11 +117,20 @@ public:
         renderer.initialize();
         renderer.setResolution(windowWidth, windowHeight);
 
+        // Only the packed display plane is presented, so skip the float color plane
+        FramebufferPlanes planes;
+        planes.color = false;
+        renderer.setFramebufferPlanes(planes);
+
         // Load model into renderer
         loadModelIntoRenderer();
 
-        // Initialize pixel buffer
-        pixelBuffer.resize(windowWidth * windowHeight * 3);
+        // Initialize frame presentation (needs the OpenGL context)
+        if (!presenter.initialize())
+        {
+            Utils::logError("Failed to initialize frame presenter");
+            return false;
+        }
 
         // Initialize timing
         lastFrameTime = std::chrono::steady_clock::now();
@@ -104,6 +138,7 @@ public:
         // Initialize UI
         ui.setCamera(&camera);
         ui.setModel(&model);
+        ui.setModelSaver(&saver);
         ui.setCoordinateAxes(&coordinateAxes);
         ui.setRenderer(&renderer);
         ui.setWindowSize(windowWidth, windowHeight);
@@ -122,6 +157,9 @@ public:
         renderer.setVertexSelectionThreshold(0.05f);     // Larger click selection range
         renderer.setEdgeDisplayThickness(0.01f);         // Thin visual edge thickness
         renderer.setEdgeSelectionThreshold(0.02f);       // Wider click selection range
+        renderer.setProgressiveRendering(true);          // Coarse frames while the camera moves
+        renderer.setSkipUnchangedFrames(true);           // Idle viewport costs no tracing
+        renderer.setTemporalReprojection(true);          // Small moves reuse the last frame's pixels
 
         // Enable debug mode for easier vertex selection (disable visibility check)
         model.setDisableVisibilityCheck(true);
@@ -222,51 +260,35 @@ public:
         Utils::logInfo("  Total edges: " + std::to_string(model.getEdgeCount()));
     }
 
-    void loadModelIntoRenderer()
+    Triangle makeFaceTriangle(const Face &face) const
     {
-        // Clear existing triangles
-        renderer.clearTriangles();
-
         const auto &vertices = model.getVertices();
-        const auto &faces = model.getFaces();
-
-        // Add faces to renderer as triangles with object-specific colors
-        for (const auto &face : faces)
-        {
-            Vector3 v0 = vertices[face.v1].position;
-            Vector3 v1 = vertices[face.v2].position;
-            Vector3 v2 = vertices[face.v3].position;
+        return Triangle(vertices[face.v1].position, vertices[face.v2].position, vertices[face.v3].position);
+    }
 
-            // Assign colors based on vertex indices to identify objects
-            Vector3 color;
+    Line makeEdgeLine(const Edge &edge) const
+    {
+        const auto &vertices = model.getVertices();
+        Vector3 edgeColor(0.9f, 0.9f, 0.9f); // Brighter gray for visibility
+        return Line(vertices[edge.v1].position, vertices[edge.v2].position, edgeColor, 1.0f);
+    }
 
-            // Ground plane (vertices 0-3): Gray
-            if (face.v1 <= 3 && face.v2 <= 3 && face.v3 <= 3)
-            {
-                color = Vector3(0.6f, 0.6f, 0.6f); // Gray ground
-            }
-            // Normal pyramid (vertices 4-8): Green
-            else if (face.v1 >= 4 && face.v1 <= 8 &&
-                     face.v2 >= 4 && face.v2 <= 8 &&
-                     face.v3 >= 4 && face.v3 <= 8)
-            {
-                color = Vector3(0.4f, 0.7f, 0.4f); // Green pyramid
-            }
-            // Inverted pyramid (vertices 9-13): Blue
-            else if (face.v1 >= 9 && face.v2 >= 9 && face.v3 >= 9)
-            {
-                color = Vector3(0.4f, 0.5f, 0.8f); // Blue inverted pyramid
-            }
-            else
-            {
-                color = Vector3(0.7f, 0.7f, 0.7f); // Fallback gray
-            }
+    void loadModelIntoRenderer()
+    {
+        const auto &vertices = model.getVertices();
+        const auto &faces = model.getFaces();
 
-            renderer.addTriangle(Triangle(v0, v1, v2, color));
-        }
+        // Every connected part of the model (ground plane and pyramids in the default scene) becomes
+        // its own mesh and instance; vertex drags are patched into the renderer's copy afterwards
+        Scene scene;
+        scene.addConnectedParts(model, faceSceneTriangles);
+        renderer.setScene(scene); // Also drops the renderer's level of detail
+        lod.clear();
+        lastEditTime = std::chrono::steady_clock::now();
 
         // Load vertices for rendering
         std::vector<Vector3> vertexPositions;
+        vertexPositions.reserve(vertices.size() + 1);
         for (const auto &vertex : vertices)
         {
             vertexPositions.push_back(vertex.position);
@@ -275,19 +297,17 @@ public:
         // Add origin point for reference
         vertexPositions.push_back(coordinateAxes.getOriginPoint());
 
-        renderer.setVertices(vertexPositions);
+        renderer.setVertices(std::move(vertexPositions));
 
         // Load edges for rendering
         const auto &edges = model.getEdges();
         std::vector<Line> edgeLines;
+        edgeLines.reserve(edges.size());
         for (const auto &edge : edges)
         {
-            Vector3 start = vertices[edge.v1].position;
-            Vector3 end = vertices[edge.v2].position;
-            Vector3 edgeColor(0.9f, 0.9f, 0.9f); // Brighter gray for visibility
-            edgeLines.emplace_back(start, end, edgeColor, 1.0f);
+            edgeLines.push_back(makeEdgeLine(edge));
         }
-        renderer.setEdges(edgeLines);
+        renderer.setEdges(std::move(edgeLines));
 
         // Load coordinate axes
         renderer.setLines(coordinateAxes.getAxisLines());
@@ -296,16 +316,67 @@ public:
         Utils::logInfo("Vertices loaded: " + std::to_string(vertices.size()));
         Utils::logInfo("Edges loaded: " + std::to_string(edges.size()));
         Utils::logInfo("Coordinate axes loaded with " + std::to_string(coordinateAxes.getAxisLines().size()) + " lines");
+
+        model.clearChanges();
+    }
+
+    // Push model edits to the renderer: moved vertices patch only the triangles, edges and
+    // vertex markers that use them, anything else reloads the whole model
+    void syncModelChanges()
+    {
+        if (!model.hasChanges())
+            return;
+
+        // The levels of detail show the old shape until they are rebuilt
+        renderer.clearLod();
+        lastEditTime = std::chrono::steady_clock::now();
+
+        if (model.hasTopologyChanged())
+        {
+            loadModelIntoRenderer();
+            return;
+        }
+
+        const auto &vertices = model.getVertices();
+        const auto &faces = model.getFaces();
+        const auto &edges = model.getEdges();
+
+        for (int vertexIndex : model.getChangedVertices())
+        {
+            renderer.updateVertex(vertexIndex, vertices[vertexIndex].position);
+        }
+
+        model.getChangedFaces(changedIndices);
+        for (int faceIndex : changedIndices)
+        {
+            renderer.updateTriangle(faceSceneTriangles[faceIndex], makeFaceTriangle(faces[faceIndex]));
+        }
+
+        model.getChangedEdges(changedIndices);
+        for (int edgeIndex : changedIndices)
+        {
+            renderer.updateEdge(edgeIndex, makeEdgeLine(edges[edgeIndex]));
+        }
+
+        model.clearChanges();
     }
 
     void run()
     {
         while (!glfwWindowShouldClose(window))
         {
+            Profiler::beginFrame();
             updateTiming();
 
-            // Poll events
-            glfwPollEvents();
+            // Poll events (mouse picking runs in the input callbacks); after a frame with nothing
+            // to render, sleep until input arrives instead of spinning at the refresh rate
+            {
+                PROFILE_SCOPE("glfwPollEvents");
+                if (renderer.getLastFrameStats().skippedFrame && !renderer.isShowingLod())
+                    glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+                else
+                    glfwPollEvents();
+            }
 
             // Handle keyboard input
             handleKeyInput();
@@ -329,10 +400,16 @@ public:
             ui.endFrame();
 
             // Swap buffers
-            glfwSwapBuffers(window);
+            {
+                PROFILE_SCOPE("glfwSwapBuffers");
+                glfwSwapBuffers(window);
+            }
 
             // Show FPS
             updateFPS();
+
+            // Aggregate this frame's timers and counters for the profiler panel
+            Profiler::endFrame();
         }
     }
 
@@ -396,6 +473,14 @@ public:
 
     void render()
     {
+        // Pick up a finished background save, then apply model edits made since the last frame
+        saver.poll(model);
+        {
+            PROFILE_SCOPE("syncModelChanges");
+            syncModelChanges();
+        }
+        updateLevelOfDetail();
+
         // Update renderer camera from our camera
         renderer.setCamera(camera.getPosition(), camera.getTarget(), camera.getUpVector());
 
@@ -403,23 +488,31 @@ public:
         renderer.render();
     }
 
-    void displayFrame()
+    // Hand finished levels of detail to the renderer, and start a build for a large model once
+    // it has not been edited for a while
+    void updateLevelOfDetail()
     {
-        const auto &pixels = renderer.getPixelData();
+        if (lod.poll() && lod.isCurrent(model))
+        {
+            renderer.setLodMesh(*lod.selectLevel(LOD_FACE_BUDGET));
+        }
+        if (lod.isBuilding() || lod.isCurrent(model) || model.getFaceCount() < LOD_MIN_SOURCE_FACES)
+            return;
 
-        // Convert float RGB to unsigned char RGB
-        for (int i = 0; i < windowWidth * windowHeight; ++i)
+        const double idleSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - lastEditTime).count();
+        if (idleSeconds >= LOD_EDIT_IDLE_SECONDS)
         {
-            pixelBuffer[i * 3 + 0] = static_cast<unsigned char>(pixels[i].x * 255.0f);
-            pixelBuffer[i * 3 + 1] = static_cast<unsigned char>(pixels[i].y * 255.0f);
-            pixelBuffer[i * 3 + 2] = static_cast<unsigned char>(pixels[i].z * 255.0f);
+            lod.start(model, LOD_MIN_FACES);
         }
+    }
 
-        // Display using OpenGL
+    void displayFrame()
+    {
+        PROFILE_SCOPE("displayFrame");
+
+        // The renderer already packed the frame to RGBA8 while rendering its tiles
         glClear(GL_COLOR_BUFFER_BIT);
-        glRasterPos2f(-1, -1);
-        glPixelZoom(1, 1);
-        glDrawPixels(windowWidth, windowHeight, GL_RGB, GL_UNSIGNED_BYTE, pixelBuffer.data());
+        presenter.present(renderer.getDisplayPixels().data(), windowWidth, windowHeight);
     }
 
     void printModelInfo()
@@ -482,9 +575,18 @@ public:
 
     void cleanup()
     {
+        // Let a running save finish writing the file
+        saver.wait(model);
+
         // Shutdown UI
         ui.shutdown();
 
+        // Release GL objects while the context still exists
+        if (window)
+        {
+            presenter.shutdown();
+        }
+
         if (inputHandler)
         {
             delete inputHandler;
@@ -547,9 +649,6 @@ public:
         // Update renderer resolution
         renderer.setResolution(width, height);
 
-        // Resize pixel buffer
-        pixelBuffer.resize(width * height * 3);
-
         // Update UI window size
         ui.setWindowSize(width, height);
 
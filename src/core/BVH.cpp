@@ -0,0 +1,691 @@
+#include "BVH.h"
+#include "../math/SimdFloat.h"
+#include "../utils/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+void AABB::expand(const Vector3 &point)
+{
+    min = Vector3(std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z));
+    max = Vector3(std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z));
+}
+
+void AABB::expand(const AABB &other)
+{
+    // Component-wise union, so merging an empty box is a no-op
+    min = Vector3(std::min(min.x, other.min.x), std::min(min.y, other.min.y), std::min(min.z, other.min.z));
+    max = Vector3(std::max(max.x, other.max.x), std::max(max.y, other.max.y), std::max(max.z, other.max.z));
+}
+
+float AABB::surfaceArea() const
+{
+    if (!isValid())
+        return 0.0f;
+
+    Vector3 extent = max - min;
+    return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+namespace
+{
+    float axisValue(const Vector3 &v, int axis)
+    {
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+}
+
+void BVH::clear()
+{
+    nodes.clear();
+    orderedTriangles.clear();
+    triangleIndices.clear();
+    trianglePositions.clear();
+    positionLeaves.clear();
+    parents.clear();
+    builtSurfaceArea = 0.0;
+    currentSurfaceArea = 0.0;
+}
+
+void BVH::build(const std::vector<Triangle> &triangles)
+{
+    clear();
+
+    const int triangleCount = static_cast<int>(triangles.size());
+    if (triangleCount == 0)
+        return;
+
+    // Per-triangle bounds and centroids used by the SAH binning
+    std::vector<AABB> triangleBounds(triangleCount);
+    std::vector<Vector3> centroids(triangleCount);
+    triangleIndices.resize(triangleCount);
+
+    for (int i = 0; i < triangleCount; ++i)
+    {
+        const Triangle &triangle = triangles[i];
+        triangleBounds[i].expand(triangle.v0);
+        triangleBounds[i].expand(triangle.v1);
+        triangleBounds[i].expand(triangle.v2);
+        centroids[i] = (triangle.v0 + triangle.v1 + triangle.v2) * (1.0f / 3.0f);
+        triangleIndices[i] = i;
+    }
+
+    // A binary tree over N leaves never needs more than 2N - 1 nodes
+    nodes.reserve(2 * triangleCount);
+
+    BVHNode root;
+    root.leftFirst = 0;
+    root.triangleCount = triangleCount;
+    nodes.push_back(root);
+    updateNodeBounds(0, triangleBounds);
+
+    // Iterative top-down build; depth is tracked so traversal stacks never overflow
+    struct BuildEntry
+    {
+        int nodeIndex;
+        int depth;
+    };
+    std::vector<BuildEntry> buildStack;
+    buildStack.push_back({0, 0});
+
+    while (!buildStack.empty())
+    {
+        BuildEntry entry = buildStack.back();
+        buildStack.pop_back();
+
+        if (entry.depth >= MAX_STACK_DEPTH - 2)
+            continue; // Keep as leaf
+
+        if (splitNode(entry.nodeIndex, triangleBounds, centroids))
+        {
+            int leftChild = nodes[entry.nodeIndex].leftFirst;
+            buildStack.push_back({leftChild, entry.depth + 1});
+            buildStack.push_back({leftChild + 1, entry.depth + 1});
+        }
+    }
+
+    // Precompute intersection data in leaf order so leaf ranges are contiguous in memory
+    orderedTriangles.resize(triangleCount);
+    for (int i = 0; i < triangleCount; ++i)
+    {
+        orderedTriangles[i] = TriangleIntersectionData(triangles[triangleIndices[i]]);
+    }
+
+    // Links used by refit(): children are always stored after their parent
+    const int nodeCount = static_cast<int>(nodes.size());
+    parents.assign(nodeCount, -1);
+    positionLeaves.resize(triangleCount);
+    trianglePositions.resize(triangleCount);
+    for (int i = 0; i < nodeCount; ++i)
+    {
+        const BVHNode &node = nodes[i];
+        if (node.isLeaf())
+        {
+            for (int k = 0; k < node.triangleCount; ++k)
+            {
+                positionLeaves[node.leftFirst + k] = i;
+                trianglePositions[triangleIndices[node.leftFirst + k]] = node.leftFirst + k;
+            }
+        }
+        else
+        {
+            parents[node.leftFirst] = i;
+            parents[node.leftFirst + 1] = i;
+        }
+    }
+
+    builtSurfaceArea = 0.0;
+    for (const BVHNode &node : nodes)
+    {
+        AABB bounds;
+        bounds.min = node.boundsMin;
+        bounds.max = node.boundsMax;
+        builtSurfaceArea += bounds.surfaceArea();
+    }
+    currentSurfaceArea = builtSurfaceArea;
+}
+
+void BVH::refit(const std::vector<Triangle> &triangles, const std::vector<int> &changedTriangles)
+{
+    const int triangleCount = static_cast<int>(orderedTriangles.size());
+    if (static_cast<int>(triangles.size()) != triangleCount)
+    {
+        build(triangles); // Triangle list changed size, refitting is not possible
+        return;
+    }
+
+    for (int triangleIndex : changedTriangles)
+    {
+        if (triangleIndex < 0 || triangleIndex >= triangleCount)
+            continue;
+
+        int position = trianglePositions[triangleIndex];
+        orderedTriangles[position] = TriangleIntersectionData(triangles[triangleIndex]);
+
+        // Recompute the leaf from its triangles, then walk up until a node's bounds stop changing
+        int nodeIndex = positionLeaves[position];
+        const BVHNode &leaf = nodes[nodeIndex];
+        AABB bounds;
+        for (int i = 0; i < leaf.triangleCount; ++i)
+        {
+            const Triangle &triangle = triangles[triangleIndices[leaf.leftFirst + i]];
+            bounds.expand(triangle.v0);
+            bounds.expand(triangle.v1);
+            bounds.expand(triangle.v2);
+        }
+
+        while (setRefitBounds(nodeIndex, bounds))
+        {
+            nodeIndex = parents[nodeIndex];
+            if (nodeIndex < 0)
+                break;
+
+            const BVHNode &left = nodes[nodes[nodeIndex].leftFirst];
+            const BVHNode &right = nodes[nodes[nodeIndex].leftFirst + 1];
+            bounds = AABB();
+            bounds.expand(left.boundsMin);
+            bounds.expand(left.boundsMax);
+            bounds.expand(right.boundsMin);
+            bounds.expand(right.boundsMax);
+        }
+    }
+}
+
+bool BVH::setRefitBounds(int nodeIndex, const AABB &bounds)
+{
+    BVHNode &node = nodes[nodeIndex];
+    if (node.boundsMin == bounds.min && node.boundsMax == bounds.max)
+        return false;
+
+    AABB previous;
+    previous.min = node.boundsMin;
+    previous.max = node.boundsMax;
+    currentSurfaceArea += bounds.surfaceArea() - previous.surfaceArea();
+
+    node.boundsMin = bounds.min;
+    node.boundsMax = bounds.max;
+    return true;
+}
+
+void BVH::updateNodeBounds(int nodeIndex, const std::vector<AABB> &triangleBounds)
+{
+    BVHNode &node = nodes[nodeIndex];
+    AABB bounds;
+    for (int i = 0; i < node.triangleCount; ++i)
+    {
+        bounds.expand(triangleBounds[triangleIndices[node.leftFirst + i]]);
+    }
+    node.boundsMin = bounds.min;
+    node.boundsMax = bounds.max;
+}
+
+float BVH::findBestSplit(const BVHNode &node, const std::vector<AABB> &triangleBounds,
+                         const std::vector<Vector3> &centroids, int &bestAxis, float &bestSplitPosition) const
+{
+    float bestCost = std::numeric_limits<float>::max();
+    bestAxis = -1;
+
+    // Bin over the centroid bounds rather than the node bounds for better separation
+    AABB centroidBounds;
+    for (int i = 0; i < node.triangleCount; ++i)
+    {
+        centroidBounds.expand(centroids[triangleIndices[node.leftFirst + i]]);
+    }
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float boundsMin = axisValue(centroidBounds.min, axis);
+        float boundsMax = axisValue(centroidBounds.max, axis);
+        if (boundsMax - boundsMin < 1e-6f)
+            continue; // All centroids on one plane along this axis
+
+        struct Bin
+        {
+            AABB bounds;
+            int count = 0;
+        };
+        Bin bins[SAH_BIN_COUNT];
+
+        float scale = SAH_BIN_COUNT / (boundsMax - boundsMin);
+        for (int i = 0; i < node.triangleCount; ++i)
+        {
+            int triangleIndex = triangleIndices[node.leftFirst + i];
+            int binIndex = std::min(SAH_BIN_COUNT - 1,
+                                    static_cast<int>((axisValue(centroids[triangleIndex], axis) - boundsMin) * scale));
+            bins[binIndex].count++;
+            bins[binIndex].bounds.expand(triangleBounds[triangleIndex]);
+        }
+
+        // Sweep from both sides to get the area/count of every split plane
+        float leftArea[SAH_BIN_COUNT - 1], rightArea[SAH_BIN_COUNT - 1];
+        int leftCount[SAH_BIN_COUNT - 1], rightCount[SAH_BIN_COUNT - 1];
+        AABB leftBox, rightBox;
+        int leftSum = 0, rightSum = 0;
+        for (int i = 0; i < SAH_BIN_COUNT - 1; ++i)
+        {
+            leftSum += bins[i].count;
+            leftCount[i] = leftSum;
+            leftBox.expand(bins[i].bounds);
+            leftArea[i] = leftBox.surfaceArea();
+
+            rightSum += bins[SAH_BIN_COUNT - 1 - i].count;
+            rightCount[SAH_BIN_COUNT - 2 - i] = rightSum;
+            rightBox.expand(bins[SAH_BIN_COUNT - 1 - i].bounds);
+            rightArea[SAH_BIN_COUNT - 2 - i] = rightBox.surfaceArea();
+        }
+
+        float binWidth = (boundsMax - boundsMin) / SAH_BIN_COUNT;
+        for (int i = 0; i < SAH_BIN_COUNT - 1; ++i)
+        {
+            if (leftCount[i] == 0 || rightCount[i] == 0)
+                continue;
+
+            float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplitPosition = boundsMin + binWidth * (i + 1);
+            }
+        }
+    }
+
+    return bestCost;
+}
+
+bool BVH::splitNode(int nodeIndex, const std::vector<AABB> &triangleBounds, const std::vector<Vector3> &centroids)
+{
+    BVHNode node = nodes[nodeIndex];
+    if (node.triangleCount <= MAX_LEAF_SIZE)
+        return false;
+
+    int axis;
+    float splitPosition;
+    float splitCost = findBestSplit(node, triangleBounds, centroids, axis, splitPosition);
+    if (axis < 0)
+        return false; // Degenerate centroids, cannot split
+
+    // Compare against the cost of leaving all triangles in this leaf
+    AABB nodeBounds;
+    nodeBounds.min = node.boundsMin;
+    nodeBounds.max = node.boundsMax;
+    float leafCost = node.triangleCount * nodeBounds.surfaceArea();
+    if (splitCost >= leafCost)
+        return false;
+
+    // Partition the triangle range around the split plane
+    int *first = triangleIndices.data() + node.leftFirst;
+    int *last = first + node.triangleCount;
+    int *middle = std::partition(first, last, [&](int triangleIndex)
+                                 { return axisValue(centroids[triangleIndex], axis) < splitPosition; });
+
+    int leftCount = static_cast<int>(middle - first);
+    if (leftCount == 0 || leftCount == node.triangleCount)
+        return false;
+
+    int leftChild = static_cast<int>(nodes.size());
+
+    BVHNode left;
+    left.leftFirst = node.leftFirst;
+    left.triangleCount = leftCount;
+    nodes.push_back(left);
+
+    BVHNode right;
+    right.leftFirst = node.leftFirst + leftCount;
+    right.triangleCount = node.triangleCount - leftCount;
+    nodes.push_back(right);
+
+    nodes[nodeIndex].leftFirst = leftChild;
+    nodes[nodeIndex].triangleCount = 0;
+
+    updateNodeBounds(leftChild, triangleBounds);
+    updateNodeBounds(leftChild + 1, triangleBounds);
+    return true;
+}
+
+float BVH::intersectBounds(const BVHNode &node, const Ray &ray, const Vector3 &invDirection, float tMin, float tMax)
+{
+    float tx1 = (node.boundsMin.x - ray.origin.x) * invDirection.x;
+    float tx2 = (node.boundsMax.x - ray.origin.x) * invDirection.x;
+    float tNear = std::min(tx1, tx2);
+    float tFar = std::max(tx1, tx2);
+
+    float ty1 = (node.boundsMin.y - ray.origin.y) * invDirection.y;
+    float ty2 = (node.boundsMax.y - ray.origin.y) * invDirection.y;
+    tNear = std::max(tNear, std::min(ty1, ty2));
+    tFar = std::min(tFar, std::max(ty1, ty2));
+
+    float tz1 = (node.boundsMin.z - ray.origin.z) * invDirection.z;
+    float tz2 = (node.boundsMax.z - ray.origin.z) * invDirection.z;
+    tNear = std::max(tNear, std::min(tz1, tz2));
+    tFar = std::min(tFar, std::max(tz1, tz2));
+
+    if (tFar >= tNear && tFar > tMin && tNear < tMax)
+    {
+        return tNear;
+    }
+    return std::numeric_limits<float>::infinity();
+}
+
+bool BVH::intersect(const Ray &ray, float tMin, float tMax, BVHHit &result) const
+{
+    if (nodes.empty())
+        return false;
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    Vector3 invDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+    if (intersectBounds(nodes[0], ray, invDirection, tMin, tMax) == infinity)
+        return false;
+
+    struct StackEntry
+    {
+        int nodeIndex;
+        float entryDistance;
+    };
+    StackEntry stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+
+    float closestDistance = tMax;
+    bool hitFound = false;
+    int nodeIndex = 0;
+    int nodesVisited = 0;
+    int triangleTests = 0;
+
+    while (true)
+    {
+        const BVHNode &node = nodes[nodeIndex];
+        nodesVisited++;
+
+        if (node.isLeaf())
+        {
+            triangleTests += node.triangleCount;
+            for (int i = 0; i < node.triangleCount; ++i)
+            {
+                TriangleHit hit = RayIntersection::intersectTriangle(ray, orderedTriangles[node.leftFirst + i]);
+
+                if (hit.hit && hit.distance < closestDistance && hit.distance > tMin)
+                {
+                    closestDistance = hit.distance;
+                    result.hit = hit;
+                    result.triangleIndex = triangleIndices[node.leftFirst + i];
+                    hitFound = true;
+                }
+            }
+        }
+        else
+        {
+            // Visit the nearer child first, defer the farther one
+            int nearChild = node.leftFirst;
+            int farChild = node.leftFirst + 1;
+            float nearDistance = intersectBounds(nodes[nearChild], ray, invDirection, tMin, closestDistance);
+            float farDistance = intersectBounds(nodes[farChild], ray, invDirection, tMin, closestDistance);
+
+            if (farDistance < nearDistance)
+            {
+                std::swap(nearChild, farChild);
+                std::swap(nearDistance, farDistance);
+            }
+
+            if (nearDistance != infinity)
+            {
+                if (farDistance != infinity)
+                {
+                    stack[stackSize++] = {farChild, farDistance};
+                }
+                nodeIndex = nearChild;
+                continue;
+            }
+        }
+
+        // Pop the next node that can still contain a closer hit (early-out)
+        bool found = false;
+        while (stackSize > 0)
+        {
+            StackEntry entry = stack[--stackSize];
+            if (entry.entryDistance < closestDistance)
+            {
+                nodeIndex = entry.nodeIndex;
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            break;
+    }
+
+    PROFILE_COUNT(BVHNodesVisited, nodesVisited);
+    PROFILE_COUNT(TriangleTests, triangleTests);
+    return hitFound;
+}
+
+void BVH::collectInFrustum(const Frustum &frustum, std::vector<int> &result) const
+{
+    if (nodes.empty())
+        return;
+
+    // Stack entries carry whether the subtree is already known to be inside
+    std::pair<int, bool> stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = {0, false};
+    int nodesVisited = 0;
+
+    while (stackSize > 0)
+    {
+        const std::pair<int, bool> entry = stack[--stackSize];
+        const BVHNode &node = nodes[entry.first];
+        nodesVisited++;
+
+        bool inside = entry.second;
+        if (!inside)
+        {
+            const Frustum::Containment containment = frustum.classifyBox(node.boundsMin, node.boundsMax);
+            if (containment == Frustum::Containment::Outside)
+                continue;
+            inside = containment == Frustum::Containment::Inside;
+        }
+
+        if (node.isLeaf())
+        {
+            result.insert(result.end(), triangleIndices.begin() + node.leftFirst,
+                          triangleIndices.begin() + node.leftFirst + node.triangleCount);
+        }
+        else
+        {
+            stack[stackSize++] = {node.leftFirst + 1, inside};
+            stack[stackSize++] = {node.leftFirst, inside};
+        }
+    }
+
+    PROFILE_COUNT(BVHNodesVisited, nodesVisited);
+}
+
+bool BVH::intersectAny(const Ray &ray, float tMin, float tMax) const
+{
+    if (nodes.empty())
+        return false;
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    Vector3 invDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+    int stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    int nodesVisited = 0;
+    int triangleTests = 0;
+    bool occluded = false;
+
+    while (stackSize > 0 && !occluded)
+    {
+        const BVHNode &node = nodes[stack[--stackSize]];
+        nodesVisited++;
+
+        if (intersectBounds(node, ray, invDirection, tMin, tMax) == infinity)
+            continue;
+
+        if (node.isLeaf())
+        {
+            for (int i = 0; i < node.triangleCount; ++i)
+            {
+                triangleTests++;
+                TriangleHit hit = RayIntersection::intersectTriangle(ray, orderedTriangles[node.leftFirst + i]);
+
+                if (hit.hit && hit.distance < tMax && hit.distance > tMin)
+                {
+                    occluded = true;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            stack[stackSize++] = node.leftFirst + 1;
+            stack[stackSize++] = node.leftFirst;
+        }
+    }
+
+    PROFILE_COUNT(BVHNodesVisited, nodesVisited);
+    PROFILE_COUNT(TriangleTests, triangleTests);
+    return occluded;
+}
+
+int BVH::intersectPacket(const RayPacket &packet, BVHHit results[RAY_PACKET_WIDTH]) const
+{
+    if (nodes.empty() || packet.activeMask == 0)
+        return 0;
+
+    const SimdMask8 activeLanes = SimdMask8::fromBits(packet.activeMask);
+    const SimdFloat8 originX = SimdFloat8::load(packet.originX);
+    const SimdFloat8 originY = SimdFloat8::load(packet.originY);
+    const SimdFloat8 originZ = SimdFloat8::load(packet.originZ);
+    const SimdFloat8 directionX = SimdFloat8::load(packet.directionX);
+    const SimdFloat8 directionY = SimdFloat8::load(packet.directionY);
+    const SimdFloat8 directionZ = SimdFloat8::load(packet.directionZ);
+    const SimdFloat8 invDirectionX = SimdFloat8::load(packet.inverseDirectionX);
+    const SimdFloat8 invDirectionY = SimdFloat8::load(packet.inverseDirectionY);
+    const SimdFloat8 invDirectionZ = SimdFloat8::load(packet.inverseDirectionZ);
+    const SimdFloat8 tMin = SimdFloat8::broadcast(packet.tMin);
+    const SimdFloat8 zero = SimdFloat8::broadcast(0.0f);
+    const SimdFloat8 parallelEpsilon = SimdFloat8::broadcast(1e-6f);
+
+    SimdFloat8 closestDistance = SimdFloat8::load(packet.tMax);
+    int closestTriangle[RAY_PACKET_WIDTH]; // Leaf-order index per lane
+    for (int lane = 0; lane < RAY_PACKET_WIDTH; ++lane)
+    {
+        closestTriangle[lane] = -1;
+    }
+
+    // Near-child order is decided once per packet from the first active ray (primary rays are coherent)
+    int leadLane = 0;
+    while (!(packet.activeMask & (1 << leadLane)))
+        ++leadLane;
+    const Vector3 leadDirection(packet.directionX[leadLane], packet.directionY[leadLane], packet.directionZ[leadLane]);
+
+    int stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    int nodesVisited = 0;
+    int triangleTests = 0;
+
+    while (stackSize > 0)
+    {
+        const BVHNode &node = nodes[stack[--stackSize]];
+        nodesVisited++;
+
+        // Same slab test as intersectBounds, for all lanes at once
+        SimdFloat8 tx1 = (SimdFloat8::broadcast(node.boundsMin.x) - originX) * invDirectionX;
+        SimdFloat8 tx2 = (SimdFloat8::broadcast(node.boundsMax.x) - originX) * invDirectionX;
+        SimdFloat8 tNear = SimdFloat8::min(tx1, tx2);
+        SimdFloat8 tFar = SimdFloat8::max(tx1, tx2);
+
+        SimdFloat8 ty1 = (SimdFloat8::broadcast(node.boundsMin.y) - originY) * invDirectionY;
+        SimdFloat8 ty2 = (SimdFloat8::broadcast(node.boundsMax.y) - originY) * invDirectionY;
+        tNear = SimdFloat8::max(tNear, SimdFloat8::min(ty1, ty2));
+        tFar = SimdFloat8::min(tFar, SimdFloat8::max(ty1, ty2));
+
+        SimdFloat8 tz1 = (SimdFloat8::broadcast(node.boundsMin.z) - originZ) * invDirectionZ;
+        SimdFloat8 tz2 = (SimdFloat8::broadcast(node.boundsMax.z) - originZ) * invDirectionZ;
+        tNear = SimdFloat8::max(tNear, SimdFloat8::min(tz1, tz2));
+        tFar = SimdFloat8::min(tFar, SimdFloat8::max(tz1, tz2));
+
+        SimdMask8 nodeHit = activeLanes & (tFar >= tNear) & (tFar > tMin) & (tNear < closestDistance);
+        if (!nodeHit.any())
+            continue;
+
+        if (node.isLeaf())
+        {
+            triangleTests += node.triangleCount;
+            for (int i = 0; i < node.triangleCount; ++i)
+            {
+                const TriangleIntersectionData &triangle = orderedTriangles[node.leftFirst + i];
+
+                // Same operations in the same order as RayIntersection::intersectTriangle
+                SimdFloat8 normalX = SimdFloat8::broadcast(triangle.normal.x);
+                SimdFloat8 normalY = SimdFloat8::broadcast(triangle.normal.y);
+                SimdFloat8 normalZ = SimdFloat8::broadcast(triangle.normal.z);
+
+                SimdFloat8 denom = normalX * directionX + normalY * directionY + normalZ * directionZ;
+                SimdMask8 rejected = SimdFloat8::abs(denom) < parallelEpsilon;
+
+                SimdFloat8 t = (SimdFloat8::broadcast(triangle.planeOffset) -
+                                (normalX * originX + normalY * originY + normalZ * originZ)) /
+                               denom;
+                rejected = rejected | (t < zero);
+
+                SimdFloat8 pointX = originX + directionX * t;
+                SimdFloat8 pointY = originY + directionY * t;
+                SimdFloat8 pointZ = originZ + directionZ * t;
+
+                rejected = rejected |
+                           ((SimdFloat8::broadcast(triangle.edgePlane0.x) * pointX +
+                             SimdFloat8::broadcast(triangle.edgePlane0.y) * pointY +
+                             SimdFloat8::broadcast(triangle.edgePlane0.z) * pointZ) < SimdFloat8::broadcast(triangle.edgeOffset0)) |
+                           ((SimdFloat8::broadcast(triangle.edgePlane1.x) * pointX +
+                             SimdFloat8::broadcast(triangle.edgePlane1.y) * pointY +
+                             SimdFloat8::broadcast(triangle.edgePlane1.z) * pointZ) < SimdFloat8::broadcast(triangle.edgeOffset1)) |
+                           ((SimdFloat8::broadcast(triangle.edgePlane2.x) * pointX +
+                             SimdFloat8::broadcast(triangle.edgePlane2.y) * pointY +
+                             SimdFloat8::broadcast(triangle.edgePlane2.z) * pointZ) < SimdFloat8::broadcast(triangle.edgeOffset2));
+
+                // Rejections are OR-ed and removed with andNot so NaN lanes behave like the scalar early-outs
+                SimdMask8 accepted = nodeHit.andNot(rejected) & (t < closestDistance) & (t > tMin);
+                int acceptedBits = accepted.bits();
+                if (acceptedBits == 0)
+                    continue;
+
+                closestDistance = SimdFloat8::select(accepted, t, closestDistance);
+                for (int lane = 0; lane < RAY_PACKET_WIDTH; ++lane)
+                {
+                    if (acceptedBits & (1 << lane))
+                        closestTriangle[lane] = node.leftFirst + i;
+                }
+            }
+        }
+        else
+        {
+            // Push the farther child first so the nearer one is visited next
+            const BVHNode &left = nodes[node.leftFirst];
+            const BVHNode &right = nodes[node.leftFirst + 1];
+            Vector3 childOffset = (right.boundsMin + right.boundsMax) - (left.boundsMin + left.boundsMax);
+            bool leftFirst = Vector3::dot(childOffset, leadDirection) >= 0.0f;
+
+            stack[stackSize++] = leftFirst ? node.leftFirst + 1 : node.leftFirst;
+            stack[stackSize++] = leftFirst ? node.leftFirst : node.leftFirst + 1;
+        }
+    }
+
+    // Fill full hit records with the scalar kernel so point/normal are identical to intersect()
+    int hitMask = 0;
+    for (int lane = 0; lane < RAY_PACKET_WIDTH; ++lane)
+    {
+        if (closestTriangle[lane] < 0)
+            continue;
+
+        results[lane].hit = RayIntersection::intersectTriangle(packet.getRay(lane), orderedTriangles[closestTriangle[lane]]);
+        results[lane].triangleIndex = triangleIndices[closestTriangle[lane]];
+        hitMask |= 1 << lane;
+    }
+
+    PROFILE_COUNT(BVHNodesVisited, nodesVisited);
+    PROFILE_COUNT(TriangleTests, triangleTests);
+    return hitMask;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Ray.h"
+#include "RayPacket.h"
+#include "Frustum.h"
+#include "../math/Vector3.h"
+#include <vector>
+#include <limits>
+
+// Axis-aligned bounding box
+struct AABB
+{
+    Vector3 min = Vector3(std::numeric_limits<float>::max());
+    Vector3 max = Vector3(-std::numeric_limits<float>::max());
+
+    void expand(const Vector3 &point);
+    void expand(const AABB &other);
+    float surfaceArea() const;
+    Vector3 centroid() const { return (min + max) * 0.5f; }
+    bool isValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+};
+
+// Flattened BVH node (32 bytes)
+// Interior nodes: leftFirst is the index of the left child, the right child is leftFirst + 1
+// Leaf nodes: leftFirst is the first entry of the node's triangle range
+struct BVHNode
+{
+    Vector3 boundsMin;
+    int leftFirst = 0;
+    Vector3 boundsMax;
+    int triangleCount = 0; // 0 for interior nodes
+
+    bool isLeaf() const { return triangleCount > 0; }
+};
+
+// Closest-hit query result
+struct BVHHit
+{
+    int triangleIndex = -1; // Index into the triangle list passed to build()
+    int instanceIndex = -1; // Set by InstanceBVH queries
+    TriangleHit hit;
+};
+
+// Bounding volume hierarchy over a triangle list (binned SAH build)
+class BVH
+{
+private:
+    std::vector<BVHNode> nodes;
+    std::vector<TriangleIntersectionData> orderedTriangles; // Precomputed triangles in leaf order
+    std::vector<int> triangleIndices;                       // Leaf order -> original triangle index
+
+    // Refit support
+    std::vector<int> trianglePositions; // Original triangle index -> leaf order position
+    std::vector<int> positionLeaves;    // Leaf order position -> leaf node
+    std::vector<int> parents;           // Node -> parent node (-1 for the root)
+    double builtSurfaceArea = 0.0;      // Summed node surface area after build()
+    double currentSurfaceArea = 0.0;    // Same sum after the latest refits
+
+    // Build parameters
+    static constexpr int SAH_BIN_COUNT = 12;
+    static constexpr int MAX_LEAF_SIZE = 4;
+    static constexpr int MAX_STACK_DEPTH = 64;
+
+public:
+    BVH() = default;
+    ~BVH() = default;
+
+    // Build from scratch over the given triangles
+    void build(const std::vector<Triangle> &triangles);
+    void clear();
+
+    // Update the listed triangles (indices into the build() list) in place and refit the bounds
+    // above them; the tree topology is kept, so queries stay exact but get slower as edits pile up
+    void refit(const std::vector<Triangle> &triangles, const std::vector<int> &changedTriangles);
+
+    // Summed node surface area relative to the last build (1 = as built), a cheap SAH quality estimate
+    float getRefitGrowth() const { return builtSurfaceArea > 0.0 ? static_cast<float>(currentSurfaceArea / builtSurfaceArea) : 1.0f; }
+
+    // Closest hit with distance in (tMin, tMax)
+    bool intersect(const Ray &ray, float tMin, float tMax, BVHHit &result) const;
+
+    // Any hit with distance in (tMin, tMax) - stops at the first hit found (shadow/occlusion queries)
+    bool intersectAny(const Ray &ray, float tMin, float tMax) const;
+
+    // Closest hit for every active lane of a packet, distance in (packet.tMin, packet.tMax[lane]).
+    // Returns the mask of lanes that hit; results match intersect() lane by lane.
+    int intersectPacket(const RayPacket &packet, BVHHit results[RAY_PACKET_WIDTH]) const;
+
+    // Append the triangles (indices into the build() list) of every leaf whose bounds touch the
+    // frustum; subtrees fully inside are taken without further plane tests
+    void collectInFrustum(const Frustum &frustum, std::vector<int> &result) const;
+
+    // Info
+    bool isEmpty() const { return orderedTriangles.empty(); }
+    int getTriangleCount() const { return static_cast<int>(orderedTriangles.size()); }
+    int getNodeCount() const { return static_cast<int>(nodes.size()); }
+    const std::vector<BVHNode> &getNodes() const { return nodes; }
+
+private:
+    void updateNodeBounds(int nodeIndex, const std::vector<AABB> &triangleBounds);
+    bool setRefitBounds(int nodeIndex, const AABB &bounds);
+    bool splitNode(int nodeIndex, const std::vector<AABB> &triangleBounds, const std::vector<Vector3> &centroids);
+    float findBestSplit(const BVHNode &node, const std::vector<AABB> &triangleBounds,
+                        const std::vector<Vector3> &centroids, int &bestAxis, float &bestSplitPosition) const;
+
+    // Slab test, returns entry distance or +inf on miss
+    static float intersectBounds(const BVHNode &node, const Ray &ray, const Vector3 &invDirection, float tMin, float tMax);
+};
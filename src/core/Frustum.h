@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../math/Matrix4.h"
+#include "../math/Vector3.h"
+#include <algorithm>
+
+// Pyramid of camera rays (four side planes and a near plane, no far plane), with inward
+// normals. Used to cull bounding boxes before per-frame triangle processing.
+class Frustum
+{
+public:
+    enum class Containment
+    {
+        Outside,
+        Intersecting,
+        Inside
+    };
+
+private:
+    static constexpr int PLANE_COUNT = 5;
+
+    Vector3 normals[PLANE_COUNT];
+    float offsets[PLANE_COUNT] = {}; // Point p is inside plane i when dot(normals[i], p) >= offsets[i]
+
+public:
+    // Rays from origin through the four corner directions (in order around the image), clipped
+    // at forward distance nearDistance
+    static Frustum fromCorners(const Vector3 &origin, const Vector3 &forward, const Vector3 corners[4], float nearDistance)
+    {
+        Frustum frustum;
+        for (int i = 0; i < 4; ++i)
+        {
+            Vector3 normal = Vector3::cross(corners[i], corners[(i + 1) % 4]).normalized();
+            if (Vector3::dot(normal, forward) < 0.0f)
+                normal = -normal; // Either winding of the corners works
+            frustum.normals[i] = normal;
+            frustum.offsets[i] = Vector3::dot(normal, origin);
+        }
+        frustum.normals[4] = forward;
+        frustum.offsets[4] = Vector3::dot(forward, origin) + nearDistance;
+        return frustum;
+    }
+
+    // The same frustum in the object space of an affine object-to-world transform:
+    // dot(n, A * p + t) >= d  <=>  dot(transpose(A) * n, p) >= d - dot(n, t)
+    Frustum toObjectSpace(const Matrix4 &objectToWorld) const
+    {
+        Frustum frustum;
+        const Vector3 translation = objectToWorld.getTranslation();
+        for (int i = 0; i < PLANE_COUNT; ++i)
+        {
+            const Vector3 &n = normals[i];
+            frustum.normals[i] = Vector3(objectToWorld(0, 0) * n.x + objectToWorld(1, 0) * n.y + objectToWorld(2, 0) * n.z,
+                                         objectToWorld(0, 1) * n.x + objectToWorld(1, 1) * n.y + objectToWorld(2, 1) * n.z,
+                                         objectToWorld(0, 2) * n.x + objectToWorld(1, 2) * n.y + objectToWorld(2, 2) * n.z);
+            frustum.offsets[i] = offsets[i] - Vector3::dot(n, translation);
+        }
+        return frustum;
+    }
+
+    // Conservative: boxes reported Intersecting may still lie just outside a frustum corner
+    Containment classifyBox(const Vector3 &boxMin, const Vector3 &boxMax) const
+    {
+        Containment result = Containment::Inside;
+        for (int i = 0; i < PLANE_COUNT; ++i)
+        {
+            const Vector3 &n = normals[i];
+            // Box corners furthest along and against the plane normal
+            const Vector3 positive(n.x >= 0.0f ? boxMax.x : boxMin.x, n.y >= 0.0f ? boxMax.y : boxMin.y,
+                                   n.z >= 0.0f ? boxMax.z : boxMin.z);
+            if (Vector3::dot(n, positive) < offsets[i])
+                return Containment::Outside;
+
+            const Vector3 negative(n.x >= 0.0f ? boxMin.x : boxMax.x, n.y >= 0.0f ? boxMin.y : boxMax.y,
+                                   n.z >= 0.0f ? boxMin.z : boxMax.z);
+            if (Vector3::dot(n, negative) < offsets[i])
+                result = Containment::Intersecting;
+        }
+        return result;
+    }
+};
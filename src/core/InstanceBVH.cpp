@@ -0,0 +1,455 @@
+#include "InstanceBVH.h"
+#include "../utils/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    bool isIdentity(const Matrix4 &matrix)
+    {
+        const Matrix4 identity = Matrix4::identity();
+        for (int i = 0; i < 16; ++i)
+        {
+            if (matrix[i] != identity[i])
+                return false;
+        }
+        return true;
+    }
+
+    float axisValue(const Vector3 &v, int axis)
+    {
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+}
+
+void InstanceBVH::clear()
+{
+    meshes.clear();
+    instances.clear();
+    nodes.clear();
+    instanceOrder.clear();
+    triangleCount = 0;
+}
+
+void InstanceBVH::setMeshCount(int count)
+{
+    meshes.resize(count);
+}
+
+void InstanceBVH::buildMesh(int mesh, const std::vector<Triangle> &triangles)
+{
+    meshes[mesh].build(triangles);
+}
+
+void InstanceBVH::refitMesh(int mesh, const std::vector<Triangle> &triangles, const std::vector<int> &changedTriangles)
+{
+    meshes[mesh].refit(triangles, changedTriangles);
+}
+
+void InstanceBVH::setInstances(const std::vector<Instance> &instanceList)
+{
+    instances.resize(instanceList.size());
+    instanceOrder.clear();
+    triangleCount = 0;
+
+    for (size_t i = 0; i < instanceList.size(); ++i)
+    {
+        const Instance &source = instanceList[i];
+        PlacedInstance &placed = instances[i];
+        placed.mesh = source.mesh;
+        placed.firstTriangle = triangleCount;
+        placed.identity = isIdentity(source.transform);
+        placed.objectToWorld = source.transform;
+        placed.worldToObject = placed.identity ? Matrix4::identity() : source.transform.inverse();
+        placed.normalToWorld = placed.worldToObject.transposed();
+        placed.bounds = AABB();
+
+        if (source.mesh < 0 || source.mesh >= static_cast<int>(meshes.size()))
+            continue; // Unknown mesh: places nothing
+        const BVH &mesh = meshes[source.mesh];
+        triangleCount += mesh.getTriangleCount();
+        if (mesh.isEmpty())
+            continue;
+
+        // World bounds from the eight corners of the mesh's root box
+        const BVHNode &root = mesh.getNodes()[0];
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const Vector3 point((corner & 1) ? root.boundsMax.x : root.boundsMin.x,
+                                (corner & 2) ? root.boundsMax.y : root.boundsMin.y,
+                                (corner & 4) ? root.boundsMax.z : root.boundsMin.z);
+            placed.bounds.expand(placed.identity ? point : source.transform.transformPoint(point));
+        }
+        instanceOrder.push_back(static_cast<int>(i));
+    }
+
+    // Top level: median splits along the longest centroid axis (instance counts are small)
+    nodes.clear();
+    if (instanceOrder.empty())
+        return;
+
+    const int placedCount = static_cast<int>(instanceOrder.size());
+    nodes.reserve(2 * placedCount);
+    BVHNode root;
+    root.leftFirst = 0;
+    root.triangleCount = placedCount;
+    nodes.push_back(root);
+
+    int stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const int nodeIndex = stack[--stackSize];
+        const int first = nodes[nodeIndex].leftFirst;
+        const int count = nodes[nodeIndex].triangleCount;
+
+        AABB bounds;
+        AABB centroidBounds;
+        for (int i = first; i < first + count; ++i)
+        {
+            const AABB &instanceBounds = instances[instanceOrder[i]].bounds;
+            bounds.expand(instanceBounds);
+            centroidBounds.expand(instanceBounds.centroid());
+        }
+        nodes[nodeIndex].boundsMin = bounds.min;
+        nodes[nodeIndex].boundsMax = bounds.max;
+        if (count <= MAX_LEAF_INSTANCES)
+            continue;
+
+        const Vector3 extent = centroidBounds.max - centroidBounds.min;
+        const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        const int middle = first + count / 2;
+        std::nth_element(instanceOrder.begin() + first, instanceOrder.begin() + middle, instanceOrder.begin() + first + count,
+                         [&](int a, int b)
+                         {
+                             return axisValue(instances[a].bounds.centroid(), axis) <
+                                    axisValue(instances[b].bounds.centroid(), axis);
+                         });
+
+        BVHNode left;
+        left.leftFirst = first;
+        left.triangleCount = middle - first;
+        BVHNode right;
+        right.leftFirst = middle;
+        right.triangleCount = first + count - middle;
+
+        const int leftIndex = static_cast<int>(nodes.size());
+        nodes.push_back(left);
+        nodes.push_back(right);
+        nodes[nodeIndex].leftFirst = leftIndex;
+        nodes[nodeIndex].triangleCount = 0;
+        stack[stackSize++] = leftIndex + 1;
+        stack[stackSize++] = leftIndex;
+    }
+}
+
+int InstanceBVH::findInstance(int sceneTriangle) const
+{
+    if (sceneTriangle < 0 || sceneTriangle >= triangleCount)
+        return -1;
+
+    // Last instance starting at or before the id; empty instances share their successor's start
+    auto it = std::upper_bound(instances.begin(), instances.end(), sceneTriangle,
+                               [](int id, const PlacedInstance &instance) { return id < instance.firstTriangle; });
+    return static_cast<int>(it - instances.begin()) - 1;
+}
+
+Ray InstanceBVH::toObjectSpace(const PlacedInstance &instance, const Ray &ray) const
+{
+    Ray local;
+    local.origin = instance.worldToObject.transformPoint(ray.origin);
+    local.direction = instance.worldToObject.transformDirection(ray.direction);
+    return local;
+}
+
+void InstanceBVH::toWorldSpace(const PlacedInstance &instance, int instanceIndex, const Ray &ray, BVHHit &hit) const
+{
+    hit.triangleIndex += instance.firstTriangle;
+    hit.instanceIndex = instanceIndex;
+    if (instance.identity)
+        return;
+
+    // The inverse transpose keeps the normal on the ray's side, so the face orientation carries over
+    hit.hit.point = ray.getPoint(hit.hit.distance);
+    hit.hit.normal = instance.normalToWorld.transformDirection(hit.hit.normal).normalized();
+}
+
+float InstanceBVH::intersectBounds(const BVHNode &node, const Ray &ray, const Vector3 &invDirection, float tMin, float tMax)
+{
+    float tx1 = (node.boundsMin.x - ray.origin.x) * invDirection.x;
+    float tx2 = (node.boundsMax.x - ray.origin.x) * invDirection.x;
+    float tNear = std::min(tx1, tx2);
+    float tFar = std::max(tx1, tx2);
+
+    float ty1 = (node.boundsMin.y - ray.origin.y) * invDirection.y;
+    float ty2 = (node.boundsMax.y - ray.origin.y) * invDirection.y;
+    tNear = std::max(tNear, std::min(ty1, ty2));
+    tFar = std::min(tFar, std::max(ty1, ty2));
+
+    float tz1 = (node.boundsMin.z - ray.origin.z) * invDirection.z;
+    float tz2 = (node.boundsMax.z - ray.origin.z) * invDirection.z;
+    tNear = std::max(tNear, std::min(tz1, tz2));
+    tFar = std::min(tFar, std::max(tz1, tz2));
+
+    if (tFar >= tNear && tFar > tMin && tNear < tMax)
+    {
+        return tNear;
+    }
+    return std::numeric_limits<float>::infinity();
+}
+
+bool InstanceBVH::intersect(const Ray &ray, float tMin, float tMax, BVHHit &result) const
+{
+    if (nodes.empty())
+        return false;
+    PROFILE_COUNT(RaysCast, 1);
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    const Vector3 invDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+    struct StackEntry
+    {
+        int nodeIndex;
+        float entryDistance;
+    };
+    StackEntry stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    float entryDistance = intersectBounds(nodes[0], ray, invDirection, tMin, tMax);
+    if (entryDistance == infinity)
+        return false;
+    stack[stackSize++] = {0, entryDistance};
+
+    float closestDistance = tMax;
+    bool hitFound = false;
+    int nodesVisited = 0;
+
+    while (stackSize > 0)
+    {
+        const StackEntry entry = stack[--stackSize];
+        if (entry.entryDistance >= closestDistance)
+            continue; // A closer hit was found since the node was pushed
+        const BVHNode &node = nodes[entry.nodeIndex];
+        nodesVisited++;
+
+        if (node.isLeaf())
+        {
+            for (int i = 0; i < node.triangleCount; ++i)
+            {
+                const int instanceIndex = instanceOrder[node.leftFirst + i];
+                const PlacedInstance &instance = instances[instanceIndex];
+                BVHHit hit;
+                if (meshes[instance.mesh].intersect(instance.identity ? ray : toObjectSpace(instance, ray), tMin,
+                                                    closestDistance, hit))
+                {
+                    closestDistance = hit.hit.distance;
+                    toWorldSpace(instance, instanceIndex, ray, hit);
+                    result = hit;
+                    hitFound = true;
+                }
+            }
+            continue;
+        }
+
+        // Push the farther child first so the nearer one is traversed next
+        int nearChild = node.leftFirst;
+        int farChild = node.leftFirst + 1;
+        float nearDistance = intersectBounds(nodes[nearChild], ray, invDirection, tMin, closestDistance);
+        float farDistance = intersectBounds(nodes[farChild], ray, invDirection, tMin, closestDistance);
+        if (farDistance < nearDistance)
+        {
+            std::swap(nearChild, farChild);
+            std::swap(nearDistance, farDistance);
+        }
+        if (farDistance != infinity)
+            stack[stackSize++] = {farChild, farDistance};
+        if (nearDistance != infinity)
+            stack[stackSize++] = {nearChild, nearDistance};
+    }
+
+    PROFILE_COUNT(BVHNodesVisited, nodesVisited);
+    return hitFound;
+}
+
+bool InstanceBVH::intersectAny(const Ray &ray, float tMin, float tMax) const
+{
+    if (nodes.empty())
+        return false;
+    PROFILE_COUNT(RaysCast, 1);
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    const Vector3 invDirection(1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z);
+
+    int stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    int nodesVisited = 0;
+    bool occluded = false;
+
+    while (stackSize > 0 && !occluded)
+    {
+        const BVHNode &node = nodes[stack[--stackSize]];
+        nodesVisited++;
+
+        if (intersectBounds(node, ray, invDirection, tMin, tMax) == infinity)
+            continue;
+
+        if (node.isLeaf())
+        {
+            for (int i = 0; i < node.triangleCount && !occluded; ++i)
+            {
+                const PlacedInstance &instance = instances[instanceOrder[node.leftFirst + i]];
+                occluded = meshes[instance.mesh].intersectAny(instance.identity ? ray : toObjectSpace(instance, ray),
+                                                              tMin, tMax);
+            }
+        }
+        else
+        {
+            stack[stackSize++] = node.leftFirst + 1;
+            stack[stackSize++] = node.leftFirst;
+        }
+    }
+
+    PROFILE_COUNT(BVHNodesVisited, nodesVisited);
+    return occluded;
+}
+
+int InstanceBVH::intersectPacket(const RayPacket &packet, BVHHit results[RAY_PACKET_WIDTH]) const
+{
+    if (nodes.empty() || packet.activeMask == 0)
+        return 0;
+
+    const float infinity = std::numeric_limits<float>::infinity();
+    Ray rays[RAY_PACKET_WIDTH];
+    Vector3 invDirections[RAY_PACKET_WIDTH];
+    float closestDistance[RAY_PACKET_WIDTH];
+    int activeRays = 0;
+    for (int lane = 0; lane < RAY_PACKET_WIDTH; ++lane)
+    {
+        rays[lane] = packet.getRay(lane);
+        invDirections[lane] = Vector3(packet.inverseDirectionX[lane], packet.inverseDirectionY[lane],
+                                      packet.inverseDirectionZ[lane]);
+        closestDistance[lane] = packet.tMax[lane];
+        activeRays += (packet.activeMask >> lane) & 1;
+    }
+
+    int stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    int nodesVisited = 0;
+    int hitMask = 0;
+
+    while (stackSize > 0)
+    {
+        const BVHNode &node = nodes[stack[--stackSize]];
+        nodesVisited++;
+
+        // Lanes that enter the node before their closest hit so far (the top level is small,
+        // so the per-lane slab tests are cheap next to the mesh traversals)
+        int laneMask = 0;
+        for (int lane = 0; lane < RAY_PACKET_WIDTH; ++lane)
+        {
+            if ((packet.activeMask & (1 << lane)) &&
+                intersectBounds(node, rays[lane], invDirections[lane], packet.tMin, closestDistance[lane]) != infinity)
+            {
+                laneMask |= 1 << lane;
+            }
+        }
+        if (laneMask == 0)
+            continue;
+
+        if (!node.isLeaf())
+        {
+            stack[stackSize++] = node.leftFirst + 1;
+            stack[stackSize++] = node.leftFirst;
+            continue;
+        }
+
+        for (int i = 0; i < node.triangleCount; ++i)
+        {
+            const int instanceIndex = instanceOrder[node.leftFirst + i];
+            const PlacedInstance &instance = instances[instanceIndex];
+
+            // Same packet with the lanes moved into object space and bounded by their closest hit
+            RayPacket local = packet;
+            for (int lane = 0; lane < RAY_PACKET_WIDTH; ++lane)
+            {
+                if (!(laneMask & (1 << lane)))
+                    local.tMax[lane] = -std::numeric_limits<float>::max();
+                else if (instance.identity)
+                    local.tMax[lane] = closestDistance[lane];
+                else
+                    local.setRay(lane, toObjectSpace(instance, rays[lane]), closestDistance[lane]);
+            }
+            local.activeMask = laneMask;
+
+            BVHHit laneHits[RAY_PACKET_WIDTH];
+            const int meshHits = meshes[instance.mesh].intersectPacket(local, laneHits);
+            for (int lane = 0; lane < RAY_PACKET_WIDTH; ++lane)
+            {
+                if (!(meshHits & (1 << lane)))
+                    continue;
+                closestDistance[lane] = laneHits[lane].hit.distance;
+                toWorldSpace(instance, instanceIndex, rays[lane], laneHits[lane]);
+                results[lane] = laneHits[lane];
+                hitMask |= 1 << lane;
+            }
+        }
+    }
+
+    PROFILE_COUNT(RaysCast, activeRays);
+    PROFILE_COUNT(BVHNodesVisited, nodesVisited);
+    return hitMask;
+}
+
+void InstanceBVH::collectInFrustum(const Frustum &frustum, std::vector<int> &result) const
+{
+    if (nodes.empty())
+        return;
+
+    int stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    int nodesVisited = 0;
+
+    while (stackSize > 0)
+    {
+        const BVHNode &node = nodes[stack[--stackSize]];
+        nodesVisited++;
+
+        const Frustum::Containment containment = frustum.classifyBox(node.boundsMin, node.boundsMax);
+        if (containment == Frustum::Containment::Outside)
+            continue;
+
+        if (!node.isLeaf())
+        {
+            stack[stackSize++] = node.leftFirst + 1;
+            stack[stackSize++] = node.leftFirst;
+            continue;
+        }
+
+        for (int i = 0; i < node.triangleCount; ++i)
+        {
+            const PlacedInstance &instance = instances[instanceOrder[node.leftFirst + i]];
+            const BVH &mesh = meshes[instance.mesh];
+            const size_t begin = result.size();
+            if (containment == Frustum::Containment::Inside)
+            {
+                for (int local = 0; local < mesh.getTriangleCount(); ++local)
+                {
+                    result.push_back(local);
+                }
+            }
+            else
+            {
+                mesh.collectInFrustum(instance.identity ? frustum : frustum.toObjectSpace(instance.objectToWorld), result);
+            }
+            for (size_t k = begin; k < result.size(); ++k)
+            {
+                result[k] += instance.firstTriangle;
+            }
+        }
+    }
+
+    PROFILE_COUNT(BVHNodesVisited, nodesVisited);
+}
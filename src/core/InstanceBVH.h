@@ -0,0 +1,81 @@
+#pragma once
+
+#include "BVH.h"
+#include "../math/Matrix4.h"
+#include <vector>
+
+// Two-level acceleration structure: one bottom-level BVH per mesh, built in object space and
+// shared by every instance of the mesh, under a top-level BVH over the instances' world bounds.
+// Moving or re-listing instances only rebuilds the top level.
+//
+// Scene triangle ids number the triangles of all instances in instance order, so a hit reports
+// BVHHit::triangleIndex = first id of its instance + triangle index within the mesh.
+// Rays enter a transformed instance with an unnormalized object-space direction, which keeps
+// hit distances in world units.
+class InstanceBVH
+{
+public:
+    struct Instance
+    {
+        int mesh = 0;
+        Matrix4 transform; // Object to world (identity by default)
+    };
+
+private:
+    struct PlacedInstance
+    {
+        int mesh = 0;
+        int firstTriangle = 0;
+        bool identity = true;  // Rays are tested in world space as they are
+        Matrix4 objectToWorld;
+        Matrix4 worldToObject;
+        Matrix4 normalToWorld; // Inverse transpose of the object-to-world matrix
+        AABB bounds;           // World space, invalid for empty meshes
+    };
+
+    std::vector<BVH> meshes;
+    std::vector<PlacedInstance> instances;
+    std::vector<BVHNode> nodes;     // Top level; leaves hold a range of instanceOrder
+    std::vector<int> instanceOrder; // Leaf order -> instance (instances with triangles only)
+    int triangleCount = 0;          // Scene triangles over all instances
+
+    static constexpr int MAX_LEAF_INSTANCES = 2;
+    static constexpr int MAX_STACK_DEPTH = 64;
+
+public:
+    void clear();
+
+    // Bottom level: (re)build or refit one mesh; the top level must be rebuilt afterwards
+    void setMeshCount(int count);
+    void buildMesh(int mesh, const std::vector<Triangle> &triangles);
+    void refitMesh(int mesh, const std::vector<Triangle> &triangles, const std::vector<int> &changedTriangles);
+    float getRefitGrowth(int mesh) const { return meshes[mesh].getRefitGrowth(); }
+
+    // Top level: place the meshes and rebuild the instance hierarchy
+    void setInstances(const std::vector<Instance> &instanceList);
+
+    // Same queries as BVH, over all instances; hits carry the scene triangle id and instance
+    bool intersect(const Ray &ray, float tMin, float tMax, BVHHit &result) const;
+    bool intersectAny(const Ray &ray, float tMin, float tMax) const;
+    int intersectPacket(const RayPacket &packet, BVHHit results[RAY_PACKET_WIDTH]) const;
+    void collectInFrustum(const Frustum &frustum, std::vector<int> &result) const; // Scene triangle ids
+
+    // Instance owning a scene triangle id (-1 when out of range)
+    int findInstance(int sceneTriangle) const;
+
+    // Info
+    bool isEmpty() const { return nodes.empty(); }
+    int getTriangleCount() const { return triangleCount; }
+    int getInstanceCount() const { return static_cast<int>(instances.size()); }
+    int getInstanceFirstTriangle(int instance) const { return instances[instance].firstTriangle; }
+    int getMeshCount() const { return static_cast<int>(meshes.size()); }
+    const BVH &getMesh(int mesh) const { return meshes[mesh]; }
+    int getTopLevelNodeCount() const { return static_cast<int>(nodes.size()); }
+
+private:
+    Ray toObjectSpace(const PlacedInstance &instance, const Ray &ray) const;
+    void toWorldSpace(const PlacedInstance &instance, int instanceIndex, const Ray &ray, BVHHit &hit) const;
+
+    // Slab test against a top-level node, returns entry distance or +inf on miss
+    static float intersectBounds(const BVHNode &node, const Ray &ray, const Vector3 &invDirection, float tMin, float tMax);
+};
@@ -0,0 +1,421 @@
+#include "MeshAdjacency.h"
+#include "Model.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr uint64_t EMPTY_KEY = ~uint64_t(0); // Never a valid key: vertex indices are non-negative ints
+    constexpr int MIN_TABLE_BITS = 4;
+}
+
+uint64_t MeshAdjacency::packKey(int v1, int v2)
+{
+    if (v1 > v2)
+        std::swap(v1, v2); // Undirected: normalize order
+    return (uint64_t(uint32_t(v1)) << 32) | uint32_t(v2);
+}
+
+size_t MeshAdjacency::homeSlot(uint64_t key) const
+{
+    // Fibonacci hashing: the top bits of the product are well mixed
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - tableBits));
+}
+
+void MeshAdjacency::clear()
+{
+    slotKeys.clear();
+    slotEdges.clear();
+    tableBits = 0;
+    edgeRecords.clear();
+    cornerVertex.clear();
+    cornerEdge.clear();
+    nextEdgeCorner.clear();
+    nextVertexCorner.clear();
+    vertexFirstCorner.clear();
+    endVertex.clear();
+    nextVertexEnd.clear();
+    vertexFirstEnd.clear();
+}
+
+void MeshAdjacency::build(const std::vector<Face> &faces, const std::vector<Edge> &lines, int vertexCount)
+{
+    clear();
+
+    // A closed triangle mesh has about 1.5 edges per face
+    growTable(faces.size() * 3 / 2 + 1);
+    edgeRecords.reserve(faces.size() * 3 / 2 + 1);
+    cornerVertex.reserve(faces.size() * 3);
+    cornerEdge.reserve(faces.size() * 3);
+    nextEdgeCorner.reserve(faces.size() * 3);
+    nextVertexCorner.reserve(faces.size() * 3);
+    vertexFirstCorner.assign(vertexCount, -1);
+
+    for (const auto &face : faces)
+    {
+        addFace(face);
+    }
+    setLines(lines);
+}
+
+void MeshAdjacency::setLines(const std::vector<Edge> &lines)
+{
+    endVertex.clear();
+    nextVertexEnd.clear();
+    endVertex.reserve(lines.size() * 2);
+    nextVertexEnd.reserve(lines.size() * 2);
+    vertexFirstEnd.assign(vertexFirstCorner.size(), -1);
+
+    for (const auto &line : lines)
+    {
+        addLine(line);
+    }
+}
+
+void MeshAdjacency::addVertex()
+{
+    vertexFirstCorner.push_back(-1);
+    vertexFirstEnd.push_back(-1);
+}
+
+void MeshAdjacency::addFace(const Face &face)
+{
+    const int faceIndex = getFaceCount();
+    const int indices[3] = {face.v1, face.v2, face.v3};
+    const int vertexCount = getVertexCount();
+    bool valid = true;
+    for (int index : indices)
+    {
+        valid = valid && index >= 0 && index < vertexCount;
+    }
+
+    for (int k = 0; k < 3; ++k)
+    {
+        const int corner = faceIndex * 3 + k;
+        if (!valid)
+        {
+            cornerVertex.push_back(-1);
+            cornerEdge.push_back(-1);
+            nextEdgeCorner.push_back(-1);
+            nextVertexCorner.push_back(-1);
+            continue;
+        }
+
+        const int vertex = indices[k];
+        const int edgeIndex = acquireEdge(vertex, indices[(k + 1) % 3]);
+        EdgeRecord &edge = edgeRecords[edgeIndex];
+
+        cornerVertex.push_back(vertex);
+        cornerEdge.push_back(edgeIndex);
+        nextEdgeCorner.push_back(edge.firstCorner);
+        nextVertexCorner.push_back(vertexFirstCorner[vertex]);
+        edge.firstCorner = corner;
+        edge.faceCount++;
+        vertexFirstCorner[vertex] = corner;
+    }
+}
+
+void MeshAdjacency::removeFace(int faceIndex)
+{
+    if (faceIndex < 0 || faceIndex >= getFaceCount())
+        return;
+
+    for (int corner = faceIndex * 3; corner < faceIndex * 3 + 3; ++corner)
+    {
+        const int vertex = cornerVertex[corner];
+        if (vertex < 0)
+            continue;
+
+        unlink(nextVertexCorner, vertexFirstCorner[vertex], corner);
+        const int edgeIndex = cornerEdge[corner];
+        unlink(nextEdgeCorner, edgeRecords[edgeIndex].firstCorner, corner);
+        if (--edgeRecords[edgeIndex].faceCount == 0)
+        {
+            releaseEdge(edgeIndex);
+        }
+
+        cornerVertex[corner] = -1;
+        cornerEdge[corner] = -1;
+        nextEdgeCorner[corner] = -1;
+        nextVertexCorner[corner] = -1;
+    }
+}
+
+void MeshAdjacency::addLine(const Edge &line)
+{
+    const int lineIndex = getLineCount();
+    const int indices[2] = {line.v1, line.v2};
+    const int vertexCount = getVertexCount();
+    const bool valid = indices[0] >= 0 && indices[0] < vertexCount && indices[1] >= 0 && indices[1] < vertexCount;
+
+    for (int k = 0; k < 2; ++k)
+    {
+        if (!valid)
+        {
+            endVertex.push_back(-1);
+            nextVertexEnd.push_back(-1);
+            continue;
+        }
+
+        const int vertex = indices[k];
+        endVertex.push_back(vertex);
+        nextVertexEnd.push_back(vertexFirstEnd[vertex]);
+        vertexFirstEnd[vertex] = lineIndex * 2 + k;
+    }
+}
+
+void MeshAdjacency::removeLine(int lineIndex)
+{
+    if (lineIndex < 0 || lineIndex >= getLineCount())
+        return;
+
+    for (int end = lineIndex * 2; end < lineIndex * 2 + 2; ++end)
+    {
+        const int vertex = endVertex[end];
+        if (vertex < 0)
+            continue;
+
+        unlink(nextVertexEnd, vertexFirstEnd[vertex], end);
+        endVertex[end] = -1;
+        nextVertexEnd[end] = -1;
+    }
+}
+
+void MeshAdjacency::compact(const std::vector<int> &vertexRemap, const std::vector<int> &faceRemap,
+                            const std::vector<int> &lineRemap)
+{
+    const int vertexCount = getVertexCount();
+    const int faceCount = getFaceCount();
+    const int lineCount = getLineCount();
+    for (int face = 0; face < faceCount; ++face)
+    {
+        if (faceRemap[face] < 0)
+            removeFace(face);
+    }
+    for (int line = 0; line < lineCount; ++line)
+    {
+        if (lineRemap[line] < 0)
+            removeLine(line);
+    }
+
+    auto mapCorner = [&](int corner) { return corner >= 0 ? faceRemap[corner / 3] * 3 + corner % 3 : -1; };
+    auto mapEnd = [&](int end) { return end >= 0 ? lineRemap[end / 2] * 2 + end % 2 : -1; };
+    auto mapVertex = [&](int vertex) { return vertex >= 0 ? vertexRemap[vertex] : -1; };
+
+    // Kept elements only move down, so every array is rewritten in place front to back
+    int keptCorners = 0;
+    for (int corner = 0; corner < faceCount * 3; ++corner)
+    {
+        const int target = mapCorner(corner);
+        if (target < 0)
+            continue;
+        cornerVertex[target] = mapVertex(cornerVertex[corner]);
+        cornerEdge[target] = cornerEdge[corner];
+        nextEdgeCorner[target] = mapCorner(nextEdgeCorner[corner]);
+        nextVertexCorner[target] = mapCorner(nextVertexCorner[corner]);
+        keptCorners++;
+    }
+    cornerVertex.resize(keptCorners);
+    cornerEdge.resize(keptCorners);
+    nextEdgeCorner.resize(keptCorners);
+    nextVertexCorner.resize(keptCorners);
+
+    int keptEnds = 0;
+    for (int end = 0; end < lineCount * 2; ++end)
+    {
+        const int target = mapEnd(end);
+        if (target < 0)
+            continue;
+        endVertex[target] = mapVertex(endVertex[end]);
+        nextVertexEnd[target] = mapEnd(nextVertexEnd[end]);
+        keptEnds++;
+    }
+    endVertex.resize(keptEnds);
+    nextVertexEnd.resize(keptEnds);
+
+    int keptVertices = 0;
+    bool renumbered = false;
+    for (int vertex = 0; vertex < vertexCount; ++vertex)
+    {
+        const int target = vertexRemap[vertex];
+        if (target < 0)
+            continue;
+        renumbered = renumbered || target != vertex;
+        vertexFirstCorner[target] = mapCorner(vertexFirstCorner[vertex]);
+        vertexFirstEnd[target] = mapEnd(vertexFirstEnd[vertex]);
+        keptVertices++;
+    }
+    renumbered = renumbered || keptVertices != vertexCount;
+    vertexFirstCorner.resize(keptVertices);
+    vertexFirstEnd.resize(keptVertices);
+
+    for (auto &edge : edgeRecords)
+    {
+        edge.firstCorner = mapCorner(edge.firstCorner);
+        if (renumbered)
+        {
+            edge.key = packKey(vertexRemap[static_cast<int>(edge.key >> 32)],
+                               vertexRemap[static_cast<int>(edge.key & 0xffffffffu)]);
+        }
+    }
+
+    // New keys hash to new slots; the edge indices themselves are unchanged
+    if (renumbered && tableBits > 0)
+    {
+        std::fill(slotKeys.begin(), slotKeys.end(), EMPTY_KEY);
+        for (int i = 0; i < static_cast<int>(edgeRecords.size()); ++i)
+        {
+            insertSlot(edgeRecords[i].key, i);
+        }
+    }
+}
+
+int MeshAdjacency::findEdge(int v1, int v2) const
+{
+    if (v1 < 0 || v2 < 0 || tableBits == 0)
+        return -1;
+    int slot = findSlot(packKey(v1, v2));
+    return slot >= 0 ? slotEdges[slot] : -1;
+}
+
+void MeshAdjacency::getEdgeVertices(int edgeIndex, int &v1, int &v2) const
+{
+    const uint64_t key = edgeRecords[edgeIndex].key;
+    v1 = static_cast<int>(key >> 32);
+    v2 = static_cast<int>(key & 0xffffffffu);
+}
+
+void MeshAdjacency::getSortedEdges(std::vector<Edge> &result) const
+{
+    // Packed keys sort in (v1, v2) order
+    std::vector<uint64_t> keys;
+    keys.reserve(edgeRecords.size());
+    for (const auto &edge : edgeRecords)
+    {
+        keys.push_back(edge.key);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    result.clear();
+    result.reserve(keys.size());
+    for (uint64_t key : keys)
+    {
+        result.emplace_back(static_cast<int>(key >> 32), static_cast<int>(key & 0xffffffffu));
+    }
+}
+
+int MeshAdjacency::findSlot(uint64_t key) const
+{
+    const size_t mask = slotKeys.size() - 1;
+    for (size_t slot = homeSlot(key);; slot = (slot + 1) & mask)
+    {
+        if (slotKeys[slot] == key)
+            return static_cast<int>(slot);
+        if (slotKeys[slot] == EMPTY_KEY)
+            return -1;
+    }
+}
+
+void MeshAdjacency::insertSlot(uint64_t key, int edgeIndex)
+{
+    const size_t mask = slotKeys.size() - 1;
+    size_t slot = homeSlot(key);
+    while (slotKeys[slot] != EMPTY_KEY)
+    {
+        slot = (slot + 1) & mask;
+    }
+    slotKeys[slot] = key;
+    slotEdges[slot] = edgeIndex;
+}
+
+void MeshAdjacency::eraseSlot(int slot)
+{
+    // Backward-shift deletion: pull later entries of the probe run into the hole,
+    // so lookups never need tombstones
+    const size_t mask = slotKeys.size() - 1;
+    size_t hole = static_cast<size_t>(slot);
+    for (size_t next = (hole + 1) & mask; slotKeys[next] != EMPTY_KEY; next = (next + 1) & mask)
+    {
+        const size_t home = homeSlot(slotKeys[next]);
+        // Move unless the entry's home lies cyclically in (hole, next]
+        const bool homeAfterHole = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!homeAfterHole)
+        {
+            slotKeys[hole] = slotKeys[next];
+            slotEdges[hole] = slotEdges[next];
+            hole = next;
+        }
+    }
+    slotKeys[hole] = EMPTY_KEY;
+}
+
+void MeshAdjacency::growTable(size_t minimumEdges)
+{
+    // Keep the load factor at or below one half
+    int bits = std::max(tableBits, MIN_TABLE_BITS);
+    while ((size_t(1) << bits) < minimumEdges * 2)
+    {
+        bits++;
+    }
+    if (bits == tableBits)
+        return;
+
+    tableBits = bits;
+    slotKeys.assign(size_t(1) << bits, EMPTY_KEY);
+    slotEdges.assign(size_t(1) << bits, -1);
+    for (int i = 0; i < static_cast<int>(edgeRecords.size()); ++i)
+    {
+        insertSlot(edgeRecords[i].key, i);
+    }
+}
+
+int MeshAdjacency::acquireEdge(int v1, int v2)
+{
+    const uint64_t key = packKey(v1, v2);
+    if (tableBits > 0)
+    {
+        int slot = findSlot(key);
+        if (slot >= 0)
+            return slotEdges[slot];
+    }
+
+    growTable(edgeRecords.size() + 1);
+    const int edgeIndex = static_cast<int>(edgeRecords.size());
+    edgeRecords.push_back({key, -1, 0});
+    insertSlot(key, edgeIndex);
+    return edgeIndex;
+}
+
+void MeshAdjacency::releaseEdge(int edgeIndex)
+{
+    eraseSlot(findSlot(edgeRecords[edgeIndex].key));
+
+    // Fill the hole with the last edge and repoint everything that referenced it
+    const int lastIndex = static_cast<int>(edgeRecords.size()) - 1;
+    if (edgeIndex != lastIndex)
+    {
+        edgeRecords[edgeIndex] = edgeRecords[lastIndex];
+        slotEdges[findSlot(edgeRecords[edgeIndex].key)] = edgeIndex;
+        for (int corner = edgeRecords[edgeIndex].firstCorner; corner >= 0; corner = nextEdgeCorner[corner])
+        {
+            cornerEdge[corner] = edgeIndex;
+        }
+    }
+    edgeRecords.pop_back();
+}
+
+void MeshAdjacency::unlink(std::vector<int> &next, int &head, int corner)
+{
+    if (head == corner)
+    {
+        head = next[corner];
+        return;
+    }
+    for (int previous = head; previous >= 0; previous = next[previous])
+    {
+        if (next[previous] == corner)
+        {
+            next[previous] = next[corner];
+            return;
+        }
+    }
+}
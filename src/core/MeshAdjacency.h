@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct Face;
+struct Edge;
+
+// Undirected edges of a triangle mesh with edge -> face and vertex -> face incidence, plus
+// vertex -> line incidence for the model's edge list, kept current as faces and lines are
+// added and removed.
+// Edges are found through a flat open-addressing hash keyed by the packed vertex pair.
+// The incidence lists are threaded through the face corners (three per face) and line
+// ends (two per line), so updates never allocate beyond amortized array growth.
+// Removing a face or line only unlinks its own corners or ends and keeps every index in
+// place; compact() drops the removed elements in one pass, alongside Model::compactDeleted().
+class MeshAdjacency
+{
+private:
+    struct EdgeRecord
+    {
+        uint64_t key;    // packKey(v1, v2)
+        int firstCorner; // Head of the list of corners using this edge
+        int faceCount;
+    };
+
+    // Hash table: slot -> edge index, linear probing with backward-shift deletion
+    std::vector<uint64_t> slotKeys;
+    std::vector<int> slotEdges;
+    int tableBits = 0;
+
+    std::vector<EdgeRecord> edgeRecords;
+
+    // Face corners: corner 3 * face + k is vertex k of the face and starts edge (k, k + 1)
+    std::vector<int> cornerVertex;     // -1 for removed faces and faces with out-of-range indices (not linked)
+    std::vector<int> cornerEdge;
+    std::vector<int> nextEdgeCorner;   // Next corner on the same edge, -1 = end
+    std::vector<int> nextVertexCorner; // Next corner at the same vertex, -1 = end
+
+    std::vector<int> vertexFirstCorner;
+
+    // Line ends: end 2 * line + k is vertex k of the line (-1 when not linked)
+    std::vector<int> endVertex;
+    std::vector<int> nextVertexEnd; // Next end at the same vertex, -1 = end
+    std::vector<int> vertexFirstEnd;
+
+public:
+    void clear();
+
+    // Rebuild from scratch for a mesh with the given faces, edge list and vertex count
+    void build(const std::vector<Face> &faces, const std::vector<Edge> &lines, int vertexCount);
+    void setLines(const std::vector<Edge> &lines); // Replace the edge list only
+
+    // Incremental updates mirroring Model's vertex, face and edge arrays
+    void addVertex();
+    void addFace(const Face &face);  // Becomes face getFaceCount()
+    void removeFace(int faceIndex);  // Unlinks the face; its index stays taken until compact()
+    void addLine(const Edge &line);  // Becomes line getLineCount()
+    void removeLine(int lineIndex);  // Unlinks the line; its index stays taken until compact()
+
+    // Drop removed elements and renumber, given old -> new index maps (-1 = dropped) that keep
+    // the order, as Model::compactDeleted() produces. Dropped faces and lines still linked are
+    // removed first; kept ones must only use kept vertices
+    void compact(const std::vector<int> &vertexRemap, const std::vector<int> &faceRemap,
+                 const std::vector<int> &lineRemap);
+
+    int getVertexCount() const { return static_cast<int>(vertexFirstCorner.size()); }
+    int getFaceCount() const { return static_cast<int>(cornerVertex.size() / 3); }
+    int getLineCount() const { return static_cast<int>(endVertex.size() / 2); }
+    int getEdgeCount() const { return static_cast<int>(edgeRecords.size()); }
+
+    // Edge index of (v1, v2) in either order, -1 if no face uses it
+    int findEdge(int v1, int v2) const;
+    void getEdgeVertices(int edgeIndex, int &v1, int &v2) const; // v1 <= v2
+    int getEdgeFaceCount(int edgeIndex) const { return edgeRecords[edgeIndex].faceCount; }
+    bool isBoundaryEdge(int edgeIndex) const { return edgeRecords[edgeIndex].faceCount == 1; }
+
+    // Visit the faces on an edge / the faces and lines at a vertex (in no particular order;
+    // a face or line is visited once per corner or end it has there, so only degenerate ones repeat)
+    template <typename Visitor>
+    void forEachEdgeFace(int edgeIndex, Visitor visit) const
+    {
+        for (int corner = edgeRecords[edgeIndex].firstCorner; corner >= 0; corner = nextEdgeCorner[corner])
+        {
+            visit(corner / 3);
+        }
+    }
+
+    template <typename Visitor>
+    void forEachVertexFace(int vertexIndex, Visitor visit) const
+    {
+        for (int corner = vertexFirstCorner[vertexIndex]; corner >= 0; corner = nextVertexCorner[corner])
+        {
+            visit(corner / 3);
+        }
+    }
+
+    template <typename Visitor>
+    void forEachVertexLine(int vertexIndex, Visitor visit) const
+    {
+        for (int end = vertexFirstEnd[vertexIndex]; end >= 0; end = nextVertexEnd[end])
+        {
+            visit(end / 2);
+        }
+    }
+
+    // All edges ordered by (v1, v2) with v1 <= v2
+    void getSortedEdges(std::vector<Edge> &result) const;
+
+private:
+    static uint64_t packKey(int v1, int v2);
+    size_t homeSlot(uint64_t key) const;
+    int findSlot(uint64_t key) const;
+    void insertSlot(uint64_t key, int edgeIndex);
+    void eraseSlot(int slot);
+    void growTable(size_t minimumEdges);
+
+    int acquireEdge(int v1, int v2); // Existing or new edge for the pair
+    void releaseEdge(int edgeIndex); // Drop an edge no face uses any more
+
+    static void unlink(std::vector<int> &next, int &head, int corner);
+};
@@ -0,0 +1,29 @@
+#include "MeshArrays.h"
+#include <algorithm>
+
+void MeshArrays::resize(int count)
+{
+    vertexCount = count;
+    const size_t padded = static_cast<size_t>((count + MeshView::SIMD_WIDTH - 1) / MeshView::SIMD_WIDTH * MeshView::SIMD_WIDTH);
+
+    for (AlignedVector<float> *component : {&positionX, &positionY, &positionZ, &normalX, &normalY, &normalZ})
+    {
+        component->resize(padded);
+        std::fill(component->begin() + count, component->end(), 0.0f);
+    }
+}
+
+MeshView MeshArrays::getView(const Face *faces, int faceCount) const
+{
+    MeshView view;
+    view.positionX = positionX.data();
+    view.positionY = positionY.data();
+    view.positionZ = positionZ.data();
+    view.normalX = normalX.data();
+    view.normalY = normalY.data();
+    view.normalZ = normalZ.data();
+    view.faces = faces;
+    view.vertexCount = vertexCount;
+    view.faceCount = faceCount;
+    return view;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../math/Vector3.h"
+#include "../utils/AlignedAllocator.h"
+
+struct Face;
+
+// Read-only view of a mesh in structure-of-arrays layout, passed by value to kernels.
+// Every float array starts on a 64-byte boundary and is zero-padded to a multiple of
+// SIMD_WIDTH, so 8-wide kernels can load whole blocks with no scalar tail.
+struct MeshView
+{
+    static constexpr int SIMD_WIDTH = 8;
+
+    const float *positionX = nullptr;
+    const float *positionY = nullptr;
+    const float *positionZ = nullptr;
+    const float *normalX = nullptr;
+    const float *normalY = nullptr;
+    const float *normalZ = nullptr;
+    const Face *faces = nullptr; // Index buffer, three vertex indices per face
+    int vertexCount = 0;
+    int faceCount = 0;
+
+    int getPaddedVertexCount() const { return (vertexCount + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH; }
+    Vector3 getPosition(int index) const { return Vector3(positionX[index], positionY[index], positionZ[index]); }
+    Vector3 getNormal(int index) const { return Vector3(normalX[index], normalY[index], normalZ[index]); }
+};
+
+// Storage behind a MeshView: one aligned array per vertex component
+class MeshArrays
+{
+private:
+    AlignedVector<float> positionX;
+    AlignedVector<float> positionY;
+    AlignedVector<float> positionZ;
+    AlignedVector<float> normalX;
+    AlignedVector<float> normalY;
+    AlignedVector<float> normalZ;
+    int vertexCount = 0;
+
+public:
+    void resize(int count); // Keeps the padding lanes zero
+    void setVertex(int index, const Vector3 &position, const Vector3 &normal)
+    {
+        positionX[index] = position.x;
+        positionY[index] = position.y;
+        positionZ[index] = position.z;
+        normalX[index] = normal.x;
+        normalY[index] = normal.y;
+        normalZ[index] = normal.z;
+    }
+
+    int getVertexCount() const { return vertexCount; }
+    MeshView getView(const Face *faces, int faceCount) const;
+};
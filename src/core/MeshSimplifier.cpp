@@ -0,0 +1,386 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    bool faceHasVertex(const Face &face, int vertex)
+    {
+        return face.v1 == vertex || face.v2 == vertex || face.v3 == vertex;
+    }
+
+    Vector3 faceNormal(const Vector3 &p0, const Vector3 &p1, const Vector3 &p2)
+    {
+        return Vector3::cross(p1 - p0, p2 - p0);
+    }
+
+    void eraseFace(std::vector<int> &list, int face)
+    {
+        auto it = std::find(list.begin(), list.end(), face);
+        if (it != list.end())
+        {
+            *it = list.back();
+            list.pop_back();
+        }
+    }
+}
+
+void MeshSimplifier::Quadric::addPlane(double a, double b, double c, double d, double weight)
+{
+    a2 += weight * a * a;
+    ab += weight * a * b;
+    ac += weight * a * c;
+    ad += weight * a * d;
+    b2 += weight * b * b;
+    bc += weight * b * c;
+    bd += weight * b * d;
+    c2 += weight * c * c;
+    cd += weight * c * d;
+    d2 += weight * d * d;
+}
+
+void MeshSimplifier::Quadric::add(const Quadric &other)
+{
+    a2 += other.a2;
+    ab += other.ab;
+    ac += other.ac;
+    ad += other.ad;
+    b2 += other.b2;
+    bc += other.bc;
+    bd += other.bd;
+    c2 += other.c2;
+    cd += other.cd;
+    d2 += other.d2;
+}
+
+double MeshSimplifier::Quadric::evaluate(const Vector3 &p) const
+{
+    const double x = p.x, y = p.y, z = p.z;
+    return a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x + b2 * y * y + 2.0 * bc * y * z +
+           2.0 * bd * y + c2 * z * z + 2.0 * cd * z + d2;
+}
+
+bool MeshSimplifier::Quadric::minimize(Vector3 &result) const
+{
+    // Gradient zero: A p = -b with A the 3x3 part, solved by Cramer's rule
+    const double det = a2 * (b2 * c2 - bc * bc) - ab * (ab * c2 - bc * ac) + ac * (ab * bc - b2 * ac);
+    const double scale = a2 + b2 + c2;
+    if (scale <= 0.0 || std::fabs(det) < 1e-9 * scale * scale * scale)
+        return false;
+
+    const double x = -(ad * (b2 * c2 - bc * bc) - ab * (bd * c2 - bc * cd) + ac * (bd * bc - b2 * cd)) / det;
+    const double y = -(a2 * (bd * c2 - cd * bc) - ad * (ab * c2 - bc * ac) + ac * (ab * cd - bd * ac)) / det;
+    const double z = -(a2 * (b2 * cd - bc * bd) - ab * (ab * cd - bd * ac) + ad * (ab * bc - b2 * ac)) / det;
+    result = Vector3(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z));
+    return std::isfinite(result.x) && std::isfinite(result.y) && std::isfinite(result.z);
+}
+
+void MeshSimplifier::load(const std::vector<Vertex> &vertices, const std::vector<Face> &sourceFaces)
+{
+    const int vertexCount = static_cast<int>(vertices.size());
+    positions.resize(vertexCount);
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        positions[i] = vertices[i].position;
+    }
+    quadrics.assign(vertexCount, Quadric());
+    stamps.assign(vertexCount, 0);
+    vertexRemoved.assign(vertexCount, 0);
+    vertexFaces.assign(vertexCount, std::vector<int>());
+    faces.clear();
+    faces.reserve(sourceFaces.size());
+    heap.clear();
+
+    auto validIndex = [&](int v) { return v >= 0 && v < vertexCount; };
+    for (const Face &face : sourceFaces)
+    {
+        if (!validIndex(face.v1) || !validIndex(face.v2) || !validIndex(face.v3) || face.v1 == face.v2 ||
+            face.v2 == face.v3 || face.v1 == face.v3)
+            continue;
+
+        const int index = static_cast<int>(faces.size());
+        faces.push_back(face);
+        vertexFaces[face.v1].push_back(index);
+        vertexFaces[face.v2].push_back(index);
+        vertexFaces[face.v3].push_back(index);
+
+        // Plane of the face, weighted by its area so slivers count for little
+        const Vector3 normal = faceNormal(positions[face.v1], positions[face.v2], positions[face.v3]);
+        const float length = normal.length();
+        if (length > 0.0f)
+        {
+            const Vector3 n = normal / length;
+            const double d = -Vector3::dot(n, positions[face.v1]);
+            for (int corner : {face.v1, face.v2, face.v3})
+            {
+                quadrics[corner].addPlane(n.x, n.y, n.z, d, 0.5 * length);
+            }
+        }
+    }
+    faceRemoved.assign(faces.size(), 0);
+    faceCount = static_cast<int>(faces.size());
+
+    // Every face edge once, with the face it came from; an edge seen once lies on a boundary
+    struct FaceEdge
+    {
+        int a, b, face;
+        bool operator<(const FaceEdge &other) const { return a != other.a ? a < other.a : b < other.b; }
+    };
+    std::vector<FaceEdge> edges;
+    edges.reserve(faces.size() * 3);
+    for (int f = 0; f < static_cast<int>(faces.size()); ++f)
+    {
+        const int corners[3] = {faces[f].v1, faces[f].v2, faces[f].v3};
+        for (int k = 0; k < 3; ++k)
+        {
+            const int a = corners[k];
+            const int b = corners[(k + 1) % 3];
+            edges.push_back({std::min(a, b), std::max(a, b), f});
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    for (size_t begin = 0; begin < edges.size();)
+    {
+        size_t end = begin + 1;
+        while (end < edges.size() && edges[end].a == edges[begin].a && edges[end].b == edges[begin].b)
+        {
+            ++end;
+        }
+
+        const FaceEdge &edge = edges[begin];
+        if (end - begin == 1)
+        {
+            // Plane through the boundary edge, perpendicular to its face, keeps the outline in place
+            const Face &face = faces[edge.face];
+            const Vector3 normal = faceNormal(positions[face.v1], positions[face.v2], positions[face.v3]);
+            const Vector3 direction = positions[edge.b] - positions[edge.a];
+            const Vector3 side = Vector3::cross(direction, normal);
+            const float length = side.length();
+            if (length > 0.0f)
+            {
+                const Vector3 n = side / length;
+                const double d = -Vector3::dot(n, positions[edge.a]);
+                const double weight = BOUNDARY_WEIGHT * direction.lengthSquared();
+                quadrics[edge.a].addPlane(n.x, n.y, n.z, d, weight);
+                quadrics[edge.b].addPlane(n.x, n.y, n.z, d, weight);
+            }
+        }
+        begin = end;
+    }
+
+    heap.reserve(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        if (i == 0 || edges[i].a != edges[i - 1].a || edges[i].b != edges[i - 1].b)
+            pushCollapse(edges[i].a, edges[i].b);
+    }
+}
+
+void MeshSimplifier::pushCollapse(int v0, int v1)
+{
+    Quadric merged = quadrics[v0];
+    merged.add(quadrics[v1]);
+
+    // The quadric's minimum unless it is ill-conditioned and lands far from the edge, against the
+    // end points and the midpoint (which also cover flat regions, where the minimum is not unique)
+    const Vector3 midpoint = (positions[v0] + positions[v1]) * 0.5f;
+    Vector3 candidates[4] = {positions[v0], positions[v1], midpoint, Vector3()};
+    int candidateCount = 3;
+    if (merged.minimize(candidates[3]) &&
+        (candidates[3] - midpoint).lengthSquared() <= (positions[v1] - positions[v0]).lengthSquared())
+        candidateCount = 4;
+
+    Collapse collapse;
+    collapse.cost = std::numeric_limits<double>::max();
+    for (int i = 0; i < candidateCount; ++i)
+    {
+        const double cost = merged.evaluate(candidates[i]);
+        if (cost < collapse.cost)
+        {
+            collapse.cost = cost;
+            collapse.position = candidates[i];
+        }
+    }
+    collapse.v0 = v0;
+    collapse.v1 = v1;
+    collapse.stamp0 = stamps[v0];
+    collapse.stamp1 = stamps[v1];
+    heap.push_back(collapse);
+    std::push_heap(heap.begin(), heap.end());
+}
+
+bool MeshSimplifier::simplify(int targetFaceCount, const std::atomic<bool> *cancel)
+{
+    int steps = 0;
+    while (faceCount > targetFaceCount && !heap.empty())
+    {
+        if (cancel && (++steps & 1023) == 0 && cancel->load(std::memory_order_relaxed))
+            return false;
+
+        std::pop_heap(heap.begin(), heap.end());
+        const Collapse collapse = heap.back();
+        heap.pop_back();
+
+        // Entries of vertices that moved or went away since were queued again or are obsolete
+        if (vertexRemoved[collapse.v0] || vertexRemoved[collapse.v1] || stamps[collapse.v0] != collapse.stamp0 ||
+            stamps[collapse.v1] != collapse.stamp1)
+            continue;
+
+        if (isCollapseAllowed(collapse.v0, collapse.v1, collapse.position))
+            applyCollapse(collapse);
+    }
+    return true;
+}
+
+void MeshSimplifier::collectNeighbors(int vertex, std::vector<int> &neighbors) const
+{
+    neighbors.clear();
+    for (int f : vertexFaces[vertex])
+    {
+        for (int corner : {faces[f].v1, faces[f].v2, faces[f].v3})
+        {
+            if (corner != vertex)
+                neighbors.push_back(corner);
+        }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+}
+
+bool MeshSimplifier::isCollapseAllowed(int v0, int v1, const Vector3 &position)
+{
+    int sharedFaces = 0;
+    for (int f : vertexFaces[v0])
+    {
+        if (faceHasVertex(faces[f], v1))
+            sharedFaces++;
+    }
+    if (sharedFaces == 0)
+        return false;
+
+    // Link condition: the end points may only share the neighbors of the faces being removed,
+    // anything more would fold the surface onto itself
+    collectNeighbors(v0, neighbors0);
+    collectNeighbors(v1, neighbors1);
+    int commonNeighbors = 0;
+    for (size_t i = 0, j = 0; i < neighbors0.size() && j < neighbors1.size();)
+    {
+        if (neighbors0[i] < neighbors1[j])
+            ++i;
+        else if (neighbors0[i] > neighbors1[j])
+            ++j;
+        else
+        {
+            commonNeighbors++;
+            ++i;
+            ++j;
+        }
+    }
+    if (commonNeighbors != sharedFaces)
+        return false;
+
+    return keepsFacesOriented(v0, v1, position) && keepsFacesOriented(v1, v0, position);
+}
+
+bool MeshSimplifier::keepsFacesOriented(int vertex, int other, const Vector3 &position) const
+{
+    for (int f : vertexFaces[vertex])
+    {
+        const Face &face = faces[f];
+        if (faceHasVertex(face, other))
+            continue; // Removed by the collapse
+
+        const Vector3 &p1 = positions[face.v1];
+        const Vector3 &p2 = positions[face.v2];
+        const Vector3 &p3 = positions[face.v3];
+        const Vector3 before = faceNormal(p1, p2, p3);
+        const Vector3 after = faceNormal(face.v1 == vertex ? position : p1, face.v2 == vertex ? position : p2,
+                                         face.v3 == vertex ? position : p3);
+        const float beforeLength = before.length();
+        const float afterLength = after.length();
+        if (beforeLength == 0.0f)
+            continue; // Degenerate already; nothing to flip
+        if (afterLength == 0.0f || Vector3::dot(before, after) < MIN_NORMAL_COSINE * beforeLength * afterLength)
+            return false;
+    }
+    return true;
+}
+
+void MeshSimplifier::applyCollapse(const Collapse &collapse)
+{
+    const int v0 = collapse.v0;
+    const int v1 = collapse.v1;
+    positions[v0] = collapse.position;
+    quadrics[v0].add(quadrics[v1]);
+    stamps[v0]++;
+    vertexRemoved[v1] = 1;
+
+    for (int f : vertexFaces[v1])
+    {
+        Face &face = faces[f];
+        if (faceHasVertex(face, v0))
+        {
+            // The collapsed edge's faces disappear
+            faceRemoved[f] = 1;
+            faceCount--;
+            for (int corner : {face.v1, face.v2, face.v3})
+            {
+                if (corner != v1)
+                    eraseFace(vertexFaces[corner], f);
+            }
+            continue;
+        }
+
+        if (face.v1 == v1)
+            face.v1 = v0;
+        else if (face.v2 == v1)
+            face.v2 = v0;
+        else
+            face.v3 = v0;
+        vertexFaces[v0].push_back(f);
+    }
+    std::vector<int>().swap(vertexFaces[v1]);
+
+    // Every edge at the merged vertex has a new cost
+    collectNeighbors(v0, neighbors0);
+    for (int neighbor : neighbors0)
+    {
+        pushCollapse(v0, neighbor);
+    }
+}
+
+void MeshSimplifier::extract(Model &model) const
+{
+    std::vector<int> remap(positions.size(), -1);
+    int vertexCount = 0;
+    for (size_t f = 0; f < faces.size(); ++f)
+    {
+        if (faceRemoved[f])
+            continue;
+        for (int corner : {faces[f].v1, faces[f].v2, faces[f].v3})
+        {
+            if (remap[corner] < 0)
+                remap[corner] = vertexCount++;
+        }
+    }
+
+    model.clear();
+    model.reserve(vertexCount, faceCount);
+    std::vector<Vector3> compacted(vertexCount);
+    for (size_t v = 0; v < positions.size(); ++v)
+    {
+        if (remap[v] >= 0)
+            compacted[remap[v]] = positions[v];
+    }
+    for (const Vector3 &position : compacted)
+    {
+        model.addVertex(position);
+    }
+    for (size_t f = 0; f < faces.size(); ++f)
+    {
+        if (!faceRemoved[f])
+            model.addFace(remap[faces[f].v1], remap[faces[f].v2], remap[faces[f].v3]);
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Model.h"
+#include "../math/Vector3.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Quadric error metric simplification (Garland & Heckbert): repeatedly collapses the edge whose
+// merged vertex lies closest, in summed squared plane distance, to the original faces around it.
+// Collapses that would flip a face or pinch the surface into a non-manifold fold are skipped, and
+// open boundaries are held in place by extra planes along their edges. simplify() can be called
+// with decreasing targets to take several levels from one collapse sequence.
+class MeshSimplifier
+{
+private:
+    // Symmetric 4x4 error quadric, upper triangle
+    struct Quadric
+    {
+        double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+        void addPlane(double a, double b, double c, double d, double weight);
+        void add(const Quadric &other);
+        double evaluate(const Vector3 &p) const;
+        bool minimize(Vector3 &result) const; // False when the 3x3 part is singular
+    };
+
+    // Collapse of edge (v0, v1) into v0, queued by cost; stale once either vertex changed
+    struct Collapse
+    {
+        double cost;
+        int v0, v1;
+        uint32_t stamp0, stamp1;
+        Vector3 position;
+
+        bool operator<(const Collapse &other) const { return cost > other.cost; } // Min-heap
+    };
+
+    std::vector<Vector3> positions;
+    std::vector<Quadric> quadrics;
+    std::vector<uint32_t> stamps;                 // Per vertex, bumped whenever it moves
+    std::vector<uint8_t> vertexRemoved;
+    std::vector<Face> faces;
+    std::vector<uint8_t> faceRemoved;
+    std::vector<std::vector<int>> vertexFaces;    // Live faces using each vertex
+    std::vector<Collapse> heap;
+    int faceCount = 0;
+
+    // Scratch for one collapse
+    std::vector<int> neighbors0;
+    std::vector<int> neighbors1;
+
+    static constexpr double BOUNDARY_WEIGHT = 1000.0;  // Boundary planes relative to face planes
+    static constexpr float MIN_NORMAL_COSINE = 0.2f;   // Largest face rotation a collapse may cause
+
+public:
+    // Take a copy of the mesh; faces with repeated or invalid vertices are dropped
+    void load(const std::vector<Vertex> &vertices, const std::vector<Face> &faces);
+
+    // Collapse edges until at most targetFaceCount faces are left or no collapse is allowed.
+    // Returns false if cancel was set before the target was reached.
+    bool simplify(int targetFaceCount, const std::atomic<bool> *cancel = nullptr);
+
+    // Current mesh with unused vertices dropped
+    void extract(Model &model) const;
+    int getFaceCount() const { return faceCount; }
+
+private:
+    void pushCollapse(int v0, int v1);
+    bool isCollapseAllowed(int v0, int v1, const Vector3 &position);
+    bool keepsFacesOriented(int vertex, int other, const Vector3 &position) const;
+    void collectNeighbors(int vertex, std::vector<int> &neighbors) const;
+    void applyCollapse(const Collapse &collapse);
+};
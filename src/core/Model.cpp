@@ -1,13 +1,87 @@
 #include "Model.h"
 #include "Ray.h"
 #include "Camera.h"
+#include "RayBatch.h"
 #include "../utils/Utils.h"
+#include "../utils/MappedFile.h"
+#include "../utils/ChunkedWriter.h"
 #include <fstream>
-#include <sstream>
 #include <algorithm>
-#include <set>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <cstdio>
 
-Model::Model() : isModified(false), selectedVertexIndex(-1), disableVisibilityCheck(false)
+namespace
+{
+    // .fjwb layout: header, then float xyz per vertex, int32 v1 v2 v3 per face, int32 v1 v2 per edge
+    constexpr char FJWB_MAGIC[4] = {'F', 'J', 'W', 'B'};
+    constexpr uint32_t FJWB_VERSION = 1;
+    constexpr uint32_t FJWB_BYTE_ORDER = 0x01020304; // Read back differently on a foreign-endian machine
+    constexpr uint64_t BINARY_CACHE_MIN_BYTES = 1 << 20; // Smaller text files parse fast enough
+    constexpr float VERTEX_BVH_MAX_REFIT_GROWTH = 2.0f;   // Node area after moves relative to the build
+
+    struct FjwbHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t vertexCount;
+        uint32_t faceCount;
+        uint32_t edgeCount;
+        int64_t sourceTime;  // Modification time of the .fjwr it was made from (0 if standalone)
+        uint64_t sourceSize; // Size of that .fjwr in bytes
+    };
+    static_assert(sizeof(FjwbHeader) == 40, "FjwbHeader must have no padding");
+    static_assert(sizeof(Face) == 3 * sizeof(int32_t), "Face is stored as raw int32 triples");
+    static_assert(sizeof(Edge) == 2 * sizeof(int32_t), "Edge is stored as raw int32 pairs");
+
+    bool getSourceStamp(const std::string &filePath, int64_t &sourceTime, uint64_t &sourceSize)
+    {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(filePath, error);
+        if (error)
+            return false;
+        auto size = std::filesystem::file_size(filePath, error);
+        if (error)
+            return false;
+
+        sourceTime = static_cast<int64_t>(time.time_since_epoch().count());
+        sourceSize = static_cast<uint64_t>(size);
+        return true;
+    }
+
+    inline bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    inline const char *skipBlanks(const char *cursor, const char *end)
+    {
+        while (cursor < end && isBlank(*cursor))
+            ++cursor;
+        return cursor;
+    }
+
+    // Reads the next whitespace-separated number of the line, like operator>> would
+    template <typename T>
+    bool parseNumber(const char *&cursor, const char *end, T &value)
+    {
+        cursor = skipBlanks(cursor, end);
+        if (cursor < end && *cursor == '+')
+            ++cursor; // from_chars rejects an explicit plus sign, streams accept it
+        std::from_chars_result result = std::from_chars(cursor, end, value);
+        if (result.ec != std::errc())
+            return false;
+        cursor = result.ptr;
+        return true;
+    }
+}
+
+Model::Model() : isModified(false), revision(0), selectedVertexIndex(-1), disableVisibilityCheck(false),
+                 topologyChanged(false), meshArraysValid(false), meshAdjacencyValid(false),
+                 occlusionBVHValid(false), vertexBVHValid(false), pendingDeletes(false), binaryCacheEnabled(false)
 {
 }
 
@@ -20,38 +94,58 @@ bool Model::loadFromFile(const std::string &filePath)
     }
 
     // Check file extension
-    if (filePath.substr(filePath.find_last_of(".") + 1) != "fjwr")
+    std::string extension = Utils::getFileExtension(filePath);
+    if (extension == "fjwb")
     {
-        Utils::logError("Unsupported file format. Expected .fjwr");
-        return false;
+        if (!loadBinaryFile(filePath, false, 0, 0))
+        {
+            Utils::logError("Failed to read .fjwb file: " + filePath);
+            return false;
+        }
     }
-
-    std::ifstream file(filePath);
-    if (!file.is_open())
+    else if (extension != "fjwr")
     {
-        Utils::logError("Cannot open file: " + filePath);
+        Utils::logError("Unsupported file format. Expected .fjwr");
         return false;
     }
+    else
+    {
+        int64_t sourceTime = 0;
+        uint64_t sourceSize = 0;
+        bool hasStamp = getSourceStamp(filePath, sourceTime, sourceSize);
+        std::string cachePath = getBinaryCachePath(filePath);
+
+        bool cached = binaryCacheEnabled && hasStamp && Utils::fileExists(cachePath) &&
+                      loadBinaryFile(cachePath, true, sourceTime, sourceSize);
+        if (!cached)
+        {
+            MappedFile file;
+            if (!file.open(filePath))
+            {
+                Utils::logError("Cannot open file: " + filePath);
+                return false;
+            }
+
+            if (!parseFjwrFile(file.data(), file.size()))
+            {
+                Utils::logError("Failed to parse .fjwr file: " + filePath);
+                return false;
+            }
 
-    // Read entire file content
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    file.close();
+            // Calculate normals and generate edges
+            calculateNormals();
+            generateEdgesFromFaces();
 
-    std::string content = buffer.str();
-    if (!parseFjwrFile(content))
-    {
-        Utils::logError("Failed to parse .fjwr file: " + filePath);
-        return false;
+            if (binaryCacheEnabled && hasStamp && sourceSize >= BINARY_CACHE_MIN_BYTES)
+            {
+                writeBinaryFile(cachePath, sourceTime, sourceSize);
+            }
+        }
     }
 
     filename = filePath;
     isModified = false;
 
-    // Calculate normals and generate edges
-    calculateNormals();
-    generateEdgesFromFaces();
-
     Utils::logInfo("Loaded model from " + filePath +
                    " (vertices: " + std::to_string(vertices.size()) +
                    ", faces: " + std::to_string(faces.size()) +
@@ -62,16 +156,19 @@ bool Model::loadFromFile(const std::string &filePath)
 
 bool Model::saveToFile(const std::string &filePath)
 {
-    std::ofstream file(filePath);
-    if (!file.is_open())
+    if (Utils::getFileExtension(filePath) == "fjwb")
     {
-        Utils::logError("Cannot create file: " + filePath);
-        return false;
+        if (!writeBinaryFile(filePath, 0, 0))
+            return false;
+
+        filename = filePath;
+        isModified = false;
+        Utils::logInfo("Saved model to " + filePath);
+        return true;
     }
 
-    std::string content = generateFjwrContent();
-    file << content;
-    file.close();
+    if (!writeFjwrFile(filePath, vertices, faces, edges))
+        return false;
 
     filename = filePath;
     isModified = false;
@@ -80,27 +177,49 @@ bool Model::saveToFile(const std::string &filePath)
     return true;
 }
 
+void Model::markSaved(const std::string &filePath, uint64_t savedRevision)
+{
+    filename = filePath;
+    isModified = savedRevision != revision; // Edits made while saving still need a save
+}
+
 bool Model::saveAs(const std::string &filePath)
 {
     return saveToFile(filePath);
 }
 
+void Model::reserve(int vertexCount, int faceCount, int edgeCount)
+{
+    vertices.reserve(std::max(vertexCount, 0));
+    faces.reserve(std::max(faceCount, 0));
+    edges.reserve(std::max(edgeCount, 0));
+}
+
 void Model::addVertex(const Vertex &vertex)
 {
     vertices.push_back(vertex);
+    if (meshAdjacencyValid)
+        meshAdjacency.addVertex();
     markAsModified();
+    markTopologyChanged();
 }
 
 void Model::addVertex(const Vector3 &position)
 {
     vertices.emplace_back(position);
+    if (meshAdjacencyValid)
+        meshAdjacency.addVertex();
     markAsModified();
+    markTopologyChanged();
 }
 
 void Model::addVertex(float x, float y, float z)
 {
     vertices.emplace_back(x, y, z);
+    if (meshAdjacencyValid)
+        meshAdjacency.addVertex();
     markAsModified();
+    markTopologyChanged();
 }
 
 void Model::addFace(const Face &face)
@@ -108,7 +227,10 @@ void Model::addFace(const Face &face)
     if (isFaceValid(face))
     {
         faces.push_back(face);
+        if (meshAdjacencyValid)
+            meshAdjacency.addFace(face);
         markAsModified();
+        markTopologyChanged();
     }
     else
     {
@@ -128,7 +250,10 @@ void Model::addEdge(const Edge &edge)
     if (isEdgeValid(edge))
     {
         edges.push_back(edge);
+        if (meshAdjacencyValid)
+            meshAdjacency.addLine(edge);
         markAsModified();
+        markTopologyChanged();
     }
     else
     {
@@ -150,51 +275,165 @@ void Model::removeVertex(int index)
         return;
     }
 
-    vertices.erase(vertices.begin() + index);
+    markVertexDeleted(index);
+    compactDeleted();
+}
 
-    // Remove faces and edges that reference this vertex
-    faces.erase(std::remove_if(faces.begin(), faces.end(),
-                               [index](const Face &face)
-                               {
-                                   return face.v1 == index || face.v2 == index || face.v3 == index;
-                               }),
-                faces.end());
+void Model::removeVertices(const std::vector<int> &indices)
+{
+    for (int index : indices)
+    {
+        markVertexDeleted(index);
+    }
+    compactDeleted();
+}
 
-    edges.erase(std::remove_if(edges.begin(), edges.end(),
-                               [index](const Edge &edge)
-                               {
-                                   return edge.v1 == index || edge.v2 == index;
-                               }),
-                edges.end());
+void Model::removeFaces(const std::vector<int> &indices)
+{
+    for (int index : indices)
+    {
+        markFaceDeleted(index);
+    }
+    compactDeleted();
+}
 
-    // Update indices in remaining faces and edges
-    for (auto &face : faces)
+void Model::markVertexDeleted(int index)
+{
+    if (!isVertexIndexValid(index))
     {
-        if (face.v1 > index)
-            face.v1--;
-        if (face.v2 > index)
-            face.v2--;
-        if (face.v3 > index)
-            face.v3--;
+        Utils::logError("Invalid vertex index: " + std::to_string(index));
+        return;
     }
+    if (isVertexDeleted(index))
+        return;
 
-    for (auto &edge : edges)
+    // Tombstones leave every index in place, so the adjacency stays valid across marks; marked faces
+    // and edges are unlinked from it, so a neighbouring vertex marked next only walks live ones
+    getMeshAdjacency();
+    vertexDeleted.resize(vertices.size(), 0);
+    faceDeleted.resize(faces.size(), 0);
+    edgeDeleted.resize(edges.size(), 0);
+
+    vertexDeleted[index] = 1;
+    incidentScratch.clear();
+    meshAdjacency.forEachVertexFace(index, [this](int face) { incidentScratch.push_back(face); });
+    for (int face : incidentScratch)
     {
-        if (edge.v1 > index)
-            edge.v1--;
-        if (edge.v2 > index)
-            edge.v2--;
+        faceDeleted[face] = 1;
+        meshAdjacency.removeFace(face);
     }
+    incidentScratch.clear();
+    meshAdjacency.forEachVertexLine(index, [this](int edge) { incidentScratch.push_back(edge); });
+    for (int edge : incidentScratch)
+    {
+        edgeDeleted[edge] = 1;
+        meshAdjacency.removeLine(edge);
+    }
+    pendingDeletes = true;
+}
+
+void Model::markFaceDeleted(int index)
+{
+    if (index < 0 || index >= static_cast<int>(faces.size()))
+    {
+        Utils::logError("Invalid face index: " + std::to_string(index));
+        return;
+    }
+
+    faceDeleted.resize(faces.size(), 0);
+    faceDeleted[index] = 1;
+    if (meshAdjacencyValid)
+        meshAdjacency.removeFace(index);
+    pendingDeletes = true;
+}
+
+bool Model::isVertexDeleted(int index) const
+{
+    return index >= 0 && index < static_cast<int>(vertexDeleted.size()) && vertexDeleted[index];
+}
+
+bool Model::isFaceDeleted(int index) const
+{
+    return index >= 0 && index < static_cast<int>(faceDeleted.size()) && faceDeleted[index];
+}
+
+void Model::compactDeleted()
+{
+    if (!pendingDeletes)
+        return;
+
+    // Surviving vertices move down in order; remap[old] = new index, -1 = deleted
+    const int oldVertexCount = static_cast<int>(vertices.size());
+    std::vector<int> remap(oldVertexCount, -1);
+    int keptVertices = 0;
+    for (int i = 0; i < oldVertexCount; ++i)
+    {
+        if (isVertexDeleted(i))
+            continue;
+        remap[i] = keptVertices;
+        vertices[keptVertices++] = vertices[i];
+    }
+    vertices.resize(keptVertices);
+
+    auto mapIndex = [&](int &vertexIndex)
+    {
+        vertexIndex = vertexIndex >= 0 && vertexIndex < oldVertexCount ? remap[vertexIndex] : -1;
+        return vertexIndex >= 0;
+    };
+
+    std::vector<int> faceRemap(faces.size(), -1);
+    int keptFaces = 0;
+    for (int i = 0; i < static_cast<int>(faces.size()); ++i)
+    {
+        Face face = faces[i];
+        if (isFaceDeleted(i) || !mapIndex(face.v1) || !mapIndex(face.v2) || !mapIndex(face.v3))
+            continue;
+        faceRemap[i] = keptFaces;
+        faces[keptFaces++] = face;
+    }
+    faces.resize(keptFaces);
+
+    std::vector<int> edgeRemap(edges.size(), -1);
+    int keptEdges = 0;
+    for (int i = 0; i < static_cast<int>(edges.size()); ++i)
+    {
+        Edge edge = edges[i];
+        bool marked = i < static_cast<int>(edgeDeleted.size()) && edgeDeleted[i];
+        if (marked || !mapIndex(edge.v1) || !mapIndex(edge.v2))
+            continue;
+        edgeRemap[i] = keptEdges;
+        edges[keptEdges++] = edge;
+    }
+    edges.resize(keptEdges);
+
+    // Same pass over the adjacency: dropped elements are unlinked, the rest renumbered in place
+    if (meshAdjacencyValid)
+    {
+        meshAdjacency.compact(remap, faceRemap, edgeRemap);
+    }
+
+    if (selectedVertexIndex >= 0)
+    {
+        selectedVertexIndex = selectedVertexIndex < oldVertexCount ? remap[selectedVertexIndex] : -1;
+    }
+
+    vertexDeleted.clear();
+    faceDeleted.clear();
+    edgeDeleted.clear();
+    pendingDeletes = false;
 
     markAsModified();
+    markTopologyChanged();
 }
 
 void Model::removeFace(int index)
 {
     if (index >= 0 && index < static_cast<int>(faces.size()))
     {
-        faces.erase(faces.begin() + index);
-        markAsModified();
+        // Through the tombstones, so later faces move down in one pass over the arrays and the
+        // adjacency instead of an erase here and a renumbering there
+        markFaceDeleted(index);
+        compactDeleted();
     }
     else
     {
@@ -206,8 +445,12 @@ void Model::removeEdge(int index)
 {
     if (index >= 0 && index < static_cast<int>(edges.size()))
     {
-        edges.erase(edges.begin() + index);
-        markAsModified();
+        edgeDeleted.resize(edges.size(), 0);
+        edgeDeleted[index] = 1;
+        if (meshAdjacencyValid)
+            meshAdjacency.removeLine(index);
+        pendingDeletes = true;
+        compactDeleted();
     }
     else
     {
@@ -220,7 +463,32 @@ void Model::setVertexPosition(int index, const Vector3 &position)
     if (isVertexIndexValid(index))
     {
         vertices[index].position = position;
-        calculateNormals(); // Recalculate normals when vertex moves
+        markMeshArraysChanged(index);
+
+        // Moving a vertex changes the normals of its faces, and so of every vertex on them (the one-ring)
+        const MeshAdjacency &adjacency = getMeshAdjacency();
+        adjacency.forEachVertexFace(index, [this](int faceIndex)
+                                    {
+                                        const Face &face = faces[faceIndex];
+                                        updateVertexNormal(face.v1);
+                                        updateVertexNormal(face.v2);
+                                        updateVertexNormal(face.v3);
+                                    });
+
+        if (vertexBVHValid)
+        {
+            vertexBVH.update(index, position);
+        }
+        if (occlusionBVHValid)
+        {
+            adjacency.forEachVertexFace(index, [this](int faceIndex) { occlusionPendingFaces.push_back(faceIndex); });
+        }
+
+        if (!topologyChanged && !vertexChangedFlag[index])
+        {
+            vertexChangedFlag[index] = 1;
+            changedVertices.push_back(index);
+        }
         markAsModified();
     }
     else
@@ -249,10 +517,150 @@ void Model::clear()
     edges.clear();
     filename.clear();
     isModified = false;
+    meshAdjacency.clear();
+    meshAdjacencyValid = false;
+    vertexDeleted.clear();
+    faceDeleted.clear();
+    edgeDeleted.clear();
+    pendingDeletes = false;
+    markTopologyChanged();
+}
+
+MeshView Model::getMeshView() const
+{
+    if (!meshArraysValid)
+    {
+        meshArrays.resize(static_cast<int>(vertices.size()));
+        for (int i = 0; i < static_cast<int>(vertices.size()); ++i)
+        {
+            meshArrays.setVertex(i, vertices[i].position, vertices[i].normal);
+        }
+        meshArraysValid = true;
+    }
+    else
+    {
+        for (int index : meshArraysPending)
+        {
+            meshArrays.setVertex(index, vertices[index].position, vertices[index].normal);
+        }
+    }
+    meshArraysPending.clear();
+    return meshArrays.getView(faces.data(), static_cast<int>(faces.size()));
+}
+
+void Model::markMeshArraysChanged(int index)
+{
+    if (!meshArraysValid)
+        return;
+
+    // A long run of edits without a sync is cheaper to refill than to replay
+    if (meshArraysPending.size() >= vertices.size())
+    {
+        meshArraysValid = false;
+        meshArraysPending.clear();
+        return;
+    }
+    meshArraysPending.push_back(index);
+}
+
+const MeshAdjacency &Model::getMeshAdjacency()
+{
+    if (!meshAdjacencyValid)
+    {
+        meshAdjacency.build(faces, edges, static_cast<int>(vertices.size()));
+        meshAdjacencyValid = true;
+
+        // Faces and edges already marked are unlinked, as if the adjacency had been there when they were
+        for (int i = 0; i < static_cast<int>(faceDeleted.size()); ++i)
+        {
+            if (faceDeleted[i])
+                meshAdjacency.removeFace(i);
+        }
+        for (int i = 0; i < static_cast<int>(edgeDeleted.size()); ++i)
+        {
+            if (edgeDeleted[i])
+                meshAdjacency.removeLine(i);
+        }
+    }
+    return meshAdjacency;
+}
+
+void Model::markTopologyChanged()
+{
+    // Indices may have shifted, so per-vertex tracking is meaningless until the next clearChanges()
+    topologyChanged = true;
+    meshArraysValid = false;
+    occlusionBVHValid = false;
+    vertexBVHValid = false;
+    changedVertices.clear();
+    vertexChangedFlag.clear();
+}
+
+void Model::clearChanges()
+{
+    topologyChanged = false;
+    changedVertices.clear();
+    vertexChangedFlag.assign(vertices.size(), 0);
+}
+
+void Model::collectChangedIncident(bool collectFaces, std::vector<int> &result)
+{
+    const MeshAdjacency &adjacency = getMeshAdjacency();
+    auto collect = [&result](int index) { result.push_back(index); };
+
+    result.clear();
+    for (int vertexIndex : changedVertices)
+    {
+        if (collectFaces)
+            adjacency.forEachVertexFace(vertexIndex, collect);
+        else
+            adjacency.forEachVertexLine(vertexIndex, collect);
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+void Model::getChangedFaces(std::vector<int> &faceIndices)
+{
+    collectChangedIncident(true, faceIndices);
+}
+
+void Model::getChangedEdges(std::vector<int> &edgeIndices)
+{
+    collectChangedIncident(false, edgeIndices);
+}
+
+Vector3 Model::calculateFaceNormal(const Face &face) const
+{
+    // CCW = front face
+    const Vector3 &v0 = vertices[face.v1].position;
+    const Vector3 &v1 = vertices[face.v2].position;
+    const Vector3 &v2 = vertices[face.v3].position;
+    return Vector3::cross(v1 - v0, v2 - v0).normalized();
+}
+
+void Model::updateVertexNormal(int index)
+{
+    // Same accumulation order (ascending faces) and fallback as calculateNormals(), so both give identical normals
+    incidentScratch.clear();
+    meshAdjacency.forEachVertexFace(index, [this](int face) { incidentScratch.push_back(face); });
+    std::sort(incidentScratch.begin(), incidentScratch.end());
+
+    Vector3 normal(0, 0, 0);
+    for (int face : incidentScratch)
+    {
+        normal = normal + calculateFaceNormal(faces[face]);
+    }
+
+    float length = normal.length();
+    vertices[index].normal = length > 0.001f ? normal / length : Vector3(0, 0, 1);
+    markMeshArraysChanged(index);
 }
 
 void Model::calculateNormals()
 {
+    meshArraysValid = false;
+
     // Reset all normals to zero
     for (auto &vertex : vertices)
     {
@@ -265,14 +673,7 @@ void Model::calculateNormals()
         if (!isFaceValid(face))
             continue;
 
-        const Vector3 &v0 = vertices[face.v1].position;
-        const Vector3 &v1 = vertices[face.v2].position;
-        const Vector3 &v2 = vertices[face.v3].position;
-
-        // Calculate face normal (CCW = front face)
-        Vector3 edge1 = v1 - v0;
-        Vector3 edge2 = v2 - v0;
-        Vector3 faceNormal = Vector3::cross(edge1, edge2).normalized();
+        Vector3 faceNormal = calculateFaceNormal(face);
 
         // Accumulate to vertex normals
         vertices[face.v1].normal = vertices[face.v1].normal + faceNormal;
@@ -424,37 +825,58 @@ bool Model::isEdgeValid(const Edge &edge) const
            edge.v1 != edge.v2;
 }
 
-bool Model::parseFjwrFile(const std::string &content)
+bool Model::parseFjwrFile(const char *data, size_t size)
 {
     clear();
 
-    std::istringstream stream(content);
-    std::string line;
-    int lineNumber = 0;
+    const char *const end = data + size;
 
-    while (std::getline(stream, line))
+    // Pre-scan: count vertex and face records so the arrays are allocated once
+    size_t vertexRecords = 0;
+    size_t faceRecords = 0;
+    for (const char *line = data; line < end;)
     {
-        lineNumber++;
+        const char *lineEnd = static_cast<const char *>(std::memchr(line, '\n', end - line));
+        if (!lineEnd)
+            lineEnd = end;
+        const char *first = skipBlanks(line, lineEnd);
+        if (first + 1 < lineEnd && isBlank(first[1]))
+        {
+            vertexRecords += (*first == 'v');
+            faceRecords += (*first == 'f');
+        }
+        line = lineEnd + 1;
+    }
+    vertices.reserve(vertexRecords);
+    faces.reserve(faceRecords);
 
-        // Remove leading/trailing whitespace
-        line.erase(0, line.find_first_not_of(" \t\r\n"));
-        line.erase(line.find_last_not_of(" \t\r\n") + 1);
+    int lineNumber = 0;
+    for (const char *line = data; line < end;)
+    {
+        const char *lineEnd = static_cast<const char *>(std::memchr(line, '\n', end - line));
+        if (!lineEnd)
+            lineEnd = end;
+        const char *cursor = skipBlanks(line, lineEnd);
+        line = lineEnd + 1;
+        lineNumber++;
 
         // Skip empty lines and comments
-        if (line.empty() || line[0] == '#')
+        if (cursor == lineEnd || *cursor == '#')
         {
             continue;
         }
 
-        std::istringstream lineStream(line);
-        std::string type;
-        lineStream >> type;
+        const char *typeEnd = cursor;
+        while (typeEnd < lineEnd && !isBlank(*typeEnd))
+            ++typeEnd;
+        std::string_view type(cursor, typeEnd - cursor);
+        cursor = typeEnd;
 
         if (type == "v")
         {
             // Vertex: v x y z
             float x, y, z;
-            if (lineStream >> x >> y >> z)
+            if (parseNumber(cursor, lineEnd, x) && parseNumber(cursor, lineEnd, y) && parseNumber(cursor, lineEnd, z))
             {
                 addVertex(x, y, z);
             }
@@ -468,7 +890,7 @@ bool Model::parseFjwrFile(const std::string &content)
         {
             // Face: f v1 v2 v3
             int v1, v2, v3;
-            if (lineStream >> v1 >> v2 >> v3)
+            if (parseNumber(cursor, lineEnd, v1) && parseNumber(cursor, lineEnd, v2) && parseNumber(cursor, lineEnd, v3))
             {
                 addFace(v1, v2, v3);
             }
@@ -482,7 +904,7 @@ bool Model::parseFjwrFile(const std::string &content)
         {
             // Edge: l v1 v2
             int v1, v2;
-            if (lineStream >> v1 >> v2)
+            if (parseNumber(cursor, lineEnd, v1) && parseNumber(cursor, lineEnd, v2))
             {
                 addEdge(v1, v2);
             }
@@ -494,7 +916,7 @@ bool Model::parseFjwrFile(const std::string &content)
         }
         else
         {
-            Utils::logError("Unknown line type '" + type + "' at line " + std::to_string(lineNumber));
+            Utils::logError("Unknown line type '" + std::string(type) + "' at line " + std::to_string(lineNumber));
             return false;
         }
     }
@@ -502,81 +924,199 @@ bool Model::parseFjwrFile(const std::string &content)
     return true;
 }
 
-std::string Model::generateFjwrContent() const
+std::string Model::getBinaryCachePath(const std::string &filePath)
+{
+    size_t lastDot = filePath.find_last_of('.');
+    size_t lastSeparator = filePath.find_last_of("/\\");
+    if (lastDot == std::string::npos || (lastSeparator != std::string::npos && lastDot < lastSeparator))
+    {
+        return filePath + ".fjwb";
+    }
+    return filePath.substr(0, lastDot) + ".fjwb";
+}
+
+bool Model::loadBinaryFile(const std::string &filePath, bool checkSource, int64_t sourceTime, uint64_t sourceSize)
+{
+    MappedFile file;
+    if (!file.open(filePath) || file.size() < sizeof(FjwbHeader))
+        return false;
+
+    FjwbHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, FJWB_MAGIC, sizeof(FJWB_MAGIC)) != 0 || header.version != FJWB_VERSION ||
+        header.byteOrder != FJWB_BYTE_ORDER)
+        return false;
+
+    // Stale cache: the text file changed since the sidecar was written
+    if (checkSource && (header.sourceTime != sourceTime || header.sourceSize != sourceSize))
+        return false;
+
+    const uint64_t vertexBytes = uint64_t(header.vertexCount) * 3 * sizeof(float);
+    const uint64_t faceBytes = uint64_t(header.faceCount) * sizeof(Face);
+    const uint64_t edgeBytes = uint64_t(header.edgeCount) * sizeof(Edge);
+    if (file.size() != sizeof(FjwbHeader) + vertexBytes + faceBytes + edgeBytes)
+        return false;
+
+    const char *cursor = file.data() + sizeof(FjwbHeader);
+    const char *faceData = cursor + vertexBytes;
+    const char *edgeData = faceData + faceBytes;
+
+    // Validate before touching the model so a corrupt file leaves it unchanged
+    const int vertexCount = static_cast<int>(header.vertexCount);
+    for (uint32_t i = 0; i < header.faceCount * 3; ++i)
+    {
+        int32_t index;
+        std::memcpy(&index, faceData + i * sizeof(int32_t), sizeof(index));
+        if (index < 0 || index >= vertexCount)
+            return false;
+    }
+    for (uint32_t i = 0; i < header.edgeCount * 2; ++i)
+    {
+        int32_t index;
+        std::memcpy(&index, edgeData + i * sizeof(int32_t), sizeof(index));
+        if (index < 0 || index >= vertexCount)
+            return false;
+    }
+
+    clear();
+    vertices.reserve(header.vertexCount);
+    for (uint32_t i = 0; i < header.vertexCount; ++i)
+    {
+        float position[3];
+        std::memcpy(position, cursor + i * sizeof(position), sizeof(position));
+        vertices.emplace_back(position[0], position[1], position[2]);
+    }
+    faces.resize(header.faceCount);
+    if (faceBytes > 0)
+        std::memcpy(faces.data(), faceData, faceBytes);
+    edges.resize(header.edgeCount);
+    if (edgeBytes > 0)
+        std::memcpy(edges.data(), edgeData, edgeBytes);
+
+    markTopologyChanged();
+    calculateNormals();
+    return true;
+}
+
+bool Model::writeBinaryFile(const std::string &filePath, int64_t sourceTime, uint64_t sourceSize) const
+{
+    FjwbHeader header;
+    std::memcpy(header.magic, FJWB_MAGIC, sizeof(FJWB_MAGIC));
+    header.version = FJWB_VERSION;
+    header.byteOrder = FJWB_BYTE_ORDER;
+    header.vertexCount = static_cast<uint32_t>(vertices.size());
+    header.faceCount = static_cast<uint32_t>(faces.size());
+    header.edgeCount = static_cast<uint32_t>(edges.size());
+    header.sourceTime = sourceTime;
+    header.sourceSize = sourceSize;
+
+    std::vector<float> positions;
+    positions.reserve(vertices.size() * 3);
+    for (const auto &vertex : vertices)
+    {
+        positions.push_back(vertex.position.x);
+        positions.push_back(vertex.position.y);
+        positions.push_back(vertex.position.z);
+    }
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        Utils::logError("Cannot write binary cache: " + filePath);
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(positions.data()), positions.size() * sizeof(float));
+    file.write(reinterpret_cast<const char *>(faces.data()), faces.size() * sizeof(Face));
+    file.write(reinterpret_cast<const char *>(edges.data()), edges.size() * sizeof(Edge));
+    if (!file)
+    {
+        Utils::logError("Failed to write binary cache: " + filePath);
+        file.close();
+        std::remove(filePath.c_str()); // Never leave a truncated cache behind
+        return false;
+    }
+    return true;
+}
+
+bool Model::writeFjwrFile(const std::string &filePath, const std::vector<Vertex> &vertices,
+                          const std::vector<Face> &faces, const std::vector<Edge> &edges)
 {
-    std::ostringstream content;
+    ChunkedWriter writer;
+    if (!writer.open(filePath))
+    {
+        Utils::logError("Cannot create file: " + filePath);
+        return false;
+    }
 
-    content << "# 3D Model exported from 3D Model Editor\n";
-    content << "# Format: .fjwr (Fujiwara format)\n";
-    content << "# v x y z          - vertex\n";
-    content << "# f v1 v2 v3       - face (CCW winding)\n";
-    content << "# l v1 v2          - edge\n\n";
+    writer.write("# 3D Model exported from 3D Model Editor\n");
+    writer.write("# Format: .fjwr (Fujiwara format)\n");
+    writer.write("# v x y z          - vertex\n");
+    writer.write("# f v1 v2 v3       - face (CCW winding)\n");
+    writer.write("# l v1 v2          - edge\n\n");
 
     // Write vertices
     for (const auto &vertex : vertices)
     {
-        content << "v " << vertex.position.x << " "
-                << vertex.position.y << " "
-                << vertex.position.z << "\n";
+        writer.write("v ");
+        writer.writeFloat(vertex.position.x);
+        writer.put(' ');
+        writer.writeFloat(vertex.position.y);
+        writer.put(' ');
+        writer.writeFloat(vertex.position.z);
+        writer.put('\n');
     }
 
     if (!vertices.empty() && !faces.empty())
     {
-        content << "\n";
+        writer.put('\n');
     }
 
     // Write faces
     for (const auto &face : faces)
     {
-        content << "f " << face.v1 << " " << face.v2 << " " << face.v3 << "\n";
+        writer.write("f ");
+        writer.writeInt(face.v1);
+        writer.put(' ');
+        writer.writeInt(face.v2);
+        writer.put(' ');
+        writer.writeInt(face.v3);
+        writer.put('\n');
     }
 
     if (!faces.empty() && !edges.empty())
     {
-        content << "\n";
+        writer.put('\n');
     }
 
     // Write edges
     for (const auto &edge : edges)
     {
-        content << "l " << edge.v1 << " " << edge.v2 << "\n";
+        writer.write("l ");
+        writer.writeInt(edge.v1);
+        writer.put(' ');
+        writer.writeInt(edge.v2);
+        writer.put('\n');
     }
 
-    return content.str();
+    if (!writer.close())
+    {
+        Utils::logError("Failed to write file: " + filePath);
+        return false;
+    }
+    return true;
 }
 
 void Model::generateEdgesFromFaces()
 {
-    std::set<std::pair<int, int>> edgeSet;
-
-    // Generate edges from all faces
-    for (const auto &face : faces)
-    {
-        if (!isFaceValid(face))
-            continue;
-
-        // Add three edges of the triangle
-        auto addEdgeToSet = [&](int v1, int v2)
-        {
-            if (v1 > v2)
-                std::swap(v1, v2); // Normalize order
-            edgeSet.insert({v1, v2});
-        };
-
-        addEdgeToSet(face.v1, face.v2);
-        addEdgeToSet(face.v2, face.v3);
-        addEdgeToSet(face.v3, face.v1);
-    }
-
     // Clear existing auto-generated edges and add new ones
     // Note: This will remove manually added edges too
     // In the future, we might want to distinguish between auto and manual edges
-    edges.clear();
-
-    for (const auto &edgePair : edgeSet)
-    {
-        edges.emplace_back(edgePair.first, edgePair.second);
-    }
+    getMeshAdjacency().getSortedEdges(edges);
+    meshAdjacency.setLines(edges);
+    edgeDeleted.clear(); // Edges of deleted vertices are still dropped by their vertex tombstones
+    markTopologyChanged();
 }
 
 // Selection system implementation
@@ -620,27 +1160,34 @@ bool Model::selectVertex(const Ray &ray, const Camera &camera, float baseThresho
     float cameraDistance = camera.getDistance();
     float dynamicThreshold = baseThreshold * cameraDistance * 0.1f;
 
-    // Find closest vertex intersection with visibility check
-    int closestVertexIndex = -1;
-    float closestDistance = std::numeric_limits<float>::max();
-
-    for (size_t i = 0; i < vertices.size(); ++i)
-    {
-        const Vector3 &vertexPos = vertices[i].position;
+    // Cull by the pick threshold first (vertex BVH); only the few vertices near the ray need an occlusion test
+    std::vector<VertexHit> candidates;
+    findVerticesNearRay(ray, dynamicThreshold, 0.0f, candidates);
 
-        // Check if vertex is visible (not occluded by faces) - unless disabled
-        if (!disableVisibilityCheck && !RayIntersection::isVertexVisible(camera.getPosition(), vertexPos, *this))
-        {
-            continue; // Skip occluded vertices
-        }
+    // Closest visible candidate wins (stable sort keeps the lower index on equal distances)
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const VertexHit &a, const VertexHit &b)
+                     { return a.distance < b.distance; });
 
-        // Check intersection with threshold
-        VertexHit hit = RayIntersection::intersectVertex(ray, vertexPos, dynamicThreshold, static_cast<int>(i));
+    // Check which candidates are visible (not occluded by faces) - unless disabled
+    std::vector<int> candidateIndices(candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        candidateIndices[i] = candidates[i].vertexIndex;
+    }
+    std::vector<uint8_t> visible(candidates.size(), 1);
+    if (!disableVisibilityCheck && !candidates.empty())
+    {
+        getVertexVisibility(camera.getPosition(), candidateIndices, visible);
+    }
 
-        if (hit.hit && hit.distance < closestDistance)
+    int closestVertexIndex = -1;
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        if (visible[i])
         {
-            closestDistance = hit.distance;
-            closestVertexIndex = hit.vertexIndex;
+            closestVertexIndex = candidateIndices[i];
+            break;
         }
     }
 
@@ -669,4 +1216,106 @@ bool Model::selectVertex(const Ray &ray, const Camera &camera, float baseThresho
     // Select the closest vertex
     setSelectedVertex(closestVertexIndex);
     return true; // Selection changed
+}
+
+void Model::updateOcclusionBVH()
+{
+    if (!occlusionBVHValid)
+    {
+        occlusionTriangles.resize(faces.size());
+        for (size_t i = 0; i < faces.size(); ++i)
+        {
+            const Face &face = faces[i];
+            occlusionTriangles[i] = isFaceValid(face)
+                                        ? Triangle(vertices[face.v1].position, vertices[face.v2].position, vertices[face.v3].position)
+                                        : Triangle(); // Degenerate, never hit
+        }
+        occlusionBVH.build(occlusionTriangles);
+        occlusionPendingFaces.clear();
+        occlusionBVHValid = true;
+        return;
+    }
+
+    if (occlusionPendingFaces.empty())
+        return;
+
+    for (int faceIndex : occlusionPendingFaces)
+    {
+        const Face &face = faces[faceIndex];
+        occlusionTriangles[faceIndex] = Triangle(vertices[face.v1].position, vertices[face.v2].position, vertices[face.v3].position);
+    }
+    occlusionBVH.refit(occlusionTriangles, occlusionPendingFaces);
+    occlusionPendingFaces.clear();
+}
+
+void Model::updateVertexBVH() const
+{
+    if (vertexBVHValid)
+    {
+        // Refits keep queries exact; rebuild once moves have loosened the tree noticeably
+        if (vertexBVH.getRefitGrowth() <= VERTEX_BVH_MAX_REFIT_GROWTH)
+            return;
+        Utils::logInfo("Rebuilding vertex BVH after moves");
+    }
+
+    std::vector<Vector3> positions(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        positions[i] = vertices[i].position;
+    }
+    vertexBVH.build(positions);
+    vertexBVHValid = true;
+}
+
+void Model::findVerticesNearRay(const Ray &ray, float radius, float spread, std::vector<VertexHit> &hits) const
+{
+    updateVertexBVH();
+    vertexBVH.findNearRay(ray, radius, spread, hits);
+}
+
+int Model::findNearestVertex(const Vector3 &position, float maxDistance) const
+{
+    updateVertexBVH();
+    return vertexBVH.findNearest(position, maxDistance);
+}
+
+void Model::getVertexVisibility(const Vector3 &cameraPos, const std::vector<int> &vertexIndices, std::vector<uint8_t> &visible,
+                                ThreadPool *pool)
+{
+    updateOcclusionBVH();
+
+    // Same rule as RayIntersection::isVertexVisible: only hits more than 0.05 in front of the vertex
+    // occlude it. Faces through the vertex are hit at the vertex itself, so they never count.
+    visible.assign(vertexIndices.size(), 1);
+    std::vector<BatchRay> rays;
+    std::vector<int> rayEntries; // Ray -> entry of vertexIndices
+    rays.reserve(vertexIndices.size());
+    rayEntries.reserve(vertexIndices.size());
+    for (size_t i = 0; i < vertexIndices.size(); ++i)
+    {
+        if (!isVertexIndexValid(vertexIndices[i]))
+        {
+            visible[i] = 0;
+            continue;
+        }
+
+        const Vector3 toVertex = vertices[vertexIndices[i]].position - cameraPos;
+        const float targetDistance = toVertex.length();
+        if (targetDistance <= 0.05f)
+            continue;
+
+        BatchRay visibilityRay;
+        visibilityRay.ray = Ray::fromUnitDirection(cameraPos, toVertex / targetDistance);
+        visibilityRay.maxDistance = targetDistance - 0.05f;
+        rays.push_back(visibilityRay);
+        rayEntries.push_back(static_cast<int>(i));
+    }
+
+    std::vector<uint8_t> occluded;
+    RayIntersection::occludedBatch(occlusionBVH, rays, 0.0f, occluded, pool);
+    for (size_t ray = 0; ray < rays.size(); ++ray)
+    {
+        if (occluded[ray])
+            visible[rayEntries[ray]] = 0;
+    }
 }
\ No newline at end of file
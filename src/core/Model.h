@@ -1,12 +1,17 @@
 #pragma once
 
 #include "../math/Vector3.h"
+#include "BVH.h"
+#include "VertexBVH.h"
+#include "MeshAdjacency.h"
+#include "MeshArrays.h"
 #include <vector>
 #include <string>
+#include <cstdint>
 
 // Forward declarations
-struct Ray;
 class Camera;
+class ThreadPool;
 
 // Data structures for 3D model representation
 struct Vertex
@@ -44,6 +49,7 @@ private:
 
     std::string filename;
     bool isModified;
+    uint64_t revision; // Bumped on every edit, so a background save can tell whether it is still current
 
     // Selection state
     int selectedVertexIndex;
@@ -51,6 +57,43 @@ private:
     // Debug mode: disable visibility check for easier selection
     bool disableVisibilityCheck;
 
+    // Change set since the last clearChanges(), so views can patch instead of reloading
+    bool topologyChanged;                // Vertices, faces or edges were added, removed or replaced
+    std::vector<int> changedVertices;    // Moved vertices, each listed once
+    std::vector<char> vertexChangedFlag; // Per vertex, set while it is in changedVertices
+
+    // Structure-of-arrays positions and normals for streaming kernels, synced on demand:
+    // moved vertices and their one-ring are patched, anything else refills them
+    mutable MeshArrays meshArrays;
+    mutable bool meshArraysValid;
+    mutable std::vector<int> meshArraysPending; // Vertices changed since the last getMeshView()
+
+    // Face edges with edge/vertex -> face and vertex -> edge incidence, built on first use and then
+    // updated in place by every add, removal and compaction
+    MeshAdjacency meshAdjacency;
+    bool meshAdjacencyValid;
+    std::vector<int> incidentScratch; // Faces or edges at one vertex, for ordered traversal
+
+    // Face BVH for selection occlusion queries, built on first use and refitted on vertex moves
+    BVH occlusionBVH;
+    bool occlusionBVHValid;
+    std::vector<Triangle> occlusionTriangles; // One per face, same order
+    std::vector<int> occlusionPendingFaces;   // Faces moved since the last refit
+
+    // Vertex BVH for threshold picking and snapping, built on first query and updated per vertex move
+    mutable VertexBVH vertexBVH;
+    mutable bool vertexBVHValid;
+
+    // Deletion tombstones, flushed by compactDeleted(); sized on first use, so newer
+    // elements beyond the end are simply not deleted
+    bool pendingDeletes;
+    std::vector<char> vertexDeleted;
+    std::vector<char> faceDeleted;
+    std::vector<char> edgeDeleted;
+
+    // Binary sidecar (.fjwb) next to loaded .fjwr files
+    bool binaryCacheEnabled;
+
 public:
     Model();
     ~Model() = default;
@@ -60,12 +103,27 @@ public:
     bool saveToFile(const std::string &filePath);
     bool saveAs(const std::string &filePath);
 
+    // Streams .fjwr text to disk; usable on a copy of the geometry from another thread
+    static bool writeFjwrFile(const std::string &filePath, const std::vector<Vertex> &vertices,
+                              const std::vector<Face> &faces, const std::vector<Edge> &edges);
+
+    // Binary cache: when enabled, loading foo.fjwr reuses foo.fjwb if it was written from the
+    // same file (size and modification time), and writes it otherwise for large files.
+    // Loading or saving a path ending in .fjwb reads or writes the binary format directly
+    void setBinaryCacheEnabled(bool enabled) { binaryCacheEnabled = enabled; }
+    bool getBinaryCacheEnabled() const { return binaryCacheEnabled; }
+    static std::string getBinaryCachePath(const std::string &filePath);
+
     // Data access
     const std::vector<Vertex> &getVertices() const { return vertices; }
     const std::vector<Face> &getFaces() const { return faces; }
     const std::vector<Edge> &getEdges() const { return edges; }
 
-    // Data modification
+    // Aligned SoA view of the vertex data with the faces as index buffer; valid until the next edit
+    MeshView getMeshView() const;
+
+    // Data modification (reserve() first when the final sizes are known, e.g. when building a mesh in bulk)
+    void reserve(int vertexCount, int faceCount, int edgeCount = 0);
     void addVertex(const Vertex &vertex);
     void addVertex(const Vector3 &position);
     void addVertex(float x, float y, float z);
@@ -81,6 +139,19 @@ public:
     void removeFace(int index);
     void removeEdge(int index);
 
+    // Batch removal: one compaction pass however many elements go (indices refer to the current arrays)
+    void removeVertices(const std::vector<int> &indices);
+    void removeFaces(const std::vector<int> &indices);
+
+    // Deferred removal: marking is O(1) per face/edge touched and keeps every index stable;
+    // compactDeleted() then drops all marked elements (and faces/edges of marked vertices) in one pass
+    void markVertexDeleted(int index);
+    void markFaceDeleted(int index);
+    bool isVertexDeleted(int index) const;
+    bool isFaceDeleted(int index) const;
+    bool hasPendingDeletes() const { return pendingDeletes; }
+    void compactDeleted();
+
     // Data modification
     void setVertexPosition(int index, const Vector3 &position);
     Vector3 getVertexPosition(int index) const;
@@ -89,6 +160,18 @@ public:
     void clear();
     void calculateNormals(); // Calculate vertex normals from faces
 
+    // Edges of the faces, their incident faces and each vertex's faces and edges (built on first use,
+    // then kept current)
+    const MeshAdjacency &getMeshAdjacency();
+
+    // Change tracking (vertex moves are tracked individually, anything else sets the topology flag)
+    bool hasChanges() const { return topologyChanged || !changedVertices.empty(); }
+    bool hasTopologyChanged() const { return topologyChanged; }
+    const std::vector<int> &getChangedVertices() const { return changedVertices; }
+    void getChangedFaces(std::vector<int> &faceIndices); // Faces using a moved vertex, ascending
+    void getChangedEdges(std::vector<int> &edgeIndices); // Edges using a moved vertex, ascending
+    void clearChanges();
+
     // Model info
     int getVertexCount() const { return static_cast<int>(vertices.size()); }
     int getFaceCount() const { return static_cast<int>(faces.size()); }
@@ -97,6 +180,9 @@ public:
     const std::string &getFilename() const { return filename; }
     bool getIsModified() const { return isModified; }
     void setModified(bool modified) { isModified = modified; }
+    uint64_t getRevision() const { return revision; }
+    // Record that the geometry as of savedRevision was written to filePath
+    void markSaved(const std::string &filePath, uint64_t savedRevision);
 
     // Selection system
     int getSelectedVertexIndex() const { return selectedVertexIndex; }
@@ -108,6 +194,17 @@ public:
     bool selectVertex(const Ray &ray, const Camera &camera, float baseThreshold);
     Vector3 getSelectedVertexPosition() const;
 
+    // Vertex queries answered by the vertex BVH (O(log n) per move, instead of scanning every vertex).
+    // findVerticesNearRay appends vertices within radius + spread * t of the ray in vertex order,
+    // like RayIntersection::intersectVertices does for spread = 0
+    void findVerticesNearRay(const Ray &ray, float radius, float spread, std::vector<VertexHit> &hits) const;
+    int findNearestVertex(const Vector3 &position, float maxDistance = std::numeric_limits<float>::max()) const; // -1 if none
+
+    // Occlusion of many vertices in one batch query (rubber-band selection, snapping):
+    // visible[i] = 1 when no face hides vertexIndices[i] from cameraPos (same rule as selectVertex)
+    void getVertexVisibility(const Vector3 &cameraPos, const std::vector<int> &vertexIndices, std::vector<uint8_t> &visible,
+                             ThreadPool *pool = nullptr);
+
     // Debug mode control
     void setDisableVisibilityCheck(bool disable) { disableVisibilityCheck = disable; }
     bool getDisableVisibilityCheck() const { return disableVisibilityCheck; }
@@ -125,12 +222,28 @@ public:
 
 private:
     // Internal file format parsing
-    bool parseFjwrFile(const std::string &content);
-    std::string generateFjwrContent() const;
+    bool parseFjwrFile(const char *data, size_t size);
+    bool loadBinaryFile(const std::string &filePath, bool checkSource, int64_t sourceTime, uint64_t sourceSize);
+    bool writeBinaryFile(const std::string &filePath, int64_t sourceTime, uint64_t sourceSize) const;
 
     // Auto-generate edges from faces
     void generateEdgesFromFaces();
 
     // Mark as modified
-    void markAsModified() { isModified = true; }
+    void markAsModified()
+    {
+        isModified = true;
+        revision++;
+    }
+    void markTopologyChanged();
+
+    // Local normal updates
+    Vector3 calculateFaceNormal(const Face &face) const;
+    void updateVertexNormal(int index);
+    void markMeshArraysChanged(int index);
+    // Selection occlusion
+    void updateOcclusionBVH();
+    void updateVertexBVH() const;
+
+    void collectChangedIncident(bool collectFaces, std::vector<int> &result);
 };
\ No newline at end of file
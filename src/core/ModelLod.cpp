@@ -0,0 +1,113 @@
+#include "ModelLod.h"
+#include "MeshSimplifier.h"
+#include "../utils/Utils.h"
+#include <algorithm>
+
+ModelLod::~ModelLod()
+{
+    clear();
+}
+
+bool ModelLod::start(const Model &model, int minFaceCount)
+{
+    if (active)
+    {
+        Utils::logError("Level-of-detail build already in progress");
+        return false;
+    }
+
+    // Snapshot on the calling thread; the worker only ever sees these copies
+    buildRevision = model.getRevision();
+    buildMinFaces = std::max(minFaceCount, 1);
+    vertices = model.getVertices();
+    faces = model.getFaces();
+
+    active = true;
+    finished = false;
+    cancelRequested = false;
+    worker = std::thread([this]()
+                         {
+                             build();
+                             finished.store(true, std::memory_order_release);
+                         });
+    return true;
+}
+
+void ModelLod::build()
+{
+    builtLevels.clear();
+
+    MeshSimplifier simplifier;
+    simplifier.load(vertices, faces);
+
+    // One collapse sequence, with a snapshot each time it passes the next level's face count
+    int target = static_cast<int>(simplifier.getFaceCount() * LEVEL_RATIO);
+    while (target >= buildMinFaces)
+    {
+        const int before = simplifier.getFaceCount();
+        if (!simplifier.simplify(target, &cancelRequested))
+        {
+            builtLevels.clear();
+            return;
+        }
+        if (simplifier.getFaceCount() >= before)
+            break; // No collapse left that keeps the surface intact
+
+        builtLevels.emplace_back();
+        simplifier.extract(builtLevels.back());
+        target = static_cast<int>(simplifier.getFaceCount() * LEVEL_RATIO);
+    }
+}
+
+bool ModelLod::poll()
+{
+    if (!active || !finished.load(std::memory_order_acquire))
+        return false;
+
+    finish();
+    return true;
+}
+
+void ModelLod::finish()
+{
+    worker.join();
+    active = false;
+
+    if (!cancelRequested)
+    {
+        levels.swap(builtLevels);
+        revision = buildRevision;
+
+        std::string faceCounts;
+        for (const Model &level : levels)
+        {
+            faceCounts += (faceCounts.empty() ? "" : ", ") + std::to_string(level.getFaceCount());
+        }
+        Utils::logInfo("Built " + std::to_string(levels.size()) + " levels of detail (" + faceCounts + " faces)");
+    }
+
+    // Release the snapshot and any dropped result
+    std::vector<Vertex>().swap(vertices);
+    std::vector<Face>().swap(faces);
+    std::vector<Model>().swap(builtLevels);
+}
+
+void ModelLod::clear()
+{
+    if (active)
+    {
+        cancelRequested = true;
+        finish();
+    }
+    std::vector<Model>().swap(levels);
+}
+
+const Model *ModelLod::selectLevel(int maxFaceCount) const
+{
+    for (const Model &level : levels)
+    {
+        if (level.getFaceCount() <= maxFaceCount)
+            return &level;
+    }
+    return levels.empty() ? nullptr : &levels.back();
+}
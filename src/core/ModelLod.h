@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Model.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Simplified copies of a model for the viewport, built on a worker thread. start() copies the
+// geometry, so the caller can keep editing; poll() from the same thread reports completion.
+// Levels are for display only: the model stays the one that is picked and edited.
+class ModelLod
+{
+private:
+    std::thread worker;
+    std::atomic<bool> finished{false};
+    std::atomic<bool> cancelRequested{false};
+    bool active = false;
+
+    // Snapshot being simplified, and the worker's result
+    uint64_t buildRevision = 0;
+    int buildMinFaces = 0;
+    std::vector<Vertex> vertices;
+    std::vector<Face> faces;
+    std::vector<Model> builtLevels;
+
+    // Levels of the last finished build, finest first
+    std::vector<Model> levels;
+    uint64_t revision = 0;
+
+public:
+    static constexpr float LEVEL_RATIO = 0.5f; // Face count of each level relative to the one before
+
+    ModelLod() = default;
+    ~ModelLod();
+
+    // Non-copyable
+    ModelLod(const ModelLod &) = delete;
+    ModelLod &operator=(const ModelLod &) = delete;
+
+    // Begin building levels of LEVEL_RATIO, LEVEL_RATIO^2, ... times the model's face count,
+    // none below minFaceCount; false if a build is already running
+    bool start(const Model &model, int minFaceCount);
+    bool isBuilding() const { return active; }
+
+    // Take over the levels of a completed build; true once per finished build
+    bool poll();
+    // Stop a running build (its levels are dropped) and release the current levels
+    void clear();
+
+    // Levels exist and were built from the model's current geometry
+    bool isCurrent(const Model &model) const { return !levels.empty() && revision == model.getRevision(); }
+    int getLevelCount() const { return static_cast<int>(levels.size()); }
+    const Model &getLevel(int level) const { return levels[level]; }
+
+    // Finest level with at most maxFaceCount faces (the coarsest if none is small enough), nullptr if empty
+    const Model *selectLevel(int maxFaceCount) const;
+
+private:
+    void build();
+    void finish();
+};
@@ -0,0 +1,74 @@
+#include "ModelSaver.h"
+#include "../utils/Utils.h"
+
+ModelSaver::~ModelSaver()
+{
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+bool ModelSaver::start(const Model &model, const std::string &filePath)
+{
+    if (active)
+    {
+        Utils::logError("Save already in progress: " + path);
+        return false;
+    }
+    if (Utils::getFileExtension(filePath) != "fjwr")
+    {
+        Utils::logError("Background saves write .fjwr files: " + filePath);
+        return false;
+    }
+
+    // Snapshot on the calling thread; the worker only ever sees these copies
+    path = filePath;
+    revision = model.getRevision();
+    vertices = model.getVertices();
+    faces = model.getFaces();
+    edges = model.getEdges();
+
+    active = true;
+    finished = false;
+    worker = std::thread([this]()
+                         {
+                             succeeded = Model::writeFjwrFile(path, vertices, faces, edges);
+                             finished.store(true, std::memory_order_release);
+                         });
+    return true;
+}
+
+bool ModelSaver::poll(Model &model)
+{
+    if (!active || !finished.load(std::memory_order_acquire))
+        return false;
+
+    finish(model);
+    return true;
+}
+
+void ModelSaver::wait(Model &model)
+{
+    if (active)
+    {
+        finish(model);
+    }
+}
+
+void ModelSaver::finish(Model &model)
+{
+    worker.join();
+    active = false;
+
+    if (succeeded)
+    {
+        model.markSaved(path, revision);
+        Utils::logInfo("Saved model to " + path + " in the background");
+    }
+
+    // Release the snapshot
+    std::vector<Vertex>().swap(vertices);
+    std::vector<Face>().swap(faces);
+    std::vector<Edge>().swap(edges);
+}
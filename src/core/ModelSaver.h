@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Model.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Saves a model on a worker thread. start() copies the geometry, so the caller can keep
+// editing while the file is written; poll() from the same thread reports completion.
+class ModelSaver
+{
+private:
+    std::thread worker;
+    std::atomic<bool> finished{false};
+    bool active = false;
+    bool succeeded = false;
+
+    // Snapshot being written
+    std::string path;
+    uint64_t revision = 0;
+    std::vector<Vertex> vertices;
+    std::vector<Face> faces;
+    std::vector<Edge> edges;
+
+public:
+    ModelSaver() = default;
+    ~ModelSaver();
+
+    // Non-copyable
+    ModelSaver(const ModelSaver &) = delete;
+    ModelSaver &operator=(const ModelSaver &) = delete;
+
+    // Begin writing the model to a .fjwr file; false if a save is already running
+    bool start(const Model &model, const std::string &filePath);
+    bool isSaving() const { return active; }
+
+    // Finish a completed save and update the model's filename and modified state.
+    // Returns true once per finished save, whether or not it succeeded.
+    bool poll(Model &model);
+    // Block until the running save (if any) finished, then poll()
+    void wait(Model &model);
+    bool lastSaveSucceeded() const { return succeeded; }
+
+private:
+    void finish(Model &model);
+};
@@ -3,6 +3,7 @@
 #include "../math/Vector3.h"
 #include <iostream>
 #include <limits>
+#include <vector>
 
 struct Ray {
     Vector3 origin;
@@ -32,6 +33,14 @@ struct Ray {
         return direction.lengthSquared() > 1e-6f;
     }
 
+    // Create ray from a direction the caller guarantees is unit length (skips renormalization)
+    static Ray fromUnitDirection(const Vector3& origin, const Vector3& unitDirection) {
+        Ray ray;
+        ray.origin = origin;
+        ray.direction = unitDirection;
+        return ray;
+    }
+
     // Create ray from two points
     static Ray fromPoints(const Vector3& start, const Vector3& end) {
         return Ray(start, (end - start).normalized());
@@ -93,6 +102,45 @@ struct Line {
         : start(start), end(end), color(color), thickness(thickness) {}
 };
 
+// Triangle structure for renderer scenes and acceleration structures
+struct Triangle {
+    Vector3 v0, v1, v2;
+    Vector3 color;
+
+    Triangle() = default;
+    Triangle(const Vector3& v0, const Vector3& v1, const Vector3& v2, const Vector3& color = Vector3(0.5f, 0.5f, 0.5f))
+        : v0(v0), v1(v1), v2(v2), color(color) {}
+};
+
+// Precomputed per-triangle data for the fast intersection kernel (64 bytes)
+// Holds the unit normal with its plane offset, plus one plane per edge so the
+// left-hand side test becomes three dot products (cross(edge, p - v) . n == p . cross(n, edge) - v . cross(n, edge))
+struct TriangleIntersectionData {
+    Vector3 normal;
+    float planeOffset = 0.0f; // dot(normal, v0)
+    Vector3 edgePlane0;       // cross(normal, v1 - v0)
+    float edgeOffset0 = 0.0f; // dot(edgePlane0, v0)
+    Vector3 edgePlane1;       // cross(normal, v2 - v1)
+    float edgeOffset1 = 0.0f; // dot(edgePlane1, v1)
+    Vector3 edgePlane2;       // cross(normal, v0 - v2)
+    float edgeOffset2 = 0.0f; // dot(edgePlane2, v2)
+
+    TriangleIntersectionData() = default;
+    TriangleIntersectionData(const Vector3& v0, const Vector3& v1, const Vector3& v2) {
+        // Same normal as intersectTriangle (CCW = front face)
+        normal = Vector3::cross(v1 - v0, v2 - v0).normalized();
+        planeOffset = Vector3::dot(normal, v0);
+        edgePlane0 = Vector3::cross(normal, v1 - v0);
+        edgeOffset0 = Vector3::dot(edgePlane0, v0);
+        edgePlane1 = Vector3::cross(normal, v2 - v1);
+        edgeOffset1 = Vector3::dot(edgePlane1, v1);
+        edgePlane2 = Vector3::cross(normal, v0 - v2);
+        edgeOffset2 = Vector3::dot(edgePlane2, v2);
+    }
+    explicit TriangleIntersectionData(const Triangle& triangle)
+        : TriangleIntersectionData(triangle.v0, triangle.v1, triangle.v2) {}
+};
+
 // Line intersection result (similar to EdgeHit)
 struct LineHit {
     bool hit = false;
@@ -121,23 +169,26 @@ struct RaycastResult {
     Vector3 point;
     int elementIndex = -1;  // Index of vertex, edge, or face
 
-    // Type-specific data
-    TriangleHit triangleHit;
-    VertexHit vertexHit;
-    EdgeHit edgeHit;
-    LineHit lineHit;
+    // Type-specific data: only what the per-type hits add (44 bytes per result, 140 with four full hit records)
+    Vector3 normal;           // FACE: surface normal
+    float parameter = 0.0f;   // EDGE, LINE: position along the segment (0.0 to 1.0)
+    bool isFrontFace = true;  // FACE
 
     RaycastResult() = default;
 };
 
 // Forward declaration for Model class
 class Model;
+struct MeshView;
 
 // Ray intersection functions
 namespace RayIntersection {
     // Ray-triangle intersection (using the algorithm from CLAUDE.md)
     TriangleHit intersectTriangle(const Ray& ray, const Vector3& v0, const Vector3& v1, const Vector3& v2);
 
+    // Fast-path ray-triangle intersection on precomputed data (same conventions as above)
+    TriangleHit intersectTriangle(const Ray& ray, const TriangleIntersectionData& triangle);
+
     // Point-in-triangle test (using left-hand side test from CLAUDE.md)
     bool isPointInsideTriangle(const Vector3& point, const Vector3& v0, const Vector3& v1, const Vector3& v2, const Vector3& normal);
 
@@ -147,6 +198,10 @@ namespace RayIntersection {
     // Ray-vertex intersection (distance check with threshold)
     VertexHit intersectVertex(const Ray& ray, const Vector3& vertex, float threshold, int vertexIndex);
 
+    // intersectVertex() over every vertex of a mesh, eight at a time (same results bit for bit);
+    // appends the hits in vertex order
+    void intersectVertices(const Ray& ray, const MeshView& mesh, float threshold, std::vector<VertexHit>& hits);
+
     // Ray-edge intersection (closest approach distance check)
     EdgeHit intersectEdge(const Ray& ray, const Vector3& edgeStart, const Vector3& edgeEnd, float threshold, int edgeIndex);
 
@@ -0,0 +1,106 @@
+#include "RayBatch.h"
+#include "../utils/ThreadPool.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr int RAYS_PER_TASK = 8 * RAY_PACKET_WIDTH;
+
+    // Trace rays [first, last) in packets; onHit(index, hit) sees every hit, misses are left alone
+    template <typename Accelerator, typename HitCallback>
+    void traceRange(const Accelerator &bvh, const std::vector<BatchRay> &rays, float tMin, int first, int last,
+                    HitCallback onHit)
+    {
+        RayPacket packet;
+        packet.tMin = tMin;
+        BVHHit laneHits[RAY_PACKET_WIDTH];
+
+        for (int start = first; start < last; start += RAY_PACKET_WIDTH)
+        {
+            const int laneCount = std::min(RAY_PACKET_WIDTH, last - start);
+            packet.activeMask = 0;
+            for (int lane = 0; lane < laneCount; ++lane)
+            {
+                packet.setRay(lane, rays[start + lane].ray, rays[start + lane].maxDistance);
+            }
+            for (int lane = laneCount; lane < RAY_PACKET_WIDTH; ++lane)
+            {
+                packet.setInactive(lane);
+            }
+
+            const int hitMask = bvh.intersectPacket(packet, laneHits);
+            for (int lane = 0; lane < laneCount; ++lane)
+            {
+                if (hitMask & (1 << lane))
+                    onHit(start + lane, laneHits[lane]);
+            }
+        }
+    }
+
+    // Split the batch into fixed chunks, on the pool when there is one
+    template <typename Accelerator, typename HitCallback>
+    void traceBatch(const Accelerator &bvh, const std::vector<BatchRay> &rays, float tMin, ThreadPool *pool,
+                    HitCallback onHit)
+    {
+        const int rayCount = static_cast<int>(rays.size());
+        const int taskCount = (rayCount + RAYS_PER_TASK - 1) / RAYS_PER_TASK;
+        auto task = [&](int taskIndex)
+        {
+            const int first = taskIndex * RAYS_PER_TASK;
+            traceRange(bvh, rays, tMin, first, std::min(rayCount, first + RAYS_PER_TASK), onHit);
+        };
+
+        if (pool && taskCount > 1)
+        {
+            pool->parallelFor(taskCount, task);
+            return;
+        }
+        for (int taskIndex = 0; taskIndex < taskCount; ++taskIndex)
+        {
+            task(taskIndex);
+        }
+    }
+
+    template <typename Accelerator>
+    void closestHits(const Accelerator &bvh, const std::vector<BatchRay> &rays, float tMin, std::vector<BVHHit> &hits,
+                     ThreadPool *pool)
+    {
+        hits.assign(rays.size(), BVHHit());
+        traceBatch(bvh, rays, tMin, pool, [&](int index, const BVHHit &hit) { hits[index] = hit; });
+    }
+
+    template <typename Accelerator>
+    void occlusion(const Accelerator &bvh, const std::vector<BatchRay> &rays, float tMin, std::vector<uint8_t> &occluded,
+                   ThreadPool *pool)
+    {
+        occluded.assign(rays.size(), 0);
+        traceBatch(bvh, rays, tMin, pool, [&](int index, const BVHHit &) { occluded[index] = 1; });
+    }
+}
+
+namespace RayIntersection
+{
+    void intersectBatch(const BVH &bvh, const std::vector<BatchRay> &rays, float tMin, std::vector<BVHHit> &hits,
+                        ThreadPool *pool)
+    {
+        closestHits(bvh, rays, tMin, hits, pool);
+    }
+
+    void intersectBatch(const InstanceBVH &bvh, const std::vector<BatchRay> &rays, float tMin, std::vector<BVHHit> &hits,
+                        ThreadPool *pool)
+    {
+        closestHits(bvh, rays, tMin, hits, pool);
+    }
+
+    void occludedBatch(const BVH &bvh, const std::vector<BatchRay> &rays, float tMin, std::vector<uint8_t> &occluded,
+                       ThreadPool *pool)
+    {
+        occlusion(bvh, rays, tMin, occluded, pool);
+    }
+
+    void occludedBatch(const InstanceBVH &bvh, const std::vector<BatchRay> &rays, float tMin, std::vector<uint8_t> &occluded,
+                       ThreadPool *pool)
+    {
+        occlusion(bvh, rays, tMin, occluded, pool);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "BVH.h"
+#include "InstanceBVH.h"
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class ThreadPool;
+
+// One ray of a batch query with its own far limit
+struct BatchRay
+{
+    Ray ray;
+    float maxDistance = std::numeric_limits<float>::max();
+};
+
+// Batched queries against a prebuilt BVH, for picking and editing tools (rubber-band selection,
+// snapping, visibility of many vertices). Answers come back in ray order and match the single-ray
+// queries ray by ray. Runs of RAY_PACKET_WIDTH rays go through the packet kernel; with a thread
+// pool the batch is split into chunks traced in parallel.
+namespace RayIntersection
+{
+    // Closest hit with distance in (tMin, maxDistance); misses keep triangleIndex -1
+    void intersectBatch(const BVH &bvh, const std::vector<BatchRay> &rays, float tMin, std::vector<BVHHit> &hits,
+                        ThreadPool *pool = nullptr);
+    void intersectBatch(const InstanceBVH &bvh, const std::vector<BatchRay> &rays, float tMin, std::vector<BVHHit> &hits,
+                        ThreadPool *pool = nullptr);
+
+    // Occlusion: 1 when anything is hit with distance in (tMin, maxDistance). Answered by the
+    // closest-hit packet kernel, which hits in the interval exactly when an any-hit query would.
+    void occludedBatch(const BVH &bvh, const std::vector<BatchRay> &rays, float tMin, std::vector<uint8_t> &occluded,
+                       ThreadPool *pool = nullptr);
+    void occludedBatch(const InstanceBVH &bvh, const std::vector<BatchRay> &rays, float tMin, std::vector<uint8_t> &occluded,
+                       ThreadPool *pool = nullptr);
+}
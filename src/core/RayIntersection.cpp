@@ -1,5 +1,6 @@
 #include "Ray.h"
 #include "Model.h"
+#include "../math/SimdFloat.h"
 #include "../utils/Utils.h"
 #include <cmath>
 #include <algorithm>
@@ -104,6 +105,47 @@ namespace RayIntersection
         return result;
     }
 
+    TriangleHit intersectTriangle(const Ray &ray, const TriangleIntersectionData &triangle)
+    {
+        TriangleHit result;
+        result.hit = false;
+
+        // Face orientation test
+        float denom = Vector3::dot(triangle.normal, ray.direction);
+        bool isFrontFace = (denom < 0); // Negative means front face
+
+        if (std::abs(denom) < 1e-6f)
+        {
+            return result; // Ray is parallel to triangle (or triangle is degenerate)
+        }
+
+        // Plane intersection using the stored plane offset
+        float t = (triangle.planeOffset - Vector3::dot(triangle.normal, ray.origin)) / denom;
+        if (t < 0)
+        {
+            return result; // Intersection behind ray origin
+        }
+
+        Vector3 point = ray.origin + ray.direction * t;
+
+        // Triangle interior test against the precomputed edge planes
+        if (Vector3::dot(triangle.edgePlane0, point) < triangle.edgeOffset0 ||
+            Vector3::dot(triangle.edgePlane1, point) < triangle.edgeOffset1 ||
+            Vector3::dot(triangle.edgePlane2, point) < triangle.edgeOffset2)
+        {
+            return result;
+        }
+
+        // Valid intersection found
+        result.hit = true;
+        result.distance = t;
+        result.point = point;
+        result.normal = isFrontFace ? triangle.normal : -triangle.normal; // Always point towards ray origin
+        result.isFrontFace = isFrontFace;
+
+        return result;
+    }
+
     float rayPointDistance(const Ray &ray, const Vector3 &point, float &rayParameter)
     {
         // Calculate closest point on ray to the given point
@@ -135,6 +177,54 @@ namespace RayIntersection
         return result;
     }
 
+    void intersectVertices(const Ray &ray, const MeshView &mesh, float threshold, std::vector<VertexHit> &hits)
+    {
+        const SimdFloat8 originX = SimdFloat8::broadcast(ray.origin.x);
+        const SimdFloat8 originY = SimdFloat8::broadcast(ray.origin.y);
+        const SimdFloat8 originZ = SimdFloat8::broadcast(ray.origin.z);
+        const SimdFloat8 directionX = SimdFloat8::broadcast(ray.direction.x);
+        const SimdFloat8 directionY = SimdFloat8::broadcast(ray.direction.y);
+        const SimdFloat8 directionZ = SimdFloat8::broadcast(ray.direction.z);
+        const SimdFloat8 zero = SimdFloat8::broadcast(0.0f);
+        const SimdFloat8 limit = SimdFloat8::broadcast(threshold);
+
+        alignas(32) float rayParameters[MeshView::SIMD_WIDTH];
+        for (int base = 0; base < mesh.vertexCount; base += MeshView::SIMD_WIDTH)
+        {
+            // rayPointDistance(), operation for operation
+            const SimdFloat8 x = SimdFloat8::load(mesh.positionX + base);
+            const SimdFloat8 y = SimdFloat8::load(mesh.positionY + base);
+            const SimdFloat8 z = SimdFloat8::load(mesh.positionZ + base);
+            const SimdFloat8 toPointX = x - originX;
+            const SimdFloat8 toPointY = y - originY;
+            const SimdFloat8 toPointZ = z - originZ;
+            SimdFloat8 rayParameter = toPointX * directionX + toPointY * directionY + toPointZ * directionZ;
+            rayParameter = SimdFloat8::select(rayParameter < zero, zero, rayParameter);
+
+            const SimdFloat8 offsetX = x - (originX + directionX * rayParameter);
+            const SimdFloat8 offsetY = y - (originY + directionY * rayParameter);
+            const SimdFloat8 offsetZ = z - (originZ + directionZ * rayParameter);
+            const SimdFloat8 distance = SimdFloat8::sqrt(offsetX * offsetX + offsetY * offsetY + offsetZ * offsetZ);
+
+            int mask = (distance <= limit).bits();
+            const int lanes = mesh.vertexCount - base;
+            if (lanes < MeshView::SIMD_WIDTH)
+                mask &= (1 << lanes) - 1; // Padding lanes
+            if (mask == 0)
+                continue;
+
+            rayParameter.store(rayParameters);
+            for (int lane = 0; lane < MeshView::SIMD_WIDTH; ++lane)
+            {
+                if (mask & (1 << lane))
+                {
+                    const int index = base + lane;
+                    hits.emplace_back(true, rayParameters[lane], mesh.getPosition(index), index);
+                }
+            }
+        }
+    }
+
     float rayEdgeDistance(const Ray &ray, const Vector3 &edgeStart, const Vector3 &edgeEnd, float &rayParameter, float &edgeParameter)
     {
         // Correct ray-edge distance calculation (3D line-line distance)
@@ -216,15 +306,15 @@ namespace RayIntersection
         float rayParam, edgeParam;
         float distance = rayEdgeDistance(ray, edgeStart, edgeEnd, rayParam, edgeParam);
 
-        // Debug for edge 0 occasionally
+        // Debug for edge 0 occasionally (only built at the Debug log level)
         static int debugCallCount = 0;
         bool shouldDebugDetail = (debugCallCount % 50000 == 0) && edgeIndex == 0;
         if (shouldDebugDetail)
         {
-            Utils::logInfo("DETAIL intersectEdge " + std::to_string(edgeIndex) + ": rawDistance=" + std::to_string(distance) +
-                           " threshold=" + std::to_string(threshold) +
-                           " rayParam=" + std::to_string(rayParam) +
-                           " edgeParam=" + std::to_string(edgeParam));
+            LOG_DEBUG("DETAIL intersectEdge " + std::to_string(edgeIndex) + ": rawDistance=" + std::to_string(distance) +
+                      " threshold=" + std::to_string(threshold) +
+                      " rayParam=" + std::to_string(rayParam) +
+                      " edgeParam=" + std::to_string(edgeParam));
         }
         debugCallCount++;
 
@@ -240,8 +330,8 @@ namespace RayIntersection
 
             if (shouldDebugDetail)
             {
-                Utils::logInfo("DETAIL intersectEdge " + std::to_string(edgeIndex) + " HIT: point(" +
-                               std::to_string(result.point.x) + "," + std::to_string(result.point.y) + "," + std::to_string(result.point.z) + ")");
+                LOG_DEBUG("DETAIL intersectEdge " + std::to_string(edgeIndex) + " HIT: point(" +
+                          std::to_string(result.point.x) + "," + std::to_string(result.point.y) + "," + std::to_string(result.point.z) + ")");
             }
         }
         else
@@ -570,22 +660,21 @@ namespace RayIntersection
         Ray visibilityRay(cameraPos, direction);
 
         // Check if any face occludes this vertex
-        const auto &faces = model.getFaces();
-        const auto &vertices = model.getVertices();
+        const MeshView mesh = model.getMeshView();
 
-        for (size_t i = 0; i < faces.size(); ++i)
+        for (int i = 0; i < mesh.faceCount; ++i)
         {
-            const auto &face = faces[i];
+            const auto &face = mesh.faces[i];
 
             // Skip invalid faces
-            if (face.v1 >= vertices.size() || face.v2 >= vertices.size() || face.v3 >= vertices.size())
+            if (face.v1 >= mesh.vertexCount || face.v2 >= mesh.vertexCount || face.v3 >= mesh.vertexCount)
             {
                 continue;
             }
 
-            const Vector3 &v0 = vertices[face.v1].position;
-            const Vector3 &v1 = vertices[face.v2].position;
-            const Vector3 &v2 = vertices[face.v3].position;
+            const Vector3 v0 = mesh.getPosition(face.v1);
+            const Vector3 v1 = mesh.getPosition(face.v2);
+            const Vector3 v2 = mesh.getPosition(face.v3);
 
             // Skip faces that contain the target vertex (allow selection of vertices on face edges)
             bool containsTargetVertex = false;
@@ -614,23 +703,23 @@ namespace RayIntersection
         RaycastResult result;
         float closestDistance = std::numeric_limits<float>::max();
 
-        const auto &vertices = model.getVertices();
+        const MeshView mesh = model.getMeshView();
         const auto &edges = model.getEdges();
         const auto &faces = model.getFaces();
+        const size_t vertexCount = static_cast<size_t>(mesh.vertexCount);
 
-        // Check vertex intersections
-        for (size_t i = 0; i < vertices.size(); ++i)
+        // Check vertex intersections (the vertex BVH returns the same hits as intersectVertices)
+        std::vector<VertexHit> vertexHits;
+        model.findVerticesNearRay(ray, vertexThreshold, 0.0f, vertexHits);
+        for (const VertexHit &vertexHit : vertexHits)
         {
-            VertexHit vertexHit = intersectVertex(ray, vertices[i].position, vertexThreshold, static_cast<int>(i));
-
-            if (vertexHit.hit && vertexHit.distance < closestDistance)
+            if (vertexHit.distance < closestDistance)
             {
                 closestDistance = vertexHit.distance;
                 result.type = RaycastResultType::VERTEX;
                 result.distance = vertexHit.distance;
                 result.point = vertexHit.point;
                 result.elementIndex = vertexHit.vertexIndex;
-                result.vertexHit = vertexHit;
             }
         }
 
@@ -640,13 +729,13 @@ namespace RayIntersection
             const auto &edge = edges[i];
 
             // Skip invalid edges
-            if (edge.v1 >= vertices.size() || edge.v2 >= vertices.size())
+            if (edge.v1 >= vertexCount || edge.v2 >= vertexCount)
             {
                 continue;
             }
 
-            const Vector3 &edgeStart = vertices[edge.v1].position;
-            const Vector3 &edgeEnd = vertices[edge.v2].position;
+            const Vector3 edgeStart = mesh.getPosition(edge.v1);
+            const Vector3 edgeEnd = mesh.getPosition(edge.v2);
 
             EdgeHit edgeHit = intersectEdge(ray, edgeStart, edgeEnd, edgeThreshold, static_cast<int>(i));
 
@@ -657,7 +746,7 @@ namespace RayIntersection
                 result.distance = edgeHit.distance;
                 result.point = edgeHit.point;
                 result.elementIndex = edgeHit.edgeIndex;
-                result.edgeHit = edgeHit;
+                result.parameter = edgeHit.edgeParameter;
             }
         }
 
@@ -667,14 +756,14 @@ namespace RayIntersection
             const auto &face = faces[i];
 
             // Skip invalid faces
-            if (face.v1 >= vertices.size() || face.v2 >= vertices.size() || face.v3 >= vertices.size())
+            if (face.v1 >= vertexCount || face.v2 >= vertexCount || face.v3 >= vertexCount)
             {
                 continue;
             }
 
-            const Vector3 &v0 = vertices[face.v1].position;
-            const Vector3 &v1 = vertices[face.v2].position;
-            const Vector3 &v2 = vertices[face.v3].position;
+            const Vector3 v0 = mesh.getPosition(face.v1);
+            const Vector3 v1 = mesh.getPosition(face.v2);
+            const Vector3 v2 = mesh.getPosition(face.v3);
 
             TriangleHit triangleHit = intersectTriangle(ray, v0, v1, v2);
 
@@ -685,7 +774,8 @@ namespace RayIntersection
                 result.distance = triangleHit.distance;
                 result.point = triangleHit.point;
                 result.elementIndex = static_cast<int>(i);
-                result.triangleHit = triangleHit;
+                result.normal = triangleHit.normal;
+                result.isFrontFace = triangleHit.isFrontFace;
             }
         }
 
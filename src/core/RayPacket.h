@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Ray.h"
+#include <limits>
+
+// Number of rays traced together by the packet kernels
+constexpr int RAY_PACKET_WIDTH = 8;
+
+// Structure-of-arrays ray packet for coherent (primary) rays
+struct alignas(32) RayPacket {
+    float originX[RAY_PACKET_WIDTH];
+    float originY[RAY_PACKET_WIDTH];
+    float originZ[RAY_PACKET_WIDTH];
+    float directionX[RAY_PACKET_WIDTH];
+    float directionY[RAY_PACKET_WIDTH];
+    float directionZ[RAY_PACKET_WIDTH];
+    float inverseDirectionX[RAY_PACKET_WIDTH];
+    float inverseDirectionY[RAY_PACKET_WIDTH];
+    float inverseDirectionZ[RAY_PACKET_WIDTH];
+    float tMax[RAY_PACKET_WIDTH]; // Per-ray upper bound (e.g. closest overlay hit)
+    float tMin = 0.0f;            // Shared lower bound
+    int activeMask = 0;           // Bit i set when lane i holds a ray
+
+    RayPacket() = default;
+
+    void setRay(int lane, const Ray& ray, float maxDistance) {
+        originX[lane] = ray.origin.x;
+        originY[lane] = ray.origin.y;
+        originZ[lane] = ray.origin.z;
+        directionX[lane] = ray.direction.x;
+        directionY[lane] = ray.direction.y;
+        directionZ[lane] = ray.direction.z;
+        inverseDirectionX[lane] = 1.0f / ray.direction.x;
+        inverseDirectionY[lane] = 1.0f / ray.direction.y;
+        inverseDirectionZ[lane] = 1.0f / ray.direction.z;
+        tMax[lane] = maxDistance;
+        activeMask |= 1 << lane;
+    }
+
+    // Fill an unused lane with a copy of lane 0 that can never hit (keeps SIMD lanes well defined)
+    void setInactive(int lane) {
+        originX[lane] = originX[0];
+        originY[lane] = originY[0];
+        originZ[lane] = originZ[0];
+        directionX[lane] = directionX[0];
+        directionY[lane] = directionY[0];
+        directionZ[lane] = directionZ[0];
+        inverseDirectionX[lane] = inverseDirectionX[0];
+        inverseDirectionY[lane] = inverseDirectionY[0];
+        inverseDirectionZ[lane] = inverseDirectionZ[0];
+        tMax[lane] = -std::numeric_limits<float>::max();
+        activeMask &= ~(1 << lane);
+    }
+
+    Ray getRay(int lane) const {
+        Ray ray;
+        ray.origin = Vector3(originX[lane], originY[lane], originZ[lane]);
+        ray.direction = Vector3(directionX[lane], directionY[lane], directionZ[lane]);
+        return ray;
+    }
+};
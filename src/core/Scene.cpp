@@ -0,0 +1,155 @@
+#include "Scene.h"
+#include "../utils/Utils.h"
+#include <numeric>
+
+void Scene::clear()
+{
+    meshes.clear();
+    instances.clear();
+}
+
+int Scene::addMesh(std::shared_ptr<const Model> mesh)
+{
+    meshes.push_back(std::move(mesh));
+    return static_cast<int>(meshes.size()) - 1;
+}
+
+int Scene::addInstance(int mesh, const Matrix4 &transform, const Material &material, const std::string &name)
+{
+    if (mesh < 0 || mesh >= static_cast<int>(meshes.size()))
+    {
+        Utils::logError("Invalid scene mesh index: " + std::to_string(mesh));
+        return -1;
+    }
+
+    SceneInstance instance;
+    instance.name = name;
+    instance.mesh = mesh;
+    instance.transform = transform;
+    instance.material = material;
+    instances.push_back(instance);
+    return static_cast<int>(instances.size()) - 1;
+}
+
+void Scene::addConnectedParts(const Model &model, std::vector<int> &faceTriangles)
+{
+    const auto &vertices = model.getVertices();
+    const auto &faces = model.getFaces();
+
+    // Union-find over the vertices each face connects
+    std::vector<int> parent(vertices.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto findRoot = [&](int vertex)
+    {
+        while (parent[vertex] != vertex)
+        {
+            parent[vertex] = parent[parent[vertex]];
+            vertex = parent[vertex];
+        }
+        return vertex;
+    };
+    for (const Face &face : faces)
+    {
+        parent[findRoot(face.v2)] = findRoot(face.v1);
+        parent[findRoot(face.v3)] = findRoot(face.v1);
+    }
+
+    // One part per group, numbered in order of its first face
+    std::vector<int> rootPart(vertices.size(), -1);
+    std::vector<int> partVertex(vertices.size(), -1); // Model vertex -> vertex within its part
+    std::vector<int> facePart(faces.size());
+    int partCount = 0;
+    for (size_t f = 0; f < faces.size(); ++f)
+    {
+        const int root = findRoot(faces[f].v1);
+        if (rootPart[root] < 0)
+        {
+            rootPart[root] = partCount++;
+        }
+        facePart[f] = rootPart[root];
+    }
+
+    // Size every part up front so building them never reallocates
+    std::vector<int> partFaceCounts(partCount, 0);
+    std::vector<int> partVertexCounts(partCount, 0);
+    for (size_t f = 0; f < faces.size(); ++f)
+    {
+        partFaceCounts[facePart[f]]++;
+    }
+    for (size_t v = 0; v < vertices.size(); ++v)
+    {
+        const int part = rootPart[findRoot(static_cast<int>(v))];
+        if (part >= 0)
+            partVertexCounts[part]++; // Vertices joined to a face, so used by exactly one part
+    }
+    std::vector<std::shared_ptr<Model>> parts(partCount);
+    for (int p = 0; p < partCount; ++p)
+    {
+        parts[p] = std::make_shared<Model>();
+        parts[p]->reserve(partVertexCounts[p], partFaceCounts[p]);
+    }
+    faceTriangles.resize(faces.size());
+
+    for (size_t f = 0; f < faces.size(); ++f)
+    {
+        const Face &face = faces[f];
+        Model &part = *parts[facePart[f]];
+
+        int corners[3] = {face.v1, face.v2, face.v3};
+        for (int &corner : corners)
+        {
+            if (partVertex[corner] < 0)
+            {
+                partVertex[corner] = part.getVertexCount();
+                part.addVertex(vertices[corner]);
+            }
+            corner = partVertex[corner];
+        }
+        faceTriangles[f] = part.getFaceCount(); // Within the part for now
+        part.addFace(corners[0], corners[1], corners[2]);
+    }
+
+    // Scene triangle ids continue after the instances already in the scene
+    std::vector<int> partFirstTriangle(parts.size());
+    int firstTriangle = getTriangleCount();
+    for (size_t p = 0; p < parts.size(); ++p)
+    {
+        partFirstTriangle[p] = firstTriangle;
+        firstTriangle += parts[p]->getFaceCount();
+        addInstance(addMesh(parts[p]), Matrix4(), Material(), "Part " + std::to_string(p));
+    }
+    for (size_t f = 0; f < faces.size(); ++f)
+    {
+        faceTriangles[f] += partFirstTriangle[facePart[f]];
+    }
+}
+
+void Scene::setTransform(int instance, const Matrix4 &transform)
+{
+    if (instance < 0 || instance >= static_cast<int>(instances.size()))
+    {
+        Utils::logError("Invalid scene instance index: " + std::to_string(instance));
+        return;
+    }
+    instances[instance].transform = transform;
+}
+
+void Scene::setMaterial(int instance, const Material &material)
+{
+    if (instance < 0 || instance >= static_cast<int>(instances.size()))
+    {
+        Utils::logError("Invalid scene instance index: " + std::to_string(instance));
+        return;
+    }
+    instances[instance].material = material;
+}
+
+int Scene::getTriangleCount() const
+{
+    int count = 0;
+    for (const SceneInstance &instance : instances)
+    {
+        count += meshes[instance.mesh]->getFaceCount();
+    }
+    return count;
+}
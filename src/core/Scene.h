@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Model.h"
+#include "../math/Matrix4.h"
+#include "../math/Vector3.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Surface look of a scene instance, applied on top of the renderer's reflection settings to
+// front faces (back faces keep the global back-face look)
+struct Material
+{
+    Vector3 tint = Vector3(1.0f, 1.0f, 1.0f); // Multiplies the front-face base color
+    float reflectivity = -1.0f;               // Front-face reflection alpha, < 0 = global setting
+};
+
+// One placement of a scene mesh
+struct SceneInstance
+{
+    std::string name;
+    int mesh = 0;      // Index into the scene's meshes
+    Matrix4 transform; // Object to world
+    Material material;
+};
+
+// Meshes and the instances placing them in the world. An instance is only a mesh index, a
+// transform and a material, so a part repeated across the scene is stored once; meshes are
+// held by shared pointer so several scenes can use the same Model as well.
+class Scene
+{
+private:
+    std::vector<std::shared_ptr<const Model>> meshes;
+    std::vector<SceneInstance> instances;
+
+public:
+    void clear();
+
+    int addMesh(std::shared_ptr<const Model> mesh); // Returns the mesh index
+    int addInstance(int mesh, const Matrix4 &transform = Matrix4(), const Material &material = Material(),
+                    const std::string &name = ""); // Returns the instance index, -1 for an unknown mesh
+
+    // Split a model into one mesh per connected group of faces, each placed once untransformed.
+    // faceTriangles receives the scene triangle id of every model face.
+    void addConnectedParts(const Model &model, std::vector<int> &faceTriangles);
+
+    void setTransform(int instance, const Matrix4 &transform);
+    void setMaterial(int instance, const Material &material);
+
+    int getMeshCount() const { return static_cast<int>(meshes.size()); }
+    const Model &getMesh(int mesh) const { return *meshes[mesh]; }
+    int getInstanceCount() const { return static_cast<int>(instances.size()); }
+    const SceneInstance &getInstance(int instance) const { return instances[instance]; }
+    int getTriangleCount() const; // Faces over all instances, as traced by the renderer
+};
@@ -0,0 +1,302 @@
+#include "VertexBVH.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    float axisValue(const Vector3 &v, int axis)
+    {
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+
+    // Does the half-line t >= 0 pass through the box grown by margin on every side?
+    bool rayTouchesBox(const Ray &ray, const Vector3 &boxMin, const Vector3 &boxMax, float margin)
+    {
+        float tNear = 0.0f;
+        float tFar = std::numeric_limits<float>::infinity();
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float origin = axisValue(ray.origin, axis);
+            const float direction = axisValue(ray.direction, axis);
+            const float low = axisValue(boxMin, axis) - margin;
+            const float high = axisValue(boxMax, axis) + margin;
+            if (direction == 0.0f)
+            {
+                if (origin < low || origin > high)
+                    return false;
+                continue;
+            }
+
+            const float t1 = (low - origin) / direction;
+            const float t2 = (high - origin) / direction;
+            tNear = std::max(tNear, std::min(t1, t2));
+            tFar = std::min(tFar, std::max(t1, t2));
+            if (tNear > tFar)
+                return false;
+        }
+        return true;
+    }
+
+    float boxDistanceSquared(const BVHNode &node, const Vector3 &position)
+    {
+        const float dx = std::max({node.boundsMin.x - position.x, 0.0f, position.x - node.boundsMax.x});
+        const float dy = std::max({node.boundsMin.y - position.y, 0.0f, position.y - node.boundsMax.y});
+        const float dz = std::max({node.boundsMin.z - position.z, 0.0f, position.z - node.boundsMax.z});
+        return dx * dx + dy * dy + dz * dz;
+    }
+}
+
+void VertexBVH::clear()
+{
+    nodes.clear();
+    points.clear();
+    pointOrder.clear();
+    pointLeaves.clear();
+    parents.clear();
+    builtSurfaceArea = 0.0;
+    currentSurfaceArea = 0.0;
+}
+
+void VertexBVH::build(const std::vector<Vector3> &positions)
+{
+    clear();
+
+    const int pointCount = static_cast<int>(positions.size());
+    if (pointCount == 0)
+        return;
+
+    points = positions;
+    pointOrder.resize(pointCount);
+    for (int i = 0; i < pointCount; ++i)
+    {
+        pointOrder[i] = i;
+    }
+    nodes.reserve(2 * (pointCount / MAX_LEAF_SIZE + 1));
+
+    BVHNode root;
+    root.leftFirst = 0;
+    root.triangleCount = pointCount;
+    nodes.push_back(root);
+
+    // Iterative top-down build; halving the range bounds the depth by log2 of the point count
+    std::vector<int> buildStack;
+    buildStack.push_back(0);
+    while (!buildStack.empty())
+    {
+        const int nodeIndex = buildStack.back();
+        buildStack.pop_back();
+
+        BVHNode &node = nodes[nodeIndex];
+        const AABB bounds = computeLeafBounds(node);
+        node.boundsMin = bounds.min;
+        node.boundsMax = bounds.max;
+        if (node.triangleCount <= MAX_LEAF_SIZE)
+            continue;
+
+        const Vector3 extent = bounds.max - bounds.min;
+        const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        const int first = node.leftFirst;
+        const int count = node.triangleCount;
+        const int middle = first + count / 2;
+        std::nth_element(pointOrder.begin() + first, pointOrder.begin() + middle, pointOrder.begin() + first + count,
+                         [&](int a, int b)
+                         {
+                             const float valueA = axisValue(points[a], axis);
+                             const float valueB = axisValue(points[b], axis);
+                             return valueA < valueB || (valueA == valueB && a < b);
+                         });
+
+        const int leftChild = static_cast<int>(nodes.size());
+        node.leftFirst = leftChild;
+        node.triangleCount = 0;
+
+        BVHNode left;
+        left.leftFirst = first;
+        left.triangleCount = middle - first;
+        BVHNode right;
+        right.leftFirst = middle;
+        right.triangleCount = first + count - middle;
+        nodes.push_back(left); // Invalidates node
+        nodes.push_back(right);
+        buildStack.push_back(leftChild);
+        buildStack.push_back(leftChild + 1);
+    }
+
+    // Links used by update(): children are always stored after their parent
+    const int nodeCount = static_cast<int>(nodes.size());
+    parents.assign(nodeCount, -1);
+    pointLeaves.resize(pointCount);
+    for (int i = 0; i < nodeCount; ++i)
+    {
+        const BVHNode &node = nodes[i];
+        if (node.isLeaf())
+        {
+            for (int k = 0; k < node.triangleCount; ++k)
+            {
+                pointLeaves[pointOrder[node.leftFirst + k]] = i;
+            }
+        }
+        else
+        {
+            parents[node.leftFirst] = i;
+            parents[node.leftFirst + 1] = i;
+        }
+    }
+
+    for (const BVHNode &node : nodes)
+    {
+        AABB bounds;
+        bounds.min = node.boundsMin;
+        bounds.max = node.boundsMax;
+        builtSurfaceArea += bounds.surfaceArea();
+    }
+    currentSurfaceArea = builtSurfaceArea;
+}
+
+AABB VertexBVH::computeLeafBounds(const BVHNode &leaf) const
+{
+    AABB bounds;
+    for (int i = 0; i < leaf.triangleCount; ++i)
+    {
+        bounds.expand(points[pointOrder[leaf.leftFirst + i]]);
+    }
+    return bounds;
+}
+
+void VertexBVH::update(int index, const Vector3 &position)
+{
+    if (index < 0 || index >= static_cast<int>(points.size()))
+        return;
+
+    points[index] = position;
+
+    // Recompute the leaf from its points, then walk up until a node's bounds stop changing
+    int nodeIndex = pointLeaves[index];
+    AABB bounds = computeLeafBounds(nodes[nodeIndex]);
+    while (setRefitBounds(nodeIndex, bounds))
+    {
+        nodeIndex = parents[nodeIndex];
+        if (nodeIndex < 0)
+            break;
+
+        const BVHNode &left = nodes[nodes[nodeIndex].leftFirst];
+        const BVHNode &right = nodes[nodes[nodeIndex].leftFirst + 1];
+        bounds = AABB();
+        bounds.expand(left.boundsMin);
+        bounds.expand(left.boundsMax);
+        bounds.expand(right.boundsMin);
+        bounds.expand(right.boundsMax);
+    }
+}
+
+bool VertexBVH::setRefitBounds(int nodeIndex, const AABB &bounds)
+{
+    BVHNode &node = nodes[nodeIndex];
+    if (node.boundsMin == bounds.min && node.boundsMax == bounds.max)
+        return false;
+
+    AABB previous;
+    previous.min = node.boundsMin;
+    previous.max = node.boundsMax;
+    currentSurfaceArea += bounds.surfaceArea() - previous.surfaceArea();
+
+    node.boundsMin = bounds.min;
+    node.boundsMax = bounds.max;
+    return true;
+}
+
+void VertexBVH::findNearRay(const Ray &ray, float radius, float spread, std::vector<VertexHit> &hits) const
+{
+    if (nodes.empty())
+        return;
+
+    const size_t firstHit = hits.size();
+    const Vector3 absDirection(std::fabs(ray.direction.x), std::fabs(ray.direction.y), std::fabs(ray.direction.z));
+
+    int stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const BVHNode &node = nodes[stack[--stackSize]];
+
+        // Widest the cone gets over the box: at the largest ray parameter of any box point
+        float margin = radius;
+        if (spread > 0.0f)
+        {
+            const Vector3 center = (node.boundsMin + node.boundsMax) * 0.5f;
+            const Vector3 halfExtent = (node.boundsMax - node.boundsMin) * 0.5f;
+            const float farthest = Vector3::dot(center - ray.origin, ray.direction) + Vector3::dot(halfExtent, absDirection);
+            margin += spread * std::max(farthest, 0.0f);
+        }
+        // Slack so rounding in the box test never drops a point the exact test below accepts
+        margin = margin * 1.0001f + 1e-6f;
+        if (!rayTouchesBox(ray, node.boundsMin, node.boundsMax, margin))
+            continue;
+
+        if (!node.isLeaf())
+        {
+            stack[stackSize++] = node.leftFirst;
+            stack[stackSize++] = node.leftFirst + 1;
+            continue;
+        }
+
+        for (int i = 0; i < node.triangleCount; ++i)
+        {
+            const int index = pointOrder[node.leftFirst + i];
+            float rayParameter;
+            const float distance = RayIntersection::rayPointDistance(ray, points[index], rayParameter);
+            if (distance <= radius + spread * rayParameter)
+            {
+                hits.emplace_back(true, rayParameter, points[index], index);
+            }
+        }
+    }
+
+    std::sort(hits.begin() + firstHit, hits.end(),
+              [](const VertexHit &a, const VertexHit &b)
+              { return a.vertexIndex < b.vertexIndex; });
+}
+
+int VertexBVH::findNearest(const Vector3 &position, float maxDistance) const
+{
+    if (nodes.empty())
+        return -1;
+
+    int nearest = -1;
+    float nearestDistanceSquared = maxDistance * maxDistance;
+
+    int stack[MAX_STACK_DEPTH];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const BVHNode &node = nodes[stack[--stackSize]];
+        if (boxDistanceSquared(node, position) > nearestDistanceSquared)
+            continue;
+
+        if (!node.isLeaf())
+        {
+            // Nearer child on top, so it tightens the bound before the other is tested
+            const int left = node.leftFirst;
+            const int right = node.leftFirst + 1;
+            const bool leftFirst = boxDistanceSquared(nodes[left], position) <= boxDistanceSquared(nodes[right], position);
+            stack[stackSize++] = leftFirst ? right : left;
+            stack[stackSize++] = leftFirst ? left : right;
+            continue;
+        }
+
+        for (int i = 0; i < node.triangleCount; ++i)
+        {
+            const int index = pointOrder[node.leftFirst + i];
+            const float distanceSquared = (points[index] - position).lengthSquared();
+            if (distanceSquared < nearestDistanceSquared ||
+                (distanceSquared == nearestDistanceSquared && (nearest < 0 || index < nearest)))
+            {
+                nearest = index;
+                nearestDistanceSquared = distanceSquared;
+            }
+        }
+    }
+    return nearest;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "BVH.h"
+#include "Ray.h"
+#include "../math/Vector3.h"
+#include <limits>
+#include <vector>
+
+// Bounding volume hierarchy over points (median split on the longest axis), for picking and
+// snapping vertices without scanning the whole mesh. Moving a point refits the bounds above its
+// leaf, which keeps every query exact at O(log n) per move; rebuild once getRefitGrowth() says
+// the tree has loosened too much.
+class VertexBVH
+{
+private:
+    std::vector<BVHNode> nodes;     // Leaves hold a range of pointOrder (triangleCount = point count)
+    std::vector<Vector3> points;    // Build order
+    std::vector<int> pointOrder;    // Leaf order -> point index
+    std::vector<int> pointLeaves;   // Point index -> leaf node
+    std::vector<int> parents;       // Node -> parent node (-1 for the root)
+    double builtSurfaceArea = 0.0;  // Summed node surface area after build()
+    double currentSurfaceArea = 0.0;
+
+    static constexpr int MAX_LEAF_SIZE = 8;
+    static constexpr int MAX_STACK_DEPTH = 64;
+
+public:
+    void build(const std::vector<Vector3> &positions);
+    void clear();
+
+    // Move one point and refit the bounds above it
+    void update(int index, const Vector3 &position);
+    float getRefitGrowth() const { return builtSurfaceArea > 0.0 ? static_cast<float>(currentSurfaceArea / builtSurfaceArea) : 1.0f; }
+
+    // Append every point within radius + spread * t of the ray, t being the point's (clamped)
+    // parameter along it: spread = 0 is a cylinder, spread > 0 a cone opening from the origin.
+    // Hits are appended in point order and match RayIntersection::intersectVertex() bit for bit.
+    void findNearRay(const Ray &ray, float radius, float spread, std::vector<VertexHit> &hits) const;
+
+    // Closest point within maxDistance (the lower index on ties), -1 if there is none
+    int findNearest(const Vector3 &position, float maxDistance = std::numeric_limits<float>::max()) const;
+
+    // Info
+    bool isEmpty() const { return nodes.empty(); }
+    int getPointCount() const { return static_cast<int>(points.size()); }
+    int getNodeCount() const { return static_cast<int>(nodes.size()); }
+
+private:
+    AABB computeLeafBounds(const BVHNode &leaf) const;
+    bool setRefitBounds(int nodeIndex, const AABB &bounds);
+};
@@ -3,6 +3,7 @@
 #include "../core/Model.h"
 #include "../core/Ray.h"
 #include "../utils/Utils.h"
+#include "../utils/Profiler.h"
 #include <GLFW/glfw3.h>
 #include <cstring>
 #include <algorithm>
@@ -43,6 +44,8 @@ void InputHandler::setExternalResizeCallback(void (*callback)(void *userPtr, int
 
 void InputHandler::update()
 {
+    PROFILE_SCOPE("InputHandler::update");
+
     // Handle preset view keys only
     handlePresetViews();
 
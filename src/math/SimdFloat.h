@@ -0,0 +1,295 @@
+#pragma once
+
+// 8-wide float vector used by the ray packet kernels.
+// Backend is chosen at compile time: AVX2 (one 256-bit register), SSE2 (two
+// 128-bit registers) or a plain scalar loop. Define SIMD_DISABLE to force the
+// scalar backend. All backends do the same IEEE operations in the same order,
+// so results match the scalar Vector3 code bit for bit.
+
+#include <cmath>
+#include <cstdint>
+
+#if !defined(SIMD_DISABLE) && defined(__AVX2__)
+#define SIMD_BACKEND_AVX
+#include <immintrin.h>
+#elif !defined(SIMD_DISABLE) && (defined(__SSE2__) || defined(_M_X64))
+#define SIMD_BACKEND_SSE
+#include <emmintrin.h>
+#else
+#define SIMD_BACKEND_SCALAR
+#endif
+
+struct SimdFloat8;
+
+// Lane mask produced by comparisons (all bits set = true)
+struct SimdMask8 {
+#if defined(SIMD_BACKEND_AVX)
+    __m256 m;
+#elif defined(SIMD_BACKEND_SSE)
+    __m128 lo, hi;
+#else
+    bool lane[8];
+#endif
+
+    // Bit i set when lane i is true
+    int bits() const {
+#if defined(SIMD_BACKEND_AVX)
+        return _mm256_movemask_ps(m);
+#elif defined(SIMD_BACKEND_SSE)
+        return _mm_movemask_ps(lo) | (_mm_movemask_ps(hi) << 4);
+#else
+        int result = 0;
+        for (int i = 0; i < 8; ++i) result |= lane[i] ? (1 << i) : 0;
+        return result;
+#endif
+    }
+
+    bool any() const { return bits() != 0; }
+
+    SimdMask8 operator&(const SimdMask8& other) const {
+        SimdMask8 r;
+#if defined(SIMD_BACKEND_AVX)
+        r.m = _mm256_and_ps(m, other.m);
+#elif defined(SIMD_BACKEND_SSE)
+        r.lo = _mm_and_ps(lo, other.lo);
+        r.hi = _mm_and_ps(hi, other.hi);
+#else
+        for (int i = 0; i < 8; ++i) r.lane[i] = lane[i] && other.lane[i];
+#endif
+        return r;
+    }
+
+    SimdMask8 operator|(const SimdMask8& other) const {
+        SimdMask8 r;
+#if defined(SIMD_BACKEND_AVX)
+        r.m = _mm256_or_ps(m, other.m);
+#elif defined(SIMD_BACKEND_SSE)
+        r.lo = _mm_or_ps(lo, other.lo);
+        r.hi = _mm_or_ps(hi, other.hi);
+#else
+        for (int i = 0; i < 8; ++i) r.lane[i] = lane[i] || other.lane[i];
+#endif
+        return r;
+    }
+
+    // this AND NOT other
+    SimdMask8 andNot(const SimdMask8& other) const {
+        SimdMask8 r;
+#if defined(SIMD_BACKEND_AVX)
+        r.m = _mm256_andnot_ps(other.m, m);
+#elif defined(SIMD_BACKEND_SSE)
+        r.lo = _mm_andnot_ps(other.lo, lo);
+        r.hi = _mm_andnot_ps(other.hi, hi);
+#else
+        for (int i = 0; i < 8; ++i) r.lane[i] = lane[i] && !other.lane[i];
+#endif
+        return r;
+    }
+
+    static SimdMask8 fromBits(int bits) {
+        SimdMask8 r;
+#if defined(SIMD_BACKEND_AVX)
+        __m256i laneBits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        __m256i selected = _mm256_and_si256(_mm256_set1_epi32(bits), laneBits);
+        r.m = _mm256_castsi256_ps(_mm256_cmpeq_epi32(selected, laneBits));
+#elif defined(SIMD_BACKEND_SSE)
+        __m128i loBits = _mm_setr_epi32(1, 2, 4, 8);
+        __m128i hiBits = _mm_setr_epi32(16, 32, 64, 128);
+        __m128i all = _mm_set1_epi32(bits);
+        r.lo = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(all, loBits), loBits));
+        r.hi = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(all, hiBits), hiBits));
+#else
+        for (int i = 0; i < 8; ++i) r.lane[i] = (bits & (1 << i)) != 0;
+#endif
+        return r;
+    }
+};
+
+struct SimdFloat8 {
+#if defined(SIMD_BACKEND_AVX)
+    __m256 v;
+#elif defined(SIMD_BACKEND_SSE)
+    __m128 lo, hi;
+#else
+    float lane[8];
+#endif
+
+    SimdFloat8() = default;
+
+    static SimdFloat8 broadcast(float value) {
+        SimdFloat8 r;
+#if defined(SIMD_BACKEND_AVX)
+        r.v = _mm256_set1_ps(value);
+#elif defined(SIMD_BACKEND_SSE)
+        r.lo = r.hi = _mm_set1_ps(value);
+#else
+        for (int i = 0; i < 8; ++i) r.lane[i] = value;
+#endif
+        return r;
+    }
+
+    // Load/store 8 floats (pointer must be 32-byte aligned)
+    static SimdFloat8 load(const float* data) {
+        SimdFloat8 r;
+#if defined(SIMD_BACKEND_AVX)
+        r.v = _mm256_load_ps(data);
+#elif defined(SIMD_BACKEND_SSE)
+        r.lo = _mm_load_ps(data);
+        r.hi = _mm_load_ps(data + 4);
+#else
+        for (int i = 0; i < 8; ++i) r.lane[i] = data[i];
+#endif
+        return r;
+    }
+
+    void store(float* data) const {
+#if defined(SIMD_BACKEND_AVX)
+        _mm256_store_ps(data, v);
+#elif defined(SIMD_BACKEND_SSE)
+        _mm_store_ps(data, lo);
+        _mm_store_ps(data + 4, hi);
+#else
+        for (int i = 0; i < 8; ++i) data[i] = lane[i];
+#endif
+    }
+
+#if defined(SIMD_BACKEND_AVX)
+#define SIMD_FLOAT8_BINARY(op, avx, sse, scalarExpr)         \
+    SimdFloat8 operator op(const SimdFloat8& o) const {       \
+        SimdFloat8 r;                                         \
+        r.v = avx(v, o.v);                                    \
+        return r;                                             \
+    }
+#elif defined(SIMD_BACKEND_SSE)
+#define SIMD_FLOAT8_BINARY(op, avx, sse, scalarExpr)         \
+    SimdFloat8 operator op(const SimdFloat8& o) const {       \
+        SimdFloat8 r;                                         \
+        r.lo = sse(lo, o.lo);                                 \
+        r.hi = sse(hi, o.hi);                                 \
+        return r;                                             \
+    }
+#else
+#define SIMD_FLOAT8_BINARY(op, avx, sse, scalarExpr)         \
+    SimdFloat8 operator op(const SimdFloat8& o) const {       \
+        SimdFloat8 r;                                         \
+        for (int i = 0; i < 8; ++i) r.lane[i] = scalarExpr;   \
+        return r;                                             \
+    }
+#endif
+
+    SIMD_FLOAT8_BINARY(+, _mm256_add_ps, _mm_add_ps, lane[i] + o.lane[i])
+    SIMD_FLOAT8_BINARY(-, _mm256_sub_ps, _mm_sub_ps, lane[i] - o.lane[i])
+    SIMD_FLOAT8_BINARY(*, _mm256_mul_ps, _mm_mul_ps, lane[i] * o.lane[i])
+    SIMD_FLOAT8_BINARY(/, _mm256_div_ps, _mm_div_ps, lane[i] / o.lane[i])
+#undef SIMD_FLOAT8_BINARY
+
+    // Ordered comparisons (false when either side is NaN, like scalar operators)
+#if defined(SIMD_BACKEND_AVX)
+#define SIMD_FLOAT8_COMPARE(op, avxPredicate, sse)            \
+    SimdMask8 operator op(const SimdFloat8& o) const {        \
+        SimdMask8 r;                                          \
+        r.m = _mm256_cmp_ps(v, o.v, avxPredicate);            \
+        return r;                                             \
+    }
+#elif defined(SIMD_BACKEND_SSE)
+#define SIMD_FLOAT8_COMPARE(op, avxPredicate, sse)            \
+    SimdMask8 operator op(const SimdFloat8& o) const {        \
+        SimdMask8 r;                                          \
+        r.lo = sse(lo, o.lo);                                 \
+        r.hi = sse(hi, o.hi);                                 \
+        return r;                                             \
+    }
+#else
+#define SIMD_FLOAT8_COMPARE(op, avxPredicate, sse)            \
+    SimdMask8 operator op(const SimdFloat8& o) const {        \
+        SimdMask8 r;                                          \
+        for (int i = 0; i < 8; ++i) r.lane[i] = lane[i] op o.lane[i]; \
+        return r;                                             \
+    }
+#endif
+
+    SIMD_FLOAT8_COMPARE(<, _CMP_LT_OQ, _mm_cmplt_ps)
+    SIMD_FLOAT8_COMPARE(>, _CMP_GT_OQ, _mm_cmpgt_ps)
+    SIMD_FLOAT8_COMPARE(<=, _CMP_LE_OQ, _mm_cmple_ps)
+    SIMD_FLOAT8_COMPARE(>=, _CMP_GE_OQ, _mm_cmpge_ps)
+#undef SIMD_FLOAT8_COMPARE
+
+    static SimdFloat8 min(const SimdFloat8& a, const SimdFloat8& b) {
+        SimdFloat8 r;
+#if defined(SIMD_BACKEND_AVX)
+        r.v = _mm256_min_ps(a.v, b.v);
+#elif defined(SIMD_BACKEND_SSE)
+        r.lo = _mm_min_ps(a.lo, b.lo);
+        r.hi = _mm_min_ps(a.hi, b.hi);
+#else
+        for (int i = 0; i < 8; ++i) r.lane[i] = a.lane[i] < b.lane[i] ? a.lane[i] : b.lane[i];
+#endif
+        return r;
+    }
+
+    static SimdFloat8 max(const SimdFloat8& a, const SimdFloat8& b) {
+        SimdFloat8 r;
+#if defined(SIMD_BACKEND_AVX)
+        r.v = _mm256_max_ps(a.v, b.v);
+#elif defined(SIMD_BACKEND_SSE)
+        r.lo = _mm_max_ps(a.lo, b.lo);
+        r.hi = _mm_max_ps(a.hi, b.hi);
+#else
+        for (int i = 0; i < 8; ++i) r.lane[i] = a.lane[i] > b.lane[i] ? a.lane[i] : b.lane[i];
+#endif
+        return r;
+    }
+
+    // Correctly rounded on every backend, like std::sqrt
+    static SimdFloat8 sqrt(const SimdFloat8& a) {
+        SimdFloat8 r;
+#if defined(SIMD_BACKEND_AVX)
+        r.v = _mm256_sqrt_ps(a.v);
+#elif defined(SIMD_BACKEND_SSE)
+        r.lo = _mm_sqrt_ps(a.lo);
+        r.hi = _mm_sqrt_ps(a.hi);
+#else
+        for (int i = 0; i < 8; ++i) r.lane[i] = std::sqrt(a.lane[i]);
+#endif
+        return r;
+    }
+
+    static SimdFloat8 abs(const SimdFloat8& a) {
+        SimdFloat8 r;
+#if defined(SIMD_BACKEND_AVX)
+        r.v = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v);
+#elif defined(SIMD_BACKEND_SSE)
+        __m128 signBit = _mm_set1_ps(-0.0f);
+        r.lo = _mm_andnot_ps(signBit, a.lo);
+        r.hi = _mm_andnot_ps(signBit, a.hi);
+#else
+        for (int i = 0; i < 8; ++i) r.lane[i] = std::abs(a.lane[i]);
+#endif
+        return r;
+    }
+
+    // mask ? a : b, per lane
+    static SimdFloat8 select(const SimdMask8& mask, const SimdFloat8& a, const SimdFloat8& b) {
+        SimdFloat8 r;
+#if defined(SIMD_BACKEND_AVX)
+        r.v = _mm256_blendv_ps(b.v, a.v, mask.m);
+#elif defined(SIMD_BACKEND_SSE)
+        r.lo = _mm_or_ps(_mm_and_ps(mask.lo, a.lo), _mm_andnot_ps(mask.lo, b.lo));
+        r.hi = _mm_or_ps(_mm_and_ps(mask.hi, a.hi), _mm_andnot_ps(mask.hi, b.hi));
+#else
+        for (int i = 0; i < 8; ++i) r.lane[i] = mask.lane[i] ? a.lane[i] : b.lane[i];
+#endif
+        return r;
+    }
+};
+
+// Build-time backend name (for logs and benchmarks)
+inline const char* simdBackendName() {
+#if defined(SIMD_BACKEND_AVX)
+    return "AVX2 (8-wide)";
+#elif defined(SIMD_BACKEND_SSE)
+    return "SSE2 (2x4-wide)";
+#else
+    return "Scalar";
+#endif
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "../math/Vector3.h"
+
+// Camera basis and per-pixel ray direction steps, computed once per frame
+// Direction through pixel (x, y) = topLeftDirection + pixelDeltaX * x + pixelDeltaY * y (unnormalized)
+struct CameraFrame
+{
+    Vector3 origin;
+    Vector3 forward;
+    Vector3 right;
+    Vector3 up;
+    float tanHalfFov = 0.0f;
+
+    Vector3 topLeftDirection; // Direction through pixel (0, 0)
+    Vector3 pixelDeltaX;      // Direction change for one pixel to the right
+    Vector3 pixelDeltaY;      // Direction change for one pixel down
+
+    Vector3 getPixelDirection(int x, int y) const
+    {
+        return topLeftDirection + pixelDeltaX * static_cast<float>(x) + pixelDeltaY * static_cast<float>(y);
+    }
+};
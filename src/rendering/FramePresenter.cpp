@@ -0,0 +1,186 @@
+#include "FramePresenter.h"
+#include "../utils/Utils.h"
+#include <GLFW/glfw3.h>
+#include <cstddef>
+#include <cstring>
+
+// Tokens above OpenGL 1.1 (not declared by every platform's gl.h)
+#ifndef GL_CLAMP_TO_EDGE
+#define GL_CLAMP_TO_EDGE 0x812F
+#endif
+#ifndef GL_UNSIGNED_INT_8_8_8_8_REV
+#define GL_UNSIGNED_INT_8_8_8_8_REV 0x8367
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_WRITE_ONLY
+#define GL_WRITE_ONLY 0x88B9
+#endif
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+namespace
+{
+    // Buffer object entry points (OpenGL 1.5 / 2.1), loaded at runtime
+    typedef void(APIENTRY *GenBuffersProc)(GLsizei count, GLuint *buffers);
+    typedef void(APIENTRY *DeleteBuffersProc)(GLsizei count, const GLuint *buffers);
+    typedef void(APIENTRY *BindBufferProc)(GLenum target, GLuint buffer);
+    typedef void(APIENTRY *BufferDataProc)(GLenum target, std::ptrdiff_t size, const void *data, GLenum usage);
+    typedef void *(APIENTRY *MapBufferProc)(GLenum target, GLenum access);
+    typedef GLboolean(APIENTRY *UnmapBufferProc)(GLenum target);
+
+    GenBuffersProc genBuffers = nullptr;
+    DeleteBuffersProc deleteBuffers = nullptr;
+    BindBufferProc bindBuffer = nullptr;
+    BufferDataProc bufferData = nullptr;
+    MapBufferProc mapBuffer = nullptr;
+    UnmapBufferProc unmapBuffer = nullptr;
+
+    bool loadBufferFunctions()
+    {
+        genBuffers = reinterpret_cast<GenBuffersProc>(glfwGetProcAddress("glGenBuffers"));
+        deleteBuffers = reinterpret_cast<DeleteBuffersProc>(glfwGetProcAddress("glDeleteBuffers"));
+        bindBuffer = reinterpret_cast<BindBufferProc>(glfwGetProcAddress("glBindBuffer"));
+        bufferData = reinterpret_cast<BufferDataProc>(glfwGetProcAddress("glBufferData"));
+        mapBuffer = reinterpret_cast<MapBufferProc>(glfwGetProcAddress("glMapBuffer"));
+        unmapBuffer = reinterpret_cast<UnmapBufferProc>(glfwGetProcAddress("glUnmapBuffer"));
+        return genBuffers && deleteBuffers && bindBuffer && bufferData && mapBuffer && unmapBuffer;
+    }
+}
+
+bool FramePresenter::initialize()
+{
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Pixel unpack buffers are core since OpenGL 2.1
+    const char *version = reinterpret_cast<const char *>(glGetString(GL_VERSION));
+    bool hasPixelBufferObjects = version && (version[0] > '2' || (version[0] == '2' && version[2] >= '1'));
+    usePixelBuffers = hasPixelBufferObjects && loadBufferFunctions();
+    if (usePixelBuffers)
+    {
+        genBuffers(PIXEL_BUFFER_COUNT, pixelBuffers);
+    }
+
+    Utils::logInfo(std::string("Frame presenter initialized (") +
+                   (usePixelBuffers ? "streaming through pixel buffer objects" : "direct texture upload") + ")");
+    return texture != 0;
+}
+
+void FramePresenter::shutdown()
+{
+    if (usePixelBuffers)
+    {
+        deleteBuffers(PIXEL_BUFFER_COUNT, pixelBuffers);
+        pixelBuffers[0] = pixelBuffers[1] = 0;
+        usePixelBuffers = false;
+    }
+    if (texture != 0)
+    {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+    textureWidth = 0;
+    textureHeight = 0;
+}
+
+void FramePresenter::resizeTexture(int width, int height)
+{
+    textureWidth = width;
+    textureHeight = height;
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, nullptr);
+
+    if (usePixelBuffers)
+    {
+        const std::ptrdiff_t size = static_cast<std::ptrdiff_t>(width) * height * sizeof(uint32_t);
+        for (int i = 0; i < PIXEL_BUFFER_COUNT; ++i)
+        {
+            bindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[i]);
+            bufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        }
+        bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+}
+
+void FramePresenter::present(const uint32_t *pixels, int width, int height)
+{
+    if (texture == 0 || width <= 0 || height <= 0)
+        return;
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (width != textureWidth || height != textureHeight)
+    {
+        resizeTexture(width, height);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    bool uploaded = false;
+    if (usePixelBuffers)
+    {
+        // Alternate buffers and orphan the storage first, so mapping never waits for the
+        // transfer still reading the previous frame; the upload itself returns immediately
+        const std::ptrdiff_t size = static_cast<std::ptrdiff_t>(width) * height * sizeof(uint32_t);
+        bindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffers[nextPixelBuffer]);
+        bufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        void *mapped = mapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+        if (mapped)
+        {
+            std::memcpy(mapped, pixels, static_cast<size_t>(size));
+            if (unmapBuffer(GL_PIXEL_UNPACK_BUFFER))
+            {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, nullptr);
+                uploaded = true;
+            }
+        }
+        bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        nextPixelBuffer = (nextPixelBuffer + 1) % PIXEL_BUFFER_COUNT;
+    }
+    if (!uploaded)
+    {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_INT_8_8_8_8_REV, pixels);
+    }
+
+    // Full-viewport quad with identity transforms
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.0f, 0.0f);
+    glVertex2f(-1.0f, -1.0f);
+    glTexCoord2f(1.0f, 0.0f);
+    glVertex2f(1.0f, -1.0f);
+    glTexCoord2f(1.0f, 1.0f);
+    glVertex2f(1.0f, 1.0f);
+    glTexCoord2f(0.0f, 1.0f);
+    glVertex2f(-1.0f, 1.0f);
+    glEnd();
+
+    glDisable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glPopMatrix();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+// Shows the software framebuffer in the OpenGL window through a streaming texture.
+// Each frame is copied into one of two pixel buffer objects (PBOs) and the texture
+// upload is started from there, so the transfer runs asynchronously while the CPU
+// renders the next frame. Falls back to a direct texture upload when PBOs are
+// not available. Needs a current OpenGL context for every call.
+class FramePresenter
+{
+private:
+    static constexpr int PIXEL_BUFFER_COUNT = 2;
+
+    unsigned int texture = 0;
+    unsigned int pixelBuffers[PIXEL_BUFFER_COUNT] = {0, 0};
+    int nextPixelBuffer = 0;
+    int textureWidth = 0;
+    int textureHeight = 0;
+    bool usePixelBuffers = false;
+
+public:
+    FramePresenter() = default;
+    ~FramePresenter() = default; // Call shutdown() while the context is still current
+
+    bool initialize();
+    void shutdown();
+
+    // Upload packed RGBA8 pixels (R in the lowest byte) and draw them over the whole viewport,
+    // first row at the bottom like glDrawPixels
+    void present(const uint32_t *pixels, int width, int height);
+
+    bool isUsingPixelBuffers() const { return usePixelBuffers; }
+
+private:
+    void resizeTexture(int width, int height);
+};
@@ -0,0 +1,49 @@
+#include "Framebuffer.h"
+#include "../utils/Utils.h"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    template <typename T>
+    void resizePlane(std::vector<T> &plane, bool enabled, size_t pixelCount)
+    {
+        if (enabled)
+        {
+            plane.resize(pixelCount);
+        }
+        else
+        {
+            std::vector<T>().swap(plane); // Release the memory, not just the size
+        }
+    }
+}
+
+void Framebuffer::resize(int newWidth, int newHeight, const FramebufferPlanes &newPlanes)
+{
+    width = newWidth;
+    height = newHeight;
+    planes = newPlanes;
+
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    resizePlane(color, planes.color, pixelCount);
+    resizePlane(display, planes.display, pixelCount);
+    resizePlane(hdr, planes.hdr, pixelCount);
+    resizePlane(depth, planes.depth, pixelCount);
+    resizePlane(triangleId, planes.depth, pixelCount);
+}
+
+void Framebuffer::clear(const Vector3 &clearColor)
+{
+    Vector3 clamped(Utils::clamp(clearColor.x, 0.0f, 1.0f), Utils::clamp(clearColor.y, 0.0f, 1.0f),
+                    Utils::clamp(clearColor.z, 0.0f, 1.0f));
+
+    std::fill(color.begin(), color.end(), clamped);
+    std::fill(display.begin(), display.end(), packRGBA8(clamped));
+
+    HdrSample cleared;
+    cleared.color = clearColor;
+    std::fill(hdr.begin(), hdr.end(), cleared);
+    std::fill(depth.begin(), depth.end(), std::numeric_limits<float>::max());
+    std::fill(triangleId.begin(), triangleId.end(), -1);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../math/Vector3.h"
+#include <vector>
+#include <cstdint>
+
+// Which pixel planes a framebuffer keeps; disabled planes are neither allocated nor written
+struct FramebufferPlanes
+{
+    bool color = true;   // Clamped float RGB (12 bytes per pixel)
+    bool display = true; // Packed RGBA8 for presentation (4 bytes per pixel)
+    bool hdr = false;    // Unclamped float RGBA (16 bytes per pixel)
+    bool depth = false;  // Primary hit distance and triangle index (8 bytes per pixel)
+};
+
+// Unclamped radiance of one pixel
+struct HdrSample
+{
+    Vector3 color;
+    float weight = 0.0f; // 1 for traced samples, 0 for pixels filled from a coarser progressive sample
+};
+
+// Renderer output split into planes, so each consumer (display, picking, export)
+// only reads the plane it needs
+struct Framebuffer
+{
+    int width = 0;
+    int height = 0;
+    FramebufferPlanes planes;
+
+    std::vector<Vector3> color;      // Clamped to [0, 1]
+    std::vector<uint32_t> display;   // R in the lowest byte, alpha opaque
+    std::vector<HdrSample> hdr;
+    std::vector<float> depth;        // Distance to the closest primary hit, triangle or overlay (FLT_MAX = sky)
+    std::vector<int> triangleId;     // Triangle index of the primary hit (-1 = overlay or sky)
+
+    // Allocate the enabled planes for the given size and release the others
+    void resize(int newWidth, int newHeight, const FramebufferPlanes &newPlanes);
+    void clear(const Vector3 &clearColor);
+
+    // Truncating 8-bit quantization of a color already clamped to [0, 1]
+    static uint32_t packRGBA8(const Vector3 &color)
+    {
+        uint32_t r = static_cast<uint32_t>(color.x * 255.0f);
+        uint32_t g = static_cast<uint32_t>(color.y * 255.0f);
+        uint32_t b = static_cast<uint32_t>(color.z * 255.0f);
+        return r | (g << 8) | (b << 16) | 0xff000000u;
+    }
+};
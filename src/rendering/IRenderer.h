@@ -1,9 +1,9 @@
 #pragma once
 
+#include "Framebuffer.h"
 #include <vector>
 
 // Forward declarations
-struct Vector3;
 class Model;
 class Camera;
 
@@ -22,9 +22,12 @@ public:
     // Render a model with camera
     virtual void render(const Model& model, const Camera& camera) = 0;
 
-    // Get the rendered pixel data (RGB format)
+    // Get the rendered pixel data (RGB format, empty when the color plane is disabled)
     virtual const std::vector<Vector3>& getPixelData() const = 0;
 
+    // All planes of the last frame (display RGBA8, float color, HDR, depth/ID)
+    virtual const Framebuffer& getFramebuffer() const = 0;
+
     // Clear the screen
     virtual void clear(const Vector3& clearColor) = 0;
 };
\ No newline at end of file
@@ -0,0 +1,627 @@
+#include "ImageWriter.h"
+#include "../utils/ChunkedWriter.h"
+#include "../utils/Utils.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    // ---- Checksums ----
+
+    const std::array<uint32_t, 256> &crcTable()
+    {
+        static const std::array<uint32_t, 256> table = []
+        {
+            std::array<uint32_t, 256> entries{};
+            for (uint32_t n = 0; n < 256; ++n)
+            {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k)
+                {
+                    c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                }
+                entries[n] = c;
+            }
+            return entries;
+        }();
+        return table;
+    }
+
+    uint32_t updateCrc(uint32_t crc, const uint8_t *data, size_t size)
+    {
+        const auto &table = crcTable();
+        for (size_t i = 0; i < size; ++i)
+        {
+            crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+    struct Adler32
+    {
+        uint32_t a = 1;
+        uint32_t b = 0;
+
+        void update(const uint8_t *data, size_t size)
+        {
+            // 5552 bytes is the longest run whose sums cannot overflow before the modulo
+            while (size > 0)
+            {
+                const size_t run = std::min<size_t>(size, 5552);
+                for (size_t i = 0; i < run; ++i)
+                {
+                    a += data[i];
+                    b += a;
+                }
+                a %= 65521;
+                b %= 65521;
+                data += run;
+                size -= run;
+            }
+        }
+        uint32_t value() const { return (b << 16) | a; }
+    };
+
+    void appendBigEndian(std::vector<uint8_t> &out, uint32_t value)
+    {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void appendLittleEndian(std::string &out, uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i)
+        {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+        }
+    }
+
+    void appendFloat(std::string &out, float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        appendLittleEndian(out, bits, 4);
+    }
+
+    void writeBytes(ChunkedWriter &writer, const void *data, size_t size)
+    {
+        writer.write(std::string_view(static_cast<const char *>(data), size));
+    }
+
+    // ---- Deflate (RFC 1951): greedy LZ77 into one block of the fixed Huffman codes ----
+
+    const int LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27,
+                                 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    const int LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    const int DISTANCE_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385,
+                                   513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    const int DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6,
+                                    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    // Streaming compressor: input arrives a scanline at a time, output accumulates in `out`
+    // for the caller to drain. Only the last WINDOW_SIZE bytes of input are kept.
+    class DeflateEncoder
+    {
+    private:
+        static constexpr int WINDOW_SIZE = 1 << 15;
+        static constexpr int MIN_MATCH = 3;
+        static constexpr int MAX_MATCH = 258;
+        static constexpr int HASH_BITS = 15;
+        static constexpr int MAX_CHAIN = 32; // Candidates tried per position
+
+        std::vector<uint8_t> window; // window[0] is input byte `base`
+        int64_t base = 0;
+        int64_t position = 0;        // Next input byte to encode
+        std::vector<int64_t> head;   // Hash -> latest position (-1 = none)
+        std::vector<int64_t> chain;  // position % WINDOW_SIZE -> previous position with that hash
+        uint32_t bitBuffer = 0;
+        int bitCount = 0;
+
+    public:
+        std::vector<uint8_t> out;
+
+        // prefix: bytes of the container (e.g. a zlib header) that precede the deflate stream
+        explicit DeflateEncoder(std::vector<uint8_t> prefix)
+            : head(size_t(1) << HASH_BITS, -1), chain(WINDOW_SIZE, -1), out(std::move(prefix))
+        {
+            writeBits(1, 1); // BFINAL: the whole stream is one block
+            writeBits(1, 2); // BTYPE 01: fixed Huffman codes
+        }
+
+        void write(const uint8_t *data, size_t size)
+        {
+            window.insert(window.end(), data, data + size);
+            encode(false);
+        }
+
+        void finish()
+        {
+            encode(true);
+            writeSymbol(256); // End of block
+            if (bitCount > 0)
+                out.push_back(static_cast<uint8_t>(bitBuffer));
+            bitBuffer = 0;
+            bitCount = 0;
+        }
+
+    private:
+        int64_t end() const { return base + static_cast<int64_t>(window.size()); }
+        uint8_t at(int64_t index) const { return window[static_cast<size_t>(index - base)]; }
+
+        uint32_t hashAt(int64_t index) const
+        {
+            const uint32_t key = at(index) | (at(index + 1) << 8) | (at(index + 2) << 16);
+            return (key * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        void insertHash(int64_t index)
+        {
+            if (index + MIN_MATCH > end())
+                return;
+            const uint32_t hash = hashAt(index);
+            chain[index % WINDOW_SIZE] = head[hash];
+            head[hash] = index;
+        }
+
+        void encode(bool final)
+        {
+            // Without the final flag, keep a full match of lookahead so matches are never cut short
+            const int64_t limit = final ? end() : end() - MAX_MATCH;
+            while (position < limit)
+            {
+                int bestLength = 0;
+                int64_t bestDistance = 0;
+                const int available = static_cast<int>(std::min<int64_t>(MAX_MATCH, end() - position));
+                if (available >= MIN_MATCH)
+                {
+                    int64_t candidate = head[hashAt(position)];
+                    for (int tries = 0; tries < MAX_CHAIN && candidate >= 0 && position - candidate <= WINDOW_SIZE; ++tries)
+                    {
+                        int length = 0;
+                        while (length < available && at(candidate + length) == at(position + length))
+                        {
+                            ++length;
+                        }
+                        if (length > bestLength)
+                        {
+                            bestLength = length;
+                            bestDistance = position - candidate;
+                            if (length == available)
+                                break;
+                        }
+                        candidate = chain[candidate % WINDOW_SIZE];
+                    }
+                }
+
+                if (bestLength >= MIN_MATCH)
+                {
+                    writeMatch(bestLength, static_cast<int>(bestDistance));
+                    for (int i = 0; i < bestLength; ++i)
+                    {
+                        insertHash(position + i);
+                    }
+                    position += bestLength;
+                }
+                else
+                {
+                    writeSymbol(at(position));
+                    insertHash(position);
+                    ++position;
+                }
+            }
+
+            // Drop history that no match can reach any more
+            const int64_t keepFrom = position - WINDOW_SIZE;
+            if (keepFrom - base >= WINDOW_SIZE)
+            {
+                window.erase(window.begin(), window.begin() + static_cast<size_t>(keepFrom - base));
+                base = keepFrom;
+            }
+        }
+
+        void writeBits(uint32_t value, int count)
+        {
+            bitBuffer |= value << bitCount;
+            bitCount += count;
+            while (bitCount >= 8)
+            {
+                out.push_back(static_cast<uint8_t>(bitBuffer));
+                bitBuffer >>= 8;
+                bitCount -= 8;
+            }
+        }
+
+        // Huffman codes are defined most significant bit first
+        void writeCode(uint32_t code, int length)
+        {
+            uint32_t reversed = 0;
+            for (int i = 0; i < length; ++i)
+            {
+                reversed |= ((code >> i) & 1) << (length - 1 - i);
+            }
+            writeBits(reversed, length);
+        }
+
+        void writeSymbol(int symbol)
+        {
+            if (symbol < 144)
+                writeCode(0x30 + symbol, 8);
+            else if (symbol < 256)
+                writeCode(0x190 + symbol - 144, 9);
+            else if (symbol < 280)
+                writeCode(symbol - 256, 7);
+            else
+                writeCode(0xc0 + symbol - 280, 8);
+        }
+
+        void writeMatch(int length, int distance)
+        {
+            int lengthCode = 28;
+            while (LENGTH_BASE[lengthCode] > length)
+            {
+                --lengthCode;
+            }
+            writeSymbol(257 + lengthCode);
+            writeBits(length - LENGTH_BASE[lengthCode], LENGTH_EXTRA[lengthCode]);
+
+            int distanceCode = 29;
+            while (DISTANCE_BASE[distanceCode] > distance)
+            {
+                --distanceCode;
+            }
+            writeCode(distanceCode, 5);
+            writeBits(distance - DISTANCE_BASE[distanceCode], DISTANCE_EXTRA[distanceCode]);
+        }
+    };
+
+    // ---- PNG ----
+
+    constexpr size_t PNG_IDAT_SIZE = 1 << 16; // Compressed bytes per IDAT chunk
+
+    void writePngChunk(ChunkedWriter &writer, const char type[4], const uint8_t *data, size_t size)
+    {
+        std::vector<uint8_t> header;
+        appendBigEndian(header, static_cast<uint32_t>(size));
+        header.insert(header.end(), type, type + 4);
+        writeBytes(writer, header.data(), header.size());
+        if (size > 0)
+            writeBytes(writer, data, size);
+
+        uint32_t crc = updateCrc(0xffffffffu, reinterpret_cast<const uint8_t *>(type), 4);
+        crc = updateCrc(crc, data, size) ^ 0xffffffffu;
+        std::vector<uint8_t> trailer;
+        appendBigEndian(trailer, crc);
+        writeBytes(writer, trailer.data(), trailer.size());
+    }
+
+    uint8_t paethPredictor(int left, int up, int upLeft)
+    {
+        const int estimate = left + up - upLeft;
+        const int toLeft = std::abs(estimate - left);
+        const int toUp = std::abs(estimate - up);
+        const int toUpLeft = std::abs(estimate - upLeft);
+        if (toLeft <= toUp && toLeft <= toUpLeft)
+            return static_cast<uint8_t>(left);
+        return static_cast<uint8_t>(toUp <= toUpLeft ? up : upLeft);
+    }
+
+    // Filter one RGB scanline with the given PNG filter type into filtered[1..]
+    void filterRow(int type, const std::vector<uint8_t> &row, const std::vector<uint8_t> &previous,
+                   std::vector<uint8_t> &filtered)
+    {
+        constexpr int BYTES_PER_PIXEL = 3;
+        filtered[0] = static_cast<uint8_t>(type);
+        for (size_t i = 0; i < row.size(); ++i)
+        {
+            const int left = i >= BYTES_PER_PIXEL ? row[i - BYTES_PER_PIXEL] : 0;
+            const int up = previous[i];
+            const int upLeft = i >= BYTES_PER_PIXEL ? previous[i - BYTES_PER_PIXEL] : 0;
+            int predicted = 0;
+            switch (type)
+            {
+            case 1: predicted = left; break;
+            case 2: predicted = up; break;
+            case 3: predicted = (left + up) / 2; break;
+            case 4: predicted = paethPredictor(left, up, upLeft); break;
+            default: break;
+            }
+            filtered[i + 1] = static_cast<uint8_t>(row[i] - predicted);
+        }
+    }
+
+    // Usual heuristic: the filter whose output, read as signed bytes, sums smallest
+    int filterCost(const std::vector<uint8_t> &filtered)
+    {
+        int cost = 0;
+        for (size_t i = 1; i < filtered.size(); ++i)
+        {
+            cost += std::abs(static_cast<int>(static_cast<int8_t>(filtered[i])));
+        }
+        return cost;
+    }
+}
+
+namespace ImageFiles
+{
+    bool writePng(const std::string &path, int width, int height, const uint32_t *rgba)
+    {
+        ChunkedWriter writer;
+        if (width <= 0 || height <= 0 || !writer.open(path))
+            return false;
+
+        static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        writeBytes(writer, SIGNATURE, sizeof(SIGNATURE));
+
+        std::vector<uint8_t> header;
+        appendBigEndian(header, static_cast<uint32_t>(width));
+        appendBigEndian(header, static_cast<uint32_t>(height));
+        const uint8_t format[5] = {8, 2, 0, 0, 0}; // 8-bit RGB, deflate, adaptive filtering, no interlace
+        header.insert(header.end(), format, format + 5);
+        writePngChunk(writer, "IHDR", header.data(), header.size());
+
+        DeflateEncoder deflate({0x78, 0x01}); // zlib header: deflate, 32K window, no dictionary
+        Adler32 adler;
+
+        const size_t rowBytes = static_cast<size_t>(width) * 3;
+        std::vector<uint8_t> row(rowBytes);
+        std::vector<uint8_t> previous(rowBytes, 0);
+        std::vector<uint8_t> filtered(rowBytes + 1);
+        std::vector<uint8_t> best(rowBytes + 1);
+        for (int y = 0; y < height; ++y)
+        {
+            const uint32_t *pixels = rgba + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x)
+            {
+                row[3 * x] = static_cast<uint8_t>(pixels[x]);
+                row[3 * x + 1] = static_cast<uint8_t>(pixels[x] >> 8);
+                row[3 * x + 2] = static_cast<uint8_t>(pixels[x] >> 16);
+            }
+
+            int bestCost = -1;
+            for (int type = 0; type <= 4; ++type)
+            {
+                filterRow(type, row, previous, filtered);
+                const int cost = filterCost(filtered);
+                if (bestCost < 0 || cost < bestCost)
+                {
+                    bestCost = cost;
+                    best.swap(filtered);
+                }
+            }
+
+            adler.update(best.data(), best.size());
+            deflate.write(best.data(), best.size());
+            previous.swap(row);
+
+            if (deflate.out.size() >= PNG_IDAT_SIZE)
+            {
+                writePngChunk(writer, "IDAT", deflate.out.data(), deflate.out.size());
+                deflate.out.clear();
+            }
+        }
+
+        deflate.finish();
+        appendBigEndian(deflate.out, adler.value());
+        writePngChunk(writer, "IDAT", deflate.out.data(), deflate.out.size());
+        writePngChunk(writer, "IEND", nullptr, 0);
+        return writer.close();
+    }
+
+    bool writeExr(const std::string &path, int width, int height, const Vector3 *rgb)
+    {
+        ChunkedWriter writer;
+        if (width <= 0 || height <= 0 || !writer.open(path))
+            return false;
+
+        // Magic number, then version 2 with no flags (single-part scanline file)
+        std::string header = {0x76, 0x2f, 0x31, 0x01, 0x02, 0x00, 0x00, 0x00};
+        auto beginAttribute = [&](const char *name, const char *type, int size)
+        {
+            header.append(name).push_back('\0');
+            header.append(type).push_back('\0');
+            appendLittleEndian(header, static_cast<uint32_t>(size), 4);
+        };
+
+        // Channels in the alphabetical order the file stores them: 32-bit float, no subsampling
+        const char *CHANNELS[3] = {"B", "G", "R"};
+        beginAttribute("channels", "chlist", 3 * (2 + 16) + 1);
+        for (const char *channel : CHANNELS)
+        {
+            header.append(channel).push_back('\0');
+            appendLittleEndian(header, 2, 4); // FLOAT
+            appendLittleEndian(header, 0, 4); // pLinear and reserved bytes
+            appendLittleEndian(header, 1, 4); // xSampling
+            appendLittleEndian(header, 1, 4); // ySampling
+        }
+        header.push_back('\0');
+
+        beginAttribute("compression", "compression", 1);
+        header.push_back('\0'); // NO_COMPRESSION
+        for (const char *window : {"dataWindow", "displayWindow"})
+        {
+            beginAttribute(window, "box2i", 16);
+            appendLittleEndian(header, 0, 4);
+            appendLittleEndian(header, 0, 4);
+            appendLittleEndian(header, static_cast<uint32_t>(width - 1), 4);
+            appendLittleEndian(header, static_cast<uint32_t>(height - 1), 4);
+        }
+        beginAttribute("lineOrder", "lineOrder", 1);
+        header.push_back('\0'); // INCREASING_Y
+        beginAttribute("pixelAspectRatio", "float", 4);
+        appendFloat(header, 1.0f);
+        beginAttribute("screenWindowCenter", "v2f", 8);
+        appendFloat(header, 0.0f);
+        appendFloat(header, 0.0f);
+        beginAttribute("screenWindowWidth", "float", 4);
+        appendFloat(header, 1.0f);
+        header.push_back('\0'); // End of header
+
+        // Offset table: one chunk per scanline, each a y coordinate, a byte count and the pixels
+        const uint64_t lineBytes = static_cast<uint64_t>(width) * 3 * sizeof(float);
+        const uint64_t firstChunk = header.size() + static_cast<uint64_t>(height) * 8;
+        for (int y = 0; y < height; ++y)
+        {
+            appendLittleEndian(header, firstChunk + static_cast<uint64_t>(y) * (8 + lineBytes), 8);
+        }
+        writer.write(header);
+
+        std::string line;
+        line.reserve(8 + lineBytes);
+        for (int y = 0; y < height; ++y)
+        {
+            const Vector3 *pixels = rgb + static_cast<size_t>(y) * width;
+            line.clear();
+            appendLittleEndian(line, static_cast<uint32_t>(y), 4);
+            appendLittleEndian(line, static_cast<uint32_t>(lineBytes), 4);
+            for (int x = 0; x < width; ++x)
+                appendFloat(line, pixels[x].z);
+            for (int x = 0; x < width; ++x)
+                appendFloat(line, pixels[x].y);
+            for (int x = 0; x < width; ++x)
+                appendFloat(line, pixels[x].x);
+            writer.write(line);
+        }
+        return writer.close();
+    }
+
+    bool writeRaw(const std::string &path, int width, int height, const Vector3 *rgb)
+    {
+        ChunkedWriter writer;
+        if (width <= 0 || height <= 0 || !writer.open(path))
+            return false;
+
+        std::vector<float> line(static_cast<size_t>(width) * 3);
+        for (int y = 0; y < height; ++y)
+        {
+            const Vector3 *pixels = rgb + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x)
+            {
+                line[3 * x] = pixels[x].x;
+                line[3 * x + 1] = pixels[x].y;
+                line[3 * x + 2] = pixels[x].z;
+            }
+            writeBytes(writer, line.data(), line.size() * sizeof(float));
+        }
+        return writer.close();
+    }
+
+    bool write(const ImageFrame &frame)
+    {
+        const size_t pixelCount = static_cast<size_t>(std::max(frame.width, 0)) * std::max(frame.height, 0);
+        switch (frame.format)
+        {
+        case ImageFormat::PNG:
+            return frame.display.size() == pixelCount && writePng(frame.path, frame.width, frame.height, frame.display.data());
+        case ImageFormat::EXR:
+            return frame.color.size() == pixelCount && writeExr(frame.path, frame.width, frame.height, frame.color.data());
+        case ImageFormat::RAW:
+            return frame.color.size() == pixelCount && writeRaw(frame.path, frame.width, frame.height, frame.color.data());
+        }
+        return false;
+    }
+
+    bool parseFormat(const std::string &name, ImageFormat &format)
+    {
+        if (name == "png")
+            format = ImageFormat::PNG;
+        else if (name == "exr")
+            format = ImageFormat::EXR;
+        else if (name == "raw")
+            format = ImageFormat::RAW;
+        else
+            return false;
+        return true;
+    }
+
+    const char *getExtension(ImageFormat format)
+    {
+        switch (format)
+        {
+        case ImageFormat::PNG: return ".png";
+        case ImageFormat::EXR: return ".exr";
+        case ImageFormat::RAW: return ".raw";
+        }
+        return "";
+    }
+}
+
+ImageWriter::ImageWriter(size_t maxPending) : maxPending(std::max<size_t>(maxPending, 1))
+{
+    thread = std::thread(&ImageWriter::run, this);
+}
+
+ImageWriter::~ImageWriter()
+{
+    finish();
+}
+
+bool ImageWriter::submit(ImageFrame &&frame)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    queueChanged.wait(lock, [this] { return stopping || queue.size() < maxPending; });
+    if (stopping)
+        return false;
+
+    queue.push_back(std::move(frame));
+    queueChanged.notify_all();
+    return true;
+}
+
+bool ImageWriter::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queueChanged.notify_all();
+    if (thread.joinable())
+        thread.join();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return failedCount == 0;
+}
+
+int ImageWriter::getWrittenCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return writtenCount;
+}
+
+int ImageWriter::getFailedCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return failedCount;
+}
+
+void ImageWriter::run()
+{
+    for (;;)
+    {
+        ImageFrame frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queueChanged.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty())
+                return; // Stopping and drained
+            frame = std::move(queue.front());
+            queue.pop_front();
+        }
+        queueChanged.notify_all(); // Room for a blocked submit()
+
+        const bool written = ImageFiles::write(frame);
+        if (written)
+            LOG_INFO("Image written: " + frame.path);
+        else
+            Utils::logError("Failed to write image: " + frame.path);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (written)
+            ++writtenCount;
+        else
+            ++failedCount;
+    }
+}
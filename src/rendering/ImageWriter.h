@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../math/Vector3.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class ImageFormat
+{
+    PNG, // 8-bit RGB from the display plane
+    EXR, // Uncompressed 32-bit float RGB scanlines (OpenEXR)
+    RAW  // Headerless 32-bit float RGB, rows top to bottom, native byte order
+};
+
+// One finished frame waiting to be encoded. Only the plane the format needs is filled:
+// PNG reads display (RGBA8, R in the lowest byte), EXR and RAW read color (linear, unclamped).
+struct ImageFrame
+{
+    std::string path;
+    ImageFormat format = ImageFormat::PNG;
+    int width = 0;
+    int height = 0;
+    std::vector<uint32_t> display;
+    std::vector<Vector3> color;
+};
+
+// Image encoders without external dependencies. Each streams the file through a
+// ChunkedWriter, so encoding needs no second copy of the image.
+namespace ImageFiles
+{
+    bool writePng(const std::string &path, int width, int height, const uint32_t *rgba);
+    bool writeExr(const std::string &path, int width, int height, const Vector3 *rgb);
+    bool writeRaw(const std::string &path, int width, int height, const Vector3 *rgb);
+
+    bool write(const ImageFrame &frame);
+    bool parseFormat(const std::string &name, ImageFormat &format); // "png", "exr" or "raw"
+    const char *getExtension(ImageFormat format);
+}
+
+// Encodes and writes frames on a background thread so rendering never waits on disk.
+// At most maxPending frames are queued; submit() blocks beyond that, which bounds
+// memory when frames render faster than they can be written.
+class ImageWriter
+{
+private:
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable queueChanged;
+    std::deque<ImageFrame> queue;
+    size_t maxPending;
+    bool stopping = false;
+    int writtenCount = 0;
+    int failedCount = 0;
+
+public:
+    explicit ImageWriter(size_t maxPending = 4);
+    ~ImageWriter();
+
+    // Non-copyable
+    ImageWriter(const ImageWriter &) = delete;
+    ImageWriter &operator=(const ImageWriter &) = delete;
+
+    // Thread-safe; false once finish() has been called
+    bool submit(ImageFrame &&frame);
+
+    // Write everything still queued and stop the thread; true if every frame was written
+    bool finish();
+
+    int getWrittenCount();
+    int getFailedCount();
+
+private:
+    void run();
+};
@@ -0,0 +1,280 @@
+#include "SoftwareRenderer.h"
+#include "ImageWriter.h"
+#include "../core/Scene.h"
+#include "../utils/Utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless offline renderer: loads a .fjwr scene, renders it from a list of camera poses
+// (a turntable around the model or poses read from a file) and streams the frames to
+// PNG, EXR or raw float files through a background writer.
+//
+// Usage: offline-render --scene file.fjwr [--output-dir DIR] [--prefix NAME] [--format png|exr|raw]
+//                       [--size WxH] [--turntable N] [--pitch DEG] [--distance D] [--fov DEG]
+//                       [--poses file.txt] [--jobs N] [--reflection-depth N] [--verbose]
+//
+// A poses file holds one pose per line, "px py pz tx ty tz [fov]" (position, target, FOV
+// in degrees); blank lines and lines starting with '#' are skipped.
+
+namespace {
+
+struct OfflineOptions {
+    std::string scenePath;
+    std::string outputDir = ".";
+    std::string prefix = "frame";
+    ImageFormat format = ImageFormat::PNG;
+    int width = 1280;
+    int height = 720;
+    int turntableFrames = 36;
+    float pitchDegrees = 25.0f;
+    float distance = 0.0f; // 0 = fit the model
+    float fovDegrees = 45.0f;
+    std::string posesPath;
+    int jobs = 1;             // Frames rendered at once, each on its share of the hardware threads
+    int reflectionDepth = -1; // -1 = renderer default
+    bool verbose = false;
+};
+
+struct CameraPose {
+    Vector3 position;
+    Vector3 target;
+    float fovDegrees;
+};
+
+void printUsage(const char *program) {
+    std::cerr << "Usage: " << program
+              << " --scene file.fjwr [--output-dir DIR] [--prefix NAME] [--format png|exr|raw]\n"
+              << "       [--size WxH] [--turntable N] [--pitch DEG] [--distance D] [--fov DEG]\n"
+              << "       [--poses file.txt] [--jobs N] [--reflection-depth N] [--verbose]" << std::endl;
+}
+
+bool parseOptions(int argc, char **argv, OfflineOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--scene" && hasValue) {
+            options.scenePath = argv[++i];
+        } else if (arg == "--output-dir" && hasValue) {
+            options.outputDir = argv[++i];
+        } else if (arg == "--prefix" && hasValue) {
+            options.prefix = argv[++i];
+        } else if (arg == "--format" && hasValue) {
+            if (!ImageFiles::parseFormat(argv[++i], options.format)) {
+                std::cerr << "Unknown image format: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--size" && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 ||
+                options.width <= 0 || options.height <= 0) {
+                std::cerr << "Invalid size (expected WxH): " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--turntable" && hasValue) {
+            options.turntableFrames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--pitch" && hasValue) {
+            options.pitchDegrees = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--distance" && hasValue) {
+            options.distance = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--fov" && hasValue) {
+            options.fovDegrees = static_cast<float>(std::atof(argv[++i]));
+        } else if (arg == "--poses" && hasValue) {
+            options.posesPath = argv[++i];
+        } else if (arg == "--jobs" && hasValue) {
+            options.jobs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--reflection-depth" && hasValue) {
+            options.reflectionDepth = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--verbose") {
+            options.verbose = true;
+        } else {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (options.scenePath.empty()) {
+        printUsage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+bool loadPoses(const OfflineOptions &options, std::vector<CameraPose> &poses) {
+    std::ifstream file(options.posesPath);
+    if (!file) {
+        Utils::logError("Cannot open poses file: " + options.posesPath);
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::istringstream fields(line);
+        std::string first;
+        if (!(fields >> first) || first[0] == '#')
+            continue;
+
+        fields.clear();
+        fields.str(line);
+        CameraPose pose;
+        pose.fovDegrees = options.fovDegrees;
+        if (!(fields >> pose.position.x >> pose.position.y >> pose.position.z >>
+              pose.target.x >> pose.target.y >> pose.target.z)) {
+            Utils::logError("Invalid pose on line " + std::to_string(lineNumber) + " of " + options.posesPath);
+            return false;
+        }
+        fields >> pose.fovDegrees; // Optional
+        poses.push_back(pose);
+    }
+    return true;
+}
+
+// Evenly spaced yaws around the model's bounding-box center
+std::vector<CameraPose> createTurntable(const OfflineOptions &options, const Model &model) {
+    Vector3 boundsMin(1e30f, 1e30f, 1e30f);
+    Vector3 boundsMax(-1e30f, -1e30f, -1e30f);
+    for (const Vertex &vertex : model.getVertices()) {
+        boundsMin = Vector3(std::min(boundsMin.x, vertex.position.x), std::min(boundsMin.y, vertex.position.y),
+                            std::min(boundsMin.z, vertex.position.z));
+        boundsMax = Vector3(std::max(boundsMax.x, vertex.position.x), std::max(boundsMax.y, vertex.position.y),
+                            std::max(boundsMax.z, vertex.position.z));
+    }
+    const Vector3 center = model.getVertexCount() > 0 ? (boundsMin + boundsMax) * 0.5f : Vector3(0, 0, 0);
+    const float radius = model.getVertexCount() > 0 ? (boundsMax - boundsMin).length() * 0.5f : 1.0f;
+
+    // Far enough that the bounding sphere fits the vertical field of view
+    const float halfFov = std::max(options.fovDegrees, 1.0f) * 0.5f * Utils::DEG_TO_RAD;
+    const float distance = options.distance > 0.0f ? options.distance : std::max(radius, 0.1f) / std::sin(halfFov) * 1.1f;
+
+    Camera camera;
+    camera.setTarget(center);
+    camera.setDistance(distance);
+    camera.setPitch(options.pitchDegrees * Utils::DEG_TO_RAD);
+
+    std::vector<CameraPose> poses;
+    poses.reserve(options.turntableFrames);
+    for (int frame = 0; frame < options.turntableFrames; ++frame) {
+        camera.setYaw(2.0f * Utils::PI * frame / options.turntableFrames);
+        poses.push_back({camera.getPosition(), center, options.fovDegrees});
+    }
+    return poses;
+}
+
+std::string framePath(const OfflineOptions &options, int frame) {
+    char number[16];
+    std::snprintf(number, sizeof(number), "_%04d", frame);
+    return options.outputDir + "/" + options.prefix + number + ImageFiles::getExtension(options.format);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    OfflineOptions options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+    if (!options.verbose)
+        Utils::setLogLevel(Utils::LogLevel::Warning);
+
+    Model model;
+    if (!model.loadFromFile(options.scenePath)) {
+        Utils::logError("Cannot load scene: " + options.scenePath);
+        return 1;
+    }
+
+    std::vector<CameraPose> poses;
+    if (!options.posesPath.empty()) {
+        if (!loadPoses(options, poses))
+            return 1;
+    } else {
+        poses = createTurntable(options, model);
+    }
+    if (poses.empty()) {
+        Utils::logError("No camera poses to render");
+        return 1;
+    }
+
+    // Every renderer shares the scene's meshes; frames in flight split the hardware threads
+    Scene scene;
+    std::vector<int> faceTriangles;
+    scene.addConnectedParts(model, faceTriangles);
+
+    const int frameCount = static_cast<int>(poses.size());
+    const int jobs = std::min(options.jobs, frameCount);
+    const int hardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int threadsPerJob = std::max(1, hardwareThreads / jobs);
+
+    // PNG takes the display bytes; float formats keep the unclamped radiance of the HDR plane
+    FramebufferPlanes planes;
+    planes.display = options.format == ImageFormat::PNG;
+    planes.color = false;
+    planes.hdr = !planes.display;
+
+    std::cout << "Rendering " << frameCount << " frames at " << options.width << "x" << options.height << " ("
+              << jobs << " in flight, " << threadsPerJob << " threads each) to " << options.outputDir << std::endl;
+
+    const auto start = std::chrono::steady_clock::now();
+    ImageWriter writer(2 * static_cast<size_t>(jobs));
+    std::atomic<int> nextFrame{0};
+    auto renderFrames = [&]() {
+        SoftwareRenderer renderer;
+        renderer.setShowVertices(false);
+        renderer.setShowEdges(false);
+        renderer.setShowCoordinateAxes(false);
+        renderer.setRenderThreadCount(threadsPerJob);
+        renderer.setFramebufferPlanes(planes);
+        renderer.setResolution(options.width, options.height);
+        if (options.reflectionDepth >= 0) {
+            // Depth = reflection bounces traced, as in the benchmark
+            renderer.getReflectionConfig().enableReflection = options.reflectionDepth > 0;
+            renderer.getReflectionConfig().maxReflectionDepth = options.reflectionDepth + 1;
+        }
+        renderer.setScene(scene);
+
+        for (int frame = nextFrame++; frame < frameCount; frame = nextFrame++) {
+            const CameraPose &pose = poses[frame];
+            renderer.setCamera(pose.position, pose.target, Vector3(0, 0, 1));
+            renderer.setCameraFOV(pose.fovDegrees);
+            renderer.render();
+
+            ImageFrame image;
+            image.path = framePath(options, frame);
+            image.format = options.format;
+            image.width = options.width;
+            image.height = options.height;
+            if (planes.display) {
+                image.display = renderer.getDisplayPixels();
+            } else {
+                const std::vector<HdrSample> &hdr = renderer.getFramebuffer().hdr;
+                image.color.resize(hdr.size());
+                for (size_t i = 0; i < hdr.size(); ++i) {
+                    image.color[i] = hdr[i].color;
+                }
+            }
+            writer.submit(std::move(image)); // Blocks while the writer is behind
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int job = 1; job < jobs; ++job) {
+        workers.emplace_back(renderFrames);
+    }
+    renderFrames(); // The main thread renders too
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    const bool written = writer.finish();
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Wrote " << writer.getWrittenCount() << " of " << frameCount << " frames in " << seconds << " s ("
+              << (seconds > 0.0 ? frameCount / seconds : 0.0) << " frames/s)" << std::endl;
+    return written ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+#include "Rasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void GBuffer::resize(int newWidth, int newHeight)
+{
+    width = newWidth;
+    height = newHeight;
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    depth.assign(pixelCount, std::numeric_limits<float>::max());
+    triangleId.assign(pixelCount, -1);
+    normal.assign(pixelCount, Vector3(0.0f, 0.0f, 0.0f));
+    frontFace.assign(pixelCount, 0);
+}
+
+void Rasterizer::setTriangles(const std::vector<Triangle> &triangles)
+{
+    triangleData.resize(triangles.size());
+    vertices.resize(triangles.size() * 3);
+    for (size_t i = 0; i < triangles.size(); ++i)
+    {
+        triangleData[i] = TriangleIntersectionData(triangles[i]);
+        vertices[3 * i] = triangles[i].v0;
+        vertices[3 * i + 1] = triangles[i].v1;
+        vertices[3 * i + 2] = triangles[i].v2;
+    }
+}
+
+void Rasterizer::updateTriangle(int index, const Triangle &triangle)
+{
+    if (index < 0 || index >= static_cast<int>(triangleData.size()))
+        return;
+
+    triangleData[index] = TriangleIntersectionData(triangle);
+    vertices[3 * index] = triangle.v0;
+    vertices[3 * index + 1] = triangle.v1;
+    vertices[3 * index + 2] = triangle.v2;
+}
+
+void Rasterizer::beginFrame(const CameraFrame &cameraFrame, int imageWidth, int imageHeight, int tileEdge, float rayEpsilon,
+                            const std::vector<int> *candidates, bool cullBackFaces)
+{
+    frame = cameraFrame;
+    width = imageWidth;
+    height = imageHeight;
+    tileSize = tileEdge;
+    tilesX = (width + tileSize - 1) / tileSize;
+    tilesY = (height + tileSize - 1) / tileSize;
+    nearLimit = rayEpsilon;
+
+    screenTriangles.clear();
+    frameTriangleCount = 0;
+    tileBins.resize(tilesX * tilesY);
+    for (auto &bin : tileBins)
+    {
+        bin.clear();
+    }
+
+    // P - origin = w * (topLeft + deltaX * x + deltaY * y), so inverting the matrix with
+    // those three columns maps a world point to homogeneous pixel coordinates (w, w * x, w * y)
+    const Vector3 &a = frame.topLeftDirection;
+    const Vector3 &b = frame.pixelDeltaX;
+    const Vector3 &c = frame.pixelDeltaY;
+    Vector3 rowW = Vector3::cross(b, c);
+    float determinant = Vector3::dot(a, rowW);
+    if (std::abs(determinant) < 1e-20f)
+        return; // Degenerate camera
+    rowW = rowW / determinant;
+    Vector3 rowX = Vector3::cross(c, a) / determinant;
+    Vector3 rowY = Vector3::cross(a, b) / determinant;
+
+    const int triangleCount = static_cast<int>(triangleData.size());
+    planeDistances.resize(triangleCount);
+    const int submittedCount = candidates ? static_cast<int>(candidates->size()) : triangleCount;
+
+    for (int submitted = 0; submitted < submittedCount; ++submitted)
+    {
+        const int i = candidates ? (*candidates)[submitted] : submitted;
+        planeDistances[i] = triangleData[i].planeOffset - Vector3::dot(triangleData[i].normal, frame.origin);
+
+        // The camera is on the back side of the plane (or in it)
+        if (cullBackFaces && planeDistances[i] >= 0.0f)
+            continue;
+
+        Vector3 homogeneous[3];
+        int behindCount = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            Vector3 toVertex = vertices[3 * i + k] - frame.origin;
+            homogeneous[k] = Vector3(Vector3::dot(rowW, toVertex), Vector3::dot(rowX, toVertex), Vector3::dot(rowY, toVertex));
+            if (homogeneous[k].x < nearLimit)
+                behindCount++;
+        }
+
+        if (behindCount == 3)
+            continue; // Entirely behind the camera
+        frameTriangleCount++;
+
+        if (behindCount == 0)
+        {
+            addScreenTriangle(homogeneous, i);
+            continue;
+        }
+
+        // Clip against the near plane w = nearLimit (gives a triangle or a quad)
+        Vector3 polygon[4];
+        int polygonSize = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            const Vector3 &current = homogeneous[k];
+            const Vector3 &next = homogeneous[(k + 1) % 3];
+            bool currentInside = current.x >= nearLimit;
+            bool nextInside = next.x >= nearLimit;
+
+            if (currentInside)
+                polygon[polygonSize++] = current;
+            if (currentInside != nextInside)
+            {
+                float s = (nearLimit - current.x) / (next.x - current.x);
+                polygon[polygonSize++] = current + (next - current) * s;
+            }
+        }
+
+        Vector3 fan[3] = {polygon[0], polygon[1], polygon[2]};
+        addScreenTriangle(fan, i);
+        if (polygonSize == 4)
+        {
+            Vector3 secondFan[3] = {polygon[0], polygon[2], polygon[3]};
+            addScreenTriangle(secondFan, i);
+        }
+    }
+}
+
+void Rasterizer::addScreenTriangle(const Vector3 homogeneous[3], int triangleIndex)
+{
+    ScreenTriangle screenTriangle;
+    for (int k = 0; k < 3; ++k)
+    {
+        screenTriangle.x[k] = homogeneous[k].y / homogeneous[k].x;
+        screenTriangle.y[k] = homogeneous[k].z / homogeneous[k].x;
+    }
+    screenTriangle.triangleIndex = triangleIndex;
+
+    // Samples sit on integer pixel coordinates, so the covered range is [ceil(min), floor(max)]
+    float minX = std::min({screenTriangle.x[0], screenTriangle.x[1], screenTriangle.x[2]});
+    float maxX = std::max({screenTriangle.x[0], screenTriangle.x[1], screenTriangle.x[2]});
+    float minY = std::min({screenTriangle.y[0], screenTriangle.y[1], screenTriangle.y[2]});
+    float maxY = std::max({screenTriangle.y[0], screenTriangle.y[1], screenTriangle.y[2]});
+    if (!(maxX >= 0.0f && minX <= width - 1 && maxY >= 0.0f && minY <= height - 1))
+        return; // Off screen (also rejects NaN)
+
+    int tileX0 = static_cast<int>(std::ceil(std::max(minX, 0.0f))) / tileSize;
+    int tileX1 = static_cast<int>(std::floor(std::min(maxX, static_cast<float>(width - 1)))) / tileSize;
+    int tileY0 = static_cast<int>(std::ceil(std::max(minY, 0.0f))) / tileSize;
+    int tileY1 = static_cast<int>(std::floor(std::min(maxY, static_cast<float>(height - 1)))) / tileSize;
+
+    int index = static_cast<int>(screenTriangles.size());
+    screenTriangles.push_back(screenTriangle);
+    for (int tileY = tileY0; tileY <= tileY1; ++tileY)
+    {
+        for (int tileX = tileX0; tileX <= tileX1; ++tileX)
+        {
+            tileBins[tileY * tilesX + tileX].push_back(index);
+        }
+    }
+}
+
+namespace
+{
+    // Top-left style tie rule: of the two orientations of a shared edge exactly one owns
+    // samples lying on it, so neighbouring triangles neither overlap nor leave cracks
+    bool ownsEdge(float dx, float dy)
+    {
+        return dy > 0.0f || (dy == 0.0f && dx < 0.0f);
+    }
+
+    bool insideEdge(float value, bool owned)
+    {
+        return value > 0.0f || (value == 0.0f && owned);
+    }
+}
+
+void Rasterizer::rasterizeTile(int x0, int y0, int x1, int y1, GBuffer &gBuffer) const
+{
+    for (int y = y0; y < y1; ++y)
+    {
+        for (int x = x0; x < x1; ++x)
+        {
+            int pixel = y * gBuffer.width + x;
+            gBuffer.depth[pixel] = std::numeric_limits<float>::max();
+            gBuffer.triangleId[pixel] = -1;
+        }
+    }
+
+    if (tileBins.empty())
+        return;
+
+    const std::vector<int> &bin = tileBins[(y0 / tileSize) * tilesX + (x0 / tileSize)];
+    for (int screenIndex : bin)
+    {
+        const ScreenTriangle &triangle = screenTriangles[screenIndex];
+
+        // Orient counter-clockwise in this edge-function convention (both faces are kept)
+        int i0 = 0, i1 = 1, i2 = 2;
+        float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) -
+                     (triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+        if (area == 0.0f || std::isnan(area))
+            continue;
+        if (area < 0.0f)
+            std::swap(i1, i2);
+
+        const float ax = triangle.x[i0], ay = triangle.y[i0];
+        const float bx = triangle.x[i1], by = triangle.y[i1];
+        const float cx = triangle.x[i2], cy = triangle.y[i2];
+        const bool ownsAB = ownsEdge(bx - ax, by - ay);
+        const bool ownsBC = ownsEdge(cx - bx, cy - by);
+        const bool ownsCA = ownsEdge(ax - cx, ay - cy);
+
+        // Sample range clamped to this tile
+        int startX = std::max(x0, static_cast<int>(std::ceil(std::max(std::min({ax, bx, cx}), static_cast<float>(x0)))));
+        int endX = std::min(x1 - 1, static_cast<int>(std::floor(std::min(std::max({ax, bx, cx}), static_cast<float>(x1 - 1)))));
+        int startY = std::max(y0, static_cast<int>(std::ceil(std::max(std::min({ay, by, cy}), static_cast<float>(y0)))));
+        int endY = std::min(y1 - 1, static_cast<int>(std::floor(std::min(std::max({ay, by, cy}), static_cast<float>(y1 - 1)))));
+
+        const TriangleIntersectionData &data = triangleData[triangle.triangleIndex];
+        const float planeDistance = planeDistances[triangle.triangleIndex];
+
+        for (int y = startY; y <= endY; ++y)
+        {
+            const float py = static_cast<float>(y);
+            for (int x = startX; x <= endX; ++x)
+            {
+                const float px = static_cast<float>(x);
+                float edgeAB = (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+                float edgeBC = (cx - bx) * (py - by) - (cy - by) * (px - bx);
+                float edgeCA = (ax - cx) * (py - cy) - (ay - cy) * (px - cx);
+                if (!insideEdge(edgeAB, ownsAB) || !insideEdge(edgeBC, ownsBC) || !insideEdge(edgeCA, ownsCA))
+                    continue;
+
+                // Depth is the distance along this pixel's camera ray, like the ray-traced path
+                Vector3 direction = frame.getPixelDirection(x, y).normalized();
+                float denom = Vector3::dot(data.normal, direction);
+                if (std::abs(denom) < 1e-6f)
+                    continue; // Seen edge-on
+
+                float t = planeDistance / denom;
+                int pixel = y * gBuffer.width + x;
+                if (t <= nearLimit || t >= gBuffer.depth[pixel])
+                    continue;
+
+                bool isFrontFace = denom < 0.0f;
+                gBuffer.depth[pixel] = t;
+                gBuffer.triangleId[pixel] = triangle.triangleIndex;
+                gBuffer.normal[pixel] = isFrontFace ? data.normal : -data.normal;
+                gBuffer.frontFace[pixel] = isFrontFace ? 1 : 0;
+            }
+        }
+    }
+}
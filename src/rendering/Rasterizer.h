@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CameraFrame.h"
+#include "../core/Ray.h"
+#include <vector>
+#include <cstdint>
+
+// Per-pixel primary visibility produced by the rasterizer
+struct GBuffer
+{
+    int width = 0;
+    int height = 0;
+    std::vector<float> depth;        // Ray distance to the visible triangle (FLT_MAX = none)
+    std::vector<int> triangleId;     // Index into the renderer triangle list (-1 = none)
+    std::vector<Vector3> normal;     // Unit normal facing the camera
+    std::vector<uint8_t> frontFace;  // 1 if the camera sees the triangle's front face
+
+    void resize(int newWidth, int newHeight);
+};
+
+// Half-space triangle rasterizer for primary visibility.
+// Triangles are projected and near-clipped once per frame, binned into the
+// renderer's tiles, and each tile is then rasterized independently, so tiles can
+// be processed on different threads. Pixels are sampled exactly where the camera
+// rays go (integer pixel coordinates) and depth is the ray distance to the
+// triangle plane, so the result can be mixed with ray-traced overlays and reflections.
+class Rasterizer
+{
+private:
+    // Triangle after projection to pixel space (one source triangle may give several after clipping)
+    struct ScreenTriangle
+    {
+        float x[3];
+        float y[3];
+        int triangleIndex;
+    };
+
+    std::vector<Vector3> vertices;                      // Source triangle corners, 3 per triangle
+    std::vector<TriangleIntersectionData> triangleData; // Per source triangle, for depth and normals
+    std::vector<float> planeDistances;                  // planeOffset - dot(normal, camera origin) for this frame
+
+    std::vector<ScreenTriangle> screenTriangles;
+    std::vector<std::vector<int>> tileBins; // Screen triangle indices per tile, in submission order
+
+    CameraFrame frame;
+    int width = 0;
+    int height = 0;
+    int tileSize = 32;
+    int tilesX = 0;
+    int tilesY = 0;
+    float nearLimit = 0.001f;
+    int frameTriangleCount = 0; // Source triangles in front of the camera this frame (after culling)
+
+public:
+    Rasterizer() = default;
+
+    // Scene geometry (call again whenever the triangle list changes)
+    void setTriangles(const std::vector<Triangle> &triangles);
+    void updateTriangle(int index, const Triangle &triangle); // Patch one entry of the current list
+    int getTriangleCount() const { return static_cast<int>(triangleData.size()); }
+
+    // Project, clip and bin the triangles for a frame; tiles use the same grid as the renderer.
+    // candidates limits the pass to a culled subset (nullptr = all triangles); with cullBackFaces,
+    // triangles facing away from the camera are dropped (only correct for closed meshes)
+    void beginFrame(const CameraFrame &cameraFrame, int imageWidth, int imageHeight, int tileEdge, float rayEpsilon,
+                    const std::vector<int> *candidates = nullptr, bool cullBackFaces = false);
+    int getFrameTriangleCount() const { return frameTriangleCount; }
+
+    // Resolve visibility for the tile [x0, x1) x [y0, y1) into the G-buffer (thread-safe across tiles)
+    void rasterizeTile(int x0, int y0, int x1, int y1, GBuffer &gBuffer) const;
+
+private:
+    void addScreenTriangle(const Vector3 clipped[3], int triangleIndex);
+};
@@ -0,0 +1,285 @@
+#include "SoftwareRenderer.h"
+#include "../utils/Utils.h"
+#include "../math/SimdFloat.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <algorithm>
+
+// Render benchmark: times full frames of the software renderer over a matrix of scenes,
+// resolutions, reflection depths and tracing paths, and writes the results as JSON.
+//
+// Usage: render-benchmark [--quick] [--frames N] [--scene file.fjwr] [--output results.json]
+
+namespace {
+
+struct BenchmarkOptions {
+    bool quick = false;
+    int frames = 5;
+    std::string scenePath = "default_scene.fjwr";
+    std::string outputPath = "render_benchmark.json";
+};
+
+struct BenchmarkScene {
+    std::string name;
+    Model model;
+    Camera camera;
+};
+
+// Tracing path selected through the renderer's toggles
+struct BenchmarkPath {
+    const char *name;
+    bool packetTracing;
+    bool rasterPrimary;
+    int threadCount; // 0 = all hardware threads
+};
+
+const BenchmarkPath BENCHMARK_PATHS[] = {
+    {"scalar", false, false, 1},
+    {"simd", true, false, 1},
+    {"threaded", true, false, 0},
+    {"raster", true, true, 0},
+};
+
+struct BenchmarkResult {
+    std::string scene;
+    int triangles = 0;
+    int width = 0;
+    int height = 0;
+    int reflectionDepth = 0;
+    std::string path;
+    int threads = 0;
+    double bvhBuildMs = 0.0;
+    double msPerFrame = 0.0;
+    double minMsPerFrame = 0.0;
+    double raysPerSecond = 0.0;
+    uint64_t primaryRays = 0;   // Per frame
+    uint64_t secondaryRays = 0; // Per frame
+    double accelerationMs = 0.0;
+    double setupMs = 0.0;
+    double traceMs = 0.0;
+};
+
+bool parseOptions(int argc, char **argv, BenchmarkOptions &options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--quick") {
+            options.quick = true;
+            options.frames = 3;
+        } else if (arg == "--frames" && hasValue) {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--scene" && hasValue) {
+            options.scenePath = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            options.outputPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--quick] [--frames N] [--scene file.fjwr] [--output results.json]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Rippled height field with about targetTriangles faces; the ripples reflect each other
+void buildRippleGrid(Model &model, int targetTriangles) {
+    const int cells = std::max(1, static_cast<int>(std::lround(std::sqrt(targetTriangles / 2.0))));
+    const float size = 3.0f;
+
+    for (int j = 0; j <= cells; ++j) {
+        for (int i = 0; i <= cells; ++i) {
+            float x = (static_cast<float>(i) / cells - 0.5f) * size;
+            float y = (static_cast<float>(j) / cells - 0.5f) * size;
+            float r = std::sqrt(x * x + y * y);
+            model.addVertex(x, y, 0.25f * std::cos(r * 6.0f) * std::exp(-r * 0.5f));
+        }
+    }
+
+    const int row = cells + 1;
+    for (int j = 0; j < cells; ++j) {
+        for (int i = 0; i < cells; ++i) {
+            int v00 = j * row + i;
+            int v10 = v00 + 1;
+            int v01 = v00 + row;
+            int v11 = v01 + 1;
+            model.addFace(v00, v10, v11);
+            model.addFace(v00, v11, v01);
+        }
+    }
+    model.calculateNormals();
+}
+
+std::vector<BenchmarkScene> createScenes(const BenchmarkOptions &options) {
+    std::vector<BenchmarkScene> scenes;
+    scenes.reserve(4);
+
+    scenes.emplace_back();
+    scenes.back().name = "default_scene";
+    if (!scenes.back().model.loadFromFile(options.scenePath)) {
+        Utils::logError("Benchmark scene not found: " + options.scenePath + " (skipped)");
+        scenes.pop_back();
+    }
+
+    std::vector<std::pair<std::string, int>> grids = {{"ripple_1k", 1000}};
+    if (!options.quick) {
+        grids.push_back({"ripple_100k", 100000});
+        grids.push_back({"ripple_1m", 1000000});
+    }
+    for (const auto &grid : grids) {
+        scenes.emplace_back();
+        scenes.back().name = grid.first;
+        buildRippleGrid(scenes.back().model, grid.second);
+    }
+
+    for (auto &scene : scenes) {
+        scene.camera.setIsometricView();
+        scene.camera.setDistance(5.0f);
+    }
+    return scenes;
+}
+
+BenchmarkResult runConfiguration(SoftwareRenderer &renderer, int frames) {
+    // Warm-up frame: thread pool creation, first-touch of the framebuffer planes
+    renderer.render();
+
+    BenchmarkResult result;
+    result.minMsPerFrame = 1e30;
+    for (int frame = 0; frame < frames; ++frame) {
+        renderer.render();
+        const RenderStats &stats = renderer.getLastFrameStats();
+        result.msPerFrame += stats.totalMs;
+        result.minMsPerFrame = std::min(result.minMsPerFrame, stats.totalMs);
+        result.accelerationMs += stats.accelerationMs;
+        result.setupMs += stats.setupMs;
+        result.traceMs += stats.traceMs;
+        result.primaryRays += stats.primarySamples;
+        result.secondaryRays += stats.secondaryRays;
+    }
+
+    const double totalMs = result.msPerFrame;
+    const double totalRays = static_cast<double>(result.primaryRays + result.secondaryRays);
+    result.raysPerSecond = totalMs > 0.0 ? totalRays / (totalMs / 1000.0) : 0.0;
+    result.msPerFrame /= frames;
+    result.accelerationMs /= frames;
+    result.setupMs /= frames;
+    result.traceMs /= frames;
+    result.primaryRays /= frames;
+    result.secondaryRays /= frames;
+    return result;
+}
+
+std::string escapeJson(const std::string &text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+void writeJson(std::ostream &out, const BenchmarkOptions &options, const std::vector<BenchmarkResult> &results) {
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"simdBackend\": \"" << simdBackendName() << "\",\n";
+    out << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"framesPerConfiguration\": " << options.frames << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult &r = results[i];
+        out << "    {\"scene\": \"" << escapeJson(r.scene) << "\", \"triangles\": " << r.triangles
+            << ", \"width\": " << r.width << ", \"height\": " << r.height
+            << ", \"reflectionDepth\": " << r.reflectionDepth
+            << ", \"path\": \"" << r.path << "\", \"threads\": " << r.threads
+            << ", \"bvhBuildMs\": " << r.bvhBuildMs
+            << ", \"msPerFrame\": " << r.msPerFrame << ", \"minMsPerFrame\": " << r.minMsPerFrame
+            << ", \"raysPerSecond\": " << std::setprecision(0) << r.raysPerSecond << std::setprecision(3)
+            << ", \"primaryRays\": " << r.primaryRays << ", \"secondaryRays\": " << r.secondaryRays
+            << ", \"stages\": {\"accelerationMs\": " << r.accelerationMs << ", \"setupMs\": " << r.setupMs
+            << ", \"traceMs\": " << r.traceMs << "}}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    BenchmarkOptions options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    Utils::logInfo(std::string("Starting render benchmark (SIMD backend: ") + simdBackendName() + ")");
+
+    std::vector<BenchmarkScene> scenes = createScenes(options);
+
+    std::vector<std::pair<int, int>> resolutions = {{320, 240}, {640, 480}, {1280, 720}};
+    std::vector<int> reflectionDepths = {0, 1, 2};
+    if (options.quick) {
+        resolutions = {{320, 240}};
+        reflectionDepths = {0, 2};
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (auto &scene : scenes) {
+        SoftwareRenderer renderer;
+        renderer.setShowVertices(false);
+        renderer.setShowCoordinateAxes(false);
+        renderer.setResolution(resolutions.front().first, resolutions.front().second);
+
+        // First frame converts the model and builds the BVH; later frames reuse both
+        renderer.render(scene.model, scene.camera);
+        const double bvhBuildMs = renderer.getLastFrameStats().accelerationMs;
+        const int triangleCount = renderer.getTriangleCount();
+
+        for (const auto &resolution : resolutions) {
+            renderer.setResolution(resolution.first, resolution.second);
+            for (int depth : reflectionDepths) {
+                // Depth = reflection bounces traced (castRay depths 0..depth reach the scene)
+                renderer.getReflectionConfig().enableReflection = depth > 0;
+                renderer.getReflectionConfig().maxReflectionDepth = depth + 1;
+                for (const BenchmarkPath &path : BENCHMARK_PATHS) {
+                    renderer.setPacketTracing(path.packetTracing);
+                    renderer.setRasterPrimary(path.rasterPrimary);
+                    renderer.setRenderThreadCount(path.threadCount);
+
+                    BenchmarkResult result = runConfiguration(renderer, options.frames);
+                    result.scene = scene.name;
+                    result.triangles = triangleCount;
+                    result.width = resolution.first;
+                    result.height = resolution.second;
+                    result.reflectionDepth = depth;
+                    result.path = path.name;
+                    result.threads = renderer.getRenderThreadCount();
+                    result.bvhBuildMs = bvhBuildMs;
+                    results.push_back(result);
+
+                    std::cout << std::left << std::setw(14) << scene.name << std::right
+                              << std::setw(5) << resolution.first << "x" << std::left << std::setw(5)
+                              << resolution.second << " depth " << depth << "  " << std::setw(9) << path.name
+                              << std::right << std::fixed << std::setprecision(2) << std::setw(10)
+                              << result.msPerFrame << " ms/frame" << std::setw(9) << std::setprecision(2)
+                              << result.raysPerSecond / 1e6 << " Mrays/s" << std::endl;
+                }
+            }
+        }
+    }
+
+    std::ofstream file(options.outputPath);
+    if (!file.is_open()) {
+        Utils::logError("Failed to open benchmark output: " + options.outputPath);
+        writeJson(std::cout, options, results);
+        return 1;
+    }
+    writeJson(file, options, results);
+    Utils::logInfo("Benchmark results written to " + options.outputPath);
+    return 0;
+}
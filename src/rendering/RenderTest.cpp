@@ -1,6 +1,19 @@
 #include "SoftwareRenderer.h"
+#include "ImageWriter.h"
+#include "../core/RayBatch.h"
+#include "../core/MeshSimplifier.h"
 #include "../utils/Utils.h"
+#include "../utils/Profiler.h"
+#include "../math/SimdFloat.h"
 #include <iostream>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <thread>
 
 void testTriangleIntersection() {
     Utils::logInfo("Testing triangle intersection algorithms...");
@@ -28,9 +41,1208 @@ void testTriangleIntersection() {
 
     std::cout << "Miss test: " << (miss.hit ? "HIT" : "MISS") << std::endl;
 
+    // Fast kernel on precomputed data must agree with the reference test
+    TriangleIntersectionData precomputed(v0, v1, v2);
+    TriangleHit fastHit = RayIntersection::intersectTriangle(hitRay, precomputed);
+    TriangleHit fastMiss = RayIntersection::intersectTriangle(missRay, precomputed);
+    bool fastMatches = fastHit.hit == hit.hit && fastMiss.hit == miss.hit &&
+                       std::abs(fastHit.distance - hit.distance) < 1e-6f &&
+                       fastHit.isFrontFace == hit.isFrontFace;
+    std::cout << "Precomputed kernel matches: " << (fastMatches ? "YES" : "NO") << std::endl;
+
     Utils::logInfo("Triangle intersection tests completed");
 }
 
+void testBVHIntersection() {
+    Utils::logInfo("Testing BVH against brute-force triangle intersection...");
+
+    // Random triangle soup inside a 10x10x10 box
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-5.0f, 5.0f);
+    std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < 2000; ++i) {
+        Vector3 center(position(rng), position(rng), position(rng));
+        triangles.emplace_back(center + Vector3(offset(rng), offset(rng), offset(rng)),
+                               center + Vector3(offset(rng), offset(rng), offset(rng)),
+                               center + Vector3(offset(rng), offset(rng), offset(rng)));
+    }
+
+    BVH bvh;
+    bvh.build(triangles);
+    std::cout << "BVH nodes: " << bvh.getNodeCount() << " for " << bvh.getTriangleCount() << " triangles" << std::endl;
+
+    int mismatches = 0;
+    int hits = 0;
+    const float tMin = 0.001f;
+    for (int i = 0; i < 2000; ++i) {
+        Ray ray(Vector3(position(rng), position(rng), position(rng)) * 2.0f,
+                Vector3(offset(rng), offset(rng), offset(rng)));
+
+        // Brute force closest hit
+        float closest = std::numeric_limits<float>::max();
+        int closestIndex = -1;
+        for (size_t t = 0; t < triangles.size(); ++t) {
+            TriangleHit hit = RayIntersection::intersectTriangle(ray, triangles[t].v0, triangles[t].v1, triangles[t].v2);
+            if (hit.hit && hit.distance > tMin && hit.distance < closest) {
+                closest = hit.distance;
+                closestIndex = static_cast<int>(t);
+            }
+        }
+
+        BVHHit bvhHit;
+        bool bvhFound = bvh.intersect(ray, tMin, std::numeric_limits<float>::max(), bvhHit);
+        bool anyFound = bvh.intersectAny(ray, tMin, std::numeric_limits<float>::max());
+
+        if (closestIndex >= 0) {
+            hits++;
+        }
+        if (bvhFound != (closestIndex >= 0) || anyFound != bvhFound ||
+            (bvhFound && std::abs(bvhHit.hit.distance - closest) > 1e-5f)) {
+            mismatches++;
+        }
+    }
+
+    std::cout << "Rays with hits: " << hits << ", mismatches: " << mismatches << std::endl;
+    std::cout << "BVH matches brute force: " << (mismatches == 0 ? "YES" : "NO") << std::endl;
+
+    Utils::logInfo("BVH intersection tests completed");
+}
+
+void testPacketIntersection() {
+    Utils::logInfo("Testing packet traversal against single-ray BVH traversal...");
+    std::cout << "SIMD backend: " << simdBackendName() << std::endl;
+
+    // Dense random soup seen through a pinhole - coherent rays like primary camera rays
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> position(-5.0f, 5.0f);
+    std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < 20000; ++i) {
+        Vector3 center(position(rng), position(rng), position(rng));
+        triangles.emplace_back(center + Vector3(offset(rng), offset(rng), offset(rng)),
+                               center + Vector3(offset(rng), offset(rng), offset(rng)),
+                               center + Vector3(offset(rng), offset(rng), offset(rng)));
+    }
+
+    BVH bvh;
+    bvh.build(triangles);
+
+    const int size = 256;
+    const float tMin = 0.001f;
+    const Vector3 origin(0.0f, -15.0f, 0.0f);
+    std::vector<Ray> rays;
+    std::vector<float> maxDistances;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            Vector3 direction((2.0f * x / size) - 1.0f, 2.0f, 1.0f - (2.0f * y / size));
+            rays.emplace_back(origin, direction);
+            // Vary the upper bound like overlay hits do
+            maxDistances.push_back((x % 7 == 0) ? 14.0f : std::numeric_limits<float>::max());
+        }
+    }
+
+    std::vector<BVHHit> scalarHits(rays.size());
+    std::vector<bool> scalarFound(rays.size());
+    auto scalarStart = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < rays.size(); ++i) {
+        scalarFound[i] = bvh.intersect(rays[i], tMin, maxDistances[i], scalarHits[i]);
+    }
+    auto scalarEnd = std::chrono::high_resolution_clock::now();
+
+    std::vector<BVHHit> packetHits(rays.size());
+    std::vector<bool> packetFound(rays.size());
+    auto packetStart = std::chrono::high_resolution_clock::now();
+    for (size_t first = 0; first < rays.size(); first += RAY_PACKET_WIDTH) {
+        RayPacket packet;
+        packet.tMin = tMin;
+        for (int lane = 0; lane < RAY_PACKET_WIDTH; ++lane) {
+            packet.setRay(lane, rays[first + lane], maxDistances[first + lane]);
+        }
+        int hitMask = bvh.intersectPacket(packet, &packetHits[first]);
+        for (int lane = 0; lane < RAY_PACKET_WIDTH; ++lane) {
+            packetFound[first + lane] = (hitMask & (1 << lane)) != 0;
+        }
+    }
+    auto packetEnd = std::chrono::high_resolution_clock::now();
+
+    int mismatches = 0;
+    int hits = 0;
+    for (size_t i = 0; i < rays.size(); ++i) {
+        if (scalarFound[i]) {
+            hits++;
+        }
+        if (scalarFound[i] != packetFound[i] ||
+            (scalarFound[i] && (scalarHits[i].triangleIndex != packetHits[i].triangleIndex ||
+                                scalarHits[i].hit.distance != packetHits[i].hit.distance))) {
+            mismatches++;
+        }
+    }
+
+    double scalarMs = std::chrono::duration<double, std::milli>(scalarEnd - scalarStart).count();
+    double packetMs = std::chrono::duration<double, std::milli>(packetEnd - packetStart).count();
+    std::cout << "Rays: " << rays.size() << ", hits: " << hits << ", mismatches: " << mismatches << std::endl;
+    std::cout << "Scalar: " << scalarMs << " ms, packet: " << packetMs << " ms" << std::endl;
+    std::cout << "Packet traversal matches scalar: " << (mismatches == 0 ? "YES" : "NO") << std::endl;
+
+    Utils::logInfo("Packet intersection tests completed");
+}
+
+void testScreenSpaceOverlays() {
+    Utils::logInfo("Testing binned screen-space overlays against per-element hit tests...");
+
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> position(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<Vector3> vertices;
+    std::vector<Line> edges;
+    for (int i = 0; i < 2000; ++i) {
+        vertices.emplace_back(position(rng), position(rng), position(rng));
+    }
+    for (int i = 0; i < 3000; ++i) {
+        edges.emplace_back(vertices[rng() % vertices.size()], vertices[rng() % vertices.size()], Vector3(0.7f), 1.0f);
+    }
+    edges.emplace_back(vertices[0], vertices[0], Vector3(0.7f), 1.0f); // Degenerate edge
+    std::vector<Line> axes = {Line(Vector3(0, 0, 0), Vector3(2, 0, 0), Vector3(1, 0, 0), 1.5f),
+                              Line(Vector3(0, 0, 0), Vector3(0, 2, 0), Vector3(0, 1, 0), 1.0f)};
+
+    // Camera inside the point cloud with an up vector that is not perpendicular to the view
+    Vector3 cameraPos(1.0f, -4.0f, 1.5f), cameraTarget(0, 0, 0), cameraUp(0, 0, 1);
+    float fov = 50.0f * Utils::DEG_TO_RAD;
+    float aspect = 4.0f / 3.0f;
+    const float vertexRadius = 0.0133f, edgeThickness = 0.01f, lineThickness = 0.01f, epsilon = 0.001f;
+
+    ScreenSpaceOverlays overlays;
+    overlays.beginFrame(cameraPos, cameraTarget, cameraUp, fov, aspect, 160, 120);
+    overlays.addVertices(vertices, vertexRadius, Vector3(1.0f));
+    overlays.addEdges(edges, edgeThickness, Vector3(0.7f));
+    overlays.addLines(axes, lineThickness);
+
+    int mismatches = 0;
+    int hits = 0;
+    for (int i = 0; i < 4000; ++i) {
+        // Mostly primary-like rays, some arbitrary directions like reflection rays
+        Vector3 direction = (i % 4 == 0) ? Vector3(unit(rng), unit(rng), unit(rng))
+                                         : (cameraTarget - cameraPos).normalized() + Vector3(unit(rng), unit(rng), unit(rng)) * 0.4f;
+        Ray ray(i % 4 == 0 ? Vector3(position(rng), position(rng), position(rng)) : cameraPos, direction);
+        bool includeLines = (i % 2) == 0;
+
+        float expected = std::numeric_limits<float>::max();
+        for (size_t v = 0; v < vertices.size(); ++v) {
+            VertexHit hit = RayIntersection::intersectVertexScreenSpace(ray, vertices[v], vertexRadius, static_cast<int>(v),
+                                                                        cameraPos, cameraTarget, cameraUp, fov, aspect);
+            if (hit.hit && hit.distance < expected && hit.distance > epsilon) expected = hit.distance;
+        }
+        for (size_t e = 0; e < edges.size(); ++e) {
+            EdgeHit hit = RayIntersection::intersectEdgeScreenSpace(ray, edges[e].start, edges[e].end, edgeThickness, static_cast<int>(e),
+                                                                    cameraPos, cameraTarget, cameraUp, fov, aspect);
+            if (hit.hit && hit.distance < expected && hit.distance > epsilon) expected = hit.distance;
+        }
+        for (size_t l = 0; includeLines && l < axes.size(); ++l) {
+            LineHit hit = RayIntersection::intersectLineScreenSpace(ray, axes[l], lineThickness, static_cast<int>(l),
+                                                                    cameraPos, cameraTarget, cameraUp, fov, aspect);
+            if (hit.hit && hit.distance < expected && hit.distance > epsilon) expected = hit.distance;
+        }
+
+        Vector3 color;
+        float binned = overlays.intersect(ray, epsilon, includeLines, color);
+        if (expected < std::numeric_limits<float>::max()) hits++;
+        if (binned != expected) mismatches++;
+    }
+
+    std::cout << "Rays with overlay hits: " << hits << ", mismatches: " << mismatches << std::endl;
+    std::cout << "Binned overlays match per-element tests: " << (mismatches == 0 ? "YES" : "NO") << std::endl;
+
+    Utils::logInfo("Screen-space overlay tests completed");
+}
+
+void testHybridRendering() {
+    Utils::logInfo("Testing rasterized primary visibility against ray tracing...");
+
+    // Closed UV sphere above a ground quad: silhouettes, shared edges and reflections
+    SoftwareRenderer renderer;
+    renderer.setResolution(200, 150);
+    renderer.setCamera(Vector3(3, -4, 2), Vector3(0, 0, 0.3f), Vector3(0, 0, 1));
+    renderer.setShowVertices(false);
+    renderer.setShowCoordinateAxes(false);
+
+    const int rings = 24, segments = 48;
+    auto spherePoint = [&](int ring, int segment) {
+        float theta = 3.14159265f * ring / rings;
+        float phi = 2.0f * 3.14159265f * segment / segments;
+        return Vector3(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), 0.5f + std::cos(theta));
+    };
+    for (int ring = 0; ring < rings; ++ring) {
+        for (int segment = 0; segment < segments; ++segment) {
+            Vector3 a = spherePoint(ring, segment), b = spherePoint(ring + 1, segment);
+            Vector3 c = spherePoint(ring + 1, segment + 1), d = spherePoint(ring, segment + 1);
+            renderer.addTriangle(Triangle(a, b, c));
+            renderer.addTriangle(Triangle(a, c, d));
+        }
+    }
+    renderer.addTriangle(Triangle(Vector3(-3, -3, -0.6f), Vector3(3, -3, -0.6f), Vector3(3, 3, -0.6f)));
+    renderer.addTriangle(Triangle(Vector3(-3, -3, -0.6f), Vector3(3, 3, -0.6f), Vector3(-3, 3, -0.6f)));
+
+    renderer.setRasterPrimary(false);
+    auto tracedStart = std::chrono::high_resolution_clock::now();
+    renderer.render();
+    auto tracedEnd = std::chrono::high_resolution_clock::now();
+    std::vector<Vector3> traced = renderer.getPixelData();
+
+    renderer.setRasterPrimary(true);
+    auto rasterStart = std::chrono::high_resolution_clock::now();
+    renderer.render();
+    auto rasterEnd = std::chrono::high_resolution_clock::now();
+    const std::vector<Vector3> &hybrid = renderer.getPixelData();
+
+    // Only pixels whose sample sits on a triangle edge may resolve to the neighbouring triangle
+    int differing = 0;
+    for (size_t i = 0; i < traced.size(); ++i) {
+        if ((traced[i] - hybrid[i]).length() > 1e-3f) differing++;
+    }
+    float differingPercent = 100.0f * differing / traced.size();
+
+    std::cout << "Ray traced: " << std::chrono::duration<double, std::milli>(tracedEnd - tracedStart).count()
+              << " ms, hybrid: " << std::chrono::duration<double, std::milli>(rasterEnd - rasterStart).count() << " ms" << std::endl;
+    std::cout << "Differing pixels: " << differing << " (" << differingPercent << "%)" << std::endl;
+    std::cout << "Hybrid image matches ray tracing: " << (differingPercent < 0.5f ? "YES" : "NO") << std::endl;
+
+    Utils::logInfo("Hybrid rendering tests completed");
+}
+
+void testProgressiveRendering() {
+    Utils::logInfo("Testing progressive refinement...");
+
+    SoftwareRenderer renderer;
+    renderer.setResolution(96, 64);
+    renderer.setShowCoordinateAxes(false);
+    renderer.addTriangle(Triangle(Vector3(-1, -1, 0), Vector3(1, -1, 0), Vector3(0, 1, 0.5f)));
+    renderer.addTriangle(Triangle(Vector3(-2, -2, -0.5f), Vector3(2, -2, -0.5f), Vector3(0, 2, -0.5f)));
+    renderer.setProgressiveRendering(true);
+    renderer.getRenderConfig().progressiveBudgetMs = 0.0f; // Always pick the coarsest level while moving
+
+    renderer.setCamera(Vector3(0, -3, 3), Vector3(0, 0, 0), Vector3(0, 0, 1));
+    renderer.render();
+    bool firstFrameComplete = !renderer.isRefining();
+
+    // Camera moves: coarse frame, then one refinement level per still frame
+    renderer.setCamera(Vector3(0.5f, -3, 3), Vector3(0, 0, 0), Vector3(0, 0, 1));
+    renderer.render();
+    int movingBlockSize = renderer.getProgressiveBlockSize();
+    int refinementFrames = 0;
+    while (renderer.isRefining() && refinementFrames < 10) {
+        renderer.render();
+        refinementFrames++;
+    }
+    std::vector<Vector3> refined = renderer.getPixelData();
+
+    // Reference: same view rendered directly
+    renderer.setProgressiveRendering(false);
+    renderer.render();
+    const std::vector<Vector3> &reference = renderer.getPixelData();
+
+    int differing = 0;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        if ((refined[i] - reference[i]).length() > 1e-4f) differing++;
+    }
+
+    std::cout << "Moving block size: " << movingBlockSize << ", refinement frames: " << refinementFrames
+              << ", differing pixels after refinement: " << differing << std::endl;
+    bool passed = firstFrameComplete && movingBlockSize == 16 && refinementFrames == 4 && differing == 0;
+    std::cout << "Progressive refinement converges: " << (passed ? "YES" : "NO") << std::endl;
+
+    Utils::logInfo("Progressive rendering tests completed");
+}
+
+void testIncrementalUpdates() {
+    Utils::logInfo("Testing incremental scene updates...");
+
+    // Model change set: moving one cube corner touches its one-ring only
+    Model model;
+    model.createCube(1.0f);
+    model.clearChanges();
+    model.setVertexPosition(0, Vector3(-0.8f, -0.6f, -0.9f));
+
+    std::vector<int> changedFaces, changedEdges;
+    model.getChangedFaces(changedFaces);
+    model.getChangedEdges(changedEdges);
+    Model fullRecompute = model;
+    fullRecompute.calculateNormals();
+    bool normalsMatch = true;
+    for (int i = 0; i < model.getVertexCount(); ++i) {
+        if (model.getVertices()[i].normal != fullRecompute.getVertices()[i].normal) normalsMatch = false;
+    }
+    std::cout << "Changed vertices: " << model.getChangedVertices().size() << ", faces: " << changedFaces.size()
+              << ", edges: " << changedEdges.size() << std::endl;
+    bool changeSetCorrect = !model.hasTopologyChanged() && model.getChangedVertices().size() == 1 &&
+                            changedFaces.size() == 6 && changedEdges.size() == 6;
+    std::cout << "Change set and one-ring normals correct: " << (changeSetCorrect && normalsMatch ? "YES" : "NO") << std::endl;
+
+    // BVH refit against brute force after moving part of a triangle soup
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> position(-5.0f, 5.0f);
+    std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < 2000; ++i) {
+        Vector3 center(position(rng), position(rng), position(rng));
+        triangles.emplace_back(center + Vector3(offset(rng), offset(rng), offset(rng)),
+                               center + Vector3(offset(rng), offset(rng), offset(rng)),
+                               center + Vector3(offset(rng), offset(rng), offset(rng)));
+    }
+    BVH bvh;
+    bvh.build(triangles);
+
+    std::vector<int> moved;
+    for (int i = 0; i < 2000; i += 10) {
+        Vector3 shift(position(rng), position(rng), position(rng));
+        triangles[i].v0 = triangles[i].v0 + shift * 0.3f;
+        triangles[i].v1 = triangles[i].v1 + shift * 0.2f;
+        moved.push_back(i);
+    }
+    auto refitStart = std::chrono::high_resolution_clock::now();
+    bvh.refit(triangles, moved);
+    auto refitEnd = std::chrono::high_resolution_clock::now();
+
+    int mismatches = 0;
+    const float tMin = 0.001f;
+    for (int i = 0; i < 2000; ++i) {
+        Ray ray(Vector3(position(rng), position(rng), position(rng)) * 2.0f,
+                Vector3(offset(rng), offset(rng), offset(rng)));
+        float closest = std::numeric_limits<float>::max();
+        for (const Triangle &triangle : triangles) {
+            TriangleHit hit = RayIntersection::intersectTriangle(ray, triangle.v0, triangle.v1, triangle.v2);
+            if (hit.hit && hit.distance > tMin && hit.distance < closest) closest = hit.distance;
+        }
+        BVHHit bvhHit;
+        bool found = bvh.intersect(ray, tMin, std::numeric_limits<float>::max(), bvhHit);
+        bool anyFound = bvh.intersectAny(ray, tMin, std::numeric_limits<float>::max());
+        bool expected = closest < std::numeric_limits<float>::max();
+        if (found != expected || anyFound != expected || (found && std::abs(bvhHit.hit.distance - closest) > 1e-5f)) {
+            mismatches++;
+        }
+    }
+    std::cout << "Refit of " << moved.size() << " triangles: "
+              << std::chrono::duration<double, std::milli>(refitEnd - refitStart).count()
+              << " ms, growth " << bvh.getRefitGrowth() << ", mismatches: " << mismatches << std::endl;
+    std::cout << "Refitted BVH matches brute force: " << (mismatches == 0 ? "YES" : "NO") << std::endl;
+
+    // Renderer patch gives the same image as loading the edited scene from scratch
+    auto setupRenderer = [](SoftwareRenderer &renderer) {
+        renderer.setResolution(96, 64);
+        renderer.setCamera(Vector3(0, -3, 3), Vector3(0, 0, 0), Vector3(0, 0, 1));
+        renderer.setShowEdges(true);
+    };
+    std::vector<Triangle> scene = {
+        Triangle(Vector3(-1, -1, 0), Vector3(1, -1, 0), Vector3(0, 1, 0.5f)),
+        Triangle(Vector3(-2, -2, -0.5f), Vector3(2, -2, -0.5f), Vector3(0, 2, -0.5f))};
+    SoftwareRenderer patched;
+    setupRenderer(patched);
+    for (const Triangle &triangle : scene) patched.addTriangle(triangle);
+    patched.setVertices({scene[0].v0, scene[0].v1, scene[0].v2});
+    patched.setEdges({Line(scene[0].v0, scene[0].v2, Vector3(0.9f, 0.9f, 0.9f), 1.0f)});
+    patched.render();
+
+    scene[0].v2 = Vector3(0.3f, 1.2f, 1.0f);
+    patched.updateTriangle(0, scene[0]);
+    patched.updateVertex(2, scene[0].v2);
+    patched.updateEdge(0, Line(scene[0].v0, scene[0].v2, Vector3(0.9f, 0.9f, 0.9f), 1.0f));
+    patched.render();
+
+    SoftwareRenderer reloaded;
+    setupRenderer(reloaded);
+    for (const Triangle &triangle : scene) reloaded.addTriangle(triangle);
+    reloaded.setVertices({scene[0].v0, scene[0].v1, scene[0].v2});
+    reloaded.setEdges({Line(scene[0].v0, scene[0].v2, Vector3(0.9f, 0.9f, 0.9f), 1.0f)});
+    reloaded.render();
+
+    int differing = 0;
+    for (size_t i = 0; i < reloaded.getPixelData().size(); ++i) {
+        if ((patched.getPixelData()[i] - reloaded.getPixelData()[i]).length() > 1e-6f) differing++;
+    }
+    std::cout << "Patched renderer matches reload: " << (differing == 0 ? "YES" : "NO") << std::endl;
+
+    Utils::logInfo("Incremental update tests completed");
+}
+
+void testFramebufferPlanes() {
+    Utils::logInfo("Testing framebuffer planes...");
+
+    SoftwareRenderer renderer;
+    renderer.setResolution(80, 60);
+    renderer.setCamera(Vector3(0, -3, 3), Vector3(0, 0, 0), Vector3(0, 0, 1));
+    renderer.addTriangle(Triangle(Vector3(-1, -1, 0), Vector3(1, -1, 0), Vector3(0, 1, 0.5f)));
+    renderer.addTriangle(Triangle(Vector3(-2, -2, -0.5f), Vector3(2, -2, -0.5f), Vector3(0, 2, -0.5f)));
+
+    FramebufferPlanes allPlanes;
+    allPlanes.hdr = true;
+    allPlanes.depth = true;
+    renderer.setFramebufferPlanes(allPlanes);
+
+    // Depth/ID plane must agree with a closest-hit query along each pixel's camera ray, on every primary path
+    const char *pathNames[3] = {"scalar", "packet", "raster"};
+    bool allPathsMatch = true;
+    for (int path = 0; path < 3; ++path) {
+        renderer.setPacketTracing(path == 1);
+        renderer.setRasterPrimary(path == 2);
+        renderer.render();
+
+        const Framebuffer &framebuffer = renderer.getFramebuffer();
+        const CameraFrame &frame = renderer.getCameraFrame();
+        int idMismatches = 0, depthMismatches = 0, colorMismatches = 0;
+        for (int y = 0; y < framebuffer.height; ++y) {
+            for (int x = 0; x < framebuffer.width; ++x) {
+                int index = y * framebuffer.width + x;
+                Ray ray = Ray::fromUnitDirection(frame.origin, frame.getPixelDirection(x, y).normalized());
+                BVHHit hit;
+                int expectedId = renderer.getBVH().intersect(ray, 0.001f, std::numeric_limits<float>::max(), hit) ? hit.triangleIndex : -1;
+                if (framebuffer.triangleId[index] != expectedId) idMismatches++;
+                else if (expectedId >= 0 && std::abs(framebuffer.depth[index] - hit.hit.distance) > 1e-3f) depthMismatches++;
+
+                // Display and color planes are the clamped HDR sample
+                const HdrSample &sample = framebuffer.hdr[index];
+                Vector3 clamped(std::min(std::max(sample.color.x, 0.0f), 1.0f), std::min(std::max(sample.color.y, 0.0f), 1.0f),
+                                std::min(std::max(sample.color.z, 0.0f), 1.0f));
+                if (sample.weight != 1.0f || framebuffer.color[index] != clamped ||
+                    framebuffer.display[index] != Framebuffer::packRGBA8(clamped)) colorMismatches++;
+            }
+        }
+        // Rasterized ownership of samples exactly on shared edges may pick the neighbouring triangle
+        int allowedIdMismatches = path == 2 ? framebuffer.width * framebuffer.height / 200 : 0;
+        std::cout << pathNames[path] << " path: ID mismatches " << idMismatches << ", depth mismatches " << depthMismatches
+                  << ", color mismatches " << colorMismatches << std::endl;
+        if (idMismatches > allowedIdMismatches || depthMismatches > 0 || colorMismatches > 0) allPathsMatch = false;
+    }
+    std::cout << "Depth/ID and color planes consistent: " << (allPathsMatch ? "YES" : "NO") << std::endl;
+
+    // Clearing to an out-of-range color clamps the color and display planes, not the HDR plane
+    Framebuffer cleared;
+    cleared.resize(4, 3, allPlanes);
+    const Vector3 brightClear(2.0f, -0.5f, 0.25f);
+    cleared.clear(brightClear);
+    const Vector3 clampedClear(1.0f, 0.0f, 0.25f);
+    bool clearClamped = true;
+    for (size_t i = 0; i < cleared.color.size(); ++i) {
+        if (cleared.color[i] != clampedClear || cleared.display[i] != Framebuffer::packRGBA8(clampedClear) ||
+            cleared.hdr[i].color != brightClear) clearClamped = false;
+    }
+    std::cout << "Out-of-range clear color clamped in color plane: " << (clearClamped ? "YES" : "NO") << std::endl;
+
+    // Display-only configuration keeps no float planes at all
+    FramebufferPlanes displayOnly;
+    displayOnly.color = false;
+    renderer.setFramebufferPlanes(displayOnly);
+    renderer.render();
+    const Framebuffer &compact = renderer.getFramebuffer();
+    bool compactOk = compact.color.empty() && compact.hdr.empty() && compact.depth.empty() &&
+                     compact.display.size() == static_cast<size_t>(80 * 60) && renderer.getPixelData().empty();
+    std::cout << "Display-only framebuffer (4 bytes/pixel): " << (compactOk ? "YES" : "NO") << std::endl;
+
+    Utils::logInfo("Framebuffer plane tests completed");
+}
+
+void testProfiler() {
+    Utils::logInfo("Testing frame profiler...");
+
+    SoftwareRenderer renderer;
+    renderer.setResolution(64, 48);
+    renderer.setCamera(Vector3(0, -3, 3), Vector3(0, 0, 0), Vector3(0, 0, 1));
+    renderer.addTriangle(Triangle(Vector3(-1, -1, 0), Vector3(1, -1, 0), Vector3(0, 1, 0.5f)));
+    renderer.addTriangle(Triangle(Vector3(-2, -2, -0.5f), Vector3(2, -2, -0.5f), Vector3(0, 2, -0.5f)));
+    renderer.setRenderThreadCount(2);
+
+    // Flush whatever earlier tests recorded, then profile exactly one frame
+    Profiler::endFrame();
+    Profiler::beginFrame();
+    renderer.render();
+    Profiler::endFrame();
+
+#ifndef PROFILER_DISABLE
+    const Profiler::FrameStats &frame = Profiler::getLastFrame();
+    const RenderStats &stats = renderer.getLastFrameStats();
+    auto counter = [&](ProfileCounter c) { return frame.counters[static_cast<int>(c)]; };
+
+    bool renderScope = false;
+    int tileCalls = 0;
+    for (const auto &scope : frame.scopes) {
+        if (scope.name == "SoftwareRenderer::render") renderScope = scope.calls == 1 && scope.totalMs > 0.0;
+        if (scope.name == "Tile") tileCalls = scope.calls;
+    }
+    std::cout << "Render scope recorded once: " << (renderScope ? "YES" : "NO") << std::endl;
+    std::cout << "Tile scopes from all workers (" << tileCalls << "): " << (tileCalls == 4 ? "YES" : "NO") << std::endl;
+
+    // Every primary and every traced reflection ray goes through the BVH
+    const uint64_t raysCast = counter(ProfileCounter::RaysCast);
+    std::cout << "Rays cast " << raysCast << " = primary + reflection: "
+              << (raysCast == stats.primarySamples + stats.secondaryRays ? "YES" : "NO") << std::endl;
+    std::cout << "Reflection rays match frame stats (" << counter(ProfileCounter::ReflectionRays) << "): "
+              << (counter(ProfileCounter::ReflectionRays) == stats.secondaryRays && stats.secondaryRays > 0 ? "YES" : "NO") << std::endl;
+    std::cout << "Traversal counters non-zero: "
+              << (counter(ProfileCounter::BVHNodesVisited) > 0 &&
+                  counter(ProfileCounter::TriangleTests) > 0 ? "YES" : "NO") << std::endl;
+
+    // Chrome trace export
+    const std::string tracePath = "test_profile_trace.json";
+    bool exported = Profiler::exportChromeTrace(tracePath);
+    std::ifstream traceFile(tracePath);
+    std::string trace((std::istreambuf_iterator<char>(traceFile)), std::istreambuf_iterator<char>());
+    traceFile.close();
+    std::remove(tracePath.c_str());
+    bool traceValid = exported && trace.rfind("{\"traceEvents\":[", 0) == 0 &&
+                      trace.find("\"name\":\"Tile\",\"ph\":\"X\"") != std::string::npos &&
+                      trace.find("\"ph\":\"C\"") != std::string::npos;
+    std::cout << "Chrome trace exported: " << (traceValid ? "YES" : "NO") << std::endl;
+
+    // Threads that exit hand their counts to the next frame and unregister
+    const int registered = Profiler::getRegisteredThreadCount();
+    Profiler::beginFrame();
+    for (int round = 0; round < 8; ++round) {
+        std::thread worker([]() {
+            PROFILE_SCOPE("Short-lived thread");
+            PROFILE_COUNT(RaysCast, 5);
+        });
+        worker.join();
+    }
+    Profiler::endFrame();
+    int shortLivedCalls = 0;
+    for (const auto &scope : Profiler::getLastFrame().scopes) {
+        if (scope.name == "Short-lived thread") shortLivedCalls = scope.calls;
+    }
+    std::cout << "Exited threads unregister and keep their counts: "
+              << (Profiler::getRegisteredThreadCount() == registered && shortLivedCalls == 8 &&
+                  Profiler::getLastFrame().counters[static_cast<int>(ProfileCounter::RaysCast)] == 40 ? "YES" : "NO")
+              << std::endl;
+#else
+    std::cout << "Profiler compiled out: " << (Profiler::getLastFrame().scopes.empty() ? "YES" : "NO") << std::endl;
+#endif
+}
+
+void testSkyTable() {
+    Utils::logInfo("Testing sky lookup table...");
+
+    const float sunAngularSize = 0.1f;
+    SkyTable table;
+    std::cout << "Empty table needs build: " << (table.needsRebuild(sunAngularSize) ? "YES" : "NO") << std::endl;
+    table.build(sunAngularSize);
+    std::cout << "Built table reused for same sun size: " << (!table.needsRebuild(sunAngularSize) ? "YES" : "NO") << std::endl;
+    std::cout << "Sun size change needs rebuild: " << (table.needsRebuild(0.05f) ? "YES" : "NO") << std::endl;
+
+    // Table lookups against the acos/pow formulas, over random directions and near the sun
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    const Vector3 sunDirection = Vector3(-0.3f, 0.3f, 1.0f).normalized();
+    float maxVerticalError = 0.0f, maxSunError = 0.0f;
+    int discMismatches = 0;
+    for (int i = 0; i < 20000; ++i) {
+        Vector3 direction(uniform(rng), uniform(rng), uniform(rng));
+        if (i % 2 == 1) direction = sunDirection + direction * 0.12f; // Half the samples around the disc
+        if (direction.length() < 1e-3f) continue;
+        direction = direction.normalized();
+
+        float expectedVertical = std::pow((direction.z + 1.0f) * 0.5f, 0.7f);
+        maxVerticalError = std::max(maxVerticalError, std::abs(table.getVerticalFactor(direction.z) - expectedVertical));
+
+        float alignment = Vector3::dot(direction, sunDirection);
+        float angle = std::acos(Utils::clamp(alignment, -1.0f, 1.0f));
+        float intensity = 0.0f;
+        bool inDisc = table.getSunIntensity(alignment, intensity);
+        if (std::abs(angle - sunAngularSize) < 1e-4f) continue; // Boundary: either answer is fine
+        if (inDisc != (angle < sunAngularSize)) {
+            discMismatches++;
+        } else if (inDisc) {
+            float expected = (1.0f - angle / sunAngularSize) * (1.0f - angle / sunAngularSize);
+            maxSunError = std::max(maxSunError, std::abs(intensity - expected));
+        }
+    }
+    std::cout << "Vertical factor within 2e-3 (max " << maxVerticalError << "): " << (maxVerticalError < 2e-3f ? "YES" : "NO") << std::endl;
+    std::cout << "Sun disc test matches acos threshold: " << (discMismatches == 0 ? "YES" : "NO") << std::endl;
+    std::cout << "Sun intensity within 2e-3 (max " << maxSunError << "): " << (maxSunError < 2e-3f ? "YES" : "NO") << std::endl;
+
+    // A rendered sky-only frame still shows the sun disc and the gradient
+    SoftwareRenderer renderer;
+    renderer.setResolution(64, 48);
+    renderer.setCamera(Vector3(0, 0, 0), -renderer.getReflectionConfig().lightDirection, Vector3(0, 1, 0));
+    renderer.render();
+    const Vector3 center = renderer.getPixelData()[24 * 64 + 32];
+    const Vector3 corner = renderer.getPixelData()[0];
+    std::cout << "Sun at the center of a sun-facing frame: " << ((center - renderer.getReflectionConfig().sunColor).length() < 0.05f ? "YES" : "NO") << std::endl;
+    std::cout << "Sky gradient at the corner: " << (corner.z > corner.x && corner.z > corner.y ? "YES" : "NO") << std::endl;
+}
+
+void testReflectionTermination() {
+    Utils::logInfo("Testing adaptive reflection termination...");
+
+    // Floor and ceiling facing each other: reflections bounce all the way to the depth limit
+    SoftwareRenderer renderer;
+    renderer.setResolution(64, 48);
+    renderer.setCamera(Vector3(0, -3, 1), Vector3(0, 0, 0.6f), Vector3(0, 0, 1));
+    renderer.addTriangle(Triangle(Vector3(-20, -20, 0), Vector3(20, -20, 0), Vector3(0, 20, 0)));
+    renderer.addTriangle(Triangle(Vector3(-20, -20, 2), Vector3(0, 20, 2), Vector3(20, -20, 2)));
+    ReflectionConfig &reflection = renderer.getReflectionConfig();
+
+    auto renderImage = [&]() {
+        renderer.render();
+        return renderer.getPixelData();
+    };
+    auto maxDifference = [](const std::vector<Vector3> &a, const std::vector<Vector3> &b) {
+        float difference = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i) {
+            difference = std::max(difference, (a[i] - b[i]).length());
+        }
+        return difference;
+    };
+
+    // Default depth: every reflection that is traced still contributes more than the threshold
+    reflection.minReflectionWeight = 0.0f;
+    std::vector<Vector3> unlimited = renderImage();
+    reflection.minReflectionWeight = 0.01f;
+    std::vector<Vector3> thresholded = renderImage();
+    std::cout << "Default depth unchanged by weight threshold: " << (maxDifference(unlimited, thresholded) == 0.0f ? "YES" : "NO") << std::endl;
+
+    // Deep recursion: the threshold cuts rays whose share is negligible, the image barely moves
+    reflection.maxReflectionDepth = 8;
+    reflection.minReflectionWeight = 0.0f;
+    unlimited = renderImage();
+    uint64_t unlimitedRays = renderer.getLastFrameStats().secondaryRays;
+    reflection.minReflectionWeight = 0.01f;
+    thresholded = renderImage();
+    uint64_t thresholdedRays = renderer.getLastFrameStats().secondaryRays;
+    float difference = maxDifference(unlimited, thresholded);
+    std::cout << "Weight threshold traces fewer rays (" << thresholdedRays << " < " << unlimitedRays << "): "
+              << (thresholdedRays < unlimitedRays ? "YES" : "NO") << std::endl;
+    std::cout << "Weight threshold image within 0.02 (" << difference << "): " << (difference < 0.02f ? "YES" : "NO") << std::endl;
+
+    // Ray budget: depth drops until the traced reflections fit, then recovers when the budget grows
+    const int budget = static_cast<int>(thresholdedRays / 3);
+    reflection.reflectionRayBudget = budget;
+    bool settled = false;
+    for (int frame = 0; frame < 12 && !settled; ++frame) {
+        renderer.render();
+        settled = renderer.getLastFrameStats().secondaryRays <= static_cast<uint64_t>(budget);
+    }
+    const RenderStats &budgetStats = renderer.getLastFrameStats();
+    std::cout << "Budget lowers depth (" << budgetStats.reflectionDepth << " < 8): " << (budgetStats.reflectionDepth < 8 ? "YES" : "NO") << std::endl;
+    std::cout << "Budget respected after settling: " << (settled ? "YES" : "NO") << std::endl;
+
+    int depthBefore = budgetStats.reflectionDepth;
+    renderer.render();
+    std::cout << "Budgeted depth stable on a still view: " << (renderer.getLastFrameStats().reflectionDepth == depthBefore ? "YES" : "NO") << std::endl;
+
+    reflection.reflectionRayBudget = static_cast<int>(unlimitedRays * 2);
+    for (int frame = 0; frame < 12; ++frame) {
+        renderer.render();
+    }
+    std::cout << "Depth recovers under a large budget: " << (renderer.getLastFrameStats().reflectionDepth == 8 ? "YES" : "NO") << std::endl;
+    std::cout << "Recovered image matches unbudgeted: " << (maxDifference(renderer.getPixelData(), thresholded) == 0.0f ? "YES" : "NO") << std::endl;
+}
+
+void testWavefrontReflections() {
+    Utils::logInfo("Testing iterative and wavefront reflection tracing...");
+
+    // Facing mirrors and a tilted plate: long reflection chains with diverging directions
+    SoftwareRenderer renderer;
+    renderer.setResolution(72, 40); // Width not a multiple of the packet width
+    renderer.setRenderThreadCount(1);
+    renderer.setCamera(Vector3(0, -3, 1), Vector3(0, 0, 0.6f), Vector3(0, 0, 1));
+    renderer.addTriangle(Triangle(Vector3(-20, -20, 0), Vector3(20, -20, 0), Vector3(0, 20, 0)));
+    renderer.addTriangle(Triangle(Vector3(-20, -20, 2), Vector3(0, 20, 2), Vector3(20, -20, 2)));
+    renderer.addTriangle(Triangle(Vector3(-0.5f, 0, 0.2f), Vector3(0.5f, 0, 0.2f), Vector3(0, 0.8f, 1.4f)));
+    ReflectionConfig &reflection = renderer.getReflectionConfig();
+    reflection.maxReflectionDepth = 64;
+    reflection.minReflectionWeight = 0.0f;
+
+    auto renderImage = [&](bool packets, bool wavefront) {
+        renderer.setPacketTracing(packets);
+        renderer.setWavefrontReflections(wavefront);
+        renderer.render();
+        return renderer.getPixelData();
+    };
+
+    std::vector<Vector3> scalar = renderImage(false, false);
+    const RenderStats scalarStats = renderer.getLastFrameStats();
+    std::cout << "Depth 64 chain traced: " << (scalarStats.secondaryRays > 0 ? "YES" : "NO") << std::endl;
+
+    std::vector<Vector3> wavefront = renderImage(true, true);
+    const RenderStats wavefrontStats = renderer.getLastFrameStats();
+    float difference = 0.0f;
+    for (size_t i = 0; i < scalar.size(); ++i) {
+        difference = std::max(difference, (scalar[i] - wavefront[i]).length());
+    }
+    std::cout << "Wavefront image matches per-pixel tracing (" << difference << "): " << (difference < 1e-5f ? "YES" : "NO") << std::endl;
+    std::cout << "Wavefront traces the same reflection rays: "
+              << (wavefrontStats.secondaryRays == scalarStats.secondaryRays ? "YES" : "NO") << std::endl;
+
+    // Depth buffer and hit ids come from the primary wave
+    FramebufferPlanes planes;
+    planes.depth = true;
+    renderer.setFramebufferPlanes(planes);
+    renderImage(false, false);
+    const std::vector<float> scalarDepth = renderer.getFramebuffer().depth;
+    const std::vector<int> scalarIds = renderer.getFramebuffer().triangleId;
+    renderImage(true, true);
+    std::cout << "Wavefront depth plane matches: "
+              << (renderer.getFramebuffer().depth == scalarDepth && renderer.getFramebuffer().triangleId == scalarIds ? "YES" : "NO")
+              << std::endl;
+}
+
+void testFrameReuse() {
+    Utils::logInfo("Testing frame skipping and temporal reprojection...");
+
+    // Floor with a box-like occluder in front: moving sideways disoccludes part of the floor
+    SoftwareRenderer renderer;
+    renderer.setResolution(96, 64);
+    renderer.setShowVertices(false);
+    renderer.setShowCoordinateAxes(false);
+    renderer.addTriangle(Triangle(Vector3(-20, -20, 0), Vector3(20, -20, 0), Vector3(0, 20, 0)));
+    renderer.addTriangle(Triangle(Vector3(-0.5f, 0, 0), Vector3(0.5f, 0, 0), Vector3(0, 0, 1.0f)));
+    renderer.setCamera(Vector3(0, -4, 1.5f), Vector3(0, 0, 0.3f), Vector3(0, 0, 1));
+    renderer.setSkipUnchangedFrames(true);
+
+    renderer.render();
+    const std::vector<Vector3> first = renderer.getPixelData();
+    renderer.render();
+    std::cout << "Unchanged frame skipped: " << (renderer.getLastFrameStats().skippedFrame ? "YES" : "NO") << std::endl;
+    std::cout << "Skipped frame keeps the image: " << (renderer.getPixelData() == first ? "YES" : "NO") << std::endl;
+
+    renderer.setCamera(Vector3(0, -4, 1.5f), Vector3(0, 0, 0.3f), Vector3(0, 0, 1));
+    renderer.render();
+    std::cout << "Same camera set again still skipped: " << (renderer.getLastFrameStats().skippedFrame ? "YES" : "NO") << std::endl;
+
+    renderer.getReflectionConfig().frontFaceReflectionAlpha = 0.5f;
+    renderer.render();
+    std::cout << "Setting change renders: " << (!renderer.getLastFrameStats().skippedFrame ? "YES" : "NO") << std::endl;
+
+    renderer.updateTriangle(1, Triangle(Vector3(-0.5f, 0, 0), Vector3(0.5f, 0, 0), Vector3(0, 0, 1.2f)));
+    renderer.render();
+    std::cout << "Scene edit renders: " << (!renderer.getLastFrameStats().skippedFrame ? "YES" : "NO") << std::endl;
+
+    // Reference image of a slightly moved camera, traced in full
+    const Vector3 movedPos(0.08f, -4, 1.5f);
+    SoftwareRenderer reference;
+    reference.setResolution(96, 64);
+    reference.setShowVertices(false);
+    reference.setShowCoordinateAxes(false);
+    reference.getReflectionConfig().frontFaceReflectionAlpha = 0.5f;
+    reference.addTriangle(Triangle(Vector3(-20, -20, 0), Vector3(20, -20, 0), Vector3(0, 20, 0)));
+    reference.addTriangle(Triangle(Vector3(-0.5f, 0, 0), Vector3(0.5f, 0, 0), Vector3(0, 0, 1.2f)));
+    reference.setCamera(movedPos, Vector3(0, 0, 0.3f), Vector3(0, 0, 1));
+    reference.render();
+
+    renderer.setTemporalReprojection(true);
+    renderer.render(); // Records the cache (settings changed)
+    renderer.render();
+    std::cout << "Recorded frame skipped: " << (renderer.getLastFrameStats().skippedFrame ? "YES" : "NO") << std::endl;
+
+    renderer.setCamera(movedPos, Vector3(0, 0, 0.3f), Vector3(0, 0, 1));
+    renderer.render();
+    const RenderStats moved = renderer.getLastFrameStats();
+    const uint64_t pixelCount = 96 * 64;
+    std::cout << "Small move reprojects (" << moved.reprojectedPixels << " of " << pixelCount << " reused): "
+              << (moved.reprojectedPixels > pixelCount / 4 && moved.primarySamples + moved.reprojectedPixels == pixelCount ? "YES" : "NO")
+              << std::endl;
+
+    const std::vector<Vector3> &reprojected = renderer.getPixelData();
+    const std::vector<Vector3> &expected = reference.getPixelData();
+    int badPixels = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        badPixels += (reprojected[i] - expected[i]).length() > 0.1f ? 1 : 0;
+    }
+    std::cout << "Reprojected image close to a full trace (" << badPixels << " pixels off): "
+              << (badPixels < static_cast<int>(pixelCount / 50) ? "YES" : "NO") << std::endl;
+
+    // Camera stopped: one full frame, then idle
+    renderer.render();
+    std::cout << "Still camera traces a full frame: "
+              << (!renderer.getLastFrameStats().skippedFrame && renderer.getLastFrameStats().reprojectedPixels == 0 ? "YES" : "NO") << std::endl;
+    std::cout << "Full frame matches the reference: " << (renderer.getPixelData() == expected ? "YES" : "NO") << std::endl;
+    renderer.render();
+    std::cout << "Then skipped: " << (renderer.getLastFrameStats().skippedFrame ? "YES" : "NO") << std::endl;
+
+    // Large move: too little of the cached surface stays on screen
+    renderer.setCamera(Vector3(3, 3, 4), Vector3(0, 0, 0.3f), Vector3(0, 0, 1));
+    renderer.render();
+    std::cout << "Large move traces in full: " << (renderer.getLastFrameStats().reprojectedPixels == 0 ? "YES" : "NO") << std::endl;
+
+    // Per-frame FOV and resolution calls only count when the values change
+    renderer.setCameraFOV(50.0f);
+    renderer.render();
+    const bool fovRenders = !renderer.getLastFrameStats().skippedFrame;
+    renderer.render(); // Still camera after the change: one full frame
+    renderer.setCameraFOV(50.0f);
+    renderer.setResolution(96, 64);
+    renderer.render();
+    std::cout << "Same FOV and resolution set again still skipped: "
+              << (fovRenders && renderer.getLastFrameStats().skippedFrame ? "YES" : "NO") << std::endl;
+}
+
+void testPrimaryCulling() {
+    Utils::logInfo("Testing frustum and back-face culling of the rasterized primary pass...");
+
+    // Grid of closed tetrahedra, camera zoomed in on one corner of it
+    SoftwareRenderer renderer;
+    renderer.setResolution(80, 60);
+    renderer.setShowVertices(false);
+    renderer.setShowCoordinateAxes(false);
+    renderer.setRasterPrimary(true);
+    for (int j = 0; j < 16; ++j) {
+        for (int i = 0; i < 16; ++i) {
+            const Vector3 base(i * 1.5f, j * 1.5f, 0.0f);
+            const Vector3 a = base, b = base + Vector3(1, 0, 0), c = base + Vector3(0, 1, 0), d = base + Vector3(0.3f, 0.3f, 1);
+            // Counter-clockwise seen from outside
+            renderer.addTriangle(Triangle(a, c, b));
+            renderer.addTriangle(Triangle(a, b, d));
+            renderer.addTriangle(Triangle(b, c, d));
+            renderer.addTriangle(Triangle(c, a, d));
+        }
+    }
+    renderer.setCamera(Vector3(-1, -1, 2), Vector3(1.5f, 1.5f, 0), Vector3(0, 0, 1));
+    renderer.setCameraFOV(25.0f);
+
+    auto renderImage = [&](bool frustum, bool backFaces) {
+        renderer.setFrustumCulling(frustum);
+        renderer.setBackFaceCulling(backFaces);
+        renderer.render();
+        return renderer.getPixelData();
+    };
+
+    const std::vector<Vector3> unculled = renderImage(false, false);
+    const int allTriangles = renderer.getLastFrameStats().primaryTriangles;
+    const std::vector<Vector3> frustumCulled = renderImage(true, false);
+    const int frustumTriangles = renderer.getLastFrameStats().primaryTriangles;
+    std::cout << "Frustum culling keeps the image: " << (frustumCulled == unculled ? "YES" : "NO") << std::endl;
+    std::cout << "Frustum culling drops triangles (" << frustumTriangles << " of " << allTriangles << "): "
+              << (frustumTriangles * 4 < allTriangles ? "YES" : "NO") << std::endl;
+
+    const std::vector<Vector3> backCulled = renderImage(true, true);
+    const int backTriangles = renderer.getLastFrameStats().primaryTriangles;
+    std::cout << "Back-face culling keeps a closed mesh's image: " << (backCulled == unculled ? "YES" : "NO") << std::endl;
+    std::cout << "Back-face culling drops triangles (" << backTriangles << " < " << frustumTriangles << "): "
+              << (backTriangles < frustumTriangles ? "YES" : "NO") << std::endl;
+
+    // Behind the camera: nothing is projected
+    renderer.setCamera(Vector3(-1, -1, 2), Vector3(-6, -6, 2), Vector3(0, 0, 1));
+    renderer.render();
+    std::cout << "Scene behind the camera culled: " << (renderer.getLastFrameStats().primaryTriangles == 0 ? "YES" : "NO") << std::endl;
+}
+
+void testSceneInstancing() {
+    Utils::logInfo("Testing instanced scenes against flattened triangle lists...");
+
+    // One closed tetrahedron placed three times (moved, rotated, scaled)
+    auto tetrahedron = std::make_shared<Model>();
+    tetrahedron->addVertex(0, 0, 0);
+    tetrahedron->addVertex(1, 0, 0);
+    tetrahedron->addVertex(0, 1, 0);
+    tetrahedron->addVertex(0.3f, 0.3f, 1);
+    tetrahedron->addFace(0, 2, 1);
+    tetrahedron->addFace(0, 1, 3);
+    tetrahedron->addFace(1, 2, 3);
+    tetrahedron->addFace(2, 0, 3);
+
+    Scene scene;
+    const int mesh = scene.addMesh(tetrahedron);
+    scene.addInstance(mesh, Matrix4::translation(Vector3(-1.5f, 0, 0)));
+    scene.addInstance(mesh, Matrix4::translation(Vector3(0.5f, 0, 0)) * Matrix4::rotationZ(0.7f));
+    scene.addInstance(mesh, Matrix4::translation(Vector3(0, 1.5f, -0.2f)) * Matrix4::scale(Vector3(1.5f, 0.8f, 1.2f)));
+
+    auto setUp = [](SoftwareRenderer &renderer) {
+        renderer.setResolution(80, 60);
+        renderer.setShowVertices(false);
+        renderer.setShowCoordinateAxes(false);
+        renderer.setCamera(Vector3(1, -4, 3), Vector3(0, 0.5f, 0.3f), Vector3(0, 0, 1));
+        FramebufferPlanes planes;
+        planes.depth = true;
+        renderer.setFramebufferPlanes(planes);
+    };
+    auto flatten = [&](SoftwareRenderer &renderer) {
+        renderer.clearTriangles();
+        for (int i = 0; i < scene.getInstanceCount(); ++i) {
+            const Matrix4 &transform = scene.getInstance(i).transform;
+            for (const Face &face : tetrahedron->getFaces()) {
+                renderer.addTriangle(Triangle(transform.transformPoint(tetrahedron->getVertices()[face.v1].position),
+                                              transform.transformPoint(tetrahedron->getVertices()[face.v2].position),
+                                              transform.transformPoint(tetrahedron->getVertices()[face.v3].position)));
+            }
+        }
+    };
+    // Transformed rays hit at slightly different floats, so allow a handful of edge pixels
+    auto closeImages = [](const SoftwareRenderer &a, const SoftwareRenderer &b) {
+        int differing = 0;
+        for (size_t i = 0; i < a.getPixelData().size(); ++i) {
+            const Vector3 d = a.getPixelData()[i] - b.getPixelData()[i];
+            const bool sameId = a.getFramebuffer().triangleId[i] == b.getFramebuffer().triangleId[i];
+            differing += (!sameId || std::abs(d.x) + std::abs(d.y) + std::abs(d.z) > 1e-3f) ? 1 : 0;
+        }
+        return differing * 200 < static_cast<int>(a.getPixelData().size());
+    };
+
+    SoftwareRenderer instanced;
+    setUp(instanced);
+    instanced.setScene(scene);
+    instanced.render();
+    SoftwareRenderer flat;
+    setUp(flat);
+    flatten(flat);
+    flat.render();
+    std::cout << "Instanced scene matches the flattened triangles: " << (closeImages(instanced, flat) ? "YES" : "NO") << std::endl;
+
+    const InstanceBVH &bvh = instanced.getBVH();
+    std::cout << "Instances share one mesh BVH (" << bvh.getMesh(0).getTriangleCount() << " triangles for "
+              << bvh.getTriangleCount() << "): "
+              << (bvh.getMeshCount() == 1 && bvh.getMesh(0).getTriangleCount() == 4 && bvh.getTriangleCount() == 12 &&
+                  instanced.getTriangleCount() == 12 ? "YES" : "NO") << std::endl;
+
+    // Packet tracing and the rasterized primary pass see the same instances
+    const std::vector<Vector3> scalarImage = instanced.getPixelData();
+    instanced.setPacketTracing(true);
+    instanced.render();
+    std::cout << "Packet tracing matches scalar tracing: " << (instanced.getPixelData() == scalarImage ? "YES" : "NO") << std::endl;
+    instanced.setRasterPrimary(true);
+    instanced.setFrustumCulling(false);
+    instanced.render();
+    const std::vector<Vector3> rasterImage = instanced.getPixelData();
+    instanced.setFrustumCulling(true);
+    instanced.render();
+    std::cout << "Frustum culling of transformed instances keeps the image: "
+              << (instanced.getPixelData() == rasterImage ? "YES" : "NO") << std::endl;
+    instanced.setRasterPrimary(false);
+    instanced.setPacketTracing(false);
+
+    // Moving an instance rebuilds only the instance level
+    const Matrix4 moved = Matrix4::translation(Vector3(0.2f, -0.8f, 0.4f)) * Matrix4::rotationX(0.4f);
+    scene.setTransform(1, moved);
+    instanced.setInstanceTransform(1, moved);
+    instanced.render();
+    const RenderStats &stats = instanced.getLastFrameStats();
+    std::cout << "Moved instance rebuilds only the top level: "
+              << (stats.rebuiltInstances && !stats.rebuiltAcceleration ? "YES" : "NO") << std::endl;
+    flatten(flat);
+    flat.render();
+    std::cout << "Moved instance matches the flattened triangles: " << (closeImages(instanced, flat) ? "YES" : "NO") << std::endl;
+
+    // Material tint applies to its own instance only (reflections off, so pixels are surface colors)
+    instanced.getReflectionConfig().enableReflection = false;
+    instanced.render();
+    const std::vector<Vector3> untinted = instanced.getPixelData();
+    Material red;
+    red.tint = Vector3(1, 0, 0);
+    instanced.setInstanceMaterial(2, red);
+    instanced.render();
+    const int firstTinted = bvh.getInstanceFirstTriangle(2);
+    bool tintOnInstance = true;
+    int tintedPixels = 0;
+    for (size_t i = 0; i < untinted.size(); ++i) {
+        const int id = instanced.getFramebuffer().triangleId[i];
+        const bool onInstance = id >= firstTinted && id < firstTinted + 4;
+        tintedPixels += onInstance ? 1 : 0;
+        const Vector3 &color = instanced.getPixelData()[i];
+        tintOnInstance = tintOnInstance && (onInstance ? color.y == 0.0f && color.z == 0.0f : color == untinted[i]);
+    }
+    std::cout << "Material tint limited to its instance (" << tintedPixels << " pixels): "
+              << (tintOnInstance && tintedPixels > 0 ? "YES" : "NO") << std::endl;
+
+    // A model split into its connected parts renders like the model itself
+    Model model;
+    model.createCube(1.0f);
+    const int cubeVertices = model.getVertexCount();
+    for (int v = 0; v < 4; ++v) {
+        model.addVertex(model.getVertices()[v].position + Vector3(0, 0, -1.5f));
+    }
+    model.addFace(cubeVertices, cubeVertices + 1, cubeVertices + 2);
+    Scene parts;
+    std::vector<int> faceTriangles;
+    parts.addConnectedParts(model, faceTriangles);
+    // Parts are numbered by their first face, so here every face keeps its index
+    bool mapped = static_cast<int>(faceTriangles.size()) == model.getFaceCount();
+    for (size_t f = 0; mapped && f < faceTriangles.size(); ++f) {
+        mapped = faceTriangles[f] == static_cast<int>(f);
+    }
+    std::cout << "Connected parts split (" << parts.getMeshCount() << " meshes): "
+              << (parts.getMeshCount() == 2 && parts.getTriangleCount() == model.getFaceCount() && mapped ? "YES" : "NO") << std::endl;
+}
+
+void testBatchQueries() {
+    Utils::logInfo("Testing batched ray queries against single-ray BVH queries...");
+
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> position(-5.0f, 5.0f);
+    std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+    std::uniform_real_distribution<float> limit(2.0f, 20.0f);
+
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < 2000; ++i) {
+        Vector3 center(position(rng), position(rng), position(rng));
+        triangles.emplace_back(center + Vector3(offset(rng), offset(rng), offset(rng)),
+                               center + Vector3(offset(rng), offset(rng), offset(rng)),
+                               center + Vector3(offset(rng), offset(rng), offset(rng)));
+    }
+    BVH bvh;
+    bvh.build(triangles);
+
+    // Rays from a few shared origins (like picking from a camera) with their own far limits
+    std::vector<BatchRay> rays(3001);
+    for (size_t i = 0; i < rays.size(); ++i) {
+        const Vector3 origin = Vector3(static_cast<float>(i % 3) * 4.0f - 4.0f, -12.0f, 1.0f);
+        rays[i].ray = Ray(origin, Vector3(offset(rng), 1.0f, offset(rng)));
+        rays[i].maxDistance = limit(rng);
+    }
+
+    ThreadPool pool(4);
+    const float tMin = 0.001f;
+    auto matchesScalar = [&](const std::vector<BVHHit> &hits, const std::vector<uint8_t> &occluded, auto &accelerator) {
+        bool closestMatch = hits.size() == rays.size();
+        bool anyMatch = occluded.size() == rays.size();
+        for (size_t i = 0; i < rays.size() && closestMatch && anyMatch; ++i) {
+            BVHHit expected;
+            const bool found = accelerator.intersect(rays[i].ray, tMin, rays[i].maxDistance, expected);
+            closestMatch = found ? hits[i].triangleIndex == expected.triangleIndex &&
+                                       hits[i].hit.distance == expected.hit.distance
+                                 : hits[i].triangleIndex == -1;
+            anyMatch = (occluded[i] != 0) == accelerator.intersectAny(rays[i].ray, tMin, rays[i].maxDistance);
+        }
+        return closestMatch && anyMatch;
+    };
+
+    std::vector<BVHHit> hits;
+    std::vector<uint8_t> occluded;
+    RayIntersection::intersectBatch(bvh, rays, tMin, hits);
+    RayIntersection::occludedBatch(bvh, rays, tMin, occluded);
+    int hitCount = 0;
+    for (const BVHHit &hit : hits) hitCount += hit.triangleIndex >= 0 ? 1 : 0;
+    std::cout << "Batch queries match single rays (" << hitCount << " of " << rays.size() << " hit): "
+              << (matchesScalar(hits, occluded, bvh) && hitCount > 0 ? "YES" : "NO") << std::endl;
+
+    RayIntersection::intersectBatch(bvh, rays, tMin, hits, &pool);
+    RayIntersection::occludedBatch(bvh, rays, tMin, occluded, &pool);
+    std::cout << "Threaded batch queries match single rays: " << (matchesScalar(hits, occluded, bvh) ? "YES" : "NO") << std::endl;
+
+    // Same soup as one mesh placed twice
+    InstanceBVH instanced;
+    instanced.setMeshCount(1);
+    instanced.buildMesh(0, triangles);
+    InstanceBVH::Instance placement;
+    std::vector<InstanceBVH::Instance> placements(2, placement);
+    placements[1].transform = Matrix4::translation(Vector3(0, 6, 0)) * Matrix4::rotationZ(0.5f);
+    instanced.setInstances(placements);
+    RayIntersection::intersectBatch(instanced, rays, tMin, hits, &pool);
+    RayIntersection::occludedBatch(instanced, rays, tMin, occluded, &pool);
+    std::cout << "Batch queries over instances match single rays: " << (matchesScalar(hits, occluded, instanced) ? "YES" : "NO") << std::endl;
+
+    // Visibility of every vertex at once against the per-face reference
+    Model model;
+    const int gridSize = 24;
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            model.addVertex(x * 0.2f - 2.3f, y * 0.2f - 2.3f, 0.2f * std::sin(x * 0.8f) * std::cos(y * 0.6f));
+        }
+    }
+    for (int y = 0; y + 1 < gridSize; ++y) {
+        for (int x = 0; x + 1 < gridSize; ++x) {
+            int i = y * gridSize + x;
+            model.addFace(i, i + 1, i + gridSize + 1);
+            model.addFace(i, i + gridSize + 1, i + gridSize);
+        }
+    }
+    const int plate = model.getVertexCount();
+    model.addVertex(-1.0f, -1.0f, 1.0f);
+    model.addVertex(0.5f, -1.0f, 1.0f);
+    model.addVertex(0.5f, 0.5f, 1.0f);
+    model.addFace(plate, plate + 1, plate + 2);
+
+    const Vector3 cameraPos(3.0f, -4.0f, 4.0f);
+    std::vector<int> allVertices(model.getVertexCount());
+    for (int i = 0; i < model.getVertexCount(); ++i) allVertices[i] = i;
+    std::vector<uint8_t> visible;
+    model.getVertexVisibility(cameraPos, allVertices, visible, &pool);
+    int mismatches = 0;
+    int hidden = 0;
+    for (int i = 0; i < model.getVertexCount(); ++i) {
+        const bool expected = RayIntersection::isVertexVisible(cameraPos, model.getVertices()[i].position, model);
+        mismatches += (visible[i] != 0) != expected ? 1 : 0;
+        hidden += expected ? 0 : 1;
+    }
+    std::cout << "Batch vertex visibility matches per-face test (" << hidden << " hidden, " << mismatches << " mismatches): "
+              << (mismatches == 0 && hidden > 0 ? "YES" : "NO") << std::endl;
+}
+
+void testQuietHotPath() {
+    Utils::logInfo("Testing log levels, bulk scene loading and the compact raycast result...");
+
+    // Hot-path log macros must not even build their message below the current level
+    int messagesBuilt = 0;
+    auto buildMessage = [&]() {
+        ++messagesBuilt;
+        return std::string("test message");
+    };
+    Utils::setLogLevel(Utils::LogLevel::Warning);
+    LOG_DEBUG(buildMessage());
+    LOG_INFO(buildMessage());
+    const bool quiet = messagesBuilt == 0 && !Utils::isLogEnabled(Utils::LogLevel::Info) &&
+                       Utils::isLogEnabled(Utils::LogLevel::Error);
+    Utils::setLogLevel(Utils::LogLevel::Debug);
+    LOG_DEBUG(buildMessage());
+    Utils::setLogLevel(Utils::LogLevel::Info);
+    LOG_DEBUG(buildMessage());
+    const int expectedBuilt = LOG_MIN_LEVEL <= 0 ? 1 : 0; // Debug compiled in or not
+    std::cout << "Messages below the log level are never built: " << (quiet && messagesBuilt == expectedBuilt ? "YES" : "NO")
+              << std::endl;
+
+    // One bulk call gives the same scene as per-triangle adds
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> position(-2.0f, 2.0f);
+    std::vector<Triangle> triangles;
+    for (int i = 0; i < 300; ++i) {
+        Vector3 center(position(rng), position(rng), position(rng) * 0.3f);
+        triangles.emplace_back(center, center + Vector3(0.4f, 0.1f, 0.0f), center + Vector3(0.0f, 0.4f, 0.2f));
+    }
+    auto makeRenderer = [](SoftwareRenderer &renderer) {
+        renderer.setResolution(64, 48);
+        renderer.setShowVertices(false);
+        renderer.setCamera(Vector3(3, -5, 3), Vector3(0, 0, 0), Vector3(0, 0, 1));
+    };
+    SoftwareRenderer oneByOne;
+    makeRenderer(oneByOne);
+    for (const Triangle &triangle : triangles) {
+        oneByOne.addTriangle(triangle);
+    }
+    SoftwareRenderer bulk;
+    makeRenderer(bulk);
+    bulk.reserveTriangles(static_cast<int>(triangles.size()));
+    bulk.addTriangles(triangles);
+    oneByOne.render();
+    bulk.render();
+    std::cout << "Bulk-added scene renders the same image: "
+              << (bulk.getTriangleCount() == 300 && bulk.getPixelData() == oneByOne.getPixelData() ? "YES" : "NO") << std::endl;
+
+    // Compact result still reports what each hit type adds
+    Model cube;
+    cube.createCube(1.0f);
+    const Ray faceRay(Vector3(0.1f, -3.0f, 0.15f), Vector3(0, 1, 0));
+    RaycastResult faceResult = RayIntersection::findClosestIntersection(faceRay, cube, 0.01f, 0.01f);
+    const Ray edgeRay(Vector3(0.5f, -3.0f, 0.2f), Vector3(0, 1, 0));
+    RaycastResult edgeResult = RayIntersection::findClosestIntersection(edgeRay, cube, 0.01f, 0.05f);
+    std::cout << "Face hit carries its normal (" << faceResult.normal.x << ", " << faceResult.normal.y << ", "
+              << faceResult.normal.z << "): "
+              << (faceResult.type == RaycastResultType::FACE && std::abs(std::abs(faceResult.normal.y) - 1.0f) < 1e-5f ? "YES" : "NO")
+              << std::endl;
+    std::cout << "Edge hit carries its parameter (" << edgeResult.parameter << "): "
+              << (edgeResult.type == RaycastResultType::EDGE && edgeResult.parameter > 0.0f && edgeResult.parameter < 1.0f ? "YES" : "NO")
+              << std::endl;
+    std::cout << "Raycast result is " << sizeof(RaycastResult) << " bytes: " << (sizeof(RaycastResult) <= 48 ? "YES" : "NO") << std::endl;
+
+    // Work stealing with range queues still runs every task exactly once
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> runs(1000);
+    for (auto &count : runs) count = 0;
+    pool.parallelFor(static_cast<int>(runs.size()), [&](int i) { runs[i]++; });
+    pool.parallelFor(static_cast<int>(runs.size()), [&](int i) { runs[i]++; });
+    bool everyTaskTwice = true;
+    for (auto &count : runs) everyTaskTwice = everyTaskTwice && count == 2;
+    std::cout << "Thread pool runs every task once per job: " << (everyTaskTwice ? "YES" : "NO") << std::endl;
+}
+
 void testSoftwareRenderer() {
     Utils::logInfo("Testing Software Renderer...");
 
@@ -39,9 +1251,10 @@ void testSoftwareRenderer() {
     renderer.initialize();
     renderer.setResolution(100, 100);  // Small resolution for quick test
 
-    // Set camera
-    renderer.setCamera(Vector3(0, 0, 3), Vector3(0, 0, 0), Vector3(0, 0, 1));
+    // Set camera looking down at the triangles (up must not be parallel to the view direction)
+    renderer.setCamera(Vector3(0, 0, 3), Vector3(0, 0, 0), Vector3(0, 1, 0));
     renderer.setCameraFOV(45.0f);
+    renderer.getReflectionConfig().enableReflection = false; // Plain shaded faces for the pixel checks
 
     // Create a simple triangle scene
     Triangle triangle1(
@@ -76,13 +1289,29 @@ void testSoftwareRenderer() {
     std::cout << "Center pixel color: " << centerPixel << std::endl;
     std::cout << "Corner pixel color: " << cornerPixel << std::endl;
 
-    // Check if we're getting reasonable colors
-    bool hasTriangleColor = (centerPixel.x > 0.5f || centerPixel.y > 0.5f); // Red or green
+    // Check if we're getting reasonable colors: the center sees the first triangle's front face,
+    // shaded with the front face color (triangle colors are not used for shading), not the sky
+    const ReflectionConfig &shading = renderer.getReflectionConfig();
+    float NdotL = std::max(0.0f, Vector3::dot(Vector3(0, 0, 1), -shading.lightDirection));
+    Vector3 faceColor = shading.frontFaceColor * (shading.ambientStrength + NdotL * shading.diffuseStrength);
+    faceColor = Vector3(std::min(faceColor.x, 1.0f), std::min(faceColor.y, 1.0f), std::min(faceColor.z, 1.0f));
+    bool hasTriangleColor = centerPixel != cornerPixel && (centerPixel - faceColor).length() < 1e-4f;
     bool hasSkyColor = (cornerPixel.z > cornerPixel.x && cornerPixel.z > cornerPixel.y); // Blue-ish
 
     std::cout << "Has triangle color in center: " << (hasTriangleColor ? "YES" : "NO") << std::endl;
     std::cout << "Has sky color in corner: " << (hasSkyColor ? "YES" : "NO") << std::endl;
 
+    // Packed display copy must hold the same pixels, quantized to bytes
+    const auto& displayPixels = renderer.getDisplayPixels();
+    int packMismatches = 0;
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        uint32_t expected = static_cast<uint32_t>(pixels[i].x * 255.0f) |
+                            (static_cast<uint32_t>(pixels[i].y * 255.0f) << 8) |
+                            (static_cast<uint32_t>(pixels[i].z * 255.0f) << 16) | 0xff000000u;
+        if (displayPixels[i] != expected) packMismatches++;
+    }
+    std::cout << "Display pixels match framebuffer: " << (packMismatches == 0 ? "YES" : "NO") << std::endl;
+
     renderer.shutdown();
     Utils::logInfo("Software Renderer tests completed");
 }
@@ -101,9 +1330,233 @@ void testCameraRayGeneration() {
     float dirLength = testRay.direction.length();
     std::cout << "Ray direction length (should be ~1.0): " << dirLength << std::endl;
 
+    // Per-frame camera basis: stepping by pixel deltas must match the per-pixel formula
+    SoftwareRenderer renderer;
+    renderer.setResolution(64, 48);
+    renderer.setCamera(Vector3(4, -6, 3), Vector3(0, 0, 0), Vector3(0, 0, 1));
+    renderer.setCameraFOV(60.0f);
+    renderer.render();
+    const CameraFrame &frame = renderer.getCameraFrame();
+
+    float tanHalfFov = std::tan(60.0f * Utils::DEG_TO_RAD * 0.5f);
+    float aspect = 64.0f / 48.0f;
+    float maxError = 0.0f;
+    for (int y = 0; y < 48; ++y) {
+        Vector3 direction = frame.getPixelDirection(0, y);
+        for (int x = 0; x < 64; ++x) {
+            float normalizedX = (2.0f * x / 64) - 1.0f;
+            float normalizedY = 1.0f - (2.0f * y / 48);
+            Vector3 expected = (frame.forward + frame.right * (normalizedX * aspect * tanHalfFov) +
+                                frame.up * (normalizedY * tanHalfFov)).normalized();
+            maxError = std::max(maxError, (direction.normalized() - expected).length());
+            direction += frame.pixelDeltaX;
+        }
+    }
+    std::cout << "Incremental ray direction max error: " << maxError << std::endl;
+    std::cout << "Camera frame matches per-pixel rays: " << (maxError < 1e-5f ? "YES" : "NO") << std::endl;
+
     Utils::logInfo("Camera ray generation tests completed");
 }
 
+void testImageWriter() {
+    Utils::logInfo("Testing offline image output...");
+
+    SoftwareRenderer renderer;
+    renderer.setResolution(48, 32);
+    renderer.setShowVertices(false);
+    FramebufferPlanes planes;
+    planes.hdr = true;
+    renderer.setFramebufferPlanes(planes);
+    Model cube;
+    cube.createCube(1.0f);
+    Camera camera;
+    camera.setIsometricView();
+    camera.setDistance(4.0f);
+    renderer.render(cube, camera);
+
+    const Framebuffer &framebuffer = renderer.getFramebuffer();
+    std::vector<Vector3> radiance;
+    for (const HdrSample &sample : framebuffer.hdr) {
+        radiance.push_back(sample.color);
+    }
+
+    // Queue of one: every submit after the first waits for the writer thread
+    ImageWriter writer(1);
+    const char *paths[3] = {"test_image_writer.png", "test_image_writer.exr", "test_image_writer.raw"};
+    const ImageFormat formats[3] = {ImageFormat::PNG, ImageFormat::EXR, ImageFormat::RAW};
+    for (int i = 0; i < 3; ++i) {
+        ImageFrame frame;
+        frame.path = paths[i];
+        frame.format = formats[i];
+        frame.width = framebuffer.width;
+        frame.height = framebuffer.height;
+        if (formats[i] == ImageFormat::PNG)
+            frame.display = framebuffer.display;
+        else
+            frame.color = radiance;
+        writer.submit(std::move(frame));
+    }
+    const bool finished = writer.finish();
+    std::cout << "Writer thread wrote every queued frame: "
+              << (finished && writer.getWrittenCount() == 3 && !writer.submit(ImageFrame()) ? "YES" : "NO") << std::endl;
+
+    auto readFile = [](const char *path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    };
+    auto readBigEndian = [](const std::vector<uint8_t> &bytes, size_t at) {
+        return (uint32_t(bytes[at]) << 24) | (uint32_t(bytes[at + 1]) << 16) | (uint32_t(bytes[at + 2]) << 8) | bytes[at + 3];
+    };
+
+    // PNG: signature, then chunks whose CRCs check out, IHDR first and IEND last
+    const std::vector<uint8_t> png = readFile(paths[0]);
+    const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    bool pngValid = png.size() > 8 && std::equal(signature, signature + 8, png.begin());
+    std::vector<std::string> chunkTypes;
+    for (size_t at = 8; pngValid && at + 12 <= png.size();) {
+        const uint32_t length = readBigEndian(png, at);
+        if (at + 12 + length > png.size()) {
+            pngValid = false;
+            break;
+        }
+        uint32_t crc = 0xffffffffu;
+        for (size_t i = at + 4; i < at + 8 + length; ++i) {
+            crc ^= png[i];
+            for (int k = 0; k < 8; ++k) crc = (crc & 1) ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+        }
+        pngValid = pngValid && (crc ^ 0xffffffffu) == readBigEndian(png, at + 8 + length);
+        chunkTypes.emplace_back(png.begin() + at + 4, png.begin() + at + 8);
+        at += 12 + length;
+    }
+    pngValid = pngValid && chunkTypes.size() >= 3 && chunkTypes.front() == "IHDR" && chunkTypes.back() == "IEND" &&
+               readBigEndian(png, 16) == 48 && readBigEndian(png, 20) == 32;
+    std::cout << "PNG has valid chunks and checksums (" << png.size() << " bytes, "
+              << (framebuffer.width * framebuffer.height * 3) << " uncompressed): "
+              << (pngValid && png.size() < static_cast<size_t>(framebuffer.width * framebuffer.height * 3) ? "YES" : "NO")
+              << std::endl;
+
+    // Raw: the float radiance back exactly, rows top to bottom
+    const std::vector<uint8_t> raw = readFile(paths[2]);
+    bool rawExact = raw.size() == radiance.size() * 3 * sizeof(float);
+    for (size_t i = 0; rawExact && i < radiance.size(); ++i) {
+        float rgb[3];
+        std::memcpy(rgb, raw.data() + i * sizeof(rgb), sizeof(rgb));
+        rawExact = rgb[0] == radiance[i].x && rgb[1] == radiance[i].y && rgb[2] == radiance[i].z;
+    }
+    std::cout << "Raw file holds the radiance exactly: " << (rawExact ? "YES" : "NO") << std::endl;
+
+    // EXR: magic number, offset table pointing at the scanlines, B G R channel planes per line
+    const std::vector<uint8_t> exr = readFile(paths[1]);
+    const size_t lineBytes = framebuffer.width * 3 * sizeof(float);
+    const size_t chunkBytes = 8 + lineBytes;
+    bool exrValid = exr.size() > 8 + framebuffer.height * (8 + chunkBytes) && exr[0] == 0x76 && exr[1] == 0x2f &&
+                    exr[2] == 0x31 && exr[3] == 0x01 && exr[4] == 2;
+    if (exrValid) {
+        const size_t firstChunk = exr.size() - framebuffer.height * chunkBytes;
+        for (int y = 0; exrValid && y < framebuffer.height; ++y) {
+            uint64_t offset = 0;
+            int32_t lineY = 0;
+            std::memcpy(&offset, exr.data() + firstChunk - framebuffer.height * 8 + y * 8, sizeof(offset));
+            std::memcpy(&lineY, exr.data() + offset, sizeof(lineY));
+            exrValid = offset == firstChunk + y * chunkBytes && lineY == y;
+            for (int x = 0; exrValid && x < framebuffer.width; ++x) {
+                float b, g, r;
+                const uint8_t *line = exr.data() + offset + 8;
+                std::memcpy(&b, line + x * sizeof(float), sizeof(float));
+                std::memcpy(&g, line + (framebuffer.width + x) * sizeof(float), sizeof(float));
+                std::memcpy(&r, line + (2 * framebuffer.width + x) * sizeof(float), sizeof(float));
+                const Vector3 &expected = radiance[y * framebuffer.width + x];
+                exrValid = r == expected.x && g == expected.y && b == expected.z;
+            }
+        }
+    }
+    std::cout << "EXR scanlines match the radiance: " << (exrValid ? "YES" : "NO") << std::endl;
+
+    for (const char *path : paths) {
+        std::remove(path);
+    }
+}
+
+void testLodRendering() {
+    Utils::logInfo("Testing level-of-detail rendering...");
+
+    // Unit UV sphere with outward faces
+    Model sphere;
+    const int rings = 60;
+    const int segments = 120;
+    sphere.addVertex(0.0f, 0.0f, 1.0f);
+    for (int ring = 1; ring < rings; ++ring) {
+        const float theta = Utils::PI * ring / rings;
+        for (int segment = 0; segment < segments; ++segment) {
+            const float phi = 2.0f * Utils::PI * segment / segments;
+            sphere.addVertex(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+        }
+    }
+    sphere.addVertex(0.0f, 0.0f, -1.0f);
+    const int bottomPole = sphere.getVertexCount() - 1;
+    auto ringVertex = [&](int ring, int segment) { return 1 + (ring - 1) * segments + segment % segments; };
+    auto addOutwardFace = [&](int a, int b, int c) {
+        const auto &v = sphere.getVertices();
+        const Vector3 normal = Vector3::cross(v[b].position - v[a].position, v[c].position - v[a].position);
+        if (Vector3::dot(normal, v[a].position + v[b].position + v[c].position) < 0.0f)
+            std::swap(b, c);
+        sphere.addFace(a, b, c);
+    };
+    for (int segment = 0; segment < segments; ++segment) {
+        addOutwardFace(0, ringVertex(1, segment), ringVertex(1, segment + 1));
+        addOutwardFace(bottomPole, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1));
+        for (int ring = 1; ring < rings - 1; ++ring) {
+            addOutwardFace(ringVertex(ring, segment), ringVertex(ring + 1, segment), ringVertex(ring + 1, segment + 1));
+            addOutwardFace(ringVertex(ring, segment), ringVertex(ring + 1, segment + 1), ringVertex(ring, segment + 1));
+        }
+    }
+
+    // Level to show while moving, as ModelLod would pick for a 4000-face budget
+    MeshSimplifier simplifier;
+    simplifier.load(sphere.getVertices(), sphere.getFaces());
+    simplifier.simplify(4000);
+    Model lodMesh;
+    simplifier.extract(lodMesh);
+
+    // Renderer: the LOD is traced while the camera moves, full detail returns once it settles
+    auto setupRenderer = [&](SoftwareRenderer &renderer) {
+        renderer.setResolution(64, 48);
+        renderer.setShowVertices(false);
+        renderer.setShowCoordinateAxes(false);
+        Scene scene;
+        std::vector<int> faceTriangles;
+        scene.addConnectedParts(sphere, faceTriangles);
+        renderer.setScene(scene);
+    };
+    SoftwareRenderer reference;
+    setupRenderer(reference);
+    SoftwareRenderer renderer;
+    setupRenderer(renderer);
+    renderer.getRenderConfig().lodSettleMs = 0.0f;
+    renderer.setLodMesh(lodMesh);
+
+    renderer.setCamera(Vector3(0, -4, 1), Vector3(0, 0, 0), Vector3(0, 0, 1));
+    renderer.render();
+    const bool movingUsesLod = renderer.getLastFrameStats().usedLod && renderer.isShowingLod() &&
+                               renderer.getTriangleCount() == lodMesh.getFaceCount();
+    renderer.render();
+    reference.setCamera(Vector3(0, -4, 1), Vector3(0, 0, 0), Vector3(0, 0, 1));
+    reference.render();
+    const bool settledIsFull = !renderer.getLastFrameStats().usedLod && renderer.getTriangleCount() == sphere.getFaceCount() &&
+                               renderer.getPixelData() == reference.getPixelData();
+    std::cout << "Moving camera traces the LOD: " << (movingUsesLod ? "YES" : "NO") << std::endl;
+    std::cout << "Settled camera traces full detail, same image: " << (settledIsFull ? "YES" : "NO") << std::endl;
+
+    // Edits always land on the full mesh, even while the LOD is on show
+    renderer.setCamera(Vector3(0, -4, 1.5f), Vector3(0, 0, 0), Vector3(0, 0, 1));
+    renderer.render();
+    const bool lodShown = renderer.isShowingLod();
+    renderer.updateTriangle(0, Triangle(Vector3(0, 0, 1), Vector3(0.1f, 0, 1), Vector3(0, 0.1f, 1)));
+    std::cout << "Edit switches back to full detail: "
+              << (lodShown && !renderer.isShowingLod() && renderer.getTriangleCount() == sphere.getFaceCount() ? "YES" : "NO")
+              << std::endl;
+}
+
 int main() {
     Utils::logInfo("Starting Raytracing Tests");
 
@@ -114,6 +1567,60 @@ int main() {
         testCameraRayGeneration();
         std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
 
+        testBVHIntersection();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testPacketIntersection();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testScreenSpaceOverlays();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testHybridRendering();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testProgressiveRendering();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testIncrementalUpdates();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testFramebufferPlanes();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testProfiler();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testSkyTable();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testReflectionTermination();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testWavefrontReflections();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testFrameReuse();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testPrimaryCulling();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testSceneInstancing();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testBatchQueries();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testQuietHotPath();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testImageWriter();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testLodRendering();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
         testSoftwareRenderer();
 
     } catch (const std::exception& e) {
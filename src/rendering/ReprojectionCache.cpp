@@ -0,0 +1,123 @@
+#include "ReprojectionCache.h"
+#include <cstring>
+#include <limits>
+
+void ReprojectionCache::release()
+{
+    width = 0;
+    height = 0;
+    key = Key();
+    complete = false;
+    surfaceCount = 0;
+    color = std::vector<Vector3>();
+    distance = std::vector<float>();
+    triangleId = std::vector<int>();
+    targets.reset();
+    targetCount = 0;
+}
+
+void ReprojectionCache::beginRecording(const CameraFrame &frameCamera, int frameWidth, int frameHeight, const Key &frameKey)
+{
+    const size_t pixelCount = static_cast<size_t>(frameWidth) * frameHeight;
+    width = frameWidth;
+    height = frameHeight;
+    camera = frameCamera;
+    key = frameKey;
+    complete = false;
+
+    // Sky until a hit is recorded: pixels without a primary triangle are never splatted
+    color.resize(pixelCount);
+    distance.assign(pixelCount, std::numeric_limits<float>::max());
+    triangleId.assign(pixelCount, -1);
+}
+
+void ReprojectionCache::markComplete()
+{
+    surfaceCount = 0;
+    for (int id : triangleId)
+    {
+        surfaceCount += id >= 0 ? 1 : 0;
+    }
+    complete = true;
+}
+
+void ReprojectionCache::beginReprojection(const CameraFrame &view)
+{
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    if (targetCount != pixelCount)
+    {
+        targets.reset(new std::atomic<uint64_t>[pixelCount]);
+        targetCount = pixelCount;
+    }
+
+    // Point - origin = s * (topLeft + deltaX * x + deltaY * y) is linear in (s, s * x, s * y);
+    // Cramer's rule on the columns (topLeft, deltaX, deltaY) also covers a non-orthogonal up vector
+    const Vector3 &t = view.topLeftDirection;
+    const Vector3 &dx = view.pixelDeltaX;
+    const Vector3 &dy = view.pixelDeltaY;
+    const Vector3 crossXY = Vector3::cross(dx, dy);
+    const float determinant = Vector3::dot(t, crossXY);
+    const float inverse = determinant != 0.0f ? 1.0f / determinant : 0.0f;
+    solveDepth = crossXY * inverse;
+    solveX = Vector3::cross(dy, t) * inverse;
+    solveY = Vector3::cross(t, dx) * inverse;
+    viewOrigin = view.origin;
+}
+
+void ReprojectionCache::clearTargets(int y0, int y1)
+{
+    for (size_t index = static_cast<size_t>(y0) * width; index < static_cast<size_t>(y1) * width; ++index)
+    {
+        targets[index].store(EMPTY_TARGET, std::memory_order_relaxed);
+    }
+}
+
+int ReprojectionCache::splatRows(int y0, int y1)
+{
+    int claimed = 0;
+    for (int y = y0; y < y1; ++y)
+    {
+        Vector3 direction = camera.getPixelDirection(0, y);
+        for (int x = 0; x < width; ++x, direction += camera.pixelDeltaX)
+        {
+            const int source = y * width + x;
+            if (triangleId[source] < 0)
+                continue;
+
+            const Vector3 toPoint = camera.origin + direction.normalized() * distance[source] - viewOrigin;
+            const float s = Vector3::dot(toPoint, solveDepth);
+            if (!(s > 0.0f))
+                continue; // Behind the new view
+
+            // Pixel centers sit at integer coordinates; the range check also rejects NaN
+            const float pixelX = Vector3::dot(toPoint, solveX) / s + 0.5f;
+            const float pixelY = Vector3::dot(toPoint, solveY) / s + 0.5f;
+            if (!(pixelX >= 0.0f && pixelX < width && pixelY >= 0.0f && pixelY < height))
+                continue;
+            const int targetX = static_cast<int>(pixelX);
+            const int targetY = static_cast<int>(pixelY);
+
+            // Non-negative floats order like their bit patterns, so the packed value is a depth test
+            const float reprojectedDistance = toPoint.length();
+            uint32_t distanceBits;
+            std::memcpy(&distanceBits, &reprojectedDistance, sizeof(distanceBits));
+            const uint64_t value = (static_cast<uint64_t>(distanceBits) << 32) | static_cast<uint32_t>(source);
+
+            std::atomic<uint64_t> &target = targets[targetY * width + targetX];
+            uint64_t current = target.load(std::memory_order_relaxed);
+            while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+            claimed += current == EMPTY_TARGET ? 1 : 0;
+        }
+    }
+    return claimed;
+}
+
+float ReprojectionCache::getReprojectedDistance(int index) const
+{
+    const uint32_t distanceBits = static_cast<uint32_t>(targets[index].load(std::memory_order_relaxed) >> 32);
+    float result;
+    std::memcpy(&result, &distanceBits, sizeof(result));
+    return result;
+}
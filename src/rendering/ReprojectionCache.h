@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CameraFrame.h"
+#include "../math/Vector3.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// The last fully traced frame, kept for temporal reprojection: unclamped radiance and primary
+// triangle hit of every pixel plus the camera they were seen from. After a small camera move
+// the cached surface points are splatted into the new view (closest point wins per pixel);
+// pixels nothing lands on (disocclusions, sky, overlays) are traced again by the renderer.
+// Shading is reused as is, so view-dependent reflections lag until the next full frame.
+class ReprojectionCache
+{
+public:
+    // Identifies what the recorded pixels were rendered from
+    struct Key
+    {
+        uint64_t sceneVersion = 0;
+        uint64_t cameraVersion = 0;
+        int reflectionDepth = 0;
+
+        bool operator==(const Key &other) const
+        {
+            return sceneVersion == other.sceneVersion && cameraVersion == other.cameraVersion &&
+                   reflectionDepth == other.reflectionDepth;
+        }
+        bool operator!=(const Key &other) const { return !(*this == other); }
+    };
+
+private:
+    static constexpr uint64_t EMPTY_TARGET = ~uint64_t(0);
+
+    int width = 0;
+    int height = 0;
+    CameraFrame camera; // Camera of the recorded pixels
+    Key key;
+    bool complete = false; // Every pixel recorded under the current key
+    int surfaceCount = 0;  // Recorded pixels with a triangle hit
+
+    std::vector<Vector3> color;
+    std::vector<float> distance;
+    std::vector<int> triangleId;
+
+    // Reprojection target per pixel of the new view: (distance bits << 32) | source pixel
+    std::unique_ptr<std::atomic<uint64_t>[]> targets;
+    size_t targetCount = 0;
+
+    // Inverse of the new view's pixel mapping, set up by beginReprojection()
+    Vector3 solveDepth, solveX, solveY; // Dot with (point - origin) gives s, s * x, s * y
+    Vector3 viewOrigin;
+
+public:
+    void release();
+
+    // Start over for a new key; pixels are recorded by the tile workers until markComplete()
+    void beginRecording(const CameraFrame &frameCamera, int frameWidth, int frameHeight, const Key &frameKey);
+    const Key &getKey() const { return key; }
+    bool hasSize(int frameWidth, int frameHeight) const { return width == frameWidth && height == frameHeight; }
+    void markComplete();
+    bool isComplete() const { return complete; }
+
+    // Called per pixel from the tile workers (distinct pixels, no synchronization)
+    void recordColor(int index, const Vector3 &radiance) { color[index] = radiance; }
+    void recordHit(int index, float hitDistance, int hitTriangle)
+    {
+        distance[index] = hitDistance;
+        triangleId[index] = hitTriangle;
+    }
+
+    // Reprojection into a view of the same size: clear the targets (rows [y0, y1) per call),
+    // then splat the recorded surface pixels of rows [y0, y1). Both are safe to run in parallel.
+    void beginReprojection(const CameraFrame &view);
+    void clearTargets(int y0, int y1);
+    int splatRows(int y0, int y1); // Returns the target pixels this call claimed first
+
+    int getSurfaceCount() const { return surfaceCount; }
+
+    // Source pixel reprojected to the given pixel of the new view, -1 = hole
+    int getSource(int index) const
+    {
+        uint64_t target = targets[index].load(std::memory_order_relaxed);
+        return target == EMPTY_TARGET ? -1 : static_cast<int>(target & 0xffffffffu);
+    }
+    float getReprojectedDistance(int index) const; // Distance from the new view (valid when getSource() >= 0)
+    const Vector3 &getColor(int source) const { return color[source]; }
+    int getTriangleId(int source) const { return triangleId[source]; }
+};
@@ -0,0 +1,316 @@
+#include "ScreenSpaceOverlays.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void ScreenSpaceOverlays::OverlayBin::clear()
+{
+    vertices.clear();
+    edges.clear();
+    lines.clear();
+}
+
+void ScreenSpaceOverlays::beginFrame(const Vector3 &position, const Vector3 &cameraTarget, const Vector3 &cameraUp,
+                                     float fov, float aspectRatio, int width, int height)
+{
+    // Calculate camera coordinate system (as in the screen-space hit tests)
+    cameraPos = position;
+    forward = (cameraTarget - cameraPos).normalized();
+    right = Vector3::cross(forward, cameraUp).normalized();
+    up = Vector3::cross(right, forward);
+
+    vertices.clear();
+    edges.clear();
+    lines.clear();
+    outsideBin.clear();
+
+    // Screen-plane rectangle covered by the image: bounds of the four corner rays.
+    // Pixel -> screen plane is a projective map, so every pixel ray falls inside.
+    float tanHalfFov = std::tan(fov * 0.5f);
+    gridMinX = gridMinY = std::numeric_limits<float>::max();
+    gridMaxX = gridMaxY = -std::numeric_limits<float>::max();
+    bool cornersInFront = true;
+    for (int corner = 0; corner < 4; ++corner)
+    {
+        float normalizedX = (corner & 1) ? 1.0f : -1.0f;
+        float normalizedY = (corner & 2) ? 1.0f : -1.0f;
+        Vector3 direction = forward + right * (normalizedX * aspectRatio * tanHalfFov) + cameraUp * (normalizedY * tanHalfFov);
+
+        float rayZ = Vector3::dot(direction, forward);
+        if (rayZ <= 0.0f)
+        {
+            cornersInFront = false;
+            break;
+        }
+        float screenX = Vector3::dot(direction, right) / rayZ;
+        float screenY = Vector3::dot(direction, up) / rayZ;
+        gridMinX = std::min(gridMinX, screenX);
+        gridMaxX = std::max(gridMaxX, screenX);
+        gridMinY = std::min(gridMinY, screenY);
+        gridMaxY = std::max(gridMaxY, screenY);
+    }
+
+    if (!cornersInFront || !(gridMaxX > gridMinX) || !(gridMaxY > gridMinY) || width <= 0 || height <= 0)
+    {
+        // Extreme view - no grid, everything goes through the outside bin
+        cellsX = cellsY = 0;
+        cells.clear();
+        return;
+    }
+
+    cellsX = std::max(1, (width + CELL_PIXELS - 1) / CELL_PIXELS);
+    cellsY = std::max(1, (height + CELL_PIXELS - 1) / CELL_PIXELS);
+    cellScaleX = cellsX / (gridMaxX - gridMinX);
+    cellScaleY = cellsY / (gridMaxY - gridMinY);
+
+    // Keep the per-cell allocations from the previous frame
+    cells.resize(cellsX * cellsY);
+    for (auto &cell : cells)
+    {
+        cell.clear();
+    }
+}
+
+Vector3 ScreenSpaceOverlays::projectToScreen(const Vector3 &point) const
+{
+    Vector3 toPoint = point - cameraPos;
+    float z = Vector3::dot(toPoint, forward);
+    if (z <= 0.001f)
+        return Vector3(0, 0, -1); // Behind camera
+
+    float x = Vector3::dot(toPoint, right);
+    float y = Vector3::dot(toPoint, up);
+
+    // Direct projection onto screen plane at z=1 (no FOV correction)
+    return Vector3(x / z, y / z, z);
+}
+
+int ScreenSpaceOverlays::cellX(float screenX) const
+{
+    return std::clamp(static_cast<int>((screenX - gridMinX) * cellScaleX), 0, cellsX - 1);
+}
+
+int ScreenSpaceOverlays::cellY(float screenY) const
+{
+    return std::clamp(static_cast<int>((screenY - gridMinY) * cellScaleY), 0, cellsY - 1);
+}
+
+void ScreenSpaceOverlays::binElement(float minX, float minY, float maxX, float maxY,
+                                     std::vector<int> OverlayBin::*list, int index)
+{
+    const bool hasGrid = cellsX > 0;
+
+    // Anything reaching past the grid can be hit by rays whose screen point is off-screen
+    if (!hasGrid || !(minX >= gridMinX && maxX <= gridMaxX && minY >= gridMinY && maxY <= gridMaxY))
+    {
+        (outsideBin.*list).push_back(index);
+    }
+
+    if (!hasGrid || !(maxX >= gridMinX && minX <= gridMaxX && maxY >= gridMinY && minY <= gridMaxY))
+        return; // Not visible through any cell
+
+    int x0 = cellX(std::max(minX, gridMinX));
+    int x1 = cellX(std::min(maxX, gridMaxX));
+    int y0 = cellY(std::max(minY, gridMinY));
+    int y1 = cellY(std::min(maxY, gridMaxY));
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            (cells[y * cellsX + x].*list).push_back(index);
+        }
+    }
+}
+
+void ScreenSpaceOverlays::addVertices(const std::vector<Vector3> &vertexList, float displayRadius, const Vector3 &color)
+{
+    vertexRadius = displayRadius;
+    vertexColor = color;
+
+    // Small pad so rounding in the distance test can never reach outside the footprint
+    const float pad = displayRadius * 1.001f + 1e-6f;
+
+    for (const Vector3 &vertex : vertexList)
+    {
+        Vector3 toVertex = vertex - cameraPos;
+        float z = Vector3::dot(toVertex, forward);
+        if (z <= 0.001f)
+            continue; // Behind camera, can never be hit
+
+        float x = Vector3::dot(toVertex, right);
+        float y = Vector3::dot(toVertex, up);
+
+        ScreenVertex screenVertex;
+        screenVertex.screenX = x / z;
+        screenVertex.screenY = y / z;
+        screenVertex.position = vertex;
+
+        int index = static_cast<int>(vertices.size());
+        vertices.push_back(screenVertex);
+        binElement(screenVertex.screenX - pad, screenVertex.screenY - pad,
+                   screenVertex.screenX + pad, screenVertex.screenY + pad, &OverlayBin::vertices, index);
+    }
+}
+
+ScreenSpaceOverlays::ScreenSegment ScreenSpaceOverlays::makeSegment(const Vector3 &start, const Vector3 &end,
+                                                                    float threshold, const Vector3 &color) const
+{
+    ScreenSegment segment;
+    segment.screenStart = projectToScreen(start);
+    segment.screenEnd = projectToScreen(end);
+    segment.worldStart = start;
+    segment.worldEnd = end;
+    segment.threshold = threshold;
+    segment.color = color;
+
+    Vector3 direction2D = Vector3(segment.screenEnd.x - segment.screenStart.x, segment.screenEnd.y - segment.screenStart.y, 0);
+    segment.length2D = direction2D.length();
+    segment.direction2D = segment.length2D < 1e-6f ? direction2D : direction2D / segment.length2D;
+    return segment;
+}
+
+void ScreenSpaceOverlays::binSegment(const ScreenSegment &segment, std::vector<int> OverlayBin::*list, int index)
+{
+    const float pad = segment.threshold * 1.001f + 1e-6f;
+    binElement(std::min(segment.screenStart.x, segment.screenEnd.x) - pad,
+               std::min(segment.screenStart.y, segment.screenEnd.y) - pad,
+               std::max(segment.screenStart.x, segment.screenEnd.x) + pad,
+               std::max(segment.screenStart.y, segment.screenEnd.y) + pad, list, index);
+}
+
+void ScreenSpaceOverlays::addEdges(const std::vector<Line> &edgeList, float displayThickness, const Vector3 &color)
+{
+    for (const Line &edge : edgeList)
+    {
+        ScreenSegment segment = makeSegment(edge.start, edge.end, displayThickness, color);
+        if (segment.screenStart.z < 0 && segment.screenEnd.z < 0)
+            continue; // Both endpoints behind camera
+
+        int index = static_cast<int>(edges.size());
+        edges.push_back(segment);
+        binSegment(segment, &OverlayBin::edges, index);
+    }
+}
+
+void ScreenSpaceOverlays::addLines(const std::vector<Line> &lineList, float lineThickness)
+{
+    for (const Line &line : lineList)
+    {
+        ScreenSegment segment = makeSegment(line.start, line.end, lineThickness * line.thickness, line.color);
+        if (segment.screenStart.z < 0 && segment.screenEnd.z < 0)
+            continue; // Both endpoints behind camera
+
+        int index = static_cast<int>(lines.size());
+        lines.push_back(segment);
+        binSegment(segment, &OverlayBin::lines, index);
+    }
+}
+
+float ScreenSpaceOverlays::testVertex(const ScreenVertex &vertex, const Ray &ray,
+                                      float rayScreenX, float rayScreenY, bool &hit) const
+{
+    // Distance in 2D screen space
+    float screenDistance = Vector3(rayScreenX - vertex.screenX, rayScreenY - vertex.screenY, 0).length();
+    hit = screenDistance <= vertexRadius;
+
+    // Calculate ray parameter t (distance along ray from origin) to match face rendering
+    Vector3 toPoint = vertex.position - ray.origin;
+    return std::max(Vector3::dot(toPoint, ray.direction), 0.0f);
+}
+
+float ScreenSpaceOverlays::testSegment(const ScreenSegment &segment, bool depthFromRay, const Ray &ray,
+                                       float rayScreenX, float rayScreenY, bool &hit) const
+{
+    const Vector3 &screenStart = segment.screenStart;
+    const Vector3 &screenEnd = segment.screenEnd;
+
+    if (segment.length2D < 1e-6f)
+    {
+        // Degenerate segment - treat as point
+        float distToStart = Vector3(rayScreenX - screenStart.x, rayScreenY - screenStart.y, 0).length();
+        hit = distToStart <= segment.threshold;
+        if (!depthFromRay)
+            return screenStart.z; // Edges keep their historical screen-depth distance here
+
+        Vector3 toPoint = segment.worldStart - ray.origin;
+        return std::max(Vector3::dot(toPoint, ray.direction), 0.0f);
+    }
+
+    // Calculate closest point on segment to ray in 2D
+    Vector3 startToRay = Vector3(rayScreenX - screenStart.x, rayScreenY - screenStart.y, 0);
+    float t = Vector3::dot(startToRay, segment.direction2D);
+    t = std::clamp(t / segment.length2D, 0.0f, 1.0f); // Normalize to [0,1]
+
+    Vector3 closestPoint2D = Vector3(
+        screenStart.x + t * (screenEnd.x - screenStart.x),
+        screenStart.y + t * (screenEnd.y - screenStart.y),
+        0);
+
+    // Distance in 2D screen space
+    float screenDistance = Vector3(rayScreenX - closestPoint2D.x, rayScreenY - closestPoint2D.y, 0).length();
+    hit = screenDistance <= segment.threshold;
+
+    // Ray parameter of the interpolated 3D point for proper depth sorting against faces
+    Vector3 worldPoint = segment.worldStart + (segment.worldEnd - segment.worldStart) * t;
+    Vector3 toPoint = worldPoint - ray.origin;
+    return std::max(Vector3::dot(toPoint, ray.direction), 0.0f);
+}
+
+float ScreenSpaceOverlays::intersect(const Ray &ray, float rayEpsilon, bool includeLines, Vector3 &hitColor) const
+{
+    float closestDistance = std::numeric_limits<float>::max();
+    if (vertices.empty() && edges.empty() && (lines.empty() || !includeLines))
+        return closestDistance;
+
+    // Convert ray to screen coordinates (without FOV correction) once for all elements
+    Vector3 rayToScreen = ray.direction;
+    Vector3 rayRelative = rayToScreen - Vector3::dot(rayToScreen, forward) * forward;
+    float rayX = Vector3::dot(rayRelative, right);
+    float rayY = Vector3::dot(rayRelative, up);
+    float rayZ = Vector3::dot(rayToScreen, forward);
+    float rayScreenX = rayX / rayZ;
+    float rayScreenY = rayY / rayZ;
+
+    // Only elements whose footprint covers the ray's screen point can be hit
+    const OverlayBin *bin = &outsideBin;
+    if (cellsX > 0 && rayScreenX >= gridMinX && rayScreenX <= gridMaxX && rayScreenY >= gridMinY && rayScreenY <= gridMaxY)
+    {
+        bin = &cells[cellY(rayScreenY) * cellsX + cellX(rayScreenX)];
+    }
+
+    bool hit;
+    for (int index : bin->vertices)
+    {
+        float distance = testVertex(vertices[index], ray, rayScreenX, rayScreenY, hit);
+        if (hit && distance < closestDistance && distance > rayEpsilon)
+        {
+            closestDistance = distance;
+            hitColor = vertexColor;
+        }
+    }
+
+    for (int index : bin->edges)
+    {
+        float distance = testSegment(edges[index], false, ray, rayScreenX, rayScreenY, hit);
+        if (hit && distance < closestDistance && distance > rayEpsilon)
+        {
+            closestDistance = distance;
+            hitColor = edges[index].color;
+        }
+    }
+
+    if (includeLines)
+    {
+        for (int index : bin->lines)
+        {
+            float distance = testSegment(lines[index], true, ray, rayScreenX, rayScreenY, hit);
+            if (hit && distance < closestDistance && distance > rayEpsilon)
+            {
+                closestDistance = distance;
+                hitColor = lines[index].color;
+            }
+        }
+    }
+
+    return closestDistance;
+}
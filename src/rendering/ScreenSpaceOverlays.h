@@ -0,0 +1,103 @@
+#pragma once
+
+#include "../math/Vector3.h"
+#include "../core/Ray.h"
+#include <vector>
+
+// Per-frame screen-space projection of the vertex, edge and axis overlays.
+// Every element is projected once per frame and binned into a grid over the
+// visible part of the screen plane, so a ray only tests the elements whose
+// screen footprint covers its grid cell instead of every element.
+// Hit tests give the same results as RayIntersection::intersect*ScreenSpace.
+class ScreenSpaceOverlays
+{
+private:
+    // Projected vertex (only vertices in front of the camera are kept)
+    struct ScreenVertex
+    {
+        float screenX;
+        float screenY;
+        Vector3 position;
+    };
+
+    // Projected edge or line; screen z < 0 marks an endpoint behind the camera
+    struct ScreenSegment
+    {
+        Vector3 screenStart;
+        Vector3 screenEnd;
+        Vector3 direction2D; // Normalized screen direction (unused when degenerate)
+        float length2D;
+        Vector3 worldStart;
+        Vector3 worldEnd;
+        float threshold; // Screen-space hit radius
+        Vector3 color;
+    };
+
+    // Element indices overlapping one grid cell, in ascending order
+    struct OverlayBin
+    {
+        std::vector<int> vertices;
+        std::vector<int> edges;
+        std::vector<int> lines;
+
+        void clear();
+    };
+
+    // Overlay screen basis (same as the screen-space hit tests)
+    Vector3 cameraPos;
+    Vector3 forward;
+    Vector3 right;
+    Vector3 up;
+
+    std::vector<ScreenVertex> vertices;
+    float vertexRadius = 0.0f; // Screen-space hit radius
+    Vector3 vertexColor;
+    std::vector<ScreenSegment> edges; // Model edges (degenerate edges use the screen depth)
+    std::vector<ScreenSegment> lines; // Coordinate axes
+
+    // Grid over the screen-plane rectangle seen by the camera
+    static constexpr int CELL_PIXELS = 8; // Approximate cell size in image pixels
+    float gridMinX = 0.0f;
+    float gridMinY = 0.0f;
+    float gridMaxX = 0.0f;
+    float gridMaxY = 0.0f;
+    float cellScaleX = 0.0f; // Cells per screen unit
+    float cellScaleY = 0.0f;
+    int cellsX = 0;
+    int cellsY = 0;
+    std::vector<OverlayBin> cells;
+    OverlayBin outsideBin; // Elements reaching outside the grid (hit by off-screen reflection rays)
+
+public:
+    ScreenSpaceOverlays() = default;
+
+    // Start a new frame: sets up the basis and grid for the view and drops all elements
+    void beginFrame(const Vector3 &cameraPos, const Vector3 &cameraTarget, const Vector3 &cameraUp,
+                    float fov, float aspectRatio, int width, int height);
+
+    // Project and bin elements (after beginFrame)
+    void addVertices(const std::vector<Vector3> &vertexList, float displayRadius, const Vector3 &color);
+    void addEdges(const std::vector<Line> &edgeList, float displayThickness, const Vector3 &color);
+    void addLines(const std::vector<Line> &lineList, float lineThickness);
+
+    // Closest overlay hit with distance > rayEpsilon, FLT_MAX if nothing is hit.
+    // Vertices win ties over edges, edges over lines; lines are only tested when includeLines is set.
+    float intersect(const Ray &ray, float rayEpsilon, bool includeLines, Vector3 &hitColor) const;
+
+    // Info
+    int getVertexCount() const { return static_cast<int>(vertices.size()); }
+    int getEdgeCount() const { return static_cast<int>(edges.size()); }
+    int getLineCount() const { return static_cast<int>(lines.size()); }
+
+private:
+    Vector3 projectToScreen(const Vector3 &point) const;
+    ScreenSegment makeSegment(const Vector3 &start, const Vector3 &end, float threshold, const Vector3 &color) const;
+    void binElement(float minX, float minY, float maxX, float maxY, std::vector<int> OverlayBin::*list, int index);
+    void binSegment(const ScreenSegment &segment, std::vector<int> OverlayBin::*list, int index);
+    int cellX(float screenX) const;
+    int cellY(float screenY) const;
+
+    float testVertex(const ScreenVertex &vertex, const Ray &ray, float rayScreenX, float rayScreenY, bool &hit) const;
+    float testSegment(const ScreenSegment &segment, bool depthFromRay, const Ray &ray,
+                      float rayScreenX, float rayScreenY, bool &hit) const;
+};
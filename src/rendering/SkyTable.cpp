@@ -0,0 +1,26 @@
+#include "SkyTable.h"
+
+void SkyTable::build(float sunAngularSize)
+{
+    verticalFactor.resize(VERTICAL_SIZE + 1);
+    for (int i = 0; i <= VERTICAL_SIZE; ++i)
+    {
+        verticalFactor[i] = std::pow(static_cast<float>(i) / VERTICAL_SIZE, 0.7f);
+    }
+
+    // angle = acos(1 - r^2) = 2 * asin(r / sqrt(2)) for disc radius parameter r = sqrt(1 - cos(angle))
+    cosSunAngularSize = std::cos(sunAngularSize);
+    const float maxRadius = std::sqrt(std::max(0.0f, 1.0f - cosSunAngularSize));
+    sunRadiusScale = maxRadius > 0.0f ? SUN_SIZE / maxRadius : 0.0f;
+
+    sunIntensity.resize(SUN_SIZE + 1);
+    for (int i = 0; i <= SUN_SIZE; ++i)
+    {
+        float radius = maxRadius * static_cast<float>(i) / SUN_SIZE;
+        float angle = 2.0f * std::asin(std::min(1.0f, radius / std::sqrt(2.0f)));
+        float intensity = sunAngularSize > 0.0f ? std::max(0.0f, 1.0f - angle / sunAngularSize) : 0.0f;
+        sunIntensity[i] = intensity * intensity; // Square for smoother falloff
+    }
+
+    builtSunAngularSize = sunAngularSize;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// Precomputed terms of the procedural sky for rays that miss the scene, so miss shading
+// needs no acos/pow per ray. The gradient is separable (sun proximity is a plain dot
+// product, only the vertical curve needs a pow), so one 1D table over the ray's z and one
+// over the sun disc radius stand in for a full environment map. Tables depend only on the
+// sun's angular size and are rebuilt when it changes; colors and direction are read live.
+class SkyTable
+{
+private:
+    static constexpr int VERTICAL_SIZE = 512; // Intervals over (z + 1) / 2 in [0, 1]
+    static constexpr int SUN_SIZE = 256;      // Intervals over sqrt(1 - cos(angle)) inside the disc
+
+    std::vector<float> verticalFactor; // pow((z + 1) / 2, 0.7)
+    std::vector<float> sunIntensity;   // (1 - angle / sunAngularSize)^2
+    float builtSunAngularSize = -1.0f;
+    float cosSunAngularSize = 1.0f;
+    float sunRadiusScale = 0.0f; // SUN_SIZE / sqrt(1 - cosSunAngularSize)
+
+public:
+    bool needsRebuild(float sunAngularSize) const { return verticalFactor.empty() || sunAngularSize != builtSunAngularSize; }
+    void build(float sunAngularSize);
+
+    // Linear interpolation of the vertical gradient curve for a normalized direction's z
+    float getVerticalFactor(float z) const
+    {
+        float position = std::min(std::max((z + 1.0f) * 0.5f, 0.0f), 1.0f) * VERTICAL_SIZE;
+        int index = std::min(static_cast<int>(position), VERTICAL_SIZE - 1);
+        float fraction = position - static_cast<float>(index);
+        return verticalFactor[index] + (verticalFactor[index + 1] - verticalFactor[index]) * fraction;
+    }
+
+    // Sun disc test by dot-product threshold; false outside the disc
+    bool getSunIntensity(float sunAlignment, float &intensity) const
+    {
+        if (!(sunAlignment > cosSunAngularSize))
+            return false;
+
+        // Indexed by sqrt(1 - cos), in which the angle is smooth even at the disc center
+        float position = std::sqrt(std::max(0.0f, 1.0f - sunAlignment)) * sunRadiusScale;
+        position = std::min(position, static_cast<float>(SUN_SIZE));
+        int index = std::min(static_cast<int>(position), SUN_SIZE - 1);
+        float fraction = position - static_cast<float>(index);
+        intensity = sunIntensity[index] + (sunIntensity[index + 1] - sunIntensity[index]) * fraction;
+        return true;
+    }
+};
@@ -1,9 +1,62 @@
 #include "SoftwareRenderer.h"
 #include "../utils/Utils.h"
+#include "../utils/Profiler.h"
 #include <fstream>
 #include <iomanip>
 #include <cmath>
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+    // Reflection rays of the current thread (read before and after each tile for RenderStats)
+    struct ThreadRayCounts
+    {
+        uint64_t traced = 0;    // Reflection rays traced through the scene
+        uint64_t truncated = 0; // Reflection rays cut off by the depth limit (the next level's cost)
+    };
+    thread_local ThreadRayCounts threadReflectionRays;
+
+    double elapsedMs(std::chrono::high_resolution_clock::time_point start,
+                     std::chrono::high_resolution_clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // Settings snapshots are plain structs copied with memcpy, so even padding compares equal
+    template <typename T>
+    bool sameBytes(const T &a, const T &b)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "settings snapshots must be plain structs");
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    }
+
+    // Renderer triangles of a model's faces, in face order (faces with invalid indices are skipped)
+    void appendModelTriangles(const Model &model, std::vector<Triangle> &triangles)
+    {
+        const MeshView mesh = model.getMeshView();
+        triangles.reserve(triangles.size() + mesh.faceCount);
+        for (int i = 0; i < mesh.faceCount; ++i)
+        {
+            const Face &face = mesh.faces[i];
+            if (face.v1 < mesh.vertexCount && face.v2 < mesh.vertexCount && face.v3 < mesh.vertexCount)
+            {
+                const Vector3 v0 = mesh.getPosition(face.v1);
+                const Vector3 v1 = mesh.getPosition(face.v2);
+                const Vector3 v2 = mesh.getPosition(face.v3);
+
+                // Use a default color for now (will be enhanced later)
+                Vector3 color(0.7f, 0.7f, 0.7f); // Light gray
+
+                triangles.emplace_back(v0, v1, v2, color);
+            }
+        }
+    }
+}
 
 void SoftwareRenderer::initialize()
 {
@@ -16,46 +69,757 @@ void SoftwareRenderer::initialize()
 void SoftwareRenderer::shutdown()
 {
     Utils::logInfo("Shutting down Software Renderer");
-    pixels.clear();
-    triangles.clear();
+    threadPool.reset();
+    framebuffer.resize(0, 0, framebuffer.planes);
+    clearTriangles();
 }
 
 void SoftwareRenderer::setResolution(int newWidth, int newHeight)
 {
+    // Callers may pass the window size every frame; keep the framebuffer and the skip cache then
+    if (newWidth == width && newHeight == height && framebuffer.width == width && framebuffer.height == height)
+        return;
+
     width = newWidth;
     height = newHeight;
     aspectRatio = static_cast<float>(width) / static_cast<float>(height);
 
-    // Resize pixel buffer
-    pixels.resize(width * height);
+    // Resize pixel buffers
+    framebuffer.resize(width, height, framebuffer.planes);
+    ++sceneVersion;
     clear(Vector3(0.1f, 0.1f, 0.2f)); // Default dark blue background
 
     Utils::logInfo("Resolution set to " + std::to_string(width) + "x" + std::to_string(height));
 }
 
+void SoftwareRenderer::setFramebufferPlanes(const FramebufferPlanes &planes)
+{
+    framebuffer.resize(width, height, planes);
+    ++sceneVersion;
+    clear(Vector3(0.1f, 0.1f, 0.2f));
+    restartRefinement(); // Newly enabled planes hold no samples yet
+}
+
 void SoftwareRenderer::clear(const Vector3 &clearColor)
 {
-    std::fill(pixels.begin(), pixels.end(), clearColor);
+    framebuffer.clear(clearColor);
+    ++sceneVersion;
 }
 
 void SoftwareRenderer::render()
 {
-    // Clear screen with sky gradient
-    for (int y = 0; y < height; ++y)
+    PROFILE_SCOPE("SoftwareRenderer::render");
+    using Clock = std::chrono::high_resolution_clock;
+    RenderStats stats;
+
+    selectDetailLevel();
+    stats.usedLod = showingLod;
+    detectSettingsChange();
+    selectReflectionDepth();
+    if (config.skipUnchangedFrames && hasCompleteFrame && completeFrameKey == getFrameKey())
+    {
+        // Nothing that affects the image changed: the framebuffer already holds this frame
+        lastFrameStats = stats;
+        lastFrameStats.reflectionDepth = frameReflectionDepth;
+        lastFrameStats.skippedFrame = true;
+        return;
+    }
+    hasCompleteFrame = false;
+
+    const auto accelerationStart = Clock::now();
+
+    if (bvhDirty)
+    {
+        buildAccelerationStructure();
+        stats.rebuiltAcceleration = true;
+    }
+    else
+    {
+        if (!pendingTriangleUpdates.empty())
+        {
+            refitAccelerationStructure();
+        }
+        if (instancesDirty)
+        {
+            updateInstanceLevel();
+            stats.rebuiltInstances = true;
+        }
+    }
+
+    auto frameStart = Clock::now();
+    stats.accelerationMs = elapsedMs(accelerationStart, frameStart);
+
+    ensureThreadPool();
+    updateCameraFrame();
+    updateOverlays();
+    if (skyTable.needsRebuild(reflectionConfig.sunAngularSize))
+    {
+        skyTable.build(reflectionConfig.sunAngularSize);
+    }
+    stats.reflectionDepth = frameReflectionDepth;
+
+    // Split the framebuffer into tiles; tiles are distributed over the worker pool
+    const int tileSize = std::max(8, config.tileSize);
+    const int tilesX = (width + tileSize - 1) / tileSize;
+    const int tilesY = (height + tileSize - 1) / tileSize;
+
+    // Small camera move from a complete frame: reuse its pixels, trace only the holes
+    if (reprojectFrame(stats, tilesX, tilesY, tileSize))
+    {
+        stats.totalMs = elapsedMs(accelerationStart, Clock::now());
+        lastFrameStats = stats;
+        return;
+    }
+    beginFrameRecording();
+
+    // Reflection rays counted per worker thread, summed once per tile
+    std::atomic<uint64_t> secondaryRays{0};
+    std::atomic<uint64_t> truncatedRays{0};
+
+    // Progressive mode: sparse samples while the camera moves, refined once it stops
+    int blockSize = 1;
+    int refineFrom = 0;
+    selectProgressiveLevel(blockSize, refineFrom);
+
+    if (blockSize > 1 || refineFrom > 0)
+    {
+        const auto traceStart = Clock::now();
+        stats.setupMs = elapsedMs(frameStart, traceStart);
+        threadPool->parallelFor(tilesX * tilesY,
+                                [&](int tileIndex)
+                                {
+                                    int x0 = (tileIndex % tilesX) * tileSize;
+                                    int y0 = (tileIndex / tilesX) * tileSize;
+                                    int x1 = std::min(x0 + tileSize, width);
+                                    int y1 = std::min(y0 + tileSize, height);
+                                    PROFILE_SCOPE("Sparse tile");
+                                    const ThreadRayCounts raysBefore = threadReflectionRays;
+                                    renderSparseTile(x0, y0, x1, y1, blockSize, refineFrom);
+                                    secondaryRays += threadReflectionRays.traced - raysBefore.traced;
+                                    truncatedRays += threadReflectionRays.truncated - raysBefore.truncated;
+                                });
+
+        stats.traceMs = elapsedMs(traceStart, Clock::now());
+        stats.totalMs = stats.accelerationMs + stats.setupMs + stats.traceMs;
+        stats.primarySamples = static_cast<uint64_t>(countTracedSamples(blockSize, refineFrom));
+        stats.secondaryRays = secondaryRays;
+        lastFrameStats = stats;
+        finishProgressiveFrame(blockSize, refineFrom, frameStart);
+        finishFrameRecording(blockSize);
+        updateReflectionBudget(secondaryRays, truncatedRays);
+        return;
+    }
+
+    const bool rasterPrimary = config.useRasterPrimary && config.showFaces;
+    if (rasterPrimary)
+    {
+        if (gBuffer.width != width || gBuffer.height != height)
+        {
+            gBuffer.resize(width, height);
+        }
+        if (rasterTrianglesDirty)
+        {
+            updateRasterTriangles();
+        }
+        const std::vector<int> *candidates = nullptr;
+        if (config.frustumCulling)
+        {
+            PROFILE_SCOPE("Frustum culling");
+            primaryCandidates.clear();
+            bvh.collectInFrustum(getViewFrustum(), primaryCandidates);
+            candidates = &primaryCandidates;
+        }
+        rasterizer.beginFrame(cameraFrame, width, height, tileSize, config.rayEpsilon, candidates, config.cullBackFaces);
+        stats.primaryTriangles = rasterizer.getFrameTriangleCount();
+    }
+
+    const auto traceStart = Clock::now();
+    stats.setupMs = elapsedMs(frameStart, traceStart);
+    threadPool->parallelFor(tilesX * tilesY,
+                            [&](int tileIndex)
+                            {
+                                int x0 = (tileIndex % tilesX) * tileSize;
+                                int y0 = (tileIndex / tilesX) * tileSize;
+                                int x1 = std::min(x0 + tileSize, width);
+                                int y1 = std::min(y0 + tileSize, height);
+                                PROFILE_SCOPE("Tile");
+                                const ThreadRayCounts raysBefore = threadReflectionRays;
+                                if (rasterPrimary)
+                                    renderRasterTile(x0, y0, x1, y1);
+                                else
+                                    renderTile(x0, y0, x1, y1);
+                                secondaryRays += threadReflectionRays.traced - raysBefore.traced;
+                                truncatedRays += threadReflectionRays.truncated - raysBefore.truncated;
+                            });
+
+    stats.traceMs = elapsedMs(traceStart, Clock::now());
+    stats.totalMs = stats.accelerationMs + stats.setupMs + stats.traceMs;
+    stats.primarySamples = static_cast<uint64_t>(width) * height;
+    stats.secondaryRays = secondaryRays;
+    lastFrameStats = stats;
+    finishProgressiveFrame(1, 0, frameStart);
+    finishFrameRecording(1);
+    updateReflectionBudget(secondaryRays, truncatedRays);
+}
+
+void SoftwareRenderer::selectProgressiveLevel(int &blockSize, int &refineFrom) const
+{
+    blockSize = 1;
+    refineFrom = 0;
+    if (!config.progressiveRendering || !progressive.hasPreviousFrame)
+        return;
+
+    bool cameraMoved = progressive.cameraPos != cameraPos || progressive.cameraTarget != cameraTarget ||
+                       progressive.cameraUp != cameraUp || progressive.fov != fov ||
+                       progressive.width != width || progressive.height != height;
+
+    if (cameraMoved)
+    {
+        // Coarsest spacing whose estimated cost fits the frame budget
+        const int maxBlockSize = std::max(1, config.progressiveMaxBlockSize);
+        blockSize = 1;
+        while (blockSize < maxBlockSize)
+        {
+            float samples = static_cast<float>(width) * height / (blockSize * blockSize);
+            if (samples * progressive.sampleCostMs <= config.progressiveBudgetMs)
+                break;
+            blockSize *= 2;
+        }
+    }
+    else if (progressive.blockSize > 1)
+    {
+        // Camera stopped: halve the spacing and keep the samples already taken
+        blockSize = progressive.blockSize / 2;
+        refineFrom = progressive.blockSize;
+    }
+}
+
+void SoftwareRenderer::finishProgressiveFrame(int blockSize, int refineFrom,
+                                              std::chrono::high_resolution_clock::time_point frameStart)
+{
+    double frameMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - frameStart).count();
+
+    const double samples = countTracedSamples(blockSize, refineFrom);
+    if (samples > 0.0)
+    {
+        float cost = static_cast<float>(frameMs / samples);
+        progressive.sampleCostMs = progressive.hasPreviousFrame ? progressive.sampleCostMs * 0.7f + cost * 0.3f : cost;
+    }
+
+    rememberProgressiveView(blockSize);
+}
+
+void SoftwareRenderer::rememberProgressiveView(int blockSize)
+{
+    progressive.hasPreviousFrame = true;
+    progressive.cameraPos = cameraPos;
+    progressive.cameraTarget = cameraTarget;
+    progressive.cameraUp = cameraUp;
+    progressive.fov = fov;
+    progressive.width = width;
+    progressive.height = height;
+    progressive.blockSize = blockSize;
+}
+
+double SoftwareRenderer::countTracedSamples(int blockSize, int refineFrom) const
+{
+    // Samples actually traced this frame (refinement skips the ones kept from the coarser level)
+    double samples = static_cast<double>(width) * height / (blockSize * blockSize);
+    if (refineFrom > 0)
+    {
+        samples -= static_cast<double>(width) * height / (refineFrom * refineFrom);
+    }
+    return samples;
+}
+
+void SoftwareRenderer::detectSettingsChange()
+{
+    // Settings are exposed by reference (UI widgets write them directly), so compare with the
+    // snapshot of the last frame instead of relying on setters
+    if (sameBytes(config, renderedConfig) && sameBytes(reflectionConfig, renderedReflectionConfig))
+        return;
+
+    std::memcpy(static_cast<void *>(&renderedConfig), &config, sizeof(config));
+    std::memcpy(static_cast<void *>(&renderedReflectionConfig), &reflectionConfig, sizeof(reflectionConfig));
+    ++sceneVersion;
+    restartRefinement(); // Kept samples were shaded with the old settings
+}
+
+void SoftwareRenderer::beginFrameRecording()
+{
+    capturePrimaryHits = framebuffer.planes.depth;
+    recordingFrame = false;
+    if (!config.temporalReprojection)
+    {
+        reprojection.release();
+        return;
+    }
+
+    // Progressive refinement of one view spans several frames under the same key
+    const ReprojectionCache::Key key = getFrameKey();
+    if (reprojection.getKey() != key || !reprojection.hasSize(width, height))
+    {
+        reprojection.beginRecording(cameraFrame, width, height, key);
+    }
+    capturePrimaryHits = true;
+    recordingFrame = true;
+}
+
+void SoftwareRenderer::finishFrameRecording(int blockSize)
+{
+    recordingFrame = false;
+    if (blockSize > 1)
+        return;
+
+    // Every pixel has now been traced for this key
+    hasCompleteFrame = true;
+    completeFrameKey = getFrameKey();
+    if (config.temporalReprojection)
     {
-        for (int x = 0; x < width; ++x)
+        reprojection.markComplete();
+    }
+}
+
+bool SoftwareRenderer::reprojectFrame(RenderStats &stats, int tilesX, int tilesY, int tileSize)
+{
+    // Only a camera move is allowed since the cached frame: any other change invalidates its shading
+    // (and once per view: when the camera stops, the frame after a reprojected one is traced in full)
+    const ReprojectionCache::Key key = getFrameKey();
+    const ReprojectionCache::Key &cached = reprojection.getKey();
+    if (!config.temporalReprojection || !reprojection.isComplete() || cached.sceneVersion != key.sceneVersion ||
+        cached.reflectionDepth != key.reflectionDepth || cached.cameraVersion == key.cameraVersion ||
+        reprojectedCameraVersion == key.cameraVersion)
+        return false;
+
+    PROFILE_SCOPE("Reprojection");
+    const auto splatStart = std::chrono::high_resolution_clock::now();
+    reprojection.beginReprojection(cameraFrame);
+    auto forEachBand = [&](const auto &task)
+    {
+        threadPool->parallelFor(tilesY, [&](int band)
+                                { task(band * tileSize, std::min((band + 1) * tileSize, height)); });
+    };
+    forEachBand([&](int y0, int y1) { reprojection.clearTargets(y0, y1); });
+    std::atomic<int> landedPixels{0};
+    forEachBand([&](int y0, int y1) { landedPixels += reprojection.splatRows(y0, y1); });
+
+    // A larger move loses too much of the cached surface: trace the frame normally instead
+    if (landedPixels < reprojection.getSurfaceCount() * config.reprojectionMinCoverage)
+        return false;
+
+    recordingFrame = false; // The cache keeps the traced frame, not this approximation
+    capturePrimaryHits = framebuffer.planes.depth;
+
+    std::atomic<uint64_t> secondaryRays{0};
+    std::atomic<uint64_t> tracedPixels{0};
+    const auto traceStart = std::chrono::high_resolution_clock::now();
+    stats.setupMs = elapsedMs(splatStart, traceStart);
+    threadPool->parallelFor(tilesX * tilesY,
+                            [&](int tileIndex)
+                            {
+                                int x0 = (tileIndex % tilesX) * tileSize;
+                                int y0 = (tileIndex / tilesX) * tileSize;
+                                int x1 = std::min(x0 + tileSize, width);
+                                int y1 = std::min(y0 + tileSize, height);
+                                PROFILE_SCOPE("Reprojected tile");
+                                const ThreadRayCounts raysBefore = threadReflectionRays;
+                                tracedPixels += renderReprojectedTile(x0, y0, x1, y1);
+                                secondaryRays += threadReflectionRays.traced - raysBefore.traced;
+                            });
+
+    stats.traceMs = elapsedMs(traceStart, std::chrono::high_resolution_clock::now());
+    stats.primarySamples = tracedPixels;
+    stats.reprojectedPixels = static_cast<uint64_t>(width) * height - tracedPixels;
+    stats.secondaryRays = secondaryRays;
+
+    // The next still frame traces everything again (reflections are view dependent); the ray
+    // budget only learns from fully traced frames
+    rememberProgressiveView(1);
+    reprojectedCameraVersion = key.cameraVersion;
+    return true;
+}
+
+int SoftwareRenderer::renderReprojectedTile(int x0, int y0, int x1, int y1)
+{
+    int traced = 0;
+    for (int y = y0; y < y1; ++y)
+    {
+        Vector3 direction = cameraFrame.getPixelDirection(x0, y);
+        for (int x = x0; x < x1; ++x, direction += cameraFrame.pixelDeltaX)
         {
-            Ray ray = generateCameraRay(x, y);
-            Vector3 color = castRay(ray);
+            const int index = y * width + x;
+            const int source = reprojection.getSource(index);
+            PrimaryHit hit;
+            if (source >= 0)
+            {
+                // Cached shading at the surface point's new position
+                hit.distance = reprojection.getReprojectedDistance(index);
+                hit.triangleId = reprojection.getTriangleId(source);
+                storePixel(x, y, reprojection.getColor(source));
+                storeHit(x, y, hit);
+                continue;
+            }
 
-            // Clamp color values to [0, 1] range
-            color.x = Utils::clamp(color.x, 0.0f, 1.0f);
-            color.y = Utils::clamp(color.y, 0.0f, 1.0f);
-            color.z = Utils::clamp(color.z, 0.0f, 1.0f);
+            // Hole: disoccluded surface, sky or overlay
+            Ray ray = Ray::fromUnitDirection(cameraFrame.origin, direction.normalized());
+            storePixel(x, y, castRay(ray, 0, capturePrimaryHits ? &hit : nullptr));
+            storeHit(x, y, hit);
+            traced++;
+        }
+    }
+    return traced;
+}
+
+void SoftwareRenderer::restartRefinement()
+{
+    // Next still frame starts over at full resolution
+    progressive.blockSize = 1;
+}
+
+void SoftwareRenderer::renderSparseTile(int x0, int y0, int x1, int y1, int blockSize, int refineFrom)
+{
+    // Blocks are anchored to the tile origin so every block stays inside its tile (one thread per tile)
+    for (int y = y0; y < y1; y += blockSize)
+    {
+        for (int x = x0; x < x1; x += blockSize)
+        {
+            // Samples of the coarser level are already in the image
+            if (refineFrom > 0 && (x - x0) % refineFrom == 0 && (y - y0) % refineFrom == 0)
+                continue;
+
+            Ray ray = Ray::fromUnitDirection(cameraFrame.origin, cameraFrame.getPixelDirection(x, y).normalized());
+            PrimaryHit hit;
+            storePixel(x, y, castRay(ray, 0, capturePrimaryHits ? &hit : nullptr));
+            storeHit(x, y, hit);
+
+            // Fill the rest of the block with the sample
+            fillBlock(x, y, std::min(x + blockSize, x1), std::min(y + blockSize, y1));
+        }
+    }
+}
+
+void SoftwareRenderer::ensureThreadPool()
+{
+    int requestedThreads = config.renderThreadCount > 0 ? config.renderThreadCount : ThreadPool::getHardwareThreadCount();
+    if (!threadPool || threadPool->getThreadCount() != requestedThreads)
+    {
+        threadPool = std::make_unique<ThreadPool>(requestedThreads);
+        Utils::logInfo("Render thread pool started with " + std::to_string(requestedThreads) + " threads");
+    }
+}
+
+void SoftwareRenderer::renderTile(int x0, int y0, int x1, int y1)
+{
+    // Packets only pay off for primary rays that actually reach the triangle stage
+    const bool usePackets = config.usePacketTracing && config.showFaces && !bvh.isEmpty() &&
+                            frameReflectionDepth > 0;
+    if (usePackets && config.useWavefrontReflections)
+    {
+        renderWavefrontTile(x0, y0, x1, y1);
+        return;
+    }
+
+    for (int y = y0; y < y1; ++y)
+    {
+        if (usePackets)
+        {
+            for (int x = x0; x < x1; x += RAY_PACKET_WIDTH)
+            {
+                renderPacket(x, std::min(x + RAY_PACKET_WIDTH, x1), y);
+            }
+            continue;
+        }
+
+        // Step the ray direction across the row instead of rebuilding it per pixel
+        Vector3 direction = cameraFrame.getPixelDirection(x0, y);
+        for (int x = x0; x < x1; ++x)
+        {
+            Ray ray = Ray::fromUnitDirection(cameraFrame.origin, direction.normalized());
+            PrimaryHit hit;
+            storePixel(x, y, castRay(ray, 0, capturePrimaryHits ? &hit : nullptr));
+            storeHit(x, y, hit);
+            direction += cameraFrame.pixelDeltaX;
+        }
+    }
+}
+
+void SoftwareRenderer::renderPacket(int x0, int x1, int y)
+{
+    // Trace up to RAY_PACKET_WIDTH neighbouring pixels of one row together;
+    // overlays and shading stay per ray so the image matches castRay exactly
+    RayPacket packet;
+    packet.tMin = config.rayEpsilon;
+
+    Ray rays[RAY_PACKET_WIDTH];
+    Vector3 overlayColors[RAY_PACKET_WIDTH];
+    float overlayDistances[RAY_PACKET_WIDTH];
+
+    const int laneCount = x1 - x0;
+    Vector3 direction = cameraFrame.getPixelDirection(x0, y);
+    for (int lane = 0; lane < laneCount; ++lane)
+    {
+        rays[lane] = Ray::fromUnitDirection(cameraFrame.origin, direction.normalized());
+        direction += cameraFrame.pixelDeltaX;
+        overlayDistances[lane] = intersectOverlays(rays[lane], 0, overlayColors[lane]);
+        packet.setRay(lane, rays[lane], overlayDistances[lane]);
+    }
+    for (int lane = laneCount; lane < RAY_PACKET_WIDTH; ++lane)
+    {
+        packet.setInactive(lane);
+    }
+
+    BVHHit hits[RAY_PACKET_WIDTH];
+    int hitMask = bvh.intersectPacket(packet, hits);
+
+    for (int lane = 0; lane < laneCount; ++lane)
+    {
+        Vector3 color;
+        PrimaryHit primaryHit;
+        primaryHit.distance = overlayDistances[lane];
+        if (hitMask & (1 << lane))
+        {
+            color = shadeTriangleHit(rays[lane], hits[lane].hit, hits[lane].instanceIndex, 0);
+            primaryHit.distance = hits[lane].hit.distance;
+            primaryHit.triangleId = hits[lane].triangleIndex;
+        }
+        else if (overlayDistances[lane] < std::numeric_limits<float>::max())
+        {
+            color = overlayColors[lane];
+        }
+        else
+        {
+            color = calculateSkyboxColor(rays[lane]);
+        }
+        storePixel(x0 + lane, y, color);
+        storeHit(x0 + lane, y, primaryHit);
+    }
+}
+
+void SoftwareRenderer::renderWavefrontTile(int x0, int y0, int x1, int y1)
+{
+    // Every ray of one depth across the tile is traced before the next depth starts, in packets;
+    // reflection waves are sorted by direction first so each packet holds similar rays.
+    // Scratch buffers are reused by each worker thread across tiles and frames.
+    thread_local std::vector<ReflectionPath> paths;
+    thread_local std::vector<PrimaryHit> primaryHits;
+    thread_local std::vector<uint64_t> wave; // (coherence key << 32) | path index
+
+    const int tileWidth = x1 - x0;
+    const int pathCount = tileWidth * (y1 - y0);
+    paths.assign(pathCount, ReflectionPath());
+    primaryHits.assign(pathCount, PrimaryHit());
+    wave.clear();
+
+    for (int y = y0; y < y1; ++y)
+    {
+        Vector3 direction = cameraFrame.getPixelDirection(x0, y);
+        for (int x = x0; x < x1; ++x)
+        {
+            const int index = (y - y0) * tileWidth + (x - x0);
+            paths[index].ray = Ray::fromUnitDirection(cameraFrame.origin, direction.normalized());
+            wave.push_back(static_cast<uint64_t>(index)); // Primary rays are coherent in pixel order
+            direction += cameraFrame.pixelDeltaX;
+        }
+    }
+
+    bool primaryWave = true;
+    while (!wave.empty())
+    {
+        traceWave(wave, paths.data(), primaryWave ? primaryHits.data() : nullptr);
+        primaryWave = false;
+
+        // Next wave: the reflection rays of the paths still going, grouped by direction octant
+        // and then by quantized direction (ties keep pixel order)
+        size_t next = 0;
+        for (uint64_t entry : wave)
+        {
+            const uint32_t index = static_cast<uint32_t>(entry);
+            if (!paths[index].active)
+                continue;
+
+            const Vector3 &dir = paths[index].ray.direction;
+            auto quantize = [](float value) { return static_cast<uint64_t>(std::min(15.0f, std::abs(value) * 16.0f)); };
+            const uint64_t octant = (dir.x < 0.0f ? 4 : 0) | (dir.y < 0.0f ? 2 : 0) | (dir.z < 0.0f ? 1 : 0);
+            const uint64_t key = (octant << 12) | (quantize(dir.x) << 8) | (quantize(dir.y) << 4) | quantize(dir.z);
+            wave[next++] = (key << 32) | index;
+        }
+        wave.resize(next);
+        std::sort(wave.begin(), wave.end());
+    }
+
+    for (int y = y0; y < y1; ++y)
+    {
+        for (int x = x0; x < x1; ++x)
+        {
+            const int index = (y - y0) * tileWidth + (x - x0);
+            storePixel(x, y, paths[index].color);
+            storeHit(x, y, primaryHits[index]);
+        }
+    }
+}
+
+void SoftwareRenderer::traceWave(const std::vector<uint64_t> &wave, ReflectionPath *paths, PrimaryHit *primaryHits) const
+{
+    RayPacket packet;
+    packet.tMin = config.rayEpsilon;
+    uint32_t laneIndices[RAY_PACKET_WIDTH];
+    Vector3 overlayColors[RAY_PACKET_WIDTH];
+    float overlayDistances[RAY_PACKET_WIDTH];
+
+    size_t next = 0;
+    while (next < wave.size())
+    {
+        // Fill a packet with rays that are still below the depth limit (the others finish here)
+        packet.activeMask = 0;
+        int laneCount = 0;
+        while (laneCount < RAY_PACKET_WIDTH && next < wave.size())
+        {
+            const uint32_t index = static_cast<uint32_t>(wave[next++]);
+            ReflectionPath &path = paths[index];
+            if (!beginPathSegment(path))
+                continue;
+
+            laneIndices[laneCount] = index;
+            overlayDistances[laneCount] = intersectOverlays(path.ray, path.depth, overlayColors[laneCount]);
+            packet.setRay(laneCount, path.ray, overlayDistances[laneCount]);
+            laneCount++;
+        }
+        if (laneCount == 0)
+            continue;
+        for (int lane = laneCount; lane < RAY_PACKET_WIDTH; ++lane)
+        {
+            packet.setInactive(lane);
+        }
+
+        BVHHit hits[RAY_PACKET_WIDTH];
+        int hitMask = bvh.intersectPacket(packet, hits);
+
+        for (int lane = 0; lane < laneCount; ++lane)
+        {
+            const uint32_t index = laneIndices[lane];
+            resolvePathSegment(paths[index], overlayDistances[lane], overlayColors[lane],
+                               (hitMask & (1 << lane)) ? &hits[lane] : nullptr,
+                               primaryHits ? &primaryHits[index] : nullptr);
+        }
+    }
+}
+
+void SoftwareRenderer::renderRasterTile(int x0, int y0, int x1, int y1)
+{
+    // Primary visibility from the G-buffer; overlays and reflections are still ray traced
+    rasterizer.rasterizeTile(x0, y0, x1, y1, gBuffer);
+
+    for (int y = y0; y < y1; ++y)
+    {
+        Vector3 direction = cameraFrame.getPixelDirection(x0, y);
+        for (int x = x0; x < x1; ++x)
+        {
+            Ray ray = Ray::fromUnitDirection(cameraFrame.origin, direction.normalized());
+            direction += cameraFrame.pixelDeltaX;
+
+            PrimaryHit primaryHit;
+            if (frameReflectionDepth <= 0)
+            {
+                storePixel(x, y, calculateSkyboxColor(ray));
+                storeHit(x, y, primaryHit);
+                continue;
+            }
+
+            Vector3 overlayColor;
+            float overlayDistance = intersectOverlays(ray, 0, overlayColor);
+            primaryHit.distance = overlayDistance;
+
+            int pixel = y * width + x;
+            if (gBuffer.triangleId[pixel] >= 0 && gBuffer.depth[pixel] < overlayDistance)
+            {
+                TriangleHit hit;
+                hit.hit = true;
+                hit.distance = gBuffer.depth[pixel];
+                hit.point = ray.getPoint(hit.distance);
+                hit.normal = gBuffer.normal[pixel];
+                hit.isFrontFace = gBuffer.frontFace[pixel] != 0;
+                storePixel(x, y, shadeTriangleHit(ray, hit, bvh.findInstance(gBuffer.triangleId[pixel]), 0));
+                primaryHit.distance = hit.distance;
+                primaryHit.triangleId = gBuffer.triangleId[pixel];
+            }
+            else if (overlayDistance < std::numeric_limits<float>::max())
+            {
+                storePixel(x, y, overlayColor);
+            }
+            else
+            {
+                storePixel(x, y, calculateSkyboxColor(ray));
+            }
+            storeHit(x, y, primaryHit);
+        }
+    }
+}
+
+void SoftwareRenderer::storePixel(int x, int y, Vector3 color)
+{
+    const int index = y * width + x;
+    if (recordingFrame)
+        reprojection.recordColor(index, color);
+    if (framebuffer.planes.hdr)
+    {
+        framebuffer.hdr[index].color = color;
+        framebuffer.hdr[index].weight = 1.0f;
+    }
+
+    // Clamp color values to [0, 1] range
+    color.x = Utils::clamp(color.x, 0.0f, 1.0f);
+    color.y = Utils::clamp(color.y, 0.0f, 1.0f);
+    color.z = Utils::clamp(color.z, 0.0f, 1.0f);
+
+    // Quantized here, on the thread that rendered the tile, so presenting needs no conversion pass
+    if (framebuffer.planes.color)
+        framebuffer.color[index] = color;
+    if (framebuffer.planes.display)
+        framebuffer.display[index] = Framebuffer::packRGBA8(color);
+}
+
+void SoftwareRenderer::storeHit(int x, int y, const PrimaryHit &hit)
+{
+    const int index = y * width + x;
+    if (recordingFrame)
+        reprojection.recordHit(index, hit.distance, hit.triangleId);
+    if (!framebuffer.planes.depth)
+        return;
+
+    framebuffer.depth[index] = hit.distance;
+    framebuffer.triangleId[index] = hit.triangleId;
+}
+
+void SoftwareRenderer::fillBlock(int x, int y, int x1, int y1)
+{
+    // Copy the sample at (x, y) over [x, x1) x [y, y1) in every enabled plane
+    const int sample = y * width + x;
+    HdrSample filled;
+    if (framebuffer.planes.hdr)
+    {
+        filled.color = framebuffer.hdr[sample].color;
+        filled.weight = 0.0f;
+    }
 
-            pixels[y * width + x] = color;
+    for (int fillY = y; fillY < y1; ++fillY)
+    {
+        const int rowStart = fillY * width + x;
+        const int rowEnd = fillY * width + x1;
+        if (framebuffer.planes.color)
+            std::fill(framebuffer.color.begin() + rowStart, framebuffer.color.begin() + rowEnd, framebuffer.color[sample]);
+        if (framebuffer.planes.display)
+            std::fill(framebuffer.display.begin() + rowStart, framebuffer.display.begin() + rowEnd, framebuffer.display[sample]);
+        if (framebuffer.planes.hdr)
+            std::fill(framebuffer.hdr.begin() + rowStart, framebuffer.hdr.begin() + rowEnd, filled);
+        if (framebuffer.planes.depth)
+        {
+            std::fill(framebuffer.depth.begin() + rowStart, framebuffer.depth.begin() + rowEnd, framebuffer.depth[sample]);
+            std::fill(framebuffer.triangleId.begin() + rowStart, framebuffer.triangleId.begin() + rowEnd, framebuffer.triangleId[sample]);
         }
     }
+
+    if (framebuffer.planes.hdr)
+        framebuffer.hdr[sample].weight = 1.0f;
 }
 
 void SoftwareRenderer::render(const Model &model, const Camera &camera)
@@ -65,315 +829,725 @@ void SoftwareRenderer::render(const Model &model, const Camera &camera)
     cameraTarget = camera.getTarget();
     cameraUp = Vector3(0, 0, 1); // Z-up coordinate system
     fov = camera.getFOV();
+    ++cameraVersion;
 
     // Clear existing triangles and convert Model to triangles
     clearTriangles();
+    appendModelTriangles(model, meshTriangles[0]);
+    bvhDirty = true;
+
+    // Render the scene
+    render();
+}
+
+const std::vector<Vector3> &SoftwareRenderer::getPixelData() const
+{
+    return framebuffer.color;
+}
+
+void SoftwareRenderer::addTriangle(const Triangle &triangle)
+{
+    showFullDetail();
+    if (sceneLoaded)
+    {
+        Utils::logError("Cannot add a triangle to a loaded scene (clear the triangles first)");
+        return;
+    }
+
+    meshTriangles[0].push_back(triangle);
+    ++sceneVersion;
+    bvhDirty = true;
+    LOG_DEBUG("Added triangle to scene (total: " + std::to_string(meshTriangles[0].size()) + ")");
+}
+
+void SoftwareRenderer::addTriangles(const std::vector<Triangle> &triangleList)
+{
+    showFullDetail();
+    if (sceneLoaded)
+    {
+        Utils::logError("Cannot add triangles to a loaded scene (clear the triangles first)");
+        return;
+    }
+
+    meshTriangles[0].insert(meshTriangles[0].end(), triangleList.begin(), triangleList.end());
+    ++sceneVersion;
+    bvhDirty = true;
+    LOG_INFO("Added " + std::to_string(triangleList.size()) + " triangles to scene (total: " +
+             std::to_string(meshTriangles[0].size()) + ")");
+}
+
+void SoftwareRenderer::reserveTriangles(int count)
+{
+    showFullDetail();
+    if (!sceneLoaded && count > 0)
+    {
+        meshTriangles[0].reserve(static_cast<size_t>(count));
+    }
+}
+
+void SoftwareRenderer::clearTriangles()
+{
+    clearLod(); // Made from the triangles being cleared
+
+    // Back to a single empty mesh placed once, untransformed
+    meshTriangles.assign(1, std::vector<Triangle>());
+    instances.assign(1, InstanceBVH::Instance());
+    instanceMaterials.assign(1, Material());
+    sceneLoaded = false;
+    ++sceneVersion;
+    bvhDirty = true;
+    LOG_INFO("Cleared all triangles from scene");
+}
+
+void SoftwareRenderer::setScene(const Scene &scene)
+{
+    clearLod(); // Made from the previous scene
+    meshTriangles.assign(scene.getMeshCount(), std::vector<Triangle>());
+    for (int mesh = 0; mesh < scene.getMeshCount(); ++mesh)
+    {
+        appendModelTriangles(scene.getMesh(mesh), meshTriangles[mesh]);
+    }
+
+    instances.resize(scene.getInstanceCount());
+    instanceMaterials.resize(scene.getInstanceCount());
+    for (int i = 0; i < scene.getInstanceCount(); ++i)
+    {
+        const SceneInstance &instance = scene.getInstance(i);
+        instances[i].mesh = instance.mesh;
+        instances[i].transform = instance.transform;
+        instanceMaterials[i] = instance.material;
+    }
+    sceneLoaded = true;
+    ++sceneVersion;
+    bvhDirty = true;
+    Utils::logInfo("Scene loaded into renderer: " + std::to_string(scene.getMeshCount()) + " meshes, " +
+                   std::to_string(scene.getInstanceCount()) + " instances, " +
+                   std::to_string(getTriangleCount()) + " triangles");
+}
+
+void SoftwareRenderer::setInstanceTransform(int instance, const Matrix4 &transform)
+{
+    showFullDetail();
+    if (instance < 0 || instance >= static_cast<int>(instances.size()))
+    {
+        Utils::logError("Invalid instance index: " + std::to_string(instance));
+        return;
+    }
+
+    instances[instance].transform = transform;
+    ++sceneVersion;
+    instancesDirty = true;
+    rasterTrianglesDirty = true;
+}
+
+void SoftwareRenderer::setInstanceMaterial(int instance, const Material &material)
+{
+    showFullDetail();
+    if (instance < 0 || instance >= static_cast<int>(instances.size()))
+    {
+        Utils::logError("Invalid instance index: " + std::to_string(instance));
+        return;
+    }
+
+    instanceMaterials[instance] = material;
+    ++sceneVersion;
+    restartRefinement();
+}
+
+void SoftwareRenderer::setLodMesh(const Model &lod)
+{
+    showFullDetail();
+
+    StashedGeometry geometry;
+    geometry.meshTriangles.resize(1);
+    appendModelTriangles(lod, geometry.meshTriangles[0]);
+    geometry.instances.resize(1);
+    geometry.instanceMaterials.resize(1);
+    stashedGeometry = std::move(geometry);
+    hasLodMesh = true;
+    LOG_INFO("Level of detail set: " + std::to_string(stashedGeometry.meshTriangles[0].size()) + " triangles");
+}
 
-    const auto &vertices = model.getVertices();
-    const auto &faces = model.getFaces();
+void SoftwareRenderer::clearLod()
+{
+    if (!hasLodMesh)
+        return;
+
+    showFullDetail();
+    stashedGeometry = StashedGeometry();
+    hasLodMesh = false;
+}
+
+void SoftwareRenderer::selectDetailLevel()
+{
+    const auto now = std::chrono::steady_clock::now();
+    const bool cameraMoved = cameraVersion != lodCameraVersion;
+    if (cameraMoved)
+    {
+        lodCameraVersion = cameraVersion;
+        lastCameraMove = now;
+    }
+
+    // Coarse for a moment after the last move too, so a drag that pauses between mouse events
+    // does not flip between the two
+    const float stillMs = std::chrono::duration<float, std::milli>(now - lastCameraMove).count();
+    const bool wantLod = hasLodMesh && config.useLod && (cameraMoved || stillMs < config.lodSettleMs);
+    if (wantLod != showingLod)
+    {
+        swapGeometry();
+    }
+}
+
+void SoftwareRenderer::showFullDetail()
+{
+    if (showingLod)
+        swapGeometry();
+}
+
+void SoftwareRenderer::swapGeometry()
+{
+    std::swap(meshTriangles, stashedGeometry.meshTriangles);
+    std::swap(instances, stashedGeometry.instances);
+    std::swap(instanceMaterials, stashedGeometry.instanceMaterials);
+    std::swap(bvh, stashedGeometry.bvh);
+    std::swap(bvhDirty, stashedGeometry.bvhDirty);
+    std::swap(instancesDirty, stashedGeometry.instancesDirty);
+    std::swap(pendingTriangleUpdates, stashedGeometry.pendingTriangleUpdates);
+    std::swap(rasterizer, stashedGeometry.rasterizer);
+    std::swap(rasterTrianglesDirty, stashedGeometry.rasterTrianglesDirty);
+    showingLod = !showingLod;
+    ++sceneVersion;
+    restartRefinement();
+}
+
+int SoftwareRenderer::getTriangleCount() const
+{
+    int count = 0;
+    for (const InstanceBVH::Instance &instance : instances)
+    {
+        count += static_cast<int>(meshTriangles[instance.mesh].size());
+    }
+    return count;
+}
+
+int SoftwareRenderer::locateTriangle(int sceneTriangle, int &meshTriangle) const
+{
+    int firstTriangle = 0;
+    for (int i = 0; i < static_cast<int>(instances.size()); ++i)
+    {
+        const int count = static_cast<int>(meshTriangles[instances[i].mesh].size());
+        if (sceneTriangle >= firstTriangle && sceneTriangle < firstTriangle + count)
+        {
+            meshTriangle = sceneTriangle - firstTriangle;
+            return i;
+        }
+        firstTriangle += count;
+    }
+    return -1;
+}
 
-    // Convert Model faces to renderer triangles
-    for (const auto &face : faces)
+Triangle SoftwareRenderer::toWorldSpace(int instance, const Triangle &triangle) const
+{
+    const Matrix4 &transform = instances[instance].transform;
+    return Triangle(transform.transformPoint(triangle.v0), transform.transformPoint(triangle.v1),
+                    transform.transformPoint(triangle.v2), triangle.color);
+}
+
+void SoftwareRenderer::buildAccelerationStructure()
+{
+    PROFILE_SCOPE("BVH build");
+    bvh.setMeshCount(static_cast<int>(meshTriangles.size()));
+    for (int mesh = 0; mesh < static_cast<int>(meshTriangles.size()); ++mesh)
+    {
+        bvh.buildMesh(mesh, meshTriangles[mesh]);
+    }
+    bvh.setInstances(instances);
+    rasterTrianglesDirty = true;
+    restartRefinement();
+    pendingTriangleUpdates.clear();
+    bvhDirty = false;
+    instancesDirty = false;
+}
+
+void SoftwareRenderer::updateInstanceLevel()
+{
+    PROFILE_SCOPE("Instance BVH build");
+    bvh.setInstances(instances);
+    instancesDirty = false;
+    restartRefinement();
+}
+
+void SoftwareRenderer::updateRasterTriangles()
+{
+    // The rasterizer works on a world-space copy of every instance's triangles in scene id order;
+    // it is only made when the raster pass runs, so instancing saves the memory otherwise
+    PROFILE_SCOPE("Raster triangle setup");
+    std::vector<Triangle> worldTriangles;
+    worldTriangles.reserve(getTriangleCount());
+    for (int i = 0; i < static_cast<int>(instances.size()); ++i)
+    {
+        for (const Triangle &triangle : meshTriangles[instances[i].mesh])
+        {
+            worldTriangles.push_back(toWorldSpace(i, triangle));
+        }
+    }
+    rasterizer.setTriangles(worldTriangles);
+    rasterTrianglesDirty = false;
+}
+
+void SoftwareRenderer::refitAccelerationStructure()
+{
+    PROFILE_SCOPE("BVH refit");
+
+    // One refit per edited mesh, shared by all of its instances
+    std::sort(pendingTriangleUpdates.begin(), pendingTriangleUpdates.end());
+    for (size_t begin = 0; begin < pendingTriangleUpdates.size();)
     {
-        if (face.v1 < vertices.size() && face.v2 < vertices.size() && face.v3 < vertices.size())
+        const int mesh = pendingTriangleUpdates[begin].first;
+        refitTriangles.clear();
+        size_t end = begin;
+        for (; end < pendingTriangleUpdates.size() && pendingTriangleUpdates[end].first == mesh; ++end)
         {
-            const Vector3 &v0 = vertices[face.v1].position;
-            const Vector3 &v1 = vertices[face.v2].position;
-            const Vector3 &v2 = vertices[face.v3].position;
+            refitTriangles.push_back(pendingTriangleUpdates[end].second);
+        }
+        begin = end;
 
-            // Use a default color for now (will be enhanced later)
-            Vector3 color(0.7f, 0.7f, 0.7f); // Light gray
+        bvh.refitMesh(mesh, meshTriangles[mesh], refitTriangles);
 
-            triangles.emplace_back(v0, v1, v2, color);
+        // Refitted bounds only grow looser, so rebuild once the tree has degraded enough to matter
+        if (bvh.getRefitGrowth(mesh) > BVH_REBUILD_GROWTH)
+        {
+            LOG_DEBUG("Rebuilding BVH after refits");
+            bvh.buildMesh(mesh, meshTriangles[mesh]);
         }
     }
 
-    // Render the scene
-    render();
+    if (!rasterTrianglesDirty)
+    {
+        for (int i = 0; i < static_cast<int>(instances.size()); ++i)
+        {
+            for (const auto &update : pendingTriangleUpdates)
+            {
+                if (update.first == instances[i].mesh)
+                {
+                    const Triangle &triangle = meshTriangles[update.first][update.second];
+                    rasterizer.updateTriangle(bvh.getInstanceFirstTriangle(i) + update.second, toWorldSpace(i, triangle));
+                }
+            }
+        }
+    }
+    pendingTriangleUpdates.clear();
+    instancesDirty = true; // Instance bounds follow the refitted meshes
+    restartRefinement();
 }
 
-const std::vector<Vector3> &SoftwareRenderer::getPixelData() const
+void SoftwareRenderer::updateTriangle(int index, const Triangle &triangle)
 {
-    return pixels;
+    showFullDetail();
+    int meshTriangle = 0;
+    const int instance = locateTriangle(index, meshTriangle);
+    if (instance < 0)
+    {
+        Utils::logError("Invalid triangle index: " + std::to_string(index));
+        return;
+    }
+
+    const int mesh = instances[instance].mesh;
+    meshTriangles[mesh][meshTriangle] = triangle;
+    ++sceneVersion;
+    if (!bvhDirty)
+    {
+        pendingTriangleUpdates.push_back({mesh, meshTriangle});
+    }
 }
 
-void SoftwareRenderer::addTriangle(const Triangle &triangle)
+void SoftwareRenderer::updateVertex(int index, const Vector3 &vertex)
 {
-    triangles.push_back(triangle);
-    Utils::logInfo("Added triangle to scene (total: " + std::to_string(triangles.size()) + ")");
+    if (index < 0 || index >= static_cast<int>(vertices.size()))
+    {
+        Utils::logError("Invalid vertex index: " + std::to_string(index));
+        return;
+    }
+
+    vertices[index] = vertex;
+    ++sceneVersion;
+    restartRefinement();
 }
 
-void SoftwareRenderer::clearTriangles()
+void SoftwareRenderer::updateEdge(int index, const Line &edge)
 {
-    triangles.clear();
-    Utils::logInfo("Cleared all triangles from scene");
+    if (index < 0 || index >= static_cast<int>(edges.size()))
+    {
+        Utils::logError("Invalid edge index: " + std::to_string(index));
+        return;
+    }
+
+    edges[index] = edge;
+    ++sceneVersion;
+    restartRefinement();
+}
+
+bool SoftwareRenderer::isOccluded(const Ray &ray, float maxDistance) const
+{
+    return bvh.intersectAny(ray, config.rayEpsilon, maxDistance);
 }
 
 void SoftwareRenderer::addLine(const Line &line)
 {
     lines.push_back(line);
-    Utils::logInfo("Added line to scene (total: " + std::to_string(lines.size()) + ")");
+    ++sceneVersion;
+    LOG_DEBUG("Added line to scene (total: " + std::to_string(lines.size()) + ")");
 }
 
 void SoftwareRenderer::clearLines()
 {
     lines.clear();
-    Utils::logInfo("Cleared all lines from scene");
+    ++sceneVersion;
+    LOG_INFO("Cleared all lines from scene");
 }
 
 void SoftwareRenderer::setLines(const std::vector<Line> &lineList)
 {
     lines = lineList;
-    Utils::logInfo("Set " + std::to_string(lines.size()) + " lines in scene");
+    ++sceneVersion;
+    restartRefinement();
+    LOG_INFO("Set " + std::to_string(lines.size()) + " lines in scene");
 }
 
 void SoftwareRenderer::addVertex(const Vector3 &vertex)
 {
     vertices.push_back(vertex);
-    Utils::logInfo("Added vertex to scene (total: " + std::to_string(vertices.size()) + ")");
+    ++sceneVersion;
+    LOG_DEBUG("Added vertex to scene (total: " + std::to_string(vertices.size()) + ")");
 }
 
 void SoftwareRenderer::clearVertices()
 {
     vertices.clear();
-    Utils::logInfo("Cleared all vertices from scene");
+    ++sceneVersion;
+    LOG_INFO("Cleared all vertices from scene");
 }
 
 void SoftwareRenderer::setVertices(const std::vector<Vector3> &vertexList)
 {
-    vertices = vertexList;
-    Utils::logInfo("Set " + std::to_string(vertices.size()) + " vertices in scene");
+    setVertices(std::vector<Vector3>(vertexList));
+}
+
+void SoftwareRenderer::setVertices(std::vector<Vector3> &&vertexList)
+{
+    vertices = std::move(vertexList);
+    ++sceneVersion;
+    restartRefinement();
+    LOG_INFO("Set " + std::to_string(vertices.size()) + " vertices in scene");
 }
 
 void SoftwareRenderer::addEdge(const Line &edge)
 {
     edges.push_back(edge);
-    Utils::logInfo("Added edge to scene (total: " + std::to_string(edges.size()) + ")");
+    ++sceneVersion;
+    LOG_DEBUG("Added edge to scene (total: " + std::to_string(edges.size()) + ")");
 }
 
 void SoftwareRenderer::clearEdges()
 {
     edges.clear();
-    Utils::logInfo("Cleared all edges from scene");
+    ++sceneVersion;
+    LOG_INFO("Cleared all edges from scene");
 }
 
 void SoftwareRenderer::setEdges(const std::vector<Line> &edgeList)
 {
-    edges = edgeList;
-    Utils::logInfo("Set " + std::to_string(edges.size()) + " edges in scene");
+    setEdges(std::vector<Line>(edgeList));
+}
+
+void SoftwareRenderer::setEdges(std::vector<Line> &&edgeList)
+{
+    edges = std::move(edgeList);
+    ++sceneVersion;
+    restartRefinement();
+    LOG_INFO("Set " + std::to_string(edges.size()) + " edges in scene");
 }
 
 void SoftwareRenderer::setCamera(const Vector3 &pos, const Vector3 &target, const Vector3 &up)
 {
+    // Called every frame by the main loop; only an actual move counts as a change
+    const Vector3 newUp = up.normalized();
+    if (pos == cameraPos && target == cameraTarget && newUp == cameraUp)
+        return;
+
     cameraPos = pos;
     cameraTarget = target;
-    cameraUp = up.normalized();
-    Utils::logInfo("Camera set: pos=" + std::to_string(pos.x) + "," + std::to_string(pos.y) + "," + std::to_string(pos.z));
+    cameraUp = newUp;
+    ++cameraVersion;
+    LOG_DEBUG("Camera set: pos=" + std::to_string(pos.x) + "," + std::to_string(pos.y) + "," + std::to_string(pos.z));
 }
 
 void SoftwareRenderer::setCameraFOV(float fovDegrees)
 {
-    fov = fovDegrees * Utils::DEG_TO_RAD;
-    Utils::logInfo("Camera FOV set to " + std::to_string(fovDegrees) + " degrees");
+    // Like setCamera, only an actual change counts
+    const float newFov = fovDegrees * Utils::DEG_TO_RAD;
+    if (newFov == fov)
+        return;
+
+    fov = newFov;
+    ++cameraVersion;
+    LOG_DEBUG("Camera FOV set to " + std::to_string(fovDegrees) + " degrees");
 }
 
-Ray SoftwareRenderer::generateCameraRay(int x, int y) const
+void SoftwareRenderer::selectReflectionDepth()
 {
-    // Convert screen coordinates to normalized device coordinates [-1, 1]
-    float normalizedX = (2.0f * x / width) - 1.0f;
-    float normalizedY = 1.0f - (2.0f * y / height); // Standard screen to NDC conversion
+    const int maxDepth = reflectionConfig.maxReflectionDepth;
+    if (reflectionConfig.reflectionRayBudget <= 0 || maxDepth <= 1)
+    {
+        frameReflectionDepth = maxDepth;
+        return;
+    }
 
-    // Calculate camera coordinate system (right-hand rule)
-    Vector3 forward = (cameraTarget - cameraPos).normalized();
-    Vector3 right = Vector3::cross(forward, cameraUp).normalized();
-    Vector3 up = cameraUp.normalized(); // Use provided up vector directly
+    // Keep the depth the budget settled on, within the configured limit (primary rays always traced)
+    if (frameReflectionDepth < 1 || frameReflectionDepth > maxDepth)
+        frameReflectionDepth = maxDepth;
+}
 
-    // Calculate ray direction
-    float tanHalfFov = std::tan(fov * 0.5f);
-    Vector3 rayDir = forward +
-                     right * (normalizedX * aspectRatio * tanHalfFov) +
-                     up * (normalizedY * tanHalfFov);
+void SoftwareRenderer::updateReflectionBudget(uint64_t tracedRays, uint64_t truncatedRays)
+{
+    const int64_t budget = reflectionConfig.reflectionRayBudget;
+    if (budget <= 0)
+        return;
 
-    return Ray(cameraPos, rayDir.normalized());
+    // Over budget: drop a bounce. One more bounce would trace at most the rays the limit cut off
+    // this frame, so only step back up when those fit too (no oscillation on a still view)
+    if (tracedRays > static_cast<uint64_t>(budget) && frameReflectionDepth > 1)
+    {
+        frameReflectionDepth--;
+    }
+    else if (frameReflectionDepth < reflectionConfig.maxReflectionDepth &&
+             tracedRays + truncatedRays <= static_cast<uint64_t>(budget))
+    {
+        frameReflectionDepth++;
+    }
 }
 
-Vector3 SoftwareRenderer::castRay(const Ray &ray, int depth) const
+void SoftwareRenderer::updateCameraFrame()
 {
-    // Check maximum reflection depth
-    if (depth >= reflectionConfig.maxReflectionDepth) {
-        return calculateSkyboxColor(ray);
-    }
+    // Calculate camera coordinate system (right-hand rule)
+    cameraFrame.origin = cameraPos;
+    cameraFrame.forward = (cameraTarget - cameraPos).normalized();
+    cameraFrame.right = Vector3::cross(cameraFrame.forward, cameraUp).normalized();
+    cameraFrame.up = cameraUp.normalized(); // Use provided up vector directly
+    cameraFrame.tanHalfFov = std::tan(fov * 0.5f);
+
+    // NDC x = 2x / width - 1 and y = 1 - 2y / height are linear in the pixel coordinates,
+    // so the (unnormalized) ray direction is too
+    const float halfWidth = aspectRatio * cameraFrame.tanHalfFov;
+    const float halfHeight = cameraFrame.tanHalfFov;
+    cameraFrame.topLeftDirection = cameraFrame.forward - cameraFrame.right * halfWidth + cameraFrame.up * halfHeight;
+    cameraFrame.pixelDeltaX = cameraFrame.right * (2.0f * halfWidth / width);
+    cameraFrame.pixelDeltaY = cameraFrame.up * (-2.0f * halfHeight / height);
+}
+
+Frustum SoftwareRenderer::getViewFrustum() const
+{
+    // Through the outer pixel samples plus a pixel of margin, so rounding never drops a covered sample
+    const Vector3 corners[4] = {
+        cameraFrame.getPixelDirection(-1, -1),
+        cameraFrame.getPixelDirection(width, -1),
+        cameraFrame.getPixelDirection(width, height),
+        cameraFrame.getPixelDirection(-1, height),
+    };
+    // Near plane through the eye; the rasterizer clips at the ray epsilon itself
+    return Frustum::fromCorners(cameraFrame.origin, cameraFrame.forward, corners, 0.0f);
+}
 
-    float closestDistance = std::numeric_limits<float>::max();
-    bool hitFound = false;
-    Vector3 hitColor;
-    TriangleHit closestTriangleHit; // Store the closest triangle hit for reflection
+void SoftwareRenderer::updateOverlays()
+{
+    // Project vertices, edges and axes to screen space once for the whole frame
+    overlays.beginFrame(cameraPos, cameraTarget, cameraUp, fov, aspectRatio, width, height);
 
-    // Test ray against vertices first (highest priority) - only if vertices are enabled
     if (config.showVertices)
     {
-        for (size_t i = 0; i < vertices.size(); ++i)
-        {
-            VertexHit vertexHit = RayIntersection::intersectVertexScreenSpace(ray, vertices[i], config.vertexDisplayRadius, static_cast<int>(i),
-                                                                              cameraPos, cameraTarget, cameraUp, fov, aspectRatio);
-
-            if (vertexHit.hit && vertexHit.distance < closestDistance && vertexHit.distance > config.rayEpsilon)
-            {
-                closestDistance = vertexHit.distance;
-                hitColor = Vector3(1.0f, 1.0f, 1.0f); // White for vertices
-                hitFound = true;
-            }
-        }
+        overlays.addVertices(vertices, config.vertexDisplayRadius, Vector3(1.0f, 1.0f, 1.0f)); // White for vertices
     }
-
-    // Test ray against edges - only if edges are enabled
     if (config.showEdges)
     {
-        for (size_t i = 0; i < edges.size(); ++i)
-        {
-            const Line &edge = edges[i];
-            EdgeHit edgeHit = RayIntersection::intersectEdgeScreenSpace(ray, edge.start, edge.end, config.edgeDisplayThickness, static_cast<int>(i),
-                                                                        cameraPos, cameraTarget, cameraUp, fov, aspectRatio);
+        overlays.addEdges(edges, config.edgeDisplayThickness, Vector3(0.7f, 0.7f, 0.7f)); // Light gray for edges
+    }
+    if (config.showCoordinateAxes)
+    {
+        overlays.addLines(lines, config.lineThickness);
+    }
+}
 
-            if (edgeHit.hit && edgeHit.distance < closestDistance && edgeHit.distance > config.rayEpsilon)
-            {
-                closestDistance = edgeHit.distance;
-                hitColor = Vector3(0.7f, 0.7f, 0.7f); // Light gray for edges
-                hitFound = true;
-            }
-        }
+Vector3 SoftwareRenderer::castRay(const Ray &ray, int depth, PrimaryHit *primaryHit) const
+{
+    ReflectionPath path;
+    path.ray = ray;
+    path.depth = depth;
+    tracePath(path, primaryHit);
+    return path.color;
+}
+
+Vector3 SoftwareRenderer::shadeTriangleHit(const Ray &ray, const TriangleHit &hit, int instance, int depth) const
+{
+    // Primary hit found by the packet or raster path; the reflections continue like castRay
+    ReflectionPath path;
+    path.ray = ray;
+    path.depth = depth;
+    shadePathHit(path, hit, instance);
+    tracePath(path, nullptr);
+    return path.color;
+}
+
+void SoftwareRenderer::tracePath(ReflectionPath &path, PrimaryHit *primaryHit) const
+{
+    // One loop iteration per bounce: no recursion, so the depth limit costs no stack
+    while (path.active && beginPathSegment(path))
+    {
+        // Overlays (vertices, edges, axes) first - they bound the triangle search
+        Vector3 overlayColor;
+        float overlayDistance = intersectOverlays(path.ray, path.depth, overlayColor);
+
+        // Find the closest triangle beyond the overlay hits through the BVH - only if faces are enabled
+        BVHHit triangleHit;
+        bool hitTriangle = config.showFaces && bvh.intersect(path.ray, config.rayEpsilon, overlayDistance, triangleHit);
+        resolvePathSegment(path, overlayDistance, overlayColor, hitTriangle ? &triangleHit : nullptr, primaryHit);
+        primaryHit = nullptr; // Only the first segment is the primary hit
     }
+}
 
-    // Test ray against coordinate axes (should be visible over triangles when very close) - only if axes are enabled
-    // IMPORTANT: Coordinate axes are only tested for primary rays (depth == 0), not for reflection rays
-    // This prevents axes from appearing in reflections on surfaces
-    if (config.showCoordinateAxes && depth == 0)
+bool SoftwareRenderer::beginPathSegment(ReflectionPath &path) const
+{
+    // Check maximum reflection depth (lowered by the ray budget under load)
+    if (path.depth >= frameReflectionDepth)
     {
-        for (size_t i = 0; i < lines.size(); ++i)
-        {
-            const Line &line = lines[i];
-            LineHit lineHit = RayIntersection::intersectLineScreenSpace(ray, line, config.lineThickness, static_cast<int>(i),
-                                                                        cameraPos, cameraTarget, cameraUp, fov, aspectRatio);
+        if (path.depth > 0)
+            threadReflectionRays.truncated++;
+        path.color += calculateSkyboxColor(path.ray) * path.weight;
+        path.active = false;
+        return false;
+    }
+    if (path.depth > 0)
+    {
+        threadReflectionRays.traced++;
+        PROFILE_COUNT(ReflectionRays, 1);
+    }
+    return true;
+}
 
-            if (lineHit.hit && lineHit.distance < closestDistance && lineHit.distance > config.rayEpsilon)
-            {
-                closestDistance = lineHit.distance;
-                hitColor = line.color;
-                hitFound = true;
-            }
-        }
+void SoftwareRenderer::resolvePathSegment(ReflectionPath &path, float overlayDistance, const Vector3 &overlayColor,
+                                          const BVHHit *triangleHit, PrimaryHit *primaryHit) const
+{
+    if (primaryHit)
+    {
+        primaryHit->distance = overlayDistance;
     }
 
-    // Test ray against all triangles - only if faces are enabled
-    bool triangleHitFound = false;
-    if (config.showFaces)
+    if (triangleHit)
     {
-        for (const Triangle &triangle : triangles)
+        if (primaryHit)
         {
-            TriangleHit hit = RayIntersection::intersectTriangle(ray, triangle.v0, triangle.v1, triangle.v2);
-
-            if (hit.hit && hit.distance < closestDistance && hit.distance > config.rayEpsilon)
-            {
-                closestTriangleHit = hit;
-                closestDistance = hit.distance;
-                hitFound = true;
-                triangleHitFound = true;
-
-                // Calculate color based on reflection settings
-                Vector3 baseColor = hit.isFrontFace ?
-                    reflectionConfig.frontFaceColor :
-                    reflectionConfig.backFaceColor;
+            primaryHit->distance = triangleHit->hit.distance;
+            primaryHit->triangleId = triangleHit->triangleIndex;
+        }
+        shadePathHit(path, triangleHit->hit, triangleHit->instanceIndex);
+        return;
+    }
 
-                // Start with base color
-                Vector3 finalColor = baseColor;
+    // Overlay hit, or no hit - sky color
+    const bool hitOverlay = overlayDistance < std::numeric_limits<float>::max();
+    path.color += (hitOverlay ? overlayColor : calculateSkyboxColor(path.ray)) * path.weight;
+    path.active = false;
+}
 
-                // Apply Lambert diffuse reflection if enabled
-                if (reflectionConfig.enableLambertDiffuse)
-                {
-                    // Lambert's cosine law: intensity is proportional to cos(angle)
-                    float NdotL = std::max(0.0f, Vector3::dot(hit.normal, -reflectionConfig.lightDirection));
+float SoftwareRenderer::intersectOverlays(const Ray &ray, int depth, Vector3 &hitColor) const
+{
+    // IMPORTANT: Coordinate axes are only tested for primary rays (depth == 0), not for reflection rays
+    // This prevents axes from appearing in reflections on surfaces
+    return overlays.intersect(ray, config.rayEpsilon, depth == 0, hitColor);
+}
 
-                    // Ambient + Diffuse
-                    Vector3 ambient = baseColor * reflectionConfig.ambientStrength;
-                    Vector3 diffuse = baseColor * NdotL * reflectionConfig.diffuseStrength;
+void SoftwareRenderer::shadePathHit(ReflectionPath &path, const TriangleHit &hit, int instance) const
+{
+    // Calculate color based on reflection settings
+    Vector3 baseColor = hit.isFrontFace ?
+        reflectionConfig.frontFaceColor :
+        reflectionConfig.backFaceColor;
+    float reflectionAlpha = hit.isFrontFace ?
+        reflectionConfig.frontFaceReflectionAlpha :
+        reflectionConfig.backFaceReflectionAlpha;
+
+    // The instance's material refines the front faces
+    if (hit.isFrontFace && instance >= 0 && instance < static_cast<int>(instanceMaterials.size()))
+    {
+        const Material &material = instanceMaterials[instance];
+        baseColor = Vector3(baseColor.x * material.tint.x, baseColor.y * material.tint.y, baseColor.z * material.tint.z);
+        if (material.reflectivity >= 0.0f)
+            reflectionAlpha = material.reflectivity;
+    }
 
-                    finalColor = ambient + diffuse;
-                }
+    // Start with base color
+    Vector3 surfaceColor = baseColor;
 
-                // Apply specular reflection if enabled (combined with Lambert)
-                if (reflectionConfig.enableReflection)
-                {
-                    // Calculate reflection vector
-                    Vector3 reflectedDir = Vector3::reflect(ray.direction, hit.normal);
+    // Apply Lambert diffuse reflection if enabled
+    if (reflectionConfig.enableLambertDiffuse)
+    {
+        // Lambert's cosine law: intensity is proportional to cos(angle)
+        float NdotL = std::max(0.0f, Vector3::dot(hit.normal, -reflectionConfig.lightDirection));
 
-                    // Create reflected ray with slight offset to avoid self-intersection
-                    Vector3 offsetPoint = hit.point + hit.normal * reflectionConfig.reflectionEpsilon;
-                    Ray reflectedRay(offsetPoint, reflectedDir);
+        // Ambient + Diffuse
+        Vector3 ambient = baseColor * reflectionConfig.ambientStrength;
+        Vector3 diffuse = baseColor * NdotL * reflectionConfig.diffuseStrength;
 
-                    // Recursively trace reflected ray
-                    Vector3 reflectedColor = castRay(reflectedRay, depth + 1);
+        surfaceColor = ambient + diffuse;
+    }
 
-                    // Determine surface reflection strength based on face orientation
-                    float reflectionAlpha = hit.isFrontFace ?
-                        reflectionConfig.frontFaceReflectionAlpha :
-                        reflectionConfig.backFaceReflectionAlpha;
+    if (!reflectionConfig.enableReflection)
+    {
+        path.color += surfaceColor * path.weight;
+        path.active = false;
+        return;
+    }
 
-                    // Blend Lambert-shaded color with specular reflection
-                    finalColor = finalColor * (1.0f - reflectionAlpha) + reflectedColor * reflectionAlpha;
-                }
+    // Specular reflection (combined with Lambert): the surface keeps (1 - alpha) of its share,
+    // the reflected ray carries the rest
+    path.color += surfaceColor * (path.weight * (1.0f - reflectionAlpha));
 
-                hitColor = finalColor;
-            }
-        }
-    }
+    // Create reflected ray with slight offset to avoid self-intersection
+    Vector3 reflectedDir = Vector3::reflect(path.ray.direction, hit.normal);
+    Vector3 offsetPoint = hit.point + hit.normal * reflectionConfig.reflectionEpsilon;
+    path.ray = Ray(offsetPoint, reflectedDir);
+    path.weight *= reflectionAlpha;
+    path.depth++;
 
-    if (hitFound)
+    // A reflection whose share of the pixel is negligible ends like a ray at the depth limit,
+    // with the sky seen along it
+    if (path.weight < reflectionConfig.minReflectionWeight)
     {
-        return hitColor;
+        path.color += calculateSkyboxColor(path.ray) * path.weight;
+        path.active = false;
     }
-
-    // No hit - return sky color
-    return calculateSkyboxColor(ray);
 }
 
 Vector3 SoftwareRenderer::calculateSkyboxColor(const Ray &ray) const
 {
     // lightDirection is the direction light travels (FROM sun TO object)
     // So the sun is in the OPPOSITE direction: -lightDirection
-    // When checking if ray points at sun, we check if ray.direction aligns with -lightDirection
-
-    // Step 1: Check if ray is pointing at the sun
-    if (reflectionConfig.enableSun) {
-        // Ray pointing at sun means ray.direction is opposite to lightDirection
-        float sunAlignment = Vector3::dot(ray.direction, -reflectionConfig.lightDirection);
-
-        // Angular distance from sun center
-        // sunAlignment close to 1.0 means ray is pointing directly at sun
-        float angularDistance = std::acos(Utils::clamp(sunAlignment, -1.0f, 1.0f));
-
-        // Check if within sun disc
-        if (angularDistance < reflectionConfig.sunAngularSize) {
-            // Inside sun disc - return sun color with smooth falloff
-            float sunIntensity = 1.0f - (angularDistance / reflectionConfig.sunAngularSize);
-            sunIntensity = sunIntensity * sunIntensity; // Square for smoother falloff
-
-            // Blend between sun color and sky color at edge
-            Vector3 edgeSkyColor = reflectionConfig.skyHorizonColor;
-            return Vector3::lerp(edgeSkyColor, reflectionConfig.sunColor, sunIntensity);
-        }
+    // sunAlignment close to 1.0 means ray is pointing directly at sun
+    float sunAlignment = Vector3::dot(ray.direction, -reflectionConfig.lightDirection);
+
+    // Step 1: Check if ray is pointing at the sun (angle < sunAngularSize, tested as a cosine threshold)
+    float sunIntensity;
+    if (reflectionConfig.enableSun && skyTable.getSunIntensity(sunAlignment, sunIntensity)) {
+        // Inside sun disc - blend between sky color at the edge and sun color at the center
+        Vector3 edgeSkyColor = reflectionConfig.skyHorizonColor;
+        return Vector3::lerp(edgeSkyColor, reflectionConfig.sunColor, sunIntensity);
     }
 
     // Step 2: Calculate sky gradient (blue sky)
     // The sky should be brighter near the sun and darker away from it
+    float sunProximity = (sunAlignment + 1.0f) * 0.5f; // Map from [-1,1] to [0,1]
 
-    // Calculate how aligned the ray is with the sun direction
-    float sunProximity = Vector3::dot(ray.direction, -reflectionConfig.lightDirection);
-    sunProximity = (sunProximity + 1.0f) * 0.5f; // Map from [-1,1] to [0,1]
-
-    // Use vertical component for additional gradient (sky gets darker towards horizon)
-    float verticalComponent = ray.direction.z; // Z is up in our coordinate system
-    float verticalFactor = (verticalComponent + 1.0f) * 0.5f; // Map from [-1,1] to [0,1]
-    verticalFactor = std::pow(verticalFactor, 0.7f); // Smooth curve
+    // Vertical gradient (sky gets darker towards horizon): pow((z + 1) / 2, 0.7) from the table
+    float verticalFactor = skyTable.getVerticalFactor(ray.direction.z); // Z is up in our coordinate system
 
     // Combine both factors: sky is brighter near sun AND higher in the sky
     float t = sunProximity * 0.7f + verticalFactor * 0.3f; // Weighted combination
@@ -393,16 +1567,23 @@ void SoftwareRenderer::saveAsText(const std::string &filename) const
     }
 
     file << "Software Renderer Output (" << width << "x" << height << ")\n";
-    file << "Triangles: " << triangles.size() << "\n";
+    file << "Triangles: " << getTriangleCount() << "\n";
     file << "Camera: pos=" << cameraPos << " target=" << cameraTarget << "\n\n";
 
+    if (!framebuffer.planes.color)
+    {
+        file << "(color plane disabled)\n";
+        file.close();
+        return;
+    }
+
     // Sample a few pixels for verification
     const int sampleStep = std::max(1, width / 20);
     for (int y = 0; y < height; y += sampleStep)
     {
         for (int x = 0; x < width; x += sampleStep)
         {
-            Vector3 color = pixels[y * width + x];
+            Vector3 color = framebuffer.color[y * width + x];
             file << "(" << std::setw(3) << x << "," << std::setw(3) << y << "): "
                  << std::fixed << std::setprecision(2)
                  << "R=" << color.x << " G=" << color.y << " B=" << color.z << "\n";
@@ -1,22 +1,24 @@
 #pragma once
 
 #include "IRenderer.h"
+#include "ScreenSpaceOverlays.h"
+#include "CameraFrame.h"
+#include "Rasterizer.h"
+#include "Framebuffer.h"
+#include "SkyTable.h"
+#include "ReprojectionCache.h"
 #include "../math/Vector3.h"
 #include "../core/Ray.h"
 #include "../core/Model.h"
 #include "../core/Camera.h"
+#include "../core/InstanceBVH.h"
+#include "../core/Scene.h"
+#include "../utils/ThreadPool.h"
 #include <vector>
 #include <memory>
-
-struct Triangle
-{
-    Vector3 v0, v1, v2;
-    Vector3 color;
-
-    Triangle() = default;
-    Triangle(const Vector3 &v0, const Vector3 &v1, const Vector3 &v2, const Vector3 &color = Vector3(0.5f, 0.5f, 0.5f))
-        : v0(v0), v1(v1), v2(v2), color(color) {}
-};
+#include <chrono>
+#include <cstdint>
+#include <limits>
 
 struct RenderConfig
 {
@@ -38,6 +40,44 @@ struct RenderConfig
     bool showFaces = true;          // Show/hide faces
     bool showCoordinateAxes = true; // Show/hide coordinate axes
 
+    // Multithreaded rendering
+    int renderThreadCount = 0; // Threads used for rendering (0 = all hardware threads)
+    int tileSize = 32;         // Tile edge length in pixels (unit of work for threads)
+
+    // Packet tracing: primary rays traced RAY_PACKET_WIDTH at a time with SIMD kernels (same image as scalar)
+    bool usePacketTracing = true;
+
+    // Wavefront mode (with packet tracing): each tile traces all rays of one reflection depth before the
+    // next, sorted by direction and in packets; same image as the per-pixel path
+    bool useWavefrontReflections = false;
+
+    // Hybrid mode: primary visibility from the rasterizer G-buffer, only reflections are ray traced
+    bool useRasterPrimary = false;
+
+    // Culling before the rasterized primary pass: BVH nodes outside the view frustum are skipped, and
+    // optionally triangles facing away (hides back faces, so only for closed meshes). Reflection rays
+    // always see the whole scene through the BVH
+    bool frustumCulling = true;
+    bool cullBackFaces = false;
+
+    // Progressive rendering: while the camera moves only every Nth pixel (N = 2, 4, ...) is traced so the
+    // frame fits the budget; once it stops, each frame halves N until the image is complete
+    bool progressiveRendering = false;
+    float progressiveBudgetMs = 33.0f; // Target frame time while the camera moves
+    int progressiveMaxBlockSize = 16;  // Coarsest sample spacing in pixels
+
+    // Frame reuse: render() returns at once while nothing that affects the image changed since the
+    // last complete frame. With reprojection, a small camera move reuses that frame's pixels at their
+    // new positions and traces only the pixels nothing landed on
+    bool skipUnchangedFrames = false;
+    bool temporalReprojection = false;
+    float reprojectionMinCoverage = 0.75f; // Share of the cached surface pixels that must stay on screen
+
+    // Level of detail: with a simplified mesh given (setLodMesh), frames rendered while the camera
+    // moves, and until it has been still for lodSettleMs, trace that mesh instead of the scene
+    bool useLod = true;
+    float lodSettleMs = 200.0f;
+
     // Default constructor
     RenderConfig() = default;
 };
@@ -48,6 +88,8 @@ struct ReflectionConfig
     // Reflection control
     bool enableReflection = true;     // Enable/disable specular reflection system
     int maxReflectionDepth = 2;       // Maximum recursion depth for reflections
+    float minReflectionWeight = 0.01f; // Reflections contributing less than this to the pixel end at the sky
+    int reflectionRayBudget = 0;      // Reflection rays per frame before the depth is lowered (0 = unlimited)
     float reflectionEpsilon = 0.001f; // Offset distance to avoid self-intersection
 
     // Lambert diffuse reflection control
@@ -75,23 +117,146 @@ struct ReflectionConfig
     ReflectionConfig() = default;
 };
 
+// Timing and ray counts of the last render() call
+struct RenderStats
+{
+    double accelerationMs = 0.0; // BVH build or refit
+    double setupMs = 0.0;        // Camera frame, overlay projection, rasterizer setup
+    double traceMs = 0.0;        // Tile pass: primary visibility, shading and reflections
+    double totalMs = 0.0;
+    uint64_t primarySamples = 0; // Pixels traced (or rasterized) this frame
+    uint64_t secondaryRays = 0;  // Reflection rays traced
+    int reflectionDepth = 0;     // Depth limit used (below maxReflectionDepth when over the ray budget)
+    uint64_t reprojectedPixels = 0; // Pixels reused from the previous complete frame
+    int primaryTriangles = 0;    // Triangles projected by the rasterized primary pass after culling
+    bool rebuiltAcceleration = false; // Mesh BVHs rebuilt
+    bool rebuiltInstances = false;    // Only the instance level rebuilt (moved instances, refitted meshes)
+    bool skippedFrame = false;   // Nothing changed, the framebuffer was left as it was
+    bool usedLod = false;        // The simplified mesh was traced instead of the scene
+};
+
 class SoftwareRenderer : public IRenderer
 {
 private:
     int width = 640;
     int height = 480;
-    std::vector<Vector3> pixels;
-    std::vector<Triangle> triangles;
+    Framebuffer framebuffer; // Output planes, written per pixel by the tile workers
     std::vector<Line> lines;       // Coordinate axes and other lines
     std::vector<Vector3> vertices; // Vertices to render as points
     std::vector<Line> edges;       // Model edges to render as lines
 
+    // Scene geometry: meshes in object space, placed by instances. Scene triangle ids number the
+    // instances' triangles in order. addTriangle() fills a single mesh with one untransformed
+    // instance; setScene() loads a Scene of shared meshes instead.
+    std::vector<std::vector<Triangle>> meshTriangles = std::vector<std::vector<Triangle>>(1);
+    std::vector<InstanceBVH::Instance> instances = std::vector<InstanceBVH::Instance>(1);
+    std::vector<Material> instanceMaterials = std::vector<Material>(1);
+    bool sceneLoaded = false; // Geometry came from setScene()
+
+    // Two-level acceleration structure (rebuilt lazily): mesh BVHs when their triangles change,
+    // only the instance level when instances move
+    InstanceBVH bvh;
+    bool bvhDirty = true;
+    bool instancesDirty = false;
+    std::vector<std::pair<int, int>> pendingTriangleUpdates; // (mesh, triangle) patched since the last frame (refit, not rebuilt)
+    std::vector<int> refitTriangles;                         // Scratch: one mesh's share of the pending updates
+    static constexpr float BVH_REBUILD_GROWTH = 2.0f; // Rebuild once refits doubled the summed node area
+
+    // The geometry not on show: the level-of-detail mesh, or the full scene while the LOD is traced.
+    // Switching swaps it with the members above, BVH and raster copy included, so neither side is
+    // ever rebuilt for a switch. Scene edits switch back to full detail first.
+    struct StashedGeometry
+    {
+        std::vector<std::vector<Triangle>> meshTriangles;
+        std::vector<InstanceBVH::Instance> instances;
+        std::vector<Material> instanceMaterials;
+        InstanceBVH bvh;
+        bool bvhDirty = true;
+        bool instancesDirty = false;
+        std::vector<std::pair<int, int>> pendingTriangleUpdates;
+        Rasterizer rasterizer;
+        bool rasterTrianglesDirty = true;
+    };
+    StashedGeometry stashedGeometry;
+    bool hasLodMesh = false;
+    bool showingLod = false;
+    uint64_t lodCameraVersion = 0; // Camera version last seen by selectDetailLevel()
+    std::chrono::steady_clock::time_point lastCameraMove;
+
+    // Rasterized primary visibility (hybrid mode)
+    Rasterizer rasterizer;
+    bool rasterTrianglesDirty = true; // World-space triangle copy refreshed when the raster pass next runs
+    GBuffer gBuffer;
+    std::vector<int> primaryCandidates; // Triangles in the view frustum this frame
+
+    // Vertices, edges and axes projected to screen space for the current frame
+    ScreenSpaceOverlays overlays;
+
+    // Miss shading terms, refreshed at the start of render() when the sun size changes
+    SkyTable skyTable;
+
+    // Persistent worker pool for tile rendering (recreated when the thread count changes)
+    std::unique_ptr<ThreadPool> threadPool;
+
     // Camera parameters
     Vector3 cameraPos = Vector3(0, 0, 5);
     Vector3 cameraTarget = Vector3(0, 0, 0);
     Vector3 cameraUp = Vector3(0, 0, 1);
     float fov = 45.0f * 3.14159f / 180.0f; // 45 degrees in radians
     float aspectRatio = 4.0f / 3.0f;
+    CameraFrame cameraFrame; // Derived from the camera parameters at the start of every render()
+
+    // Primary hit recorded for the depth/ID plane
+    struct PrimaryHit
+    {
+        float distance = std::numeric_limits<float>::max();
+        int triangleId = -1;
+    };
+
+    // Color gathered front to back along a chain of reflections: each surface adds its shading
+    // weighted by the reflectivity of the surfaces before it, then the ray moves on
+    struct ReflectionPath
+    {
+        Ray ray;
+        Vector3 color = Vector3(0, 0, 0);
+        float weight = 1.0f; // Share of the pixel the current ray still carries
+        int depth = 0;
+        bool active = true;
+    };
+
+    // Progressive refinement state, carried across frames
+    struct ProgressiveState
+    {
+        bool hasPreviousFrame = false;
+        Vector3 cameraPos;
+        Vector3 cameraTarget;
+        Vector3 cameraUp;
+        float fov = 0.0f;
+        int width = 0;
+        int height = 0;
+        int blockSize = 1;        // Sample spacing of the image in the framebuffer (1 = complete)
+        float sampleCostMs = 0.0f; // Moving average of frame time per traced sample
+    };
+    ProgressiveState progressive;
+
+    RenderStats lastFrameStats;
+
+    // Reflection depth limit of the current frame, adapted between frames under a ray budget
+    int frameReflectionDepth = 0;
+
+    // Change tracking for frame reuse: every scene edit bumps sceneVersion, every camera move cameraVersion
+    uint64_t sceneVersion = 0;
+    uint64_t cameraVersion = 0;
+    RenderConfig renderedConfig; // Settings snapshots of the last frame (settings are written by reference)
+    ReflectionConfig renderedReflectionConfig;
+    bool hasCompleteFrame = false; // The framebuffer holds a fully traced frame of completeFrameKey
+    ReprojectionCache::Key completeFrameKey;
+
+    // Temporal reprojection source, recorded by storePixel()/storeHit() while recordingFrame is set
+    ReprojectionCache reprojection;
+    bool recordingFrame = false;
+    uint64_t reprojectedCameraVersion = std::numeric_limits<uint64_t>::max(); // View of the last reprojected frame
+    bool capturePrimaryHits = false; // castRay() reports primary hits (depth plane or recording)
 
     // Render configuration
     RenderConfig config;
@@ -108,11 +273,49 @@ public:
     void render() override;
     void render(const Model &model, const Camera &camera) override;
     const std::vector<Vector3> &getPixelData() const override;
+    const Framebuffer &getFramebuffer() const override { return framebuffer; }
+    const std::vector<uint32_t> &getDisplayPixels() const { return framebuffer.display; }
+
+    // Output planes (the default keeps float color and RGBA8; drop color when only displaying)
+    void setFramebufferPlanes(const FramebufferPlanes &planes);
+    const FramebufferPlanes &getFramebufferPlanes() const { return framebuffer.planes; }
     void clear(const Vector3 &clearColor) override;
 
-    // Scene management
+    // Scene management: a flat triangle list, or a scene of instanced meshes replacing it
+    // (clearTriangles() goes back to an empty list). Bulk loads should reserve and add in one call:
+    // addTriangle() is meant for a handful of triangles
     void addTriangle(const Triangle &triangle);
+    void addTriangles(const std::vector<Triangle> &triangleList);
+    void reserveTriangles(int count);
     void clearTriangles();
+    void setScene(const Scene &scene);
+    void buildAccelerationStructure();
+
+    // Level of detail (see RenderConfig::useLod): a simplified copy of the scene, drawn as one mesh
+    // with the default material. setScene() and clearTriangles() drop it; while it is on show,
+    // triangle counts and BVH queries see it instead of the scene
+    void setLodMesh(const Model &lod);
+    void clearLod();
+    bool hasLod() const { return hasLodMesh; }
+    bool isShowingLod() const { return showingLod; }
+
+    // Instance updates: only the instance level of the BVH is rebuilt at the next render()
+    void setInstanceTransform(int instance, const Matrix4 &transform);
+    void setInstanceMaterial(int instance, const Material &material);
+    int getInstanceCount() const { return static_cast<int>(instances.size()); }
+
+    // Incremental scene updates (e.g. while a vertex is dragged): entries are patched in place by
+    // index and the acceleration structure is refitted at the next render() instead of rebuilt.
+    // A triangle is given in its mesh's object space and changes in every instance of the mesh.
+    void updateTriangle(int index, const Triangle &triangle);
+    void updateVertex(int index, const Vector3 &vertex);
+    void updateEdge(int index, const Line &edge);
+    int getTriangleCount() const; // Scene triangles over all instances
+    const InstanceBVH &getBVH() const { return bvh; }
+    const GBuffer &getGBuffer() const { return gBuffer; } // Valid after a frame in hybrid mode
+
+    // Occlusion query against scene triangles (any-hit, for shadow/visibility tests)
+    bool isOccluded(const Ray &ray, float maxDistance) const;
 
     // Line management for coordinate axes
     void addLine(const Line &line);
@@ -123,13 +326,16 @@ public:
     void addVertex(const Vector3 &vertex);
     void clearVertices();
     void setVertices(const std::vector<Vector3> &vertexList);
+    void setVertices(std::vector<Vector3> &&vertexList); // Takes the buffer over (no copy)
     void addEdge(const Line &edge);
     void clearEdges();
     void setEdges(const std::vector<Line> &edgeList);
+    void setEdges(std::vector<Line> &&edgeList);
 
     // Camera control
     void setCamera(const Vector3 &pos, const Vector3 &target, const Vector3 &up);
     void setCameraFOV(float fovDegrees);
+    const CameraFrame &getCameraFrame() const { return cameraFrame; }
 
     // Configuration access
     RenderConfig &getRenderConfig() { return config; }
@@ -143,6 +349,39 @@ public:
     void setEdgeDisplayThickness(float thickness) { config.edgeDisplayThickness = thickness; }
     void setLineThickness(float thickness) { config.lineThickness = thickness; }
 
+    // Threading settings
+    void setRenderThreadCount(int threadCount) { config.renderThreadCount = threadCount; }
+    int getRenderThreadCount() const { return threadPool ? threadPool->getThreadCount() : config.renderThreadCount; }
+
+    // Packet tracing settings
+    void setPacketTracing(bool enabled) { config.usePacketTracing = enabled; }
+    bool getPacketTracing() const { return config.usePacketTracing; }
+
+    // Wavefront reflection tracing
+    void setWavefrontReflections(bool enabled) { config.useWavefrontReflections = enabled; }
+    bool getWavefrontReflections() const { return config.useWavefrontReflections; }
+
+    // Progressive rendering
+    void setProgressiveRendering(bool enabled) { config.progressiveRendering = enabled; }
+    bool getProgressiveRendering() const { return config.progressiveRendering; }
+    int getProgressiveBlockSize() const { return progressive.blockSize; } // Spacing of the last frame (1 = complete)
+    bool isRefining() const { return progressive.blockSize > 1; }
+    void restartRefinement(); // Drop kept samples, e.g. after the scene changed under a still camera
+
+    // Frame reuse (see RenderConfig::skipUnchangedFrames)
+    void setSkipUnchangedFrames(bool enabled) { config.skipUnchangedFrames = enabled; }
+    bool getSkipUnchangedFrames() const { return config.skipUnchangedFrames; }
+    void setTemporalReprojection(bool enabled) { config.temporalReprojection = enabled; }
+    bool getTemporalReprojection() const { return config.temporalReprojection; }
+
+    // Hybrid raster/ray tracing settings
+    void setRasterPrimary(bool enabled) { config.useRasterPrimary = enabled; }
+    bool getRasterPrimary() const { return config.useRasterPrimary; }
+    void setFrustumCulling(bool enabled) { config.frustumCulling = enabled; }
+    bool getFrustumCulling() const { return config.frustumCulling; }
+    void setBackFaceCulling(bool enabled) { config.cullBackFaces = enabled; }
+    bool getBackFaceCulling() const { return config.cullBackFaces; }
+
     // Selection settings
     void setVertexSelectionThreshold(float threshold) { config.vertexSelectionThreshold = threshold; }
     void setEdgeSelectionThreshold(float threshold) { config.edgeSelectionThreshold = threshold; }
@@ -163,12 +402,54 @@ public:
     bool getShowFaces() const { return config.showFaces; }
     bool getShowCoordinateAxes() const { return config.showCoordinateAxes; }
 
+    // Timing of the last frame, for benchmarks and stats overlays
+    const RenderStats &getLastFrameStats() const { return lastFrameStats; }
+
     // Debug
     void saveAsText(const std::string &filename) const;
 
 private:
     // Internal rendering methods
-    Ray generateCameraRay(int x, int y) const;
-    Vector3 castRay(const Ray &ray, int depth = 0) const;
+    void ensureThreadPool();
+    void selectDetailLevel();
+    void showFullDetail();
+    void swapGeometry();
+    void refitAccelerationStructure();
+    void updateInstanceLevel();
+    void updateRasterTriangles();
+    int locateTriangle(int sceneTriangle, int &meshTriangle) const; // Instance of a scene triangle id, -1 if none
+    Triangle toWorldSpace(int instance, const Triangle &triangle) const;
+    void updateCameraFrame();
+    Frustum getViewFrustum() const; // Camera rays of the current frame's pixels
+    void updateOverlays();
+    void renderTile(int x0, int y0, int x1, int y1);
+    void renderPacket(int x0, int x1, int y);
+    void renderWavefrontTile(int x0, int y0, int x1, int y1);
+    void traceWave(const std::vector<uint64_t> &wave, ReflectionPath *paths, PrimaryHit *primaryHits) const;
+    void renderRasterTile(int x0, int y0, int x1, int y1);
+    void renderSparseTile(int x0, int y0, int x1, int y1, int blockSize, int refineFrom);
+    void selectProgressiveLevel(int &blockSize, int &refineFrom) const;
+    void detectSettingsChange();
+    ReprojectionCache::Key getFrameKey() const { return {sceneVersion, cameraVersion, frameReflectionDepth}; }
+    void beginFrameRecording();
+    void finishFrameRecording(int blockSize);
+    bool reprojectFrame(RenderStats &stats, int tilesX, int tilesY, int tileSize);
+    int renderReprojectedTile(int x0, int y0, int x1, int y1); // Returns the pixels traced
+    double countTracedSamples(int blockSize, int refineFrom) const;
+    void selectReflectionDepth();
+    void updateReflectionBudget(uint64_t tracedRays, uint64_t truncatedRays);
+    void finishProgressiveFrame(int blockSize, int refineFrom, std::chrono::high_resolution_clock::time_point frameStart);
+    void rememberProgressiveView(int blockSize);
+    void storePixel(int x, int y, Vector3 color);
+    void storeHit(int x, int y, const PrimaryHit &hit);
+    void fillBlock(int x, int y, int x1, int y1);
+    Vector3 castRay(const Ray &ray, int depth = 0, PrimaryHit *primaryHit = nullptr) const;
+    void tracePath(ReflectionPath &path, PrimaryHit *primaryHit) const;
+    bool beginPathSegment(ReflectionPath &path) const; // False (and path finished) at the depth limit
+    void resolvePathSegment(ReflectionPath &path, float overlayDistance, const Vector3 &overlayColor,
+                            const BVHHit *triangleHit, PrimaryHit *primaryHit) const;
+    void shadePathHit(ReflectionPath &path, const TriangleHit &hit, int instance) const;
+    float intersectOverlays(const Ray &ray, int depth, Vector3 &hitColor) const; // Closest overlay distance (FLT_MAX if none)
+    Vector3 shadeTriangleHit(const Ray &ray, const TriangleHit &hit, int instance, int depth) const;
     Vector3 calculateSkyboxColor(const Ray &ray) const;
 };
\ No newline at end of file
@@ -1,12 +1,25 @@
 #include <iostream>
 #include "../core/Model.h"
+#include "../core/ModelSaver.h"
 #include "../core/Camera.h"
+#include "../core/MeshSimplifier.h"
+#include "../core/ModelLod.h"
 #include "../rendering/SoftwareRenderer.h"
+#include "../math/SimdFloat.h"
 #include "../utils/Utils.h"
 #include <GLFW/glfw3.h>
 #include <GL/gl.h>
 #include <vector>
 #include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <cmath>
+#include <set>
+#include <random>
+#include <algorithm>
 
 class ModelTestApp {
 private:
@@ -243,7 +256,735 @@ public:
     }
 };
 
-int main() {
+// Headless model checks, run with --checks instead of opening the viewer
+void testModelFileLoading() {
+    Utils::logInfo("Testing .fjwr parsing and the .fjwb binary format...");
+
+    const std::string textPath = "model_test_model.fjwr";
+    const std::string binaryPath = Model::getBinaryCachePath(textPath);
+    {
+        std::ofstream file(textPath, std::ios::binary);
+        file << "# test model\r\n"
+             << "v 0 0 0\r\n"
+             << "  v +1.5 0 -2e-1\n"
+             << "\n"
+             << "v 0 1 0.25\n"
+             << "v 1 1 0\n"
+             << "f 0 1 2\n"
+             << "f 1 3 2\n"
+             << "f 0 1 9\n" // Invalid indices are reported and skipped
+             << "l 0 3";   // No trailing newline; replaced by the face edges after loading
+    }
+
+    Model text;
+    bool loaded = text.loadFromFile(textPath);
+    bool parsed = loaded && text.getVertexCount() == 4 && text.getFaceCount() == 2 &&
+                  text.getVertices()[1].position.x == 1.5f && text.getVertices()[1].position.z == -0.2f &&
+                  text.getVertices()[2].position.z == 0.25f && text.getFaces()[1].v2 == 3 &&
+                  !text.getIsModified();
+    std::cout << "Text parser reads vertices and faces: " << (parsed ? "YES" : "NO") << std::endl;
+
+    Model broken;
+    { std::ofstream(textPath, std::ios::binary) << "v 0 0 0\nv 1 x 0\n"; }
+    std::cout << "Malformed vertex is rejected: " << (!broken.loadFromFile(textPath) ? "YES" : "NO") << std::endl;
+
+    // Round trip through the binary format
+    bool saved = text.saveToFile(binaryPath);
+    Model binary;
+    bool binaryLoaded = saved && binary.loadFromFile(binaryPath);
+    bool identical = binaryLoaded && binary.getVertexCount() == text.getVertexCount() &&
+                     binary.getFaceCount() == text.getFaceCount() && binary.getEdgeCount() == text.getEdgeCount();
+    for (int i = 0; identical && i < text.getVertexCount(); ++i) {
+        identical = (binary.getVertices()[i].position - text.getVertices()[i].position).length() == 0.0f &&
+                    (binary.getVertices()[i].normal - text.getVertices()[i].normal).length() == 0.0f;
+    }
+    for (int i = 0; identical && i < text.getEdgeCount(); ++i) {
+        identical = binary.getEdges()[i].v1 == text.getEdges()[i].v1 && binary.getEdges()[i].v2 == text.getEdges()[i].v2;
+    }
+    std::cout << "Binary file round trip is exact: " << (identical ? "YES" : "NO") << std::endl;
+
+    // A sidecar not written from the current text file is ignored
+    Model cached;
+    cached.setBinaryCacheEnabled(true);
+    bool usedText = cached.loadFromFile(textPath) == false; // Text is malformed now, the stale sidecar must not hide that
+    std::cout << "Stale binary cache is ignored: " << (usedText ? "YES" : "NO") << std::endl;
+
+    // Streaming text writer: shortest round-trip floats, so a save/load cycle is exact
+    const std::string savedPath = "model_test_saved.fjwr";
+    text.setVertexPosition(3, Vector3(1.0f / 3.0f, -123456.789f, 1e-7f));
+    bool textSaved = text.saveToFile(savedPath);
+    Model reloaded;
+    bool exact = textSaved && reloaded.loadFromFile(savedPath) && reloaded.getVertexCount() == text.getVertexCount() &&
+                 reloaded.getFaceCount() == text.getFaceCount();
+    for (int i = 0; exact && i < text.getVertexCount(); ++i) {
+        const Vector3 &a = reloaded.getVertices()[i].position;
+        const Vector3 &b = text.getVertices()[i].position;
+        exact = a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+    std::cout << "Text save round trip is exact: " << (exact ? "YES" : "NO") << std::endl;
+
+    // Background save writes the snapshot taken at start(); later edits keep the model modified
+    ModelSaver saver;
+    text.setVertexPosition(0, Vector3(0.5f, 0.5f, 0.5f));
+    bool started = saver.start(text, savedPath);
+    bool rejected = !saver.start(text, savedPath); // Only one save at a time
+    text.setVertexPosition(0, Vector3(2.0f, 2.0f, 2.0f));
+    saver.wait(text);
+    Model snapshot;
+    bool snapshotSaved = started && rejected && saver.lastSaveSucceeded() && snapshot.loadFromFile(savedPath) &&
+                         snapshot.getVertices()[0].position.x == 0.5f && text.getIsModified() &&
+                         text.getFilename() == savedPath;
+    std::cout << "Background save writes the snapshot: " << (snapshotSaved ? "YES" : "NO") << std::endl;
+
+    std::remove(textPath.c_str());
+    std::remove(binaryPath.c_str());
+    std::remove(savedPath.c_str());
+
+    Utils::logInfo("Model file loading tests completed");
+}
+
+void testMeshAdjacency() {
+    Utils::logInfo("Testing mesh adjacency...");
+
+    // Edge generation matches the ordered-set reference
+    Model cube;
+    cube.createCube(1.0f);
+    std::set<std::pair<int, int>> reference;
+    for (const auto &face : cube.getFaces()) {
+        int corners[3] = {face.v1, face.v2, face.v3};
+        for (int k = 0; k < 3; ++k) {
+            reference.insert({std::min(corners[k], corners[(k + 1) % 3]), std::max(corners[k], corners[(k + 1) % 3])});
+        }
+    }
+    bool edgesMatch = cube.getEdgeCount() == static_cast<int>(reference.size());
+    int edgeIndex = 0;
+    for (const auto &pair : reference) {
+        if (!edgesMatch) break;
+        const Edge &edge = cube.getEdges()[edgeIndex++];
+        edgesMatch = edge.v1 == pair.first && edge.v2 == pair.second;
+    }
+    std::cout << "Generated edges match ordered reference: " << (edgesMatch ? "YES" : "NO") << std::endl;
+
+    // Incremental updates on a grid agree with a full rebuild
+    Model grid;
+    const int gridSize = 24;
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            grid.addVertex(static_cast<float>(x), static_cast<float>(y), 0.0f);
+        }
+    }
+    auto addQuad = [&](int x, int y) {
+        int i = y * gridSize + x;
+        grid.addFace(i, i + 1, i + gridSize + 1);
+        grid.addFace(i, i + gridSize + 1, i + gridSize);
+    };
+    for (int y = 0; y + 1 < gridSize; y += 2) {
+        for (int x = 0; x + 1 < gridSize; ++x) addQuad(x, y);
+    }
+    for (int x = 0; x + 1 < gridSize; ++x) grid.addEdge(x, x + 1);
+    grid.getMeshAdjacency(); // Build, then keep it current from here on
+    for (int y = 1; y + 1 < gridSize; y += 2) {
+        for (int x = 0; x + 1 < gridSize; ++x) addQuad(x, y);
+    }
+    for (int y = 1; y < gridSize; ++y) grid.addEdge(y * gridSize, (y - 1) * gridSize);
+    std::mt19937 rng(7);
+    for (int i = 0; i < 200; ++i) {
+        grid.removeFace(static_cast<int>(rng() % grid.getFaceCount()));
+    }
+    for (int i = 0; i < 10; ++i) {
+        grid.removeEdge(static_cast<int>(rng() % grid.getEdgeCount()));
+    }
+    grid.addVertex(100.0f, 0.0f, 0.0f);
+    grid.addFace(0, 1, grid.getVertexCount() - 1);
+    grid.addEdge(0, grid.getVertexCount() - 1);
+
+    const MeshAdjacency &incremental = grid.getMeshAdjacency();
+    MeshAdjacency rebuilt;
+    rebuilt.build(grid.getFaces(), grid.getEdges(), grid.getVertexCount());
+
+    enum class Incidence { EdgeFaces, VertexFaces, VertexLines };
+    auto sortedFaces = [](const MeshAdjacency &adjacency, Incidence incidence, int index) {
+        std::vector<int> result;
+        auto collect = [&](int face) { result.push_back(face); };
+        if (incidence == Incidence::EdgeFaces) adjacency.forEachEdgeFace(index, collect);
+        else if (incidence == Incidence::VertexFaces) adjacency.forEachVertexFace(index, collect);
+        else adjacency.forEachVertexLine(index, collect);
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    bool consistent = incremental.getEdgeCount() == rebuilt.getEdgeCount() &&
+                      incremental.getFaceCount() == grid.getFaceCount() &&
+                      incremental.getLineCount() == grid.getEdgeCount();
+    for (int e = 0; consistent && e < rebuilt.getEdgeCount(); ++e) {
+        int v1, v2;
+        rebuilt.getEdgeVertices(e, v1, v2);
+        int match = incremental.findEdge(v2, v1);
+        consistent = match >= 0 && incremental.getEdgeFaceCount(match) == rebuilt.getEdgeFaceCount(e) &&
+                     sortedFaces(incremental, Incidence::EdgeFaces, match) == sortedFaces(rebuilt, Incidence::EdgeFaces, e);
+    }
+    for (int v = 0; consistent && v < grid.getVertexCount(); ++v) {
+        consistent = sortedFaces(incremental, Incidence::VertexFaces, v) == sortedFaces(rebuilt, Incidence::VertexFaces, v) &&
+                     sortedFaces(incremental, Incidence::VertexLines, v) == sortedFaces(rebuilt, Incidence::VertexLines, v);
+    }
+    int boundaryEdges = 0;
+    for (int e = 0; e < rebuilt.getEdgeCount(); ++e) {
+        if (rebuilt.isBoundaryEdge(e)) boundaryEdges++;
+    }
+    std::cout << "Edges: " << rebuilt.getEdgeCount() << " (" << boundaryEdges << " boundary)" << std::endl;
+    std::cout << "Incremental adjacency matches rebuild: " << (consistent ? "YES" : "NO") << std::endl;
+    std::cout << "Missing edge is not found: " << (incremental.findEdge(0, gridSize * gridSize - 1) < 0 ? "YES" : "NO") << std::endl;
+
+    // Removal only unlinks: indices stay until compact(), which renumbers like a rebuild.
+    // Every third face is unlinked up front; dropping vertex 0 also drops its faces and lines
+    MeshAdjacency tombstoned;
+    tombstoned.build(grid.getFaces(), grid.getEdges(), grid.getVertexCount());
+    const int faceCount = tombstoned.getFaceCount();
+    std::vector<int> vertexRemap(grid.getVertexCount());
+    for (int v = 0; v < grid.getVertexCount(); ++v) vertexRemap[v] = v - 1;
+    std::vector<int> faceRemap(faceCount, -1);
+    std::vector<Face> keptFaces;
+    for (int f = 0; f < faceCount; ++f) {
+        const Face &face = grid.getFaces()[f];
+        if (f % 3 == 0) {
+            tombstoned.removeFace(f);
+        } else if (face.v1 != 0 && face.v2 != 0 && face.v3 != 0) {
+            faceRemap[f] = static_cast<int>(keptFaces.size());
+            keptFaces.push_back(Face(face.v1 - 1, face.v2 - 1, face.v3 - 1));
+        }
+    }
+    bool stable = tombstoned.getFaceCount() == faceCount;
+    std::vector<int> lineRemap(grid.getEdgeCount(), -1);
+    std::vector<Edge> keptLines;
+    for (int l = 0; l < grid.getEdgeCount(); ++l) {
+        const Edge &line = grid.getEdges()[l];
+        if (line.v1 == 0 || line.v2 == 0) continue;
+        lineRemap[l] = static_cast<int>(keptLines.size());
+        keptLines.push_back(Edge(line.v1 - 1, line.v2 - 1));
+    }
+    tombstoned.compact(vertexRemap, faceRemap, lineRemap);
+    MeshAdjacency compactReference;
+    compactReference.build(keptFaces, keptLines, grid.getVertexCount() - 1);
+    bool compacted = tombstoned.getFaceCount() == compactReference.getFaceCount() &&
+                     tombstoned.getEdgeCount() == compactReference.getEdgeCount() &&
+                     tombstoned.getLineCount() == compactReference.getLineCount();
+    for (int e = 0; compacted && e < compactReference.getEdgeCount(); ++e) {
+        int v1, v2;
+        compactReference.getEdgeVertices(e, v1, v2);
+        int match = tombstoned.findEdge(v1, v2);
+        compacted = match >= 0 && sortedFaces(tombstoned, Incidence::EdgeFaces, match) == sortedFaces(compactReference, Incidence::EdgeFaces, e);
+    }
+    for (int v = 0; compacted && v < compactReference.getVertexCount(); ++v) {
+        compacted = sortedFaces(tombstoned, Incidence::VertexFaces, v) == sortedFaces(compactReference, Incidence::VertexFaces, v) &&
+                    sortedFaces(tombstoned, Incidence::VertexLines, v) == sortedFaces(compactReference, Incidence::VertexLines, v);
+    }
+    std::cout << "Removed faces keep their indices until compaction: " << (stable ? "YES" : "NO") << std::endl;
+    std::cout << "Compacted adjacency matches rebuild: " << (compacted ? "YES" : "NO") << std::endl;
+
+    Utils::logInfo("Mesh adjacency tests completed");
+}
+
+void testBatchDeletion() {
+    Utils::logInfo("Testing batch vertex deletion...");
+
+    const int gridSize = 120;
+    Model model;
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            model.addVertex(static_cast<float>(x), static_cast<float>(y), 0.0f);
+        }
+    }
+    for (int y = 0; y + 1 < gridSize; ++y) {
+        for (int x = 0; x + 1 < gridSize; ++x) {
+            int i = y * gridSize + x;
+            model.addFace(i, i + 1, i + gridSize + 1);
+            model.addFace(i, i + gridSize + 1, i + gridSize);
+            model.addEdge(i, i + 1);
+        }
+    }
+
+    // Delete a box of vertices plus a sprinkling of random ones
+    std::vector<int> doomed;
+    std::mt19937 rng(3);
+    for (int y = 30; y < 70; ++y) {
+        for (int x = 20; x < 90; ++x) doomed.push_back(y * gridSize + x);
+    }
+    for (int i = 0; i < 500; ++i) doomed.push_back(static_cast<int>(rng() % (gridSize * gridSize)));
+    std::vector<char> isDoomed(gridSize * gridSize, 0);
+    for (int index : doomed) isDoomed[index] = 1;
+
+    // Reference: the survivors in order, with the faces and edges that only use survivors
+    Model reference = model;
+    std::vector<int> remap(gridSize * gridSize, -1);
+    int kept = 0;
+    for (int i = 0; i < gridSize * gridSize; ++i) {
+        if (!isDoomed[i]) remap[i] = kept++;
+    }
+    std::vector<Face> expectedFaces;
+    for (const auto &face : reference.getFaces()) {
+        if (remap[face.v1] >= 0 && remap[face.v2] >= 0 && remap[face.v3] >= 0)
+            expectedFaces.emplace_back(remap[face.v1], remap[face.v2], remap[face.v3]);
+    }
+    std::vector<Edge> expectedEdges;
+    for (const auto &edge : reference.getEdges()) {
+        if (remap[edge.v1] >= 0 && remap[edge.v2] >= 0) expectedEdges.emplace_back(remap[edge.v1], remap[edge.v2]);
+    }
+
+    int survivor = 60 * gridSize + 100;
+    model.setSelectedVertex(survivor);
+    auto start = std::chrono::high_resolution_clock::now();
+    model.removeVertices(doomed);
+    double batchMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    bool matches = model.getVertexCount() == kept && model.getFaceCount() == static_cast<int>(expectedFaces.size()) &&
+                   model.getEdgeCount() == static_cast<int>(expectedEdges.size());
+    for (int i = 0; matches && i < model.getFaceCount(); ++i) {
+        const Face &a = model.getFaces()[i];
+        const Face &b = expectedFaces[i];
+        matches = a.v1 == b.v1 && a.v2 == b.v2 && a.v3 == b.v3;
+    }
+    for (int i = 0; matches && i < model.getEdgeCount(); ++i) {
+        matches = model.getEdges()[i].v1 == expectedEdges[i].v1 && model.getEdges()[i].v2 == expectedEdges[i].v2;
+    }
+    for (int i = 0; matches && i < gridSize * gridSize; ++i) {
+        if (remap[i] >= 0) matches = model.getVertices()[remap[i]].position == reference.getVertices()[i].position;
+    }
+    std::cout << "Deleted " << (gridSize * gridSize - kept) << " vertices in " << batchMs << " ms" << std::endl;
+    std::cout << "Batch deletion matches reference: " << (matches ? "YES" : "NO") << std::endl;
+    std::cout << "Selection follows its vertex: " << (model.getSelectedVertexIndex() == remap[survivor] ? "YES" : "NO") << std::endl;
+
+    // Deferred marks keep indices stable until the compaction, and the adjacency drops marked faces as they go
+    Model deferred = reference;
+    deferred.markFaceDeleted(deferred.getFaceCount() - 1); // Before the adjacency exists
+    deferred.markVertexDeleted(0);
+    bool stable = deferred.getVertexCount() == gridSize * gridSize && deferred.isVertexDeleted(0) &&
+                  deferred.isFaceDeleted(0) && deferred.hasPendingDeletes();
+    bool liveOnly = true;
+    const MeshAdjacency &marked = deferred.getMeshAdjacency();
+    for (int v : {1, gridSize, gridSize + 1, gridSize * gridSize - 1}) {
+        marked.forEachVertexFace(v, [&](int face) { liveOnly = liveOnly && !deferred.isFaceDeleted(face); });
+    }
+    marked.forEachVertexLine(1, [&](int edge) { liveOnly = liveOnly && edge != 0; }); // Edge 0 is (0, 1)
+    std::cout << "Adjacency skips marked faces and edges: " << (liveOnly && marked.getFaceCount() == reference.getFaceCount() ? "YES" : "NO") << std::endl;
+    deferred.compactDeleted();
+    stable = stable && !deferred.hasPendingDeletes() && deferred.getVertexCount() == gridSize * gridSize - 1 &&
+             deferred.getFaceCount() == reference.getFaceCount() - 3; // Two faces of vertex 0 and the marked one
+    std::cout << "Deferred deletion compacts once: " << (stable ? "YES" : "NO") << std::endl;
+
+    // The compacted adjacency carries on in step with the arrays
+    MeshAdjacency rebuilt;
+    rebuilt.build(deferred.getFaces(), deferred.getEdges(), deferred.getVertexCount());
+    const MeshAdjacency &compacted = deferred.getMeshAdjacency();
+    bool inStep = compacted.getFaceCount() == deferred.getFaceCount() && compacted.getEdgeCount() == rebuilt.getEdgeCount() &&
+                  compacted.getLineCount() == deferred.getEdgeCount();
+    for (int v = 0; inStep && v < deferred.getVertexCount(); v += 37) {
+        std::vector<int> a, b;
+        compacted.forEachVertexFace(v, [&](int face) { a.push_back(face); });
+        rebuilt.forEachVertexFace(v, [&](int face) { b.push_back(face); });
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        inStep = a == b;
+    }
+    std::cout << "Compacted adjacency matches rebuild: " << (inStep ? "YES" : "NO") << std::endl;
+
+    Utils::logInfo("Batch deletion tests completed");
+}
+
+void testVertexBVH() {
+    Utils::logInfo("Testing vertex BVH picking and nearest-vertex queries...");
+
+    std::mt19937 rng(777);
+    std::uniform_real_distribution<float> position(-4.0f, 4.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> radius(0.01f, 0.3f);
+
+    Model model;
+    for (int i = 0; i < 6000; ++i) {
+        model.addVertex(position(rng), position(rng), position(rng) * 0.25f);
+    }
+    model.addVertex(1.0f, 1.0f, 0.0f); // Duplicates: ties must resolve like the linear scan
+    model.addVertex(1.0f, 1.0f, 0.0f);
+
+    // Ray queries against the SIMD scan (cylinder) and the scalar test (cone), nearest against brute force
+    auto matchesLinearScan = [&](int queryCount) {
+        bool cylinderMatch = true;
+        bool coneMatch = true;
+        bool nearestMatch = true;
+        for (int q = 0; q < queryCount; ++q) {
+            const Ray ray(Vector3(position(rng), position(rng), 6.0f), Vector3(unit(rng) * 0.3f, unit(rng) * 0.3f, -1.0f));
+            const float threshold = radius(rng);
+
+            std::vector<VertexHit> expected;
+            std::vector<VertexHit> found;
+            RayIntersection::intersectVertices(ray, model.getMeshView(), threshold, expected);
+            model.findVerticesNearRay(ray, threshold, 0.0f, found);
+            cylinderMatch = cylinderMatch && found.size() == expected.size();
+            for (size_t i = 0; cylinderMatch && i < found.size(); ++i) {
+                cylinderMatch = found[i].vertexIndex == expected[i].vertexIndex && found[i].distance == expected[i].distance;
+            }
+
+            const float spread = 0.02f;
+            expected.clear();
+            found.clear();
+            for (int v = 0; v < model.getVertexCount(); ++v) {
+                float rayParameter;
+                const Vector3 &point = model.getVertices()[v].position;
+                if (RayIntersection::rayPointDistance(ray, point, rayParameter) <= threshold + spread * rayParameter) {
+                    expected.emplace_back(true, rayParameter, point, v);
+                }
+            }
+            model.findVerticesNearRay(ray, threshold, spread, found);
+            coneMatch = coneMatch && found.size() == expected.size();
+            for (size_t i = 0; coneMatch && i < found.size(); ++i) {
+                coneMatch = found[i].vertexIndex == expected[i].vertexIndex && found[i].distance == expected[i].distance;
+            }
+
+            const Vector3 target = q == 0 ? Vector3(1.0f, 1.0f, 0.0f) : Vector3(position(rng), position(rng), position(rng));
+            int nearest = -1;
+            float nearestDistance = std::numeric_limits<float>::max();
+            for (int v = 0; v < model.getVertexCount(); ++v) {
+                const float distance = (model.getVertices()[v].position - target).lengthSquared();
+                if (distance < nearestDistance) {
+                    nearestDistance = distance;
+                    nearest = v;
+                }
+            }
+            nearestMatch = nearestMatch && model.findNearestVertex(target) == nearest;
+            const float limit = std::sqrt(nearestDistance) * 0.5f;
+            nearestMatch = nearestMatch && (limit == 0.0f || model.findNearestVertex(target, limit) == -1);
+        }
+        std::cout << "  Cylinder picks match linear scan: " << (cylinderMatch ? "YES" : "NO") << std::endl;
+        std::cout << "  Cone picks match linear scan: " << (coneMatch ? "YES" : "NO") << std::endl;
+        std::cout << "  Nearest vertex matches brute force: " << (nearestMatch ? "YES" : "NO") << std::endl;
+    };
+
+    std::cout << "Freshly built index:" << std::endl;
+    matchesLinearScan(300);
+
+    // Moves refit the index in place; keep moving until it rebuilds at least once
+    for (int i = 0; i < 3000; ++i) {
+        const int v = static_cast<int>(rng() % static_cast<unsigned>(model.getVertexCount()));
+        model.setVertexPosition(v, Vector3(position(rng), position(rng), position(rng)));
+    }
+    std::cout << "After 3000 vertex moves:" << std::endl;
+    matchesLinearScan(300);
+
+    model.addVertex(0.0f, 0.0f, 0.0f);
+    std::cout << "After adding a vertex:" << std::endl;
+    matchesLinearScan(50);
+
+    // One pick: index against the linear scan it replaces
+    const Ray pickRay(Vector3(0.3f, -0.2f, 6.0f), Vector3(0.0f, 0.0f, -1.0f));
+    const int repeats = 2000;
+    std::vector<VertexHit> hits;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        hits.clear();
+        RayIntersection::intersectVertices(pickRay, model.getMeshView(), 0.1f, hits);
+    }
+    auto scanTime = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / repeats;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        hits.clear();
+        model.findVerticesNearRay(pickRay, 0.1f, 0.0f, hits);
+    }
+    auto indexTime = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / repeats;
+    std::cout << "Pick over " << model.getVertexCount() << " vertices: linear scan " << scanTime << " us, vertex BVH "
+              << indexTime << " us (" << hits.size() << " hits)" << std::endl;
+}
+
+void testVertexSelection() {
+    Utils::logInfo("Testing vertex selection against the per-face visibility test...");
+
+    // Height-field grid with a floating occluder plate above part of it
+    Model model;
+    const int gridSize = 16;
+    for (int y = 0; y < gridSize; ++y) {
+        for (int x = 0; x < gridSize; ++x) {
+            model.addVertex(x * 0.25f - 2.0f, y * 0.25f - 2.0f, 0.2f * std::sin(x * 1.0f) * std::cos(y * 0.75f));
+        }
+    }
+    for (int y = 0; y + 1 < gridSize; ++y) {
+        for (int x = 0; x + 1 < gridSize; ++x) {
+            int i = y * gridSize + x;
+            model.addFace(i, i + 1, i + gridSize + 1);
+            model.addFace(i, i + gridSize + 1, i + gridSize);
+        }
+    }
+    int plate = model.getVertexCount();
+    model.addVertex(-1.0f, -1.0f, 1.0f);
+    model.addVertex(0.5f, -1.0f, 1.0f);
+    model.addVertex(0.5f, 0.5f, 1.0f);
+    model.addFace(plate, plate + 1, plate + 2);
+
+    Camera camera;
+    camera.setDistance(6.0f);
+    camera.setIsometricView();
+    const float threshold = 0.3f; // Wide pick radius so most sample rays select something
+    const float dynamicThreshold = threshold * camera.getDistance() * 0.1f;
+
+    int mismatches = 0;
+    int selections = 0;
+    double acceleratedMs = 0.0;
+    double referenceMs = 0.0;
+    auto comparePicks = [&]() {
+        for (int py = 0; py < 480; py += 40) {
+            for (int px = 0; px < 640; px += 40) {
+                Ray ray = camera.screenToWorldRay(px, py, 640, 480);
+
+                // Reference: visibility test for every vertex, then the threshold test
+                auto referenceStart = std::chrono::high_resolution_clock::now();
+                int expected = -1;
+                float closestDistance = std::numeric_limits<float>::max();
+                for (int i = 0; i < model.getVertexCount(); ++i) {
+                    const Vector3 &position = model.getVertices()[i].position;
+                    if (!RayIntersection::isVertexVisible(camera.getPosition(), position, model)) continue;
+                    VertexHit hit = RayIntersection::intersectVertex(ray, position, dynamicThreshold, i);
+                    if (hit.hit && hit.distance < closestDistance) {
+                        closestDistance = hit.distance;
+                        expected = i;
+                    }
+                }
+                auto referenceEnd = std::chrono::high_resolution_clock::now();
+
+                model.clearSelection();
+                model.selectVertex(ray, camera, threshold);
+                auto acceleratedEnd = std::chrono::high_resolution_clock::now();
+
+                referenceMs += std::chrono::duration<double, std::milli>(referenceEnd - referenceStart).count();
+                acceleratedMs += std::chrono::duration<double, std::milli>(acceleratedEnd - referenceEnd).count();
+                if (expected >= 0) selections++;
+                if (model.getSelectedVertexIndex() != expected) mismatches++;
+            }
+        }
+    };
+
+    comparePicks();
+    model.setVertexPosition(plate + 2, Vector3(1.5f, 1.0f, 0.8f)); // Occlusion index is refitted, not rebuilt
+    comparePicks();
+
+    std::cout << "Selections: " << selections << ", mismatches: " << mismatches
+              << ", per-face test: " << referenceMs << " ms, accelerated: " << acceleratedMs << " ms" << std::endl;
+    std::cout << "Accelerated selection matches per-face visibility: " << (mismatches == 0 && selections > 0 ? "YES" : "NO") << std::endl;
+
+    Utils::logInfo("Vertex selection tests completed");
+}
+
+void testMeshArrays() {
+    Utils::logInfo("Testing structure-of-arrays mesh view...");
+
+    Model model;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> coordinate(-2.0f, 2.0f);
+    const int vertexCount = 20003; // Not a multiple of the SIMD width
+    for (int i = 0; i < vertexCount; ++i) {
+        model.addVertex(coordinate(rng), coordinate(rng), coordinate(rng));
+    }
+    for (int i = 0; i + 2 < vertexCount; i += 3) {
+        model.addFace(i, i + 1, i + 2);
+    }
+    model.calculateNormals();
+
+    MeshView mesh = model.getMeshView();
+    bool aligned = reinterpret_cast<uintptr_t>(mesh.positionX) % 64 == 0 && reinterpret_cast<uintptr_t>(mesh.normalZ) % 64 == 0 &&
+                   mesh.getPaddedVertexCount() % MeshView::SIMD_WIDTH == 0 && mesh.faceCount == model.getFaceCount();
+    std::cout << "Mesh arrays aligned and padded: " << (aligned ? "YES" : "NO") << std::endl;
+
+    // Patched after a move: the vertex and its one-ring normals
+    model.setVertexPosition(4, Vector3(5.0f, 5.0f, 5.0f));
+    mesh = model.getMeshView();
+    bool synced = true;
+    for (int i = 0; synced && i < vertexCount; ++i) {
+        const Vertex &vertex = model.getVertices()[i];
+        synced = mesh.getPosition(i) == vertex.position && mesh.getNormal(i) == vertex.normal;
+    }
+    std::cout << "Mesh view follows vertex edits: " << (synced ? "YES" : "NO") << std::endl;
+
+    // 8-wide vertex picking against the scalar test
+    int mismatches = 0;
+    int hitCount = 0;
+    double scalarMs = 0.0;
+    double simdMs = 0.0;
+    std::vector<VertexHit> hits;
+    for (int r = 0; r < 200; ++r) {
+        Ray ray(Vector3(coordinate(rng), coordinate(rng), 6.0f), Vector3(coordinate(rng) * 0.2f, coordinate(rng) * 0.2f, -1.0f).normalized());
+
+        auto scalarStart = std::chrono::high_resolution_clock::now();
+        std::vector<VertexHit> expected;
+        for (int i = 0; i < vertexCount; ++i) {
+            VertexHit hit = RayIntersection::intersectVertex(ray, model.getVertices()[i].position, 0.05f, i);
+            if (hit.hit) expected.push_back(hit);
+        }
+        auto simdStart = std::chrono::high_resolution_clock::now();
+        hits.clear();
+        RayIntersection::intersectVertices(ray, mesh, 0.05f, hits);
+        auto simdEnd = std::chrono::high_resolution_clock::now();
+        scalarMs += std::chrono::duration<double, std::milli>(simdStart - scalarStart).count();
+        simdMs += std::chrono::duration<double, std::milli>(simdEnd - simdStart).count();
+
+        hitCount += static_cast<int>(expected.size());
+        if (hits.size() != expected.size()) {
+            mismatches++;
+            continue;
+        }
+        for (size_t i = 0; i < hits.size(); ++i) {
+            if (hits[i].vertexIndex != expected[i].vertexIndex || hits[i].distance != expected[i].distance) mismatches++;
+        }
+    }
+    std::cout << "Vertex hits: " << hitCount << ", scalar: " << scalarMs << " ms, " << simdBackendName() << ": " << simdMs << " ms" << std::endl;
+    std::cout << "SIMD vertex test matches scalar: " << (mismatches == 0 && hitCount > 0 ? "YES" : "NO") << std::endl;
+
+    Utils::logInfo("Mesh array tests completed");
+}
+
+void testLevelOfDetail() {
+    Utils::logInfo("Testing level-of-detail simplification...");
+
+    // Unit UV sphere with outward faces
+    Model sphere;
+    const int rings = 60;
+    const int segments = 120;
+    sphere.addVertex(0.0f, 0.0f, 1.0f);
+    for (int ring = 1; ring < rings; ++ring) {
+        const float theta = Utils::PI * ring / rings;
+        for (int segment = 0; segment < segments; ++segment) {
+            const float phi = 2.0f * Utils::PI * segment / segments;
+            sphere.addVertex(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+        }
+    }
+    sphere.addVertex(0.0f, 0.0f, -1.0f);
+    const int bottomPole = sphere.getVertexCount() - 1;
+    auto ringVertex = [&](int ring, int segment) { return 1 + (ring - 1) * segments + segment % segments; };
+    auto addOutwardFace = [&](int a, int b, int c) {
+        const auto &v = sphere.getVertices();
+        const Vector3 normal = Vector3::cross(v[b].position - v[a].position, v[c].position - v[a].position);
+        if (Vector3::dot(normal, v[a].position + v[b].position + v[c].position) < 0.0f)
+            std::swap(b, c);
+        sphere.addFace(a, b, c);
+    };
+    for (int segment = 0; segment < segments; ++segment) {
+        addOutwardFace(0, ringVertex(1, segment), ringVertex(1, segment + 1));
+        addOutwardFace(bottomPole, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1));
+        for (int ring = 1; ring < rings - 1; ++ring) {
+            addOutwardFace(ringVertex(ring, segment), ringVertex(ring + 1, segment), ringVertex(ring + 1, segment + 1));
+            addOutwardFace(ringVertex(ring, segment), ringVertex(ring + 1, segment + 1), ringVertex(ring, segment + 1));
+        }
+    }
+
+    // Quadric collapses keep the vertices on the surface and the faces facing out
+    MeshSimplifier simplifier;
+    simplifier.load(sphere.getVertices(), sphere.getFaces());
+    simplifier.simplify(1500);
+    Model coarse;
+    simplifier.extract(coarse);
+    float maxRadiusError = 0.0f;
+    for (const Vertex &vertex : coarse.getVertices()) {
+        maxRadiusError = std::max(maxRadiusError, std::abs(vertex.position.length() - 1.0f));
+    }
+    int outwardFaces = 0;
+    for (const Face &face : coarse.getFaces()) {
+        const auto &v = coarse.getVertices();
+        const Vector3 normal = Vector3::cross(v[face.v2].position - v[face.v1].position, v[face.v3].position - v[face.v1].position);
+        if (Vector3::dot(normal, v[face.v1].position + v[face.v2].position + v[face.v3].position) > 0.0f)
+            outwardFaces++;
+    }
+    std::cout << "Sphere simplified from " << sphere.getFaceCount() << " to " << coarse.getFaceCount() << " faces: "
+              << (coarse.getFaceCount() <= 1500 && coarse.getFaceCount() > 1400 ? "YES" : "NO") << std::endl;
+    std::cout << "Simplified vertices stay on the sphere (max error " << maxRadiusError << "): "
+              << (maxRadiusError < 0.02f ? "YES" : "NO") << std::endl;
+    std::cout << "Simplified faces keep their orientation: " << (outwardFaces == coarse.getFaceCount() ? "YES" : "NO") << std::endl;
+
+    // Open boundary: the corners of a flat grid survive aggressive simplification
+    Model grid;
+    const int cells = 40;
+    for (int j = 0; j <= cells; ++j) {
+        for (int i = 0; i <= cells; ++i) {
+            grid.addVertex(static_cast<float>(i) / cells, static_cast<float>(j) / cells, 0.0f);
+        }
+    }
+    for (int j = 0; j < cells; ++j) {
+        for (int i = 0; i < cells; ++i) {
+            const int v00 = j * (cells + 1) + i;
+            grid.addFace(v00, v00 + 1, v00 + cells + 2);
+            grid.addFace(v00, v00 + cells + 2, v00 + cells + 1);
+        }
+    }
+    simplifier.load(grid.getVertices(), grid.getFaces());
+    simplifier.simplify(100);
+    Model coarseGrid;
+    simplifier.extract(coarseGrid);
+    int cornersKept = 0;
+    for (const Vertex &vertex : coarseGrid.getVertices()) {
+        const bool onCornerX = vertex.position.x == 0.0f || vertex.position.x == 1.0f;
+        const bool onCornerY = vertex.position.y == 0.0f || vertex.position.y == 1.0f;
+        if (onCornerX && onCornerY)
+            cornersKept++;
+    }
+    std::cout << "Grid outline kept (" << coarseGrid.getFaceCount() << " faces, " << cornersKept << " corners): "
+              << (coarseGrid.getFaceCount() <= 100 && cornersKept == 4 ? "YES" : "NO") << std::endl;
+
+    // Background build: levels halve down to the minimum and match the model they came from
+    ModelLod lod;
+    lod.start(sphere, 1000);
+    const auto buildStart = std::chrono::steady_clock::now();
+    while (!lod.poll() && std::chrono::steady_clock::now() - buildStart < std::chrono::seconds(30)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    bool levelsHalve = lod.getLevelCount() >= 3;
+    int previousFaces = sphere.getFaceCount();
+    for (int level = 0; level < lod.getLevelCount(); ++level) {
+        const int levelFaces = lod.getLevel(level).getFaceCount();
+        levelsHalve = levelsHalve && levelFaces <= previousFaces / 2 && levelFaces >= 1000;
+        previousFaces = levelFaces;
+    }
+    const Model *budgetLevel = lod.selectLevel(4000);
+    std::cout << "Background build made " << lod.getLevelCount() << " halving levels: "
+              << (levelsHalve && lod.isCurrent(sphere) && budgetLevel && budgetLevel->getFaceCount() <= 4000 ? "YES" : "NO")
+              << std::endl;
+
+    // Editing the model makes its levels stale
+    sphere.setVertexPosition(0, Vector3(0.0f, 0.0f, 1.1f));
+    std::cout << "Edited model invalidates its levels: " << (!lod.isCurrent(sphere) ? "YES" : "NO") << std::endl;
+}
+
+int runModelChecks() {
+    Utils::logInfo("Starting Model Checks");
+
+    try {
+        testModelFileLoading();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testMeshAdjacency();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testBatchDeletion();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testVertexBVH();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testVertexSelection();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testMeshArrays();
+        std::cout << "\n" << std::string(50, '-') << "\n" << std::endl;
+
+        testLevelOfDetail();
+
+    } catch (const std::exception& e) {
+        Utils::logError("Check failed with exception: " + std::string(e.what()));
+        return -1;
+    }
+
+    Utils::logInfo("All model checks completed successfully!");
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--checks") {
+        return runModelChecks();
+    }
+
     Utils::logInfo("Starting Model Test Application (Phase 4)");
 
     ModelTestApp app;
@@ -1,6 +1,9 @@
 #include "UI.h"
 #include "../utils/Utils.h"
+#include "../math/SimdFloat.h"
+#include "../utils/Profiler.h"
 #include <iostream>
+#include <algorithm>
 
 // ImGui includes (conditional compilation)
 #ifdef IMGUI_AVAILABLE
@@ -12,6 +15,7 @@
 UI::UI()
     : camera(nullptr)
     , model(nullptr)
+    , modelSaver(nullptr)
     , coordinateAxes(nullptr)
     , renderer(nullptr)
     , showUI(true)
@@ -20,6 +24,7 @@ UI::UI()
     , showDisplaySettings(true)
     , showAxesSettings(true)
     , showReflectionSettings(true)
+    , showProfiler(true)
     , displayVertices(true)
     , displayEdges(false)
     , displayFaces(true)
@@ -88,6 +93,7 @@ void UI::newFrame() {
 }
 
 void UI::endFrame() {
+    PROFILE_SCOPE("UI::endFrame");
     #ifdef IMGUI_AVAILABLE
     if (imguiAvailable) {
         ImGui::Render();
@@ -98,6 +104,7 @@ void UI::endFrame() {
 
 void UI::render() {
     if (!showUI) return;
+    PROFILE_SCOPE("UI::render");
 
     #ifdef IMGUI_AVAILABLE
     if (imguiAvailable) {
@@ -154,8 +161,16 @@ void UI::renderMainMenuBar() {
             if (ImGui::MenuItem("Open...", "Ctrl+O")) {
                 Utils::logInfo("Open dialog requested (not implemented yet)");
             }
-            if (ImGui::MenuItem("Save", "Ctrl+S")) {
-                Utils::logInfo("Save requested (not implemented yet)");
+            if (ImGui::MenuItem("Save", "Ctrl+S", false, !modelSaver || !modelSaver->isSaving())) {
+                if (model && !model->getFilename().empty()) {
+                    if (modelSaver && Utils::getFileExtension(model->getFilename()) == "fjwr") {
+                        modelSaver->start(*model, model->getFilename());
+                    } else {
+                        model->saveToFile(model->getFilename());
+                    }
+                } else {
+                    Utils::logInfo("Save requested, but the model has no file name yet");
+                }
             }
             ImGui::Separator();
             if (ImGui::MenuItem("Exit")) {
@@ -169,6 +184,8 @@ void UI::renderMainMenuBar() {
             ImGui::MenuItem("Selection Info", nullptr, &showSelectionInfo);
             ImGui::MenuItem("Display Settings", nullptr, &showDisplaySettings);
             ImGui::MenuItem("Axes Settings", nullptr, &showAxesSettings);
+            ImGui::MenuItem("Reflection Settings", nullptr, &showReflectionSettings);
+            ImGui::MenuItem("Profiler", nullptr, &showProfiler);
             ImGui::EndMenu();
         }
 
@@ -216,6 +233,10 @@ void UI::renderToolPanel() {
         if (showReflectionSettings) {
             renderReflectionSettingsPanel();
         }
+
+        if (showProfiler) {
+            renderProfilerPanel();
+        }
     }
     ImGui::End();
     #endif
@@ -245,7 +266,12 @@ void UI::renderSelectionInfoPanel() {
             Vector3 position = model->getSelectedVertexPosition();
 
             ImGui::Text("Selected Vertex: %d", selectedIndex);
-            ImGui::Text("Position: (%.3f, %.3f, %.3f)", position.x, position.y, position.z);
+
+            // Dragging edits the model in place; the renderer picks up only the affected triangles
+            float editPosition[3] = {position.x, position.y, position.z};
+            if (ImGui::DragFloat3("Position", editPosition, 0.01f)) {
+                model->setVertexPosition(selectedIndex, Vector3(editPosition[0], editPosition[1], editPosition[2]));
+            }
 
             if (ImGui::Button("Clear Selection")) {
                 model->clearSelection();
@@ -270,6 +296,28 @@ void UI::renderDisplaySettingsPanel() {
         if (changed) {
             applyDisplaySettings();
         }
+
+        if (renderer) {
+            RenderConfig& renderConfig = renderer->getRenderConfig();
+            ImGui::SliderInt("Render Threads (0 = auto)", &renderConfig.renderThreadCount, 0, ThreadPool::getHardwareThreadCount());
+            ImGui::Checkbox("Packet Tracing (SIMD)", &renderConfig.usePacketTracing);
+            if (renderConfig.usePacketTracing) {
+                ImGui::Checkbox("Wavefront Reflections", &renderConfig.useWavefrontReflections);
+            }
+            ImGui::Text("SIMD backend: %s", simdBackendName());
+            ImGui::Checkbox("Rasterize Primary Rays", &renderConfig.useRasterPrimary);
+            if (renderConfig.useRasterPrimary) {
+                ImGui::Checkbox("Frustum Culling", &renderConfig.frustumCulling);
+                ImGui::Checkbox("Back-Face Culling (closed meshes)", &renderConfig.cullBackFaces);
+                ImGui::Text("Primary triangles: %d", renderer->getLastFrameStats().primaryTriangles);
+            }
+            ImGui::Checkbox("Progressive While Moving", &renderConfig.progressiveRendering);
+            if (renderConfig.progressiveRendering) {
+                ImGui::SliderFloat("Frame Budget (ms)", &renderConfig.progressiveBudgetMs, 5.0f, 100.0f);
+            }
+            ImGui::Checkbox("Skip Unchanged Frames", &renderConfig.skipUnchangedFrames);
+            ImGui::Checkbox("Reproject Small Camera Moves", &renderConfig.temporalReprojection);
+        }
     }
     #endif
 }
@@ -377,6 +425,18 @@ void UI::renderReflectionSettingsPanel() {
                     if (ImGui::SliderInt("Max Reflection Depth", &reflectionConfig.maxReflectionDepth, 1, 10)) {
                         settingsChanged = true;
                     }
+
+                    // Adaptive termination: skip reflections that barely contribute, cap rays per frame
+                    if (ImGui::SliderFloat("Min Reflection Weight", &reflectionConfig.minReflectionWeight, 0.0f, 0.1f, "%.3f")) {
+                        settingsChanged = true;
+                    }
+                    if (ImGui::InputInt("Reflection Ray Budget", &reflectionConfig.reflectionRayBudget, 10000, 100000)) {
+                        reflectionConfig.reflectionRayBudget = std::max(0, reflectionConfig.reflectionRayBudget);
+                        settingsChanged = true;
+                    }
+                    if (renderer->getLastFrameStats().reflectionDepth < reflectionConfig.maxReflectionDepth) {
+                        ImGui::Text("Depth lowered to %d by the ray budget", renderer->getLastFrameStats().reflectionDepth);
+                    }
                 }
             }
 
@@ -482,6 +542,49 @@ void UI::renderReflectionSettingsPanel() {
     #endif
 }
 
+void UI::renderProfilerPanel() {
+    #ifdef IMGUI_AVAILABLE
+    if (imguiAvailable && ImGui::CollapsingHeader("Profiler")) {
+        #ifndef PROFILER_DISABLE
+        const std::vector<Profiler::FrameStats>& history = Profiler::getHistory();
+        const Profiler::FrameStats& frame = Profiler::getLastFrame();
+
+        // Frame time graph over the kept history
+        float frameTimes[Profiler::HISTORY_FRAMES] = {};
+        float maxFrameMs = 1.0f;
+        for (size_t i = 0; i < history.size(); ++i) {
+            frameTimes[i] = static_cast<float>(history[i].frameMs);
+            maxFrameMs = std::max(maxFrameMs, frameTimes[i]);
+        }
+        ImGui::Text("Frame %llu: %.2f ms", static_cast<unsigned long long>(frame.frameIndex), frame.frameMs);
+        ImGui::PlotLines("##FrameTimes", frameTimes, static_cast<int>(history.size()), 0, nullptr,
+                         0.0f, maxFrameMs, ImVec2(0, 40));
+
+        // Scopes overlap (e.g. tiles run inside SoftwareRenderer::render, on every worker thread)
+        ImGui::Separator();
+        for (const auto& scope : frame.scopes) {
+            ImGui::Text("%-26s %7.2f ms  x%d", scope.name.c_str(), scope.totalMs, scope.calls);
+        }
+
+        ImGui::Separator();
+        for (int i = 0; i < Profiler::COUNTER_COUNT; ++i) {
+            ImGui::Text("%-26s %llu", Profiler::getCounterName(static_cast<ProfileCounter>(i)),
+                        static_cast<unsigned long long>(frame.counters[i]));
+        }
+
+        ImGui::Separator();
+        if (ImGui::Button("Export Chrome Trace")) {
+            Profiler::exportChromeTrace("profile_trace.json");
+        }
+        ImGui::SameLine();
+        ImGui::TextDisabled("(last %d frames)", static_cast<int>(history.size()));
+        #else
+        ImGui::Text("Profiler compiled out (PROFILER_DISABLE)");
+        #endif
+    }
+    #endif
+}
+
 void UI::applyReflectionSettings() {
     if (renderer) {
         Utils::logInfo("Reflection settings applied");
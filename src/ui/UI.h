@@ -2,6 +2,7 @@
 
 #include "../core/Camera.h"
 #include "../core/Model.h"
+#include "../core/ModelSaver.h"
 #include "../core/CoordinateAxes.h"
 #include "../rendering/SoftwareRenderer.h"
 
@@ -14,6 +15,7 @@ private:
     // References to main components
     Camera* camera;
     Model* model;
+    ModelSaver* modelSaver;
     CoordinateAxes* coordinateAxes;
     SoftwareRenderer* renderer;
 
@@ -24,6 +26,7 @@ private:
     bool showDisplaySettings;
     bool showAxesSettings;
     bool showReflectionSettings;
+    bool showProfiler;
 
     // Display settings
     bool displayVertices;
@@ -46,6 +49,7 @@ public:
     // Component references
     void setCamera(Camera* cam) { camera = cam; }
     void setModel(Model* mdl) { model = mdl; }
+    void setModelSaver(ModelSaver* saver) { modelSaver = saver; }
     void setCoordinateAxes(CoordinateAxes* axes) { coordinateAxes = axes; }
     void setRenderer(SoftwareRenderer* rend) { renderer = rend; }
 
@@ -72,6 +76,7 @@ private:
     void renderDisplaySettingsPanel();
     void renderAxesSettingsPanel();
     void renderReflectionSettingsPanel();
+    void renderProfilerPanel();
 
 public:
     // Apply settings to renderer
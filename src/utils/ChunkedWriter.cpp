@@ -0,0 +1,70 @@
+#include "ChunkedWriter.h"
+#include <charconv>
+#include <cstring>
+
+namespace
+{
+    constexpr size_t MAX_NUMBER_CHARS = 32; // Longer than any to_chars int or shortest float
+}
+
+bool ChunkedWriter::open(const std::string &path)
+{
+    close();
+
+    file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    buffer.resize(CHUNK_SIZE);
+    used = 0;
+    failed = false;
+    return true;
+}
+
+bool ChunkedWriter::close()
+{
+    if (!file)
+        return false;
+
+    flush();
+    if (std::fclose(file) != 0)
+        failed = true;
+    file = nullptr;
+    return !failed;
+}
+
+void ChunkedWriter::write(std::string_view text)
+{
+    if (used + text.size() > buffer.size())
+    {
+        flush();
+        if (text.size() > buffer.size())
+        {
+            // Too large to buffer: write it through
+            if (file && std::fwrite(text.data(), 1, text.size(), file) != text.size())
+                failed = true;
+            return;
+        }
+    }
+    std::memcpy(buffer.data() + used, text.data(), text.size());
+    used += text.size();
+}
+
+void ChunkedWriter::writeInt(int value)
+{
+    char *begin = reserve(MAX_NUMBER_CHARS);
+    used = std::to_chars(begin, begin + MAX_NUMBER_CHARS, value).ptr - buffer.data();
+}
+
+void ChunkedWriter::writeFloat(float value)
+{
+    char *begin = reserve(MAX_NUMBER_CHARS);
+    used = std::to_chars(begin, begin + MAX_NUMBER_CHARS, value).ptr - buffer.data();
+}
+
+void ChunkedWriter::flush()
+{
+    if (used > 0 && file && std::fwrite(buffer.data(), 1, used, file) != used)
+        failed = true;
+    used = 0;
+}
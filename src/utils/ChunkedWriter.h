@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdio>
+
+// Buffered file writer for large text exports: numbers are formatted with std::to_chars
+// straight into a fixed-size buffer that is flushed to disk whenever it fills up,
+// so memory use stays constant regardless of the file size.
+class ChunkedWriter
+{
+private:
+    std::FILE *file = nullptr;
+    std::vector<char> buffer; // Kept across open()/close() so one writer can be reused
+    size_t used = 0;
+    bool failed = false;
+
+public:
+    static constexpr size_t CHUNK_SIZE = 1 << 16;
+
+    ChunkedWriter() = default;
+    ~ChunkedWriter() { close(); }
+
+    // Non-copyable
+    ChunkedWriter(const ChunkedWriter &) = delete;
+    ChunkedWriter &operator=(const ChunkedWriter &) = delete;
+
+    bool open(const std::string &path);
+    bool close(); // Flushes; false if any write since open() failed
+
+    // Only valid between a successful open() and close()
+
+    void write(std::string_view text);
+    void put(char c)
+    {
+        reserve(1)[0] = c;
+        used++;
+    }
+    void writeInt(int value);
+    void writeFloat(float value); // Shortest text that reads back to the same float
+
+    void flush();
+
+private:
+    // Room for at least `bytes` more characters at buffer.data() + used
+    char *reserve(size_t bytes)
+    {
+        if (used + bytes > buffer.size())
+            flush();
+        return buffer.data() + used;
+    }
+};
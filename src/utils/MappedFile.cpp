@@ -0,0 +1,100 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+        {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping)
+            {
+                void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                if (view)
+                {
+                    fileHandle = file;
+                    mappingHandle = mapping;
+                    mappedData = static_cast<const char *>(view);
+                    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+                    isMapped = true;
+                    return true;
+                }
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+    }
+#else
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor >= 0)
+    {
+        struct stat fileStat;
+        if (fstat(descriptor, &fileStat) == 0 && fileStat.st_size > 0)
+        {
+            void *view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (view != MAP_FAILED)
+            {
+                // The parser reads front to back once
+                madvise(view, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+                ::close(descriptor); // The mapping keeps the file alive
+                mappedData = static_cast<const char *>(view);
+                mappedSize = static_cast<size_t>(fileStat.st_size);
+                isMapped = true;
+                return true;
+            }
+        }
+        ::close(descriptor);
+    }
+#endif
+
+    // Fallback: read into memory (also covers empty files, which cannot be mapped)
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    fallbackBuffer = buffer.str();
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (isMapped)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mappedData);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<char *>(mappedData), mappedSize);
+#endif
+    }
+
+    mappedData = nullptr;
+    mappedSize = 0;
+    isMapped = false;
+    fallbackBuffer.clear();
+}
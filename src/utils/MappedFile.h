@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+// Read-only view of a whole file, memory-mapped where the platform allows it
+// (POSIX mmap / Win32 file mapping) so large files are parsed in place without a copy.
+// Falls back to reading the file into memory when mapping is not possible.
+class MappedFile
+{
+private:
+    const char *mappedData = nullptr;
+    size_t mappedSize = 0;
+    std::string fallbackBuffer; // Used when the file could not be mapped (or is empty)
+    bool isMapped = false;
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    // Non-copyable
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    const char *data() const { return isMapped ? mappedData : fallbackBuffer.data(); }
+    size_t size() const { return isMapped ? mappedSize : fallbackBuffer.size(); }
+};
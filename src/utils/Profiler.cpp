@@ -0,0 +1,317 @@
+#include "Profiler.h"
+#include "ChunkedWriter.h"
+#include "Utils.h"
+#include <memory>
+
+namespace
+{
+    struct FrameTrace
+    {
+        uint64_t frameIndex = 0;
+        int64_t startNs = 0;
+        int64_t endNs = 0;
+        std::vector<std::pair<int, Profiler::ScopeEvent>> events; // (thread id, event)
+    };
+
+    struct ProfilerState
+    {
+        std::mutex threadsMutex;
+        std::vector<std::unique_ptr<Profiler::ThreadData>> threads;
+        int nextThreadId = 1;
+
+        // Left by threads that exited since the last endFrame() (guarded by threadsMutex)
+        uint64_t retiredCounters[Profiler::COUNTER_COUNT] = {};
+        std::vector<std::pair<int, Profiler::ScopeEvent>> retiredEvents;
+
+        const Profiler::Clock::time_point epoch = Profiler::Clock::now();
+        uint64_t frameIndex = 0;
+        Profiler::Clock::time_point frameStart = epoch;
+        std::atomic<bool> frameOpen{false}; // Scopes outside beginFrame()/endFrame() are dropped
+
+        // Main thread only
+        std::vector<Profiler::FrameStats> history;
+        std::vector<FrameTrace> traces; // Parallel to history
+        Profiler::FrameStats emptyFrame;
+    };
+
+    ProfilerState &state()
+    {
+        static ProfilerState instance;
+        return instance;
+    }
+
+    int64_t sinceEpochNs(Profiler::Clock::time_point time)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time - state().epoch).count();
+    }
+
+    Profiler::ScopeStats &findScope(std::vector<Profiler::ScopeStats> &scopes, const char *name)
+    {
+        // A frame has a handful of distinct scopes, a linear search is fine
+        for (auto &scope : scopes)
+        {
+            if (scope.name == name)
+                return scope;
+        }
+        scopes.push_back({name, 0.0, 0});
+        return scopes.back();
+    }
+
+    // Unregisters the thread's data when the thread exits (thread_local destructor)
+    struct ThreadRegistration
+    {
+        Profiler::ThreadData *data = nullptr;
+
+        ~ThreadRegistration()
+        {
+            if (!data)
+                return;
+
+            ProfilerState &profiler = state();
+            std::lock_guard<std::mutex> lock(profiler.threadsMutex);
+            for (int i = 0; i < Profiler::COUNTER_COUNT; ++i)
+            {
+                profiler.retiredCounters[i] += data->counters[i].load(std::memory_order_relaxed) - data->collected[i];
+            }
+            {
+                std::lock_guard<std::mutex> eventLock(data->eventMutex);
+                for (const Profiler::ScopeEvent &event : data->events)
+                {
+                    profiler.retiredEvents.emplace_back(data->threadId, event);
+                }
+            }
+
+            auto &threads = profiler.threads;
+            for (size_t i = 0; i < threads.size(); ++i)
+            {
+                if (threads[i].get() == data)
+                {
+                    threads[i] = std::move(threads.back());
+                    threads.pop_back();
+                    break;
+                }
+            }
+            Profiler::currentThread = nullptr;
+        }
+    };
+
+    thread_local ThreadRegistration threadRegistration;
+
+    void writeMicroseconds(ChunkedWriter &writer, int64_t nanoseconds)
+    {
+        writer.write(std::to_string(nanoseconds / 1000));
+        writer.put('.');
+        int fraction = static_cast<int>(nanoseconds % 1000);
+        writer.put(static_cast<char>('0' + fraction / 100));
+        writer.put(static_cast<char>('0' + fraction / 10 % 10));
+        writer.put(static_cast<char>('0' + fraction % 10));
+    }
+}
+
+namespace Profiler
+{
+    ThreadData &registerThread()
+    {
+        ProfilerState &profiler = state();
+        std::lock_guard<std::mutex> lock(profiler.threadsMutex);
+        profiler.threads.push_back(std::make_unique<ThreadData>());
+        ThreadData &data = *profiler.threads.back();
+        data.threadId = profiler.nextThreadId++;
+        currentThread = &data;
+        threadRegistration.data = &data;
+        return data;
+    }
+
+    int getRegisteredThreadCount()
+    {
+        ProfilerState &profiler = state();
+        std::lock_guard<std::mutex> lock(profiler.threadsMutex);
+        return static_cast<int>(profiler.threads.size());
+    }
+
+    void recordScope(const char *name, Clock::time_point start, Clock::time_point end)
+    {
+        // Without a frame loop (tests, benchmark) nothing would ever collect the events
+        if (!state().frameOpen.load(std::memory_order_relaxed))
+            return;
+
+        ThreadData &data = threadData();
+        const int64_t startNs = sinceEpochNs(start);
+        const int64_t durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+        std::lock_guard<std::mutex> lock(data.eventMutex); // Uncontended except during endFrame()
+        data.events.push_back({name, startNs, durationNs});
+    }
+
+    void beginFrame()
+    {
+        state().frameStart = Clock::now();
+        state().frameOpen.store(true, std::memory_order_relaxed);
+    }
+
+    void endFrame()
+    {
+        ProfilerState &profiler = state();
+        const Clock::time_point frameEnd = Clock::now();
+        profiler.frameOpen.store(false, std::memory_order_relaxed);
+
+        FrameStats frame;
+        frame.frameIndex = profiler.frameIndex++;
+        frame.frameMs = std::chrono::duration<double, std::milli>(frameEnd - profiler.frameStart).count();
+
+        FrameTrace trace;
+        trace.frameIndex = frame.frameIndex;
+        trace.startNs = sinceEpochNs(profiler.frameStart);
+        trace.endNs = sinceEpochNs(frameEnd);
+
+        auto addEvent = [&](int threadId, const ScopeEvent &event)
+        {
+            ScopeStats &scope = findScope(frame.scopes, event.name);
+            scope.totalMs += event.durationNs / 1e6;
+            scope.calls++;
+            trace.events.emplace_back(threadId, event);
+        };
+
+        std::vector<ScopeEvent> events;
+        {
+            std::lock_guard<std::mutex> lock(profiler.threadsMutex);
+            for (int i = 0; i < COUNTER_COUNT; ++i)
+            {
+                frame.counters[i] += profiler.retiredCounters[i];
+                profiler.retiredCounters[i] = 0;
+            }
+            for (const auto &entry : profiler.retiredEvents)
+            {
+                addEvent(entry.first, entry.second);
+            }
+            profiler.retiredEvents.clear();
+
+            for (auto &thread : profiler.threads)
+            {
+                for (int i = 0; i < COUNTER_COUNT; ++i)
+                {
+                    const uint64_t total = thread->counters[i].load(std::memory_order_relaxed);
+                    frame.counters[i] += total - thread->collected[i];
+                    thread->collected[i] = total;
+                }
+
+                {
+                    std::lock_guard<std::mutex> eventLock(thread->eventMutex);
+                    events.swap(thread->events);
+                }
+                for (const ScopeEvent &event : events)
+                {
+                    addEvent(thread->threadId, event);
+                }
+                events.clear();
+            }
+        }
+
+        if (static_cast<int>(profiler.history.size()) == HISTORY_FRAMES)
+        {
+            profiler.history.erase(profiler.history.begin());
+            profiler.traces.erase(profiler.traces.begin());
+        }
+        profiler.history.push_back(std::move(frame));
+        profiler.traces.push_back(std::move(trace));
+    }
+
+    const FrameStats &getLastFrame()
+    {
+        const ProfilerState &profiler = state();
+        return profiler.history.empty() ? profiler.emptyFrame : profiler.history.back();
+    }
+
+    const std::vector<FrameStats> &getHistory()
+    {
+        return state().history;
+    }
+
+    const char *getCounterName(ProfileCounter counter)
+    {
+        switch (counter)
+        {
+        case ProfileCounter::RaysCast:
+            return "Rays cast";
+        case ProfileCounter::TriangleTests:
+            return "Triangle tests";
+        case ProfileCounter::BVHNodesVisited:
+            return "BVH nodes visited";
+        case ProfileCounter::ReflectionRays:
+            return "Reflection rays";
+        default:
+            return "";
+        }
+    }
+
+    bool exportChromeTrace(const std::string &path)
+    {
+        ProfilerState &profiler = state();
+        ChunkedWriter writer;
+        if (!writer.open(path))
+        {
+            Utils::logError("Failed to open trace file: " + path);
+            return false;
+        }
+
+        // Complete events ("X") for scopes, one counter track ("C") per frame
+        writer.write("{\"traceEvents\":[\n");
+        bool first = true;
+        auto separator = [&]()
+        {
+            writer.write(first ? "" : ",\n");
+            first = false;
+        };
+
+        for (size_t f = 0; f < profiler.traces.size(); ++f)
+        {
+            const FrameTrace &trace = profiler.traces[f];
+            const FrameStats &frame = profiler.history[f];
+
+            separator();
+            writer.write("{\"name\":\"Frame ");
+            writer.writeInt(static_cast<int>(trace.frameIndex));
+            writer.write("\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":");
+            writeMicroseconds(writer, trace.startNs);
+            writer.write(",\"dur\":");
+            writeMicroseconds(writer, trace.endNs - trace.startNs);
+            writer.put('}');
+
+            for (const auto &entry : trace.events)
+            {
+                separator();
+                writer.write("{\"name\":\"");
+                writer.write(entry.second.name);
+                writer.write("\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+                writer.writeInt(entry.first);
+                writer.write(",\"ts\":");
+                writeMicroseconds(writer, entry.second.startNs);
+                writer.write(",\"dur\":");
+                writeMicroseconds(writer, entry.second.durationNs);
+                writer.put('}');
+            }
+
+            separator();
+            writer.write("{\"name\":\"Counters\",\"ph\":\"C\",\"pid\":1,\"ts\":");
+            writeMicroseconds(writer, trace.startNs);
+            writer.write(",\"args\":{");
+            for (int i = 0; i < COUNTER_COUNT; ++i)
+            {
+                writer.write(i == 0 ? "\"" : ",\"");
+                writer.write(getCounterName(static_cast<ProfileCounter>(i)));
+                writer.write("\":");
+                writer.write(std::to_string(frame.counters[i]));
+            }
+            writer.write("}}");
+        }
+        writer.write("\n]}\n");
+
+        if (!writer.close())
+        {
+            Utils::logError("Failed to write trace file: " + path);
+            return false;
+        }
+        Utils::logInfo("Exported " + std::to_string(profiler.traces.size()) + " frames to " + path);
+        return true;
+    }
+}
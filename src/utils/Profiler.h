@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Lightweight frame profiler: scoped timers and hot-path counters, aggregated per frame.
+// Every thread records into its own buffers; Profiler::endFrame() collects them on the main
+// thread. Build with PROFILER_DISABLE to compile all PROFILE_* macros out.
+//
+//   PROFILE_SCOPE("SoftwareRenderer::render");      // Times the enclosing block
+//   PROFILE_COUNT(TriangleTests, testedTriangles);   // Adds to a per-frame counter
+
+enum class ProfileCounter
+{
+    RaysCast,        // Ray queries against the scene BVH (packet lanes count individually)
+    TriangleTests,   // Ray/triangle tests in BVH leaves (one per triangle for a packet)
+    BVHNodesVisited, // Nodes popped during traversal
+    ReflectionRays,  // Reflection rays spawned by shading
+    Count
+};
+
+namespace Profiler
+{
+    constexpr int COUNTER_COUNT = static_cast<int>(ProfileCounter::Count);
+    constexpr int HISTORY_FRAMES = 120; // Frames kept for the UI graph and trace export
+
+    using Clock = std::chrono::steady_clock;
+
+    struct ScopeStats
+    {
+        std::string name;
+        double totalMs = 0.0; // Summed over all threads
+        int calls = 0;
+    };
+
+    struct FrameStats
+    {
+        uint64_t frameIndex = 0;
+        double frameMs = 0.0;
+        std::vector<ScopeStats> scopes; // In order of first completion
+        uint64_t counters[COUNTER_COUNT] = {};
+    };
+
+    // Frame boundaries (main thread); scopes are only recorded inside a frame, counters always
+    void beginFrame();
+    void endFrame();
+
+    // Aggregated results of completed frames, oldest first
+    const FrameStats &getLastFrame();
+    const std::vector<FrameStats> &getHistory();
+
+    // Chrome trace event JSON (chrome://tracing, Perfetto) of the frames in the history
+    bool exportChromeTrace(const std::string &path);
+
+    const char *getCounterName(ProfileCounter counter);
+
+    // --- Recording (any thread) ---
+
+    struct ScopeEvent
+    {
+        const char *name; // String literal
+        int64_t startNs;  // Since profiler start
+        int64_t durationNs;
+    };
+
+    // Per-thread recording buffers, registered on a thread's first record and dropped when it exits;
+    // counts and events it had not handed over yet go to the next endFrame()
+    struct ThreadData
+    {
+        int threadId = 0;
+        std::atomic<uint64_t> counters[COUNTER_COUNT] = {}; // Cumulative, written by the owner only
+        uint64_t collected[COUNTER_COUNT] = {};            // Totals at the last endFrame()
+        std::mutex eventMutex;
+        std::vector<ScopeEvent> events;
+    };
+
+    ThreadData &registerThread();
+    inline thread_local ThreadData *currentThread = nullptr;
+    int getRegisteredThreadCount(); // Threads currently recording
+
+    inline ThreadData &threadData()
+    {
+        return currentThread ? *currentThread : registerThread();
+    }
+
+    inline void addCount(ProfileCounter counter, uint64_t amount)
+    {
+        // Only the owning thread writes, so a plain load/store pair is enough (no locked RMW)
+        std::atomic<uint64_t> &value = threadData().counters[static_cast<int>(counter)];
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void recordScope(const char *name, Clock::time_point start, Clock::time_point end);
+}
+
+class ProfileScope
+{
+private:
+    const char *name;
+    Profiler::Clock::time_point start;
+
+public:
+    explicit ProfileScope(const char *scopeName) : name(scopeName), start(Profiler::Clock::now()) {}
+    ~ProfileScope() { Profiler::recordScope(name, start, Profiler::Clock::now()); }
+
+    // Non-copyable
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifndef PROFILER_DISABLE
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_COUNT(counter, amount) Profiler::addCount(ProfileCounter::counter, static_cast<uint64_t>(amount))
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_COUNT(counter, amount) ((void)(amount)) // Keeps local tallies "used"; optimized away
+#endif
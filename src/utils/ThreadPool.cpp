@@ -0,0 +1,158 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threadCount)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = getHardwareThreadCount();
+    }
+
+    queues.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i)
+    {
+        queues.push_back(std::make_unique<TaskQueue>());
+    }
+
+    workers.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; ++i)
+    {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+int ThreadPool::getHardwareThreadCount()
+{
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+void ThreadPool::run(int taskCount, const TaskRef &task)
+{
+    if (taskCount <= 0)
+        return;
+
+    // Nothing to distribute - run on the calling thread
+    if (workers.empty() || taskCount == 1)
+    {
+        for (int i = 0; i < taskCount; ++i)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    // Give every thread a contiguous block of tasks; neighbouring tasks
+    // (e.g. neighbouring tiles) tend to cost the same, so imbalance between
+    // blocks is what stealing evens out
+    const int threadCount = static_cast<int>(queues.size());
+    for (int q = 0; q < threadCount; ++q)
+    {
+        int begin = static_cast<int>(static_cast<int64_t>(taskCount) * q / threadCount);
+        int end = static_cast<int>(static_cast<int64_t>(taskCount) * (q + 1) / threadCount);
+
+        std::lock_guard<std::mutex> lock(queues[q]->mutex);
+        queues[q]->next = begin;
+        queues[q]->end = end;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        currentTask = &task;
+        workersInJob = static_cast<int>(workers.size());
+        ++jobGeneration;
+    }
+    jobReady.notify_all();
+
+    runTasks(0, task);
+
+    // Wait until every worker has left the job so 'task' can safely go out of scope
+    std::unique_lock<std::mutex> lock(jobMutex);
+    jobDone.wait(lock, [this]
+                 { return workersInJob == 0; });
+    currentTask = nullptr;
+}
+
+void ThreadPool::workerLoop(int queueIndex)
+{
+    uint64_t seenGeneration = 0;
+
+    while (true)
+    {
+        const TaskRef *task = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [&]
+                          { return stopping || jobGeneration != seenGeneration; });
+            if (stopping)
+                return;
+
+            seenGeneration = jobGeneration;
+            task = currentTask;
+        }
+
+        runTasks(queueIndex, *task);
+
+        {
+            std::lock_guard<std::mutex> lock(jobMutex);
+            if (--workersInJob == 0)
+            {
+                jobDone.notify_all();
+            }
+        }
+    }
+}
+
+void ThreadPool::runTasks(int queueIndex, const TaskRef &task)
+{
+    // All tasks are queued before the job starts, so once both the own queue
+    // and every other queue are empty there is no more work for this job
+    int taskIndex;
+    while (popTask(queueIndex, taskIndex) || stealTask(queueIndex, taskIndex))
+    {
+        task(taskIndex);
+    }
+}
+
+bool ThreadPool::popTask(int queueIndex, int &taskIndex)
+{
+    TaskQueue &queue = *queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.next == queue.end)
+        return false;
+
+    // Owner works front to back through its block
+    taskIndex = queue.next++;
+    return true;
+}
+
+bool ThreadPool::stealTask(int thiefIndex, int &taskIndex)
+{
+    const int threadCount = static_cast<int>(queues.size());
+    for (int offset = 1; offset < threadCount; ++offset)
+    {
+        TaskQueue &victim = *queues[(thiefIndex + offset) % threadCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.next == victim.end)
+            continue;
+
+        // Thieves take from the far end to stay away from the owner
+        taskIndex = --victim.end;
+        return true;
+    }
+    return false;
+}
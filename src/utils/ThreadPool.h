@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <cstdint>
+
+// Persistent worker pool with per-thread task queues and work stealing.
+// The calling thread participates in every parallelFor, so a pool of N threads
+// owns N - 1 worker threads.
+class ThreadPool
+{
+private:
+    // A thread's block of task indices [next, end): the owner takes from the front, thieves from
+    // the back, so the block stays contiguous and needs no storage
+    struct TaskQueue
+    {
+        std::mutex mutex;
+        int next = 0;
+        int end = 0;
+    };
+
+    // Non-owning view of the caller's task, so dispatching a job never allocates
+    struct TaskRef
+    {
+        const void *context = nullptr;
+        void (*invoke)(const void *context, int taskIndex) = nullptr;
+
+        void operator()(int taskIndex) const { invoke(context, taskIndex); }
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<TaskQueue>> queues; // queues[0] belongs to the calling thread
+
+    // Job dispatch state
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    std::condition_variable jobDone;
+    const TaskRef *currentTask = nullptr;
+    uint64_t jobGeneration = 0;
+    int workersInJob = 0;
+    bool stopping = false;
+
+public:
+    explicit ThreadPool(int threadCount = 0); // 0 = hardware concurrency
+    ~ThreadPool();
+
+    // Non-copyable
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Run task(i) for i in [0, taskCount) and wait until all tasks finished. Any callable works
+    // (lambdas are called through a plain function pointer, no std::function is built per call)
+    template <typename Task>
+    void parallelFor(int taskCount, const Task &task)
+    {
+        TaskRef taskRef;
+        taskRef.context = &task;
+        taskRef.invoke = [](const void *context, int taskIndex)
+        { (*static_cast<const Task *>(context))(taskIndex); };
+        run(taskCount, taskRef);
+    }
+
+    // Total number of threads taking part in parallelFor (workers + caller)
+    int getThreadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+    static int getHardwareThreadCount();
+
+private:
+    void run(int taskCount, const TaskRef &task);
+    void workerLoop(int queueIndex);
+    void runTasks(int queueIndex, const TaskRef &task);
+    bool popTask(int queueIndex, int &taskIndex);
+    bool stealTask(int thiefIndex, int &taskIndex);
+};
@@ -2,10 +2,39 @@
 #include <iostream>
 #include <chrono>
 #include <iomanip>
+#include <atomic>
 
 namespace Utils {
 
+    namespace {
+        std::atomic<int> logLevel{static_cast<int>(LogLevel::Info)};
+    }
+
+    void setLogLevel(LogLevel level) {
+        logLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    LogLevel getLogLevel() {
+        return static_cast<LogLevel>(logLevel.load(std::memory_order_relaxed));
+    }
+
+    bool isLogEnabled(LogLevel level) {
+        return static_cast<int>(level) >= logLevel.load(std::memory_order_relaxed);
+    }
+
+    void logDebug(const std::string& message) {
+        if (!isLogEnabled(LogLevel::Debug)) return;
+        auto now = std::chrono::system_clock::now();
+        auto time_t = std::chrono::system_clock::to_time_t(now);
+        auto tm = *std::localtime(&time_t);
+
+        std::cout << "[DEBUG] "
+                  << std::put_time(&tm, "%H:%M:%S")
+                  << " " << message << std::endl;
+    }
+
     void logInfo(const std::string& message) {
+        if (!isLogEnabled(LogLevel::Info)) return;
         auto now = std::chrono::system_clock::now();
         auto time_t = std::chrono::system_clock::to_time_t(now);
         auto tm = *std::localtime(&time_t);
@@ -16,6 +45,7 @@ namespace Utils {
     }
 
     void logError(const std::string& message) {
+        if (!isLogEnabled(LogLevel::Error)) return;
         auto now = std::chrono::system_clock::now();
         auto time_t = std::chrono::system_clock::to_time_t(now);
         auto tm = *std::localtime(&time_t);
@@ -26,6 +56,7 @@ namespace Utils {
     }
 
     void logWarning(const std::string& message) {
+        if (!isLogEnabled(LogLevel::Warning)) return;
         auto now = std::chrono::system_clock::now();
         auto time_t = std::chrono::system_clock::to_time_t(now);
         auto tm = *std::localtime(&time_t);
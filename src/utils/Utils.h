@@ -13,7 +13,20 @@ namespace Utils {
             exit(1); \
         }
 
+    // Log levels: messages below the runtime level are dropped (default Info)
+    enum class LogLevel {
+        Debug = 0,
+        Info,
+        Warning,
+        Error,
+        None
+    };
+    void setLogLevel(LogLevel level);
+    LogLevel getLogLevel();
+    bool isLogEnabled(LogLevel level);
+
     // Logging functions
+    void logDebug(const std::string& message);
     void logInfo(const std::string& message);
     void logError(const std::string& message);
     void logWarning(const std::string& message);
@@ -39,4 +52,18 @@ namespace Utils {
         if (value > max) return max;
         return value;
     }
-}
\ No newline at end of file
+}
+
+// Logging from hot paths (per element added, per edit): the message expression is only evaluated
+// when the level is enabled, so quiet levels build no strings at all. LOG_MIN_LEVEL (0 = Debug ...
+// 3 = Error) removes the levels below it at compile time
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+#define LOG_AT_LEVEL(level, function, message) \
+    do { \
+        if (static_cast<int>(level) >= LOG_MIN_LEVEL && Utils::isLogEnabled(level)) \
+            function(message); \
+    } while (0)
+#define LOG_DEBUG(message) LOG_AT_LEVEL(Utils::LogLevel::Debug, Utils::logDebug, message)
+#define LOG_INFO(message) LOG_AT_LEVEL(Utils::LogLevel::Info, Utils::logInfo, message)